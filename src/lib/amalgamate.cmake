@@ -0,0 +1,54 @@
+# Single header amalgamation of the core library
+#
+# Generates `rainflow_inline.h` from `rainflow.h` and `rainflow.c`. The build
+# runs it into the binary directory (target rfc_amalgamation), or run it
+# standalone (output into the current directory by default):
+#[[
+    cmake [-DRFC_INLINE_OUTPUT=path/rainflow_inline.h] -P src/lib/amalgamate.cmake
+#]]
+# Define RFC_IMPLEMENTATION in exactly one source file before including
+# `rainflow_inline.h`. That translation unit gets the implementation and
+# the inlinable feed entry points RFC_feed_sample_inline() and
+# RFC_feed_block_inline().
+
+set(rfc_lib_dir ${CMAKE_CURRENT_LIST_DIR})
+if (NOT RFC_INLINE_OUTPUT)
+    set(RFC_INLINE_OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/rainflow_inline.h)
+endif ()
+
+file(READ ${rfc_lib_dir}/rainflow.h rfc_header)
+file(READ ${rfc_lib_dir}/rainflow.c rfc_source)
+
+# Declarations are part of the amalgamation already
+string(REPLACE "#include \"rainflow.h\"\n" "" rfc_source "${rfc_source}")
+
+set(rfc_inline
+"/*
+ * rainflow_inline.h
+ *
+ * Single header amalgamation of rainflow.h and rainflow.c, generated by
+ * amalgamate.cmake. Do not edit, changes apply to the original files.
+ *
+ * Usage:
+ *   #define RFC_IMPLEMENTATION   (in exactly one source file)
+ *   #include \"rainflow_inline.h\"
+ */
+
+#if defined(RFC_IMPLEMENTATION) && defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE  /* ftruncate() under strict C99 (RFC_SHM_SUPPORT) */
+#endif
+
+${rfc_header}
+
+#if defined(RFC_IMPLEMENTATION) && !defined(RAINFLOW_INLINE_IMPLEMENTATION)
+#define RAINFLOW_INLINE_IMPLEMENTATION
+#define RFC_INLINE_API 1
+
+${rfc_source}
+#endif /*RFC_IMPLEMENTATION*/
+")
+
+# Touch output only on changes
+file(WRITE ${RFC_INLINE_OUTPUT}.tmp "${rfc_inline}")
+configure_file(${RFC_INLINE_OUTPUT}.tmp ${RFC_INLINE_OUTPUT} COPYONLY)
+file(REMOVE ${RFC_INLINE_OUTPUT}.tmp)
@@ -17,5 +17,6 @@
   #define RFC_AT_SUPPORT             ON
   #define RFC_AR_SUPPORT             ON
   #define RFC_DEBUG_FLAGS            OFF
+  #define RFC_SHM_SUPPORT            ON
   #define RFC_EXPORT_MEX             ON
 #endif /*RFC_VERSION_MAJOR*/
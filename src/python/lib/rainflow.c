@@ -103,6 +103,10 @@
 #endif /*COAN_INVOKED*/
 
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE  /* ftruncate() under strict C99 (RFC_SHM_SUPPORT) */
+#endif
+
 #include "rainflow.h"
 
 #include <assert.h>  /* assert() */
@@ -110,6 +114,12 @@
 #include <stdlib.h>  /* calloc(), free(), abs() */
 #include <string.h>  /* memset() */
 #include <float.h>   /* DBL_MAX */
+#if RFC_SHM_SUPPORT
+#include <fcntl.h>     /* O_CREAT, O_RDWR, O_RDONLY */
+#include <sys/mman.h>  /* shm_open(), shm_unlink(), mmap(), munmap() */
+#include <sys/stat.h>  /* fstat() */
+#include <unistd.h>    /* ftruncate(), close() */
+#endif /*RFC_SHM_SUPPORT*/
 
 static char* __rfc_core_version__ = RFC_CORE_VERSION;
 
@@ -124,6 +134,28 @@ static char* __rfc_core_version__ = RFC_CORE_VERSION;
 #endif
 
 
+#if !RFC_MINIMAL
+/* Parameters of a spectral cycle amplitude distribution, see RFC_spectral_damage() */
+struct spectral_param
+{
+    int                     method;                             /**< Estimation method (RFC_SPECTRAL...) */
+    double                  m0;                                 /**< Variance (0th spectral moment) */
+    double                  nu_0;                               /**< Rate of mean upcrossings */
+    double                  nu_p;                               /**< Rate of peaks */
+    double                  alpha2;                             /**< Bandwidth parameter */
+    double                  D1, D2, D3, Q, R;                   /**< Dirlik coefficients */
+    double                  b;                                  /**< Tovo-Benasciutti weighting factor */
+};
+
+/* Counting state of one plane, see RFC_cp_damage(). Contexts are packed, the union keeps consecutive planes aligned */
+union cp_plane
+{
+    rfc_ctx_s               ctx;                                /**< Counting state */
+    double                  align;                              /**< Alignment only */
+};
+#endif /*!RFC_MINIMAL*/
+
+
 /* Core functions */
 #if !RFC_MINIMAL
 #if RFC_AT_SUPPORT
@@ -136,10 +168,15 @@ static void                 clear_lut                       (       rfc_ctx_s *
 static bool                 autoresize                      (       rfc_ctx_s *, rfc_value_tuple_s* pt );
 #endif /*RFC_AR_SUPPORT*/
 static void                 cycle_find                      (       rfc_ctx_s *, rfc_flags_e flags );
+static bool                 value_mode_check                (       rfc_ctx_s * );
 #else /*RFC_MINIMAL*/
 #define cycle_find          cycle_find_4ptm
 #endif /*!RFC_MINIMAL*/
+static bool                 feed_sample                     (       rfc_ctx_s *, rfc_value_t value, rfc_flags_e flags );
 static bool                 feed_once                       (       rfc_ctx_s *, const rfc_value_tuple_s* tp, rfc_flags_e flags );
+#if !RFC_MINIMAL
+static bool                 feed_once_tp                    (       rfc_ctx_s *, const rfc_value_tuple_s* tp );
+#endif /*!RFC_MINIMAL*/
 #if RFC_DH_SUPPORT
 static bool                 feed_once_dh                    (       rfc_ctx_s *, const rfc_value_tuple_s* pt );
 #endif /*RFC_DH_SUPPORT*/
@@ -175,8 +212,12 @@ static bool                 finalize_res_clormann_seeger    (       rfc_ctx_s *,
 static bool                 finalize_res_rp_DIN45667        (       rfc_ctx_s *, rfc_flags_e flags );
 static bool                 finalize_res_repeated           (       rfc_ctx_s *, rfc_flags_e flags );
 static bool                 residue_exchange                (       rfc_ctx_s *, rfc_value_tuple_s **residue, size_t *residue_cap, size_t *residue_cnt, bool restore );
+static bool                 ctx_clone_init                  (       rfc_ctx_s *, rfc_ctx_s *clone );
+static bool                 ctx_clone_deinit                (       rfc_ctx_s *clone );
+static bool                 finalize_fork_init              (       rfc_ctx_s *, rfc_ctx_s *fork );
 #endif /*!RFC_MINIMAL*/
 static void                 residue_remove_item             (       rfc_ctx_s *, size_t index, size_t count );
+static bool                 residue_grow                    (       rfc_ctx_s * );
 /* Memory allocator */
 static void *               mem_alloc                       ( void *ptr, size_t num, size_t size, int aim );
 #if RFC_TP_SUPPORT
@@ -186,6 +227,14 @@ static bool                 tp_get                          (       rfc_ctx_s *,
 static bool                 tp_inc_damage                   (       rfc_ctx_s *, size_t tp_pos, double damage );
 static void                 tp_lock                         (       rfc_ctx_s *, bool do_lock );
 static bool                 tp_refeed                       (       rfc_ctx_s *, rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param );
+/* Turning point archives */
+static void                 archive_put_uint                ( unsigned char *p, uint64_t v, int bytes );
+static uint64_t             archive_get_uint                ( const unsigned char *p, int bytes );
+static size_t               archive_put_varint              ( unsigned char *p, uint64_t v );
+static bool                 archive_get_varint              ( const unsigned char **p, const unsigned char *end, uint64_t *v );
+static size_t               archive_put_xor                 ( unsigned char *p, uint64_t x );
+static bool                 archive_encode                  (       rfc_ctx_s *, unsigned char *archive, unsigned chunk_size, double scale, size_t *size );
+static bool                 archive_decode_chunk            ( const unsigned char *archive, size_t size, size_t chunk, size_t skip, rfc_value_tuple_s *tp, size_t count, size_t *decoded );
 #endif /*RFC_TP_SUPPORT*/
 #if RFC_DH_SUPPORT
 static bool                 spread_damage                   (       rfc_ctx_s *, rfc_value_tuple_s *from, rfc_value_tuple_s *to, rfc_value_tuple_s *next, rfc_flags_e flags );
@@ -202,16 +251,97 @@ static bool                 damage_calc                     (       rfc_ctx_s *,
 static bool                 damage_lut_init                 (       rfc_ctx_s * );
 static bool                 damage_calc_fast                (       rfc_ctx_s *, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret );
 #endif /*RFC_DAMAGE_FAST*/
+#if !RFC_MINIMAL
+static bool                 cp_plane_init                   (       rfc_ctx_s *, rfc_ctx_s *plane );
+static void                 spectral_fft                    ( double *re, double *im, unsigned n );
+static double               spectral_exceedance             ( const struct spectral_param *, double Sa );
+static bool                 rmd_rehash                      (       rfc_ctx_s *, size_t cap, unsigned mean_shift );
+static bool                 rmd_add                         (       rfc_ctx_s *, unsigned range, unsigned mean, unsigned duration, rfc_counts_t inc );
+static unsigned             rmd_duration_class              ( const rfc_ctx_s *, double duration );
+static int                  rmd_item_cmp                    ( const void *lhs, const void *rhs );
+static bool                 cycles_add                      (       rfc_ctx_s *, rfc_value_t from, rfc_value_t to, rfc_counts_t inc );
+static void                 cycles_compact                  (       rfc_ctx_s * );
+static int                  cycle_item_cmp                  ( const void *lhs, const void *rhs );
+static double               top_item_key                    ( const rfc_ctx_s *, const rfc_top_item_s *item );
+static void                 top_add                         (       rfc_ctx_s *, const rfc_value_tuple_s *from, const rfc_value_tuple_s *to, double damage );
+static int                  top_item_cmp_damage             ( const void *lhs, const void *rhs );
+static int                  top_item_cmp_range              ( const void *lhs, const void *rhs );
+static void                 snapshot_publish                (       rfc_ctx_s * );
+static void                 snapshot_free                   (       rfc_ctx_s * );
+static void                 region_publish                  (       rfc_ctx_s * );
+static void                 region_free                     (       rfc_ctx_s * );
+static bool                 mux_feed                        (       rfc_ctx_s *, const rfc_value_t *data, size_t count );
+static bool                 follower_feed                   (       rfc_ctx_s *, const rfc_value_tuple_s *tp );
+static bool                 follower_finalize               (       rfc_ctx_s *, rfc_res_method_e residual_method );
+static bool                 rfm_pyramid_build               (       rfc_ctx_s *, unsigned level );
+static unsigned             quantize_bounds                 ( const rfc_ctx_s *, double value );
+static unsigned             range_class                     ( const rfc_ctx_s *, unsigned class_from, unsigned class_to );
+static unsigned             cycle_cond                      ( const rfc_ctx_s *, const rfc_value_tuple_s *from, const rfc_value_tuple_s *to );
+static bool                 damage_calc_cond                (       rfc_ctx_s *, unsigned cond, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret );
+static double               sl_neuber                       ( const rfc_sl_param_s *, double S, double m );
+static double               sl_life                         ( double A, double p, double B, double q, double L );
+static bool                 sl_damage_calc                  (       rfc_ctx_s *, double Sa, double Sm, double *damage );
+#endif /*!RFC_MINIMAL*/
 static bool                 error_raise                     (       rfc_ctx_s *, rfc_error_e );
 static rfc_value_t          value_delta                     (       rfc_ctx_s *, const rfc_value_tuple_s* pt_from, const rfc_value_tuple_s* pt_to, int *sign_ptr );
 
 
+#if !RFC_MINIMAL
+#define QUANTIZE( r, v )    ( (r)->class_count ? ( (r)->class_bounds ? quantize_bounds( (r), (v) ) : (unsigned)( ((v) - (r)->class_offset) / (r)->class_width ) ) : 0 )
+#define AMPLITUDE( r, i )   ( (r)->class_count ? ( (r)->class_bounds ? ( (double)(r)->class_bounds[i] - (r)->class_bounds[0] ) / 2 : (double)(r)->class_width * (i) / 2 ) : 0.0 )
+#define CLASS_MEAN( r, c )  ( (r)->class_count ? ( (r)->class_bounds ? ( (double)(r)->class_bounds[c] + (r)->class_bounds[(c)+1] ) / 2 : (double)(r)->class_width * (0.5 + (c)) + (r)->class_offset ) : 0.0 )
+#define CLASS_UPPER( r, c ) ( (r)->class_count ? ( (r)->class_bounds ? (double)(r)->class_bounds[(c)+1] : (double)(r)->class_width * (1.0 + (c)) + (r)->class_offset ) : 0.0 )
+#define CYCLE_SA( r, f, t ) ( (r)->class_bounds ? fabs( (double)(r)->class_bounds[f] - (r)->class_bounds[t] ) / 2 : (double)abs( (int)(f) - (int)(t) ) / 2.0 * (r)->class_width )
+#define CYCLE_SM( r, f, t ) ( (r)->class_bounds ? ( (double)(r)->class_bounds[f] + (r)->class_bounds[t] ) / 2 : ( (int)(f) + (int)(t) ) / 2.0 * (r)->class_width + (r)->class_offset )
+#else /*RFC_MINIMAL*/
 #define QUANTIZE( r, v )    ( (r)->class_count ? (unsigned)( ((v) - (r)->class_offset) / (r)->class_width ) : 0 )
 #define AMPLITUDE( r, i )   ( (r)->class_count ? ( (double)(r)->class_width * (i) / 2 ) : 0.0 )
 #define CLASS_MEAN( r, c )  ( (r)->class_count ? ( (double)(r)->class_width * (0.5 + (c)) + (r)->class_offset ) : 0.0 )
 #define CLASS_UPPER( r, c ) ( (r)->class_count ? ( (double)(r)->class_width * (1.0 + (c)) + (r)->class_offset ) : 0.0 )
+#define CYCLE_SA( r, f, t ) ( (double)abs( (int)(f) - (int)(t) ) / 2.0 * (r)->class_width )
+#define CYCLE_SM( r, f, t ) ( ( (int)(f) + (int)(t) ) / 2.0 * (r)->class_width + (r)->class_offset )
+#endif /*!RFC_MINIMAL*/
 #define NUMEL( x )          ( sizeof(x) / sizeof(*(x)) )
 #define MAT_OFFS( i, j )    ( (i) * class_count + (j) )
+#define RMM_SIZE( n )       ( (n) * ( (n) + 1 ) / 2 )
+#define RMM_OFFS( r, s )    ( (r) * class_count - (r) * ( (r) - 1 ) / 2 + ( (s) - (r) ) / 2 )
+#define RMD_HASH( r, m, d ) ( (size_t)(r) * 73856093u ^ (size_t)(m) * 19349663u ^ (size_t)(d) * 83492791u )
+#define RMD_CAP_MIN         (64)
+#define SNAPSHOT_TILE       (16)
+#define ARCHIVE_MAGIC       "RFCA"
+#define ARCHIVE_VERSION     (1)
+#define ARCHIVE_HEADER_SIZE (48)
+#define ARCHIVE_CHUNK_SIZE  (4096)
+#define ARCHIVE_ZIGZAG( v, ref )    ( ( (uint64_t)(v) - (uint64_t)(ref) ) >> 63 ? ( ~( (uint64_t)(v) - (uint64_t)(ref) ) << 1 ) | 1 : ( (uint64_t)(v) - (uint64_t)(ref) ) << 1 )
+#define ARCHIVE_UNZIGZAG( z, ref )  ( ( (z) & 1 ) ? (uint64_t)(ref) + ~( (z) >> 1 ) : (uint64_t)(ref) + ( (z) >> 1 ) )
+#if !RFC_MINIMAL
+#define VALUE_MODE( r )     ( (r)->internal.flags & RFC_FLAGS_COUNT_VALUES )
+#else /*RFC_MINIMAL*/
+#define VALUE_MODE( r )     ( 0 )
+#endif /*!RFC_MINIMAL*/
+
+#if !RFC_MINIMAL
+/* Full memory barrier, orders snapshot sequence counters and contents */
+#if defined(__GNUC__) || defined(__clang__)
+#define MEMORY_BARRIER()    __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM64)
+#define MEMORY_BARRIER()    __dmb( _ARM64_BARRIER_ISH )  /* Weakly ordered targets need a hardware fence */
+#elif defined(_M_ARM)
+#define MEMORY_BARRIER()    __dmb( _ARM_BARRIER_ISH )
+#else
+#define MEMORY_BARRIER()    _ReadWriteBarrier()          /* x86/x64 preserve store-store and load-load order */
+#endif
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define MEMORY_BARRIER()    atomic_thread_fence( memory_order_seq_cst )
+#else
+/* No barrier known, snapshots and result regions are unsupported */
+#define MEMORY_BARRIER_NONE 1
+#define MEMORY_BARRIER()    ( (void)0 )
+#endif
+#endif /*!RFC_MINIMAL*/
 
 #define RFC_CTX_CHECK_AND_ASSIGN                                                    \
     rfc_ctx_s *rfc_ctx = (rfc_ctx_s*)ctx;                                           \
@@ -312,6 +442,11 @@ bool RFC_init( void *ctx, unsigned class_count, rfc_value_t class_width, rfc_val
     rfc_ctx->class_offset                   = class_offset;
     rfc_ctx->hysteresis                     = hysteresis;
 
+#if !RFC_MINIMAL
+    /* Nominal stress approach per default */
+    memset( &rfc_ctx->sl, 0, sizeof(rfc_ctx->sl) );
+#endif /*!RFC_MINIMAL*/
+
     /* Values for a "pseudo Woehler curve" */
     rfc_ctx->state = RFC_STATE_INIT;   /* Bypass sanity check for state in wl_init() */
     RFC_wl_init_elementary( rfc_ctx, /*sx*/ RFC_WL_SD_DEFAULT, /*nx*/ RFC_WL_ND_DEFAULT, /*k*/ RFC_WL_K_DEFAULT );
@@ -339,6 +474,11 @@ bool RFC_init( void *ctx, unsigned class_count, rfc_value_t class_width, rfc_val
 #if !RFC_MINIMAL
     /* Rainflow counting method */
     rfc_ctx->counting_method                = RFC_COUNTING_METHOD_4PTM;
+
+    /* Duration classes for range-mean-duration histogram (octaves, starting at 2 samples) */
+    rfc_ctx->rmd_dur_min                    = 2.0;
+    rfc_ctx->rmd_dur_ratio                  = 2.0;
+    rfc_ctx->rmd_dur_count                  = RFC_RMD_DUR_COUNT_DEFAULT;
 #endif /*!RFC_MINIMAL*/
 
     /* Residue */
@@ -384,6 +524,30 @@ bool RFC_init( void *ctx, unsigned class_count, rfc_value_t class_width, rfc_val
                                                                                  sizeof(rfc_counts_t), RFC_MEM_AIM_LC );
             if( !rfc_ctx->lc ) ok = false;
         }
+
+        if( ok && ( flags & RFC_FLAGS_COUNT_RMM ) )
+        {
+            rfc_ctx->rmm                    = (rfc_counts_t*)rfc_ctx->mem_alloc( NULL, RMM_SIZE( class_count ),
+                                                                                 sizeof(rfc_counts_t), RFC_MEM_AIM_RMM );
+            if( !rfc_ctx->rmm ) ok = false;
+        }
+
+        if( ok && ( flags & RFC_FLAGS_COUNT_RMD ) )
+        {
+            rfc_ctx->rmd                    = (rfc_rmd_item_s*)rfc_ctx->mem_alloc( NULL, RMD_CAP_MIN,
+                                                                                   sizeof(rfc_rmd_item_s), RFC_MEM_AIM_RMD );
+            rfc_ctx->rmd_cap                = RMD_CAP_MIN;
+            rfc_ctx->rmd_cnt                = 0;
+            if( !rfc_ctx->rmd ) ok = false;
+            else memset( rfc_ctx->rmd, 0, sizeof(rfc_rmd_item_s) * RMD_CAP_MIN );
+        }
+
+        if( ok && ( flags & RFC_FLAGS_COUNT_TAL ) )
+        {
+            rfc_ctx->tal                    = (size_t*)rfc_ctx->mem_alloc( NULL, class_count,
+                                                                           sizeof(size_t), RFC_MEM_AIM_TAL );
+            if( !rfc_ctx->tal ) ok = false;
+        }
 #endif /*!RFC_MINIMAL*/
         if( !ok )
         {
@@ -392,6 +556,22 @@ bool RFC_init( void *ctx, unsigned class_count, rfc_value_t class_width, rfc_val
         }
     }
 
+#if !RFC_MINIMAL
+    /* Cycles in value domain, class_count may be zero */
+    if( flags & RFC_FLAGS_COUNT_VALUES )
+    {
+        rfc_ctx->cycles_cnt                 = 0;
+        rfc_ctx->cycles_cap                 = 256;
+        rfc_ctx->cycles                     = (rfc_cycle_item_s*)rfc_ctx->mem_alloc( NULL, rfc_ctx->cycles_cap,
+                                                                                     sizeof(rfc_cycle_item_s), RFC_MEM_AIM_CYCLES );
+        if( !rfc_ctx->cycles || !rfc_ctx->residue )
+        {
+            RFC_deinit( rfc_ctx );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+    }
+#endif /*!RFC_MINIMAL*/
+
     /* Damage */
     rfc_ctx->damage                         = 0.0;
     rfc_ctx->damage_residue                 = 0.0;
@@ -975,6 +1155,227 @@ bool RFC_tp_clear( void *ctx )
     return true;
 }
 
+
+/**
+ * @brief      Write the turning point storage into a compact archive.
+ *             Positions are stored as varint deltas. Values are stored as
+ *             varint deltas of quantized values, if all values are exact
+ *             multiples of 1/scale, otherwise they are XORed with the
+ *             turning point two steps back (same slope) and stored without
+ *             zero bytes. Both ways are lossless. A chunk index allows
+ *             random access.
+ *             Recounting the archive by RFC_archive_feed() gives identical
+ *             results for any hysteresis not less than the archive's.
+ *
+ * @param         ctx         The rainflow context
+ * @param[out]    archive     The archive, may be NULL to query the size
+ * @param[in,out] size        The capacity of archive, receives the
+ *                            size written (or needed)
+ * @param         chunk_size  The number of turning points per chunk (0 for default)
+ * @param         scale       The quantization, values times scale are integral
+ *                            (e.g. ADC counts per unit), 0 for XOR coding
+ *
+ * @return     true on success, false if the capacity is too small
+ * 
+ * @note       Finalize the context first, so that the interim turning
+ *             point is stored.
+ */
+bool RFC_archive_write( const void *ctx, unsigned char *archive, size_t *size, unsigned chunk_size, double scale )
+{
+    size_t needed;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !size || ( *size && !archive ) )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !chunk_size )
+    {
+        chunk_size = ARCHIVE_CHUNK_SIZE;
+    }
+
+    if( !archive_encode( rfc_ctx, NULL, chunk_size, scale, &needed ) )
+    {
+        return false;
+    }
+
+    if( *size < needed )
+    {
+        /* Buffer too small, report the needed size */
+        *size = needed;
+        return false;
+    }
+
+    if( !archive_encode( rfc_ctx, archive, chunk_size, scale, &needed ) )
+    {
+        return false;
+    }
+
+    *size = needed;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get information on an archive.
+ *
+ * @param      archive       The archive
+ * @param      size          The size of the archive in bytes
+ * @param[out] hysteresis    The hysteresis turning points are extracted with, may be NULL
+ * @param[out] sample_count  The number of samples of the original signal, may be NULL
+ * @param[out] tp_count      The number of turning points, may be NULL
+ *
+ * @return     true on success
+ * 
+ * @note       No context involved.
+ */
+bool RFC_archive_info( const unsigned char *archive, size_t size, rfc_value_t *hysteresis, size_t *sample_count, size_t *tp_count )
+{
+    double   h;
+    uint64_t bits;
+
+    if( !archive || size < ARCHIVE_HEADER_SIZE || memcmp( archive, ARCHIVE_MAGIC, 4 ) || archive[4] != ARCHIVE_VERSION ||
+        !archive_get_uint( archive + 32, 4 ) )
+    {
+        return false;
+    }
+
+    bits = archive_get_uint( archive + 8, 8 );
+    memcpy( &h, &bits, sizeof(h) );
+
+    if( hysteresis )   *hysteresis   = (rfc_value_t)h;
+    if( sample_count ) *sample_count = (size_t)archive_get_uint( archive + 16, 8 );
+    if( tp_count )     *tp_count     = (size_t)archive_get_uint( archive + 24, 8 );
+
+    return true;
+}
+
+
+/**
+ * @brief      Read turning points from an archive. Only the chunks
+ *             covering the range requested are decoded.
+ *
+ * @param      archive  The archive
+ * @param      size     The size of the archive in bytes
+ * @param      first    The first turning point to read, base 0
+ * @param[out] tp       The turning points (value, pos and cond are set)
+ * @param      count    The number of turning points to read
+ *
+ * @return     true on success
+ * 
+ * @note       No context involved.
+ */
+bool RFC_archive_get( const unsigned char *archive, size_t size, size_t first, rfc_value_tuple_s *tp, size_t count )
+{
+    size_t   tp_count;
+    unsigned chunk_size;
+
+    if( !RFC_archive_info( archive, size, NULL, NULL, &tp_count ) || first > tp_count || count > tp_count - first || ( count && !tp ) )
+    {
+        return false;
+    }
+
+    chunk_size = (unsigned)archive_get_uint( archive + 32, 4 );
+
+    while( count )
+    {
+        size_t chunk = first / chunk_size;
+        size_t skip  = first % chunk_size;
+        size_t n;
+
+        if( !archive_decode_chunk( archive, size, chunk, skip, tp, count, &n ) )
+        {
+            return false;
+        }
+
+        tp    += n;
+        first += n;
+        count -= n;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Feed all turning points of an archive (see RFC_feed_tuple()).
+ *
+ * @param      ctx      The rainflow context
+ * @param      archive  The archive
+ * @param      size     The size of the archive in bytes
+ *
+ * @return     true on success
+ * 
+ * @note       The hysteresis of the context must not be less than the
+ *             archive's.
+ */
+bool RFC_archive_feed( void *ctx, const unsigned char *archive, size_t size )
+{
+    rfc_value_tuple_s *tp;
+    rfc_value_t        hysteresis;
+    size_t             sample_count, tp_count, chunk_count, chunk;
+    unsigned           chunk_size;
+    bool               ok = true;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !RFC_archive_info( archive, size, &hysteresis, &sample_count, &tp_count ) || rfc_ctx->hysteresis < hysteresis )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    chunk_size  = (unsigned)archive_get_uint( archive + 32, 4 );
+    chunk_count = (size_t)archive_get_uint( archive + 36, 4 );
+
+    if( !tp_count )
+    {
+        return true;
+    }
+
+    tp = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, chunk_size, sizeof(rfc_value_tuple_s), RFC_MEM_AIM_ARCHIVE );
+
+    if( !tp )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+
+    for( chunk = 0; ok && chunk < chunk_count; chunk++ )
+    {
+        size_t n, i;
+
+        if( !archive_decode_chunk( archive, size, chunk, 0, tp, chunk_size, &n ) )
+        {
+            ok = error_raise( rfc_ctx, RFC_ERROR_INVARG );
+            break;
+        }
+
+        for( i = 0; i < n; i++ )
+        {
+            tp[i].cls = QUANTIZE( rfc_ctx, tp[i].value );
+        }
+
+        ok = RFC_feed_tuple( rfc_ctx, tp, n );
+    }
+
+    rfc_ctx->mem_alloc( tp, 0, 0, RFC_MEM_AIM_ARCHIVE );
+
+    /* Samples following the last turning point */
+    if( ok && rfc_ctx->internal.pos < sample_count )
+    {
+        rfc_ctx->internal.pos = sample_count;
+    }
+
+    return ok;
+}
+
 #endif /*RFC_TP_SUPPORT*/
 
 
@@ -1255,6 +1656,37 @@ bool RFC_clear_counts( void *ctx )
         memset( rfc_ctx->lc, 0, sizeof(rfc_counts_t) * rfc_ctx->class_count );
     }
 
+    if( rfc_ctx->rmm )
+    {
+        memset( rfc_ctx->rmm, 0, sizeof(rfc_counts_t) * RMM_SIZE( rfc_ctx->class_count ) );
+    }
+
+    if( rfc_ctx->rmd )
+    {
+        memset( rfc_ctx->rmd, 0, sizeof(rfc_rmd_item_s) * rfc_ctx->rmd_cap );
+        rfc_ctx->rmd_cnt = 0;
+    }
+
+    if( rfc_ctx->cond_rfm )
+    {
+        memset( rfc_ctx->cond_rfm, 0, sizeof(rfc_counts_t) * rfc_ctx->cond_count * rfc_ctx->class_count * rfc_ctx->class_count );
+    }
+
+    if( rfc_ctx->cond_damage )
+    {
+        memset( rfc_ctx->cond_damage, 0, sizeof(double) * rfc_ctx->cond_count );
+    }
+
+    rfc_ctx->top_cnt = 0;
+
+    if( rfc_ctx->tal )
+    {
+        memset( rfc_ctx->tal, 0, sizeof(size_t) * rfc_ctx->class_count );
+    }
+
+    rfc_ctx->rfm_rev++;
+    rfc_ctx->cycles_cnt = 0;
+
     rfc_ctx->residue_cnt                = 0;
 
     rfc_ctx->internal.slope             = 0;
@@ -1338,6 +1770,20 @@ bool RFC_deinit( void *ctx )
 #if !RFC_MINIMAL
     if( rfc_ctx->rp )                   rfc_ctx->mem_alloc( rfc_ctx->rp,            0, 0, RFC_MEM_AIM_RP );
     if( rfc_ctx->lc )                   rfc_ctx->mem_alloc( rfc_ctx->lc,            0, 0, RFC_MEM_AIM_LC );
+    if( rfc_ctx->rmm )                  rfc_ctx->mem_alloc( rfc_ctx->rmm,           0, 0, RFC_MEM_AIM_RMM );
+    if( rfc_ctx->rmd )                  rfc_ctx->mem_alloc( rfc_ctx->rmd,           0, 0, RFC_MEM_AIM_RMD );
+    if( rfc_ctx->rfm_pyr )              rfc_ctx->mem_alloc( rfc_ctx->rfm_pyr,       0, 0, RFC_MEM_AIM_RFM_PYRAMID );
+    if( rfc_ctx->cycles )               rfc_ctx->mem_alloc( rfc_ctx->cycles,        0, 0, RFC_MEM_AIM_CYCLES );
+    if( rfc_ctx->class_bounds )         rfc_ctx->mem_alloc( rfc_ctx->class_bounds,  0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+    if( rfc_ctx->class_bounds_lut )     rfc_ctx->mem_alloc( rfc_ctx->class_bounds_lut, 0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+    if( rfc_ctx->cond_rfm )             rfc_ctx->mem_alloc( rfc_ctx->cond_rfm,      0, 0, RFC_MEM_AIM_COND );
+    if( rfc_ctx->cond_damage )          rfc_ctx->mem_alloc( rfc_ctx->cond_damage,   0, 0, RFC_MEM_AIM_COND );
+    if( rfc_ctx->tal )                  rfc_ctx->mem_alloc( rfc_ctx->tal,           0, 0, RFC_MEM_AIM_TAL );
+    if( rfc_ctx->wl_bin_lut )           rfc_ctx->mem_alloc( rfc_ctx->wl_bin_lut,    0, 0, RFC_MEM_AIM_WL_BINS );
+    if( rfc_ctx->top )                  rfc_ctx->mem_alloc( rfc_ctx->top,           0, 0, RFC_MEM_AIM_TOP );
+    if( rfc_ctx->followers )            rfc_ctx->mem_alloc( rfc_ctx->followers,     0, 0, RFC_MEM_AIM_FOLLOWERS );
+    snapshot_free( rfc_ctx );
+    region_free( rfc_ctx );
 #endif /*!RFC_MINIMAL*/
 #if RFC_TP_SUPPORT
     if( rfc_ctx->tp && !rfc_ctx->internal.tp_static )
@@ -1368,6 +1814,41 @@ bool RFC_deinit( void *ctx )
 #if !RFC_MINIMAL
     rfc_ctx->rp                         = NULL;
     rfc_ctx->lc                         = NULL;
+    rfc_ctx->rmm                        = NULL;
+    rfc_ctx->rmd                        = NULL;
+    rfc_ctx->rmd_cap                    = 0;
+    rfc_ctx->rmd_cnt                    = 0;
+    rfc_ctx->rfm_pyr                    = NULL;
+    rfc_ctx->rfm_pyr_cap                = 0;
+    rfc_ctx->rfm_pyr_levels             = 0;
+    rfc_ctx->cycles                     = NULL;
+    rfc_ctx->cycles_cap                 = 0;
+    rfc_ctx->cycles_cnt                 = 0;
+    rfc_ctx->class_bounds               = NULL;
+    rfc_ctx->class_bounds_lut           = NULL;
+    rfc_ctx->class_bounds_lut_count     = 0;
+    rfc_ctx->cond_count                 = 0;
+    rfc_ctx->cond_rfm                   = NULL;
+    rfc_ctx->cond_damage                = NULL;
+    rfc_ctx->wl_bin_count               = 0;
+    rfc_ctx->wl_bin_lut                 = NULL;
+    rfc_ctx->tal                        = NULL;
+    rfc_ctx->top                        = NULL;
+    rfc_ctx->top_cap                    = 0;
+    rfc_ctx->top_cnt                    = 0;
+    memset( rfc_ctx->snapshot, 0, sizeof(rfc_ctx->snapshot) );
+    rfc_ctx->snapshot_epoch             = 0;
+    rfc_ctx->snapshot_rfm_rev           = 0;
+    rfc_ctx->snapshot_tiles             = 0;
+    rfc_ctx->region                     = NULL;
+    rfc_ctx->region_dirty               = NULL;
+    rfc_ctx->region_rfm_rev             = 0;
+    rfc_ctx->region_tiles               = 0;
+#if RFC_SHM_SUPPORT
+    rfc_ctx->region_shm_name            = NULL;
+#endif /*RFC_SHM_SUPPORT*/
+    rfc_ctx->followers                  = NULL;
+    rfc_ctx->follower_cnt               = 0;
 #endif /*!RFC_MINIMAL*/
     
     rfc_ctx->internal.slope             = 0;
@@ -1394,6 +1875,8 @@ bool RFC_deinit( void *ctx )
     rfc_ctx->dh                         = NULL;
     rfc_ctx->dh_cap                     = 0;
     rfc_ctx->dh_cnt                     = 0;
+    rfc_ctx->dh_istream                 = NULL;
+    rfc_ctx->spread_damage_method       = RFC_SD_HALF_23;
     rfc_ctx->internal.dh_static         = false;
 #endif /*RFC_DH_SUPPORT*/
 
@@ -1427,6 +1910,53 @@ bool RFC_deinit( void *ctx )
 }
 
 
+/**
+ * @brief      Process one data sample, shared by all feeding functions.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      value    The data sample
+ * @param      flags    The flags (context flags)
+ *
+ * @return     true on success
+ */
+static inline
+bool feed_sample( rfc_ctx_s *rfc_ctx, rfc_value_t value, rfc_flags_e flags )
+{
+    rfc_value_tuple_s tp = { value };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
+
+    /* Assign class and global position (base 1) */
+    tp.pos = ++rfc_ctx->internal.pos;
+    tp.cls = QUANTIZE( rfc_ctx, tp.value );
+
+    if( rfc_ctx->class_count && ( tp.cls >= rfc_ctx->class_count || tp.value < rfc_ctx->class_offset ) )
+    {
+#if RFC_AR_SUPPORT
+        if( flags & RFC_FLAGS_AUTORESIZE )
+        {
+            if( !autoresize( rfc_ctx, &tp ) )
+            {
+                return false;
+            }
+        }
+        else
+#endif /*RFC_AR_SUPPORT*/
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+        }
+    }
+
+#if !RFC_MINIMAL
+    /* Time at level */
+    if( rfc_ctx->tal )
+    {
+        rfc_ctx->tal[tp.cls]++;
+    }
+#endif /*!RFC_MINIMAL*/
+
+    return feed_once( rfc_ctx, &tp, flags );
+}
+
+
 /**
  * @brief      "Feed" counting algorithm with data samples (consecutive calls
  *             allowed).
@@ -1466,46 +1996,133 @@ bool RFC_feed( void *ctx, const rfc_value_t * data, size_t data_count )
     /* Process data */
     while( data_count-- )
     {
-        rfc_value_tuple_s tp = { *data++ };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
-
-        /* Assign class and global position (base 1) */
-        tp.pos = ++rfc_ctx->internal.pos;
-        tp.cls = QUANTIZE( rfc_ctx, tp.value );
-
-        if( rfc_ctx->class_count && ( tp.cls >= rfc_ctx->class_count || tp.value < rfc_ctx->class_offset ) )
-        {
-#if !RFC_AR_SUPPORT
-            return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
-#else
-            if( !RFC_flags_check( ctx, RFC_FLAGS_AUTORESIZE, 0 ) )
-            {
-                return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
-            }
-
-            if( !autoresize( ctx, &tp ) )
-            {
-                return false;
-            }
-#endif /*RFC_AR_SUPPORT*/
-        }
-        
-        if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) )
+        if( !feed_sample( rfc_ctx, *data++, rfc_ctx->internal.flags ) )
         {
             return false;
         }
     }
 
+#if !RFC_MINIMAL
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
+    }
+#endif /*!RFC_MINIMAL*/
+
     return true;
 }
 
 
-#if !RFC_MINIMAL
+#if RFC_INLINE_API
 /**
- * @brief      Do countings for a given cycle
+ * @brief      "Feed" counting algorithm with one data sample. Defined in the
+ *             amalgamation (rainflow_inline.h) only, where it shares the
+ *             translation unit with the caller and may be inlined into
+ *             the acquisition loop. The context is not checked.
  *
- * @param      ctx       The rainflow context
- * @param[in]  from_val  The from value
- * @param[in]  to_val    The to value
+ * @param      rfc_ctx  The rainflow context
+ * @param      value    The data sample
+ * @param      flags    The flags, must equal the context flags (raises
+ *                      RFC_ERROR_INVARG otherwise). A constant lets the
+ *                      compiler specialize the counting path.
+ *
+ * @return     true on success
+ * 
+ * @note       Results are not published to snapshots or regions. Damage
+ *             history spread methods reading the input stream are not
+ *             available.
+ */
+static inline
+bool RFC_feed_sample_inline( rfc_ctx_s *rfc_ctx, rfc_value_t value, rfc_flags_e flags )
+{
+    assert( rfc_ctx && rfc_ctx->version == sizeof(rfc_ctx_s) );
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( flags != rfc_ctx->internal.flags )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    return feed_sample( rfc_ctx, value, flags );
+}
+
+
+/**
+ * @brief      "Feed" counting algorithm with data samples (consecutive calls
+ *             allowed). Defined in the amalgamation (rainflow_inline.h)
+ *             only, see RFC_feed_sample_inline().
+ *
+ * @param      rfc_ctx     The rainflow context
+ * @param[in]  data        The data
+ * @param      data_count  The data count
+ * @param      flags       The flags, must equal the context flags
+ *
+ * @return     true on success
+ */
+static inline
+bool RFC_feed_block_inline( rfc_ctx_s *rfc_ctx, const rfc_value_t *data, size_t data_count, rfc_flags_e flags )
+{
+    assert( rfc_ctx && rfc_ctx->version == sizeof(rfc_ctx_s) );
+
+    if( !data ) return !data_count;
+
+#if RFC_DH_SUPPORT
+    if( rfc_ctx->dh )
+    {
+        if( !rfc_ctx->dh_istream )
+        {
+            /* Assign input stream */
+            rfc_ctx->dh_istream = data;
+        }
+        else if( rfc_ctx->dh_istream + rfc_ctx->internal.pos != data )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_DH_BAD_STREAM );
+        }
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    /* Process data */
+    while( data_count-- )
+    {
+        if( !RFC_feed_sample_inline( rfc_ctx, *data++, flags ) )
+        {
+            return false;
+        }
+    }
+
+#if !RFC_MINIMAL
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
+    }
+#endif /*!RFC_MINIMAL*/
+
+    return true;
+}
+#endif /*RFC_INLINE_API*/
+
+
+#if !RFC_MINIMAL
+/**
+ * @brief      Do countings for a given cycle
+ *
+ * @param      ctx       The rainflow context
+ * @param[in]  from_val  The from value
+ * @param[in]  to_val    The to value
  * @param[in]  flags     The flags
  *
  * @return     true on success
@@ -1525,7 +2142,7 @@ bool RFC_cycle_process_counts( void *ctx, rfc_value_t from_val, rfc_value_t to_v
 
     cycle_process_counts( rfc_ctx, &from, &to, /*next*/ NULL, flags );
 
-    return true;
+    return rfc_ctx->state != RFC_STATE_ERROR;
 }
 
 
@@ -1573,339 +2190,382 @@ bool RFC_feed_scaled( void *ctx, const rfc_value_t * data, size_t data_count, do
                 return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
             }
         }
+
+        /* Time at level */
+        if( rfc_ctx->tal )
+        {
+            rfc_ctx->tal[tp.cls]++;
+        }
         
         if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) ) return false;
     }
 
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
+    }
+
     return true;
 }
 
 
 /**
- * @brief         Feed counting algorithm with data tuples (tp_pos is kept maintaining). 
+ * @brief      "Feed" counting algorithm with data samples and a parallel
+ *             condition channel (consecutive calls allowed).
+ *             Each closed cycle is counted into the matrix and damage of its
+ *             condition in addition, see RFC_cond_init().
  *
- * @param         ctx         The rainflow context
- * @param[in,out] data        The data tuples
- * @param         data_count  The data count
+ * @param      ctx         The rainflow context
+ * @param[in]  data        The data
+ * @param[in]  cond        The condition (state index) for each data sample
+ * @param      data_count  The data count
  *
- * @return        true on success
+ * @return     true on success
  */
-bool RFC_feed_tuple( void *ctx, rfc_value_tuple_s *data, size_t data_count )
+bool RFC_feed_cond( void *ctx, const rfc_value_t * data, const unsigned *cond, size_t data_count )
 {
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( data_count && !data ) return false;
+    if( !data || !cond ) return !data_count;
 
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
+    if( !rfc_ctx->cond_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+#if RFC_DH_SUPPORT
+    if( rfc_ctx->dh )
+    {
+        if( !rfc_ctx->dh_istream )
+        {
+            /* Assign input stream */
+            rfc_ctx->dh_istream = data;
+        }
+        else if( rfc_ctx->dh_istream + rfc_ctx->internal.pos != data )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_DH_BAD_STREAM );
+        }
+    }
+#endif /*RFC_DH_SUPPORT*/
+
     /* Process data */
     while( data_count-- )
     {
-        if( rfc_ctx->class_count && ( data->cls >= rfc_ctx->class_count || data->value < rfc_ctx->class_offset ) )
+        rfc_value_tuple_s tp = { *data++ };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
+
+        /* Assign class, condition and global position (base 1) */
+        tp.pos  = ++rfc_ctx->internal.pos;
+        tp.cls  = QUANTIZE( rfc_ctx, tp.value );
+        tp.cond = *cond++;
+
+        if( tp.cond >= rfc_ctx->cond_count )
         {
-#if RFC_FLAGS_AUTORESIZE
-            unsigned cls = QUANTIZE( ctx, data->value );
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        }
 
-            if( data->cls != cls )
-            {
-                return error_raise( rfc_ctx, RFC_ERROR_DATA_INCONSISTENT );
-            }
-            else
-#endif /*RFC_FLAGS_AUTORESIZE*/
-            {
-                return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
-            }
+        if( rfc_ctx->class_count && ( tp.cls >= rfc_ctx->class_count || tp.value < rfc_ctx->class_offset ) )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+        }
+
+        /* Time at level */
+        if( rfc_ctx->tal )
+        {
+            rfc_ctx->tal[tp.cls]++;
         }
         
-        if( !feed_once( rfc_ctx, data++, rfc_ctx->internal.flags ) ) return false;
+        if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) ) return false;
+    }
+
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
     }
 
     return true;
 }
-#endif /*!RFC_MINIMAL*/
 
 
 /**
- * @brief      Finalize pending counts and turning point storage.
+ * @brief      "Feed" counting algorithm with run-length encoded data samples
+ *             (consecutive calls allowed).
+ *             Samples repeated within a run can't form a turning point,
+ *             thus only the first and the last sample of a run are processed.
+ *             Stream positions advance by the run length.
  *
- * @param      ctx              The rainflow context
- * @param      residual_method  The residual method (RFC_RES_...)
+ * @param      ctx        The rainflow context
+ * @param[in]  values     The value of each run
+ * @param[in]  repeats    The number of samples in each run (0 skips the run)
+ * @param      run_count  The number of runs
  *
  * @return     true on success
+ * 
+ * @note       Damage history spread methods reading the input stream
+ *             (RFC_SD_TRANSIENT_23, RFC_SD_TRANSIENT_23c) are not supported.
  */
-bool RFC_finalize( void *ctx, rfc_res_method_e residual_method )
+bool RFC_feed_rle( void *ctx, const rfc_value_t *values, const size_t *repeats, size_t run_count )
 {
-    double damage;
-    bool ok;
     RFC_CTX_CHECK_AND_ASSIGN
-    
+
+    if( run_count && ( !values || !repeats ) ) return false;
+
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
-#if _DEBUG
-    rfc_ctx->internal.finalizing = true;
-#endif /*_DEBUG*/
-
-    damage = rfc_ctx->damage;
-
-#if RFC_USE_DELEGATES
-    if( rfc_ctx->finalize_fcn )
+#if RFC_DH_SUPPORT
+    if( rfc_ctx->dh && ( rfc_ctx->spread_damage_method == RFC_SD_TRANSIENT_23 || 
+                         rfc_ctx->spread_damage_method == RFC_SD_TRANSIENT_23c ) )
     {
-        ok = rfc_ctx->finalize_fcn( rfc_ctx, residual_method );
+        /* Runs don't provide the input stream */
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
     }
-    else
-#endif /*RFC_USE_DELEGATES*/
+#endif /*RFC_DH_SUPPORT*/
+
+    /* Process runs */
+    while( run_count-- )
     {
-        int flags = rfc_ctx->internal.flags;
+        rfc_value_tuple_s tp = { *values++ };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
+        size_t            n  = *repeats++;
 
-#if !RFC_MINIMAL
-        /* Level crossing counting is already considered for residue */
-        flags &= ~RFC_FLAGS_COUNT_LC;
-#endif /*!RFC_MINIMAL*/
+        if( !n ) continue;
 
-        switch( residual_method )
+        /* Assign class and global position (base 1) of the first sample */
+        tp.pos = ++rfc_ctx->internal.pos;
+        tp.cls = QUANTIZE( rfc_ctx, tp.value );
+
+        if( rfc_ctx->class_count && ( tp.cls >= rfc_ctx->class_count || tp.value < rfc_ctx->class_offset ) )
         {
-            case RFC_RES_NONE:
-                /* FALLTHROUGH */
-            case RFC_RES_IGNORE:
-                ok = finalize_res_ignore( rfc_ctx, flags );
-                break;
-            case RFC_RES_NO_FINALIZE:
-                ok = finalize_res_no_finalize( rfc_ctx, flags );
-                break;
-#if !RFC_MINIMAL
-            case RFC_RES_DISCARD:
-                ok = finalize_res_discard( rfc_ctx, flags );
-                break;
-            case RFC_RES_HALFCYCLES:
-                ok = finalize_res_weight_cycles( rfc_ctx, rfc_ctx->half_inc, flags );
-                break;
-            case RFC_RES_FULLCYCLES:
-                ok = finalize_res_weight_cycles( rfc_ctx, rfc_ctx->full_inc, flags );
-                break;
-            case RFC_RES_CLORMANN_SEEGER:
-                ok = finalize_res_clormann_seeger( rfc_ctx, flags );
-                break;
-            case RFC_RES_REPEATED:
-                ok = finalize_res_repeated( rfc_ctx, flags );
-                break;
-            case RFC_RES_RP_DIN45667:
-                ok = finalize_res_rp_DIN45667( rfc_ctx, flags );
-                break;
-#endif /*!RFC_MINIMAL*/
-            default:
-                assert( false );
-                ok = error_raise( rfc_ctx, RFC_ERROR_INVARG );
+#if !RFC_AR_SUPPORT
+            return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+#else
+            if( !RFC_flags_check( ctx, RFC_FLAGS_AUTORESIZE, 0 ) )
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+            }
+
+            if( !autoresize( ctx, &tp ) )
+            {
+                return false;
+            }
+#endif /*RFC_AR_SUPPORT*/
+        }
+
+        /* Time at level */
+        if( rfc_ctx->tal )
+        {
+            rfc_ctx->tal[tp.cls] += n;
+        }
+
+        if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) )
+        {
+            return false;
+        }
+
+        if( n > 1 )
+        {
+            /* Last sample of the run (right margin, damage history) */
+            rfc_ctx->internal.pos += n - 1;
+            tp.pos                 = rfc_ctx->internal.pos;
+
+            if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) )
+            {
+                return false;
+            }
         }
-        assert( rfc_ctx->state == RFC_STATE_FINALIZE );
     }
 
-#if !RFC_MINIMAL
-    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_NONE || !rfc_ctx->class_count )
+    if( rfc_ctx->snapshot_tiles )
     {
-#else /*RFC_MINIMAL*/
-    if( !rfc_ctx->class_count )
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
     {
-#endif /*!RFC_MINIMAL*/
-        rfc_ctx->residue_cnt = 0;
+        region_publish( rfc_ctx );
     }
 
-    rfc_ctx->damage_residue = rfc_ctx->damage - damage;
-    rfc_ctx->state          = ok ? RFC_STATE_FINISHED : RFC_STATE_ERROR;
+    return true;
+}
 
-#if _DEBUG
-    rfc_ctx->internal.finalizing = false;
-#endif /*_DEBUG*/
 
-#if RFC_DH_SUPPORT
-    if( ok )
-    {
-        ok = spread_damage_map_tp( rfc_ctx );
-    }
-#endif /*RFC_DH_SUPPORT*/
-
-    return ok;
-}
-
-
-#if !RFC_MINIMAL
 /**
- * @brief      Make rainflow matrix symmetrical
+ * @brief      "Feed" counting algorithm with class indices (consecutive
+ *             calls allowed). Samples take the class mean as value.
+ *             Samples staying within the hysteresis band of the interim
+ *             turning point are skipped by comparing class indices, only
+ *             the remaining ones are passed to the filter.
  *
- * @param      ctx   The rainflow context
+ * @param      ctx         The rainflow context
+ * @param[in]  cls         The class indices, base 0
+ * @param      data_count  The data count
  *
  * @return     true on success
+ * 
+ * @note       Damage history spread methods reading the input stream are
+ *             not available.
  */
-bool RFC_rfm_make_symmetric( void *ctx )
+bool RFC_feed_classes( void *ctx, const uint16_t *cls, size_t data_count )
 {
-    unsigned       class_count;
-    unsigned       from, to;
-    rfc_counts_t  *rfm;
+    unsigned class_count;
+    unsigned max_cls = 0;
+    int      band;
+    size_t   pos_offset;
+    size_t   i;
+    double   width_max;
 
     RFC_CTX_CHECK_AND_ASSIGN
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
-    {
-        return false;
-    }
 
-    rfm = rfc_ctx->rfm;
+    if( data_count && !cls ) return false;
 
-    if( !rfm )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
     class_count = rfc_ctx->class_count;
 
-    /* Cumulate entries symmetric by major diagonal */
-    for( from = 0; from < class_count; from++ )
-    {
-        for( to = from + 1; to < class_count; to++ )
-        {
-            /* to > from, always */
-            rfm[ MAT_OFFS( from, to ) ] += rfm[ MAT_OFFS( to, from ) ];
-            rfm[ MAT_OFFS( to, from ) ]  = 0;
-        }
-    }
-
-    return true;
-}
-
-
-/**
- * @brief      Returns the number of non zero entries in rainflow matrix
- *
- * @param[in]  ctx   The rainflow context
- *
- * @return     true on success
- */
-bool RFC_rfm_non_zeros( const void *ctx, unsigned *count )
-{
-    unsigned            class_count;
-    unsigned            from, to;
-    rfc_counts_t       *rfm_it;
-
-    RFC_CTX_CHECK_AND_ASSIGN
-
-    if( !count )
+    if( !class_count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+
+    /* Check range */
+    for( i = 0; i < data_count; i++ )
     {
-        return false;
+        if( cls[i] > max_cls ) max_cls = cls[i];
     }
 
-    class_count = rfc_ctx->class_count;
-
-    rfm_it = rfc_ctx->rfm;
-
-    if( !rfm_it || !class_count )
+    if( data_count && max_cls >= class_count )
     {
-        return false;
+        return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
     }
 
-    *count = 0;
-    for( from = 0; from < class_count; from++ )
+    /* Time at level */
+    if( rfc_ctx->tal )
     {
-        for( to = 0; to < class_count; to++ )
+        for( i = 0; i < data_count; i++ )
         {
-            if( *rfm_it++ ) (*count)++;
+            rfc_ctx->tal[cls[i]]++;
         }
     }
 
-    return true;
-}
+    /* Class distances less than band are within hysteresis for sure */
+    width_max = rfc_ctx->class_width;
 
+    if( rfc_ctx->class_bounds )
+    {
+        unsigned j;
 
-/**
- * @brief      Get the rainflow matrix as sparse elements
- *
- * @param      ctx     The rainflow context
- * @param[out] buffer  The elements buffer, if NULL memory will be allocated
- * @param[out] count   The number of elements in buffer
- *
- * @return     true on success
- * @note       The counts are natively returned, regardless of .full_inc!
-*/
-bool RFC_rfm_get( const void *ctx, rfc_rfm_item_s **buffer, unsigned *count )
-{
-    unsigned            class_count;
-    unsigned            from, to;
-    unsigned            count_old;
-    rfc_counts_t       *rfm_it;
-    rfc_rfm_item_s     *item;
+        for( j = 0, width_max = 0.0; j < class_count; j++ )
+        {
+            double width = (double)rfc_ctx->class_bounds[j+1] - rfc_ctx->class_bounds[j];
 
+            if( width > width_max ) width_max = width;
+        }
+    }
 
-    RFC_CTX_CHECK_AND_ASSIGN
+    band = ( width_max > 0.0 && rfc_ctx->hysteresis / width_max < (double)class_count ) ? (int)( rfc_ctx->hysteresis / width_max ) : (int)class_count;
 
-    if( !buffer || !count )
+    if( band < 1 )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        /* Samples equal to the interim turning point have no effect anyway */
+        band = 1;
     }
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+
+#if RFC_USE_DELEGATES
+    if( rfc_ctx->tp_next_fcn )
     {
-        return false;
+        /* Delegated filter sees every sample */
+        band = -1;
     }
+#endif /*RFC_USE_DELEGATES*/
 
-    class_count = rfc_ctx->class_count;
-
-    rfm_it = rfc_ctx->rfm;
-
+    /* Process data */
+    pos_offset = rfc_ctx->internal.pos;
 
-    if( !rfm_it || !class_count )
+    for( i = 0; i < data_count; i++ )
     {
-        return false;
-    }
+        rfc_value_tuple_s tp = { 0.0 };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
 
-    /* *buffer = NULL; */
-    count_old  = *count;
-    *count     = 0;
-    for( from = 0; from < class_count; from++ )
-    {
-        for( to = 0; to < class_count; to++, rfm_it++ )
+        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM && band >= 0 )
         {
-            if( *rfm_it )
+            /* Range of classes with no effect: neither extending the slope nor exceeding hysteresis */
+            const rfc_value_tuple_s *interim = &rfc_ctx->residue[rfc_ctx->residue_cnt];
+            int                      I       = (int)interim->cls;
+            bool                     exact   = interim->value == CLASS_MEAN( rfc_ctx, interim->cls );
+            int                      lo, hi;
+
+            if( rfc_ctx->internal.slope > 0 )
             {
-                (*count)++;
+                lo = I - band + 1;
+                hi = exact ? I : I - 1;
+            }
+            else
+            {
+                lo = exact ? I : I + 1;
+                hi = I + band - 1;
+            }
+
+#if RFC_GLOBAL_EXTREMA
+            {
+                const rfc_value_tuple_s *ext = rfc_ctx->internal.extrema;
+
+                /* Global extrema stay untouched */
+                if( lo < (int)ext[0].cls + ( ext[0].value != CLASS_MEAN( rfc_ctx, ext[0].cls ) ) )
+                {
+                    lo = (int)ext[0].cls + ( ext[0].value != CLASS_MEAN( rfc_ctx, ext[0].cls ) );
+                }
+
+                if( hi > (int)ext[1].cls - ( ext[1].value != CLASS_MEAN( rfc_ctx, ext[1].cls ) ) )
+                {
+                    hi = (int)ext[1].cls - ( ext[1].value != CLASS_MEAN( rfc_ctx, ext[1].cls ) );
+                }
+            }
+#endif /*RFC_GLOBAL_EXTREMA*/
+
+            /* The last sample is always processed (right margin, damage history) */
+            while( i + 1 < data_count && (int)cls[i] >= lo && (int)cls[i] <= hi )
+            {
+                i++;
             }
         }
-    }
 
-    if( *count > count_old )
-    {
-        *buffer = rfc_ctx->mem_alloc( *buffer, *count, sizeof(rfc_rfm_item_s), RFC_MEM_AIM_RFM_ELEMENTS );
+        /* Assign class, value and global position (base 1) */
+        tp.cls   = cls[i];
+        tp.value = (rfc_value_t)CLASS_MEAN( rfc_ctx, tp.cls );
+        tp.pos   = rfc_ctx->internal.pos = pos_offset + i + 1;
 
-        if( !*buffer )
+        if( !feed_once( rfc_ctx, &tp, rfc_ctx->internal.flags ) )
         {
-            error_raise( rfc_ctx, RFC_ERROR_MEMORY );
             return false;
         }
     }
-        
-    item   = *buffer;
-    rfm_it = rfc_ctx->rfm;
-    for( from = 0; from < class_count; from++ )
+
+    if( rfc_ctx->snapshot_tiles )
     {
-        for( to = 0; to < class_count; to++, rfm_it++ )
-        {
-            if( *rfm_it )
-            {
-                item->from   = from;
-                item->to     = to;
-                item->counts = *rfm_it;
+        snapshot_publish( rfc_ctx );
+    }
 
-                item++;
-            }
-        }
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
     }
 
     return true;
@@ -1913,169 +2573,191 @@ bool RFC_rfm_get( const void *ctx, rfc_rfm_item_s **buffer, unsigned *count )
 
 
 /**
- * @brief      Set (or increment) rainflow matrix with given elements
+ * @brief      "Feed" counting algorithm with turning points already known
+ *             (consecutive calls allowed). The filter is bypassed: points
+ *             are checked in bulk to alternate, exceeding hysteresis, and
+ *             appended to the residue directly. The last point given is
+ *             kept as interim turning point.
  *
- * @param      ctx       The rainflow context
- * @param[in]  buffer    The elements buffer
- * @param      count     The number of elements in buffer
- * @param      add_only  Counts are added if set to true
+ * @param      ctx         The rainflow context
+ * @param[in]  values      The turning point values
+ * @param[in]  positions   The turning point positions (base 1, strictly
+ *                         increasing), or NULL for consecutive positions
+ * @param      count       The turning point count
  *
  * @return     true on success
- * @note       The counts are natively added, regardless of .full_inc!
+ * 
+ * @note       Time at level isn't counted and damage history spread
+ *             methods reading the input stream are not available.
  */
-bool RFC_rfm_set( void *ctx, const rfc_rfm_item_s *buffer, unsigned count, bool add_only )
+bool RFC_feed_tp( void *ctx, const rfc_value_t *values, const size_t *positions, size_t count )
 {
-          unsigned           class_count, i;
-    const rfc_rfm_item_s    *item;
-          rfc_counts_t      *rfm;
+    rfc_value_tuple_s prev = { 0.0 };
+    size_t            pos_offset;
+    size_t            i;
+    int               slope;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !buffer )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-    }
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    if( count && !values ) return false;
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    class_count = rfc_ctx->class_count;
-
-    rfm = rfc_ctx->rfm;
-
-    if( !rfm || !class_count )
+    if( rfc_ctx->state != RFC_STATE_INIT && rfc_ctx->state != RFC_STATE_BUSY_INTERIM )
     {
-        return false;
+        /* Filter is still searching the first turning point */
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    if( !add_only )
+    pos_offset = rfc_ctx->internal.pos;
+    slope      = 0;
+
+    if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
     {
-        /* Initialize with zeros */
-        memset( rfm, 0, sizeof(rfc_rfm_item_s) * class_count * class_count );
+        prev  = rfc_ctx->residue[rfc_ctx->residue_cnt];
+        slope = rfc_ctx->internal.slope;
     }
 
-    item = buffer;
+    /* Check range, positions and alternation */
     for( i = 0; i < count; i++ )
     {
-        unsigned from, to;
+        rfc_value_tuple_s tp = { values[i] };
 
-        from = ( item->from < 0 ) ? 1 : ( item->from + 1 );
-        to   = ( item->to   < 0 ) ? 1 : ( item->to   + 1 );
+        tp.cls = QUANTIZE( rfc_ctx, tp.value );
 
-        if( from > class_count ) from = class_count;
-        if( to   > class_count ) to   = class_count;
+        if( rfc_ctx->class_count && ( tp.cls >= rfc_ctx->class_count || tp.value < rfc_ctx->class_offset ) )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+        }
 
-        if( from > 0 && to > 0 )
+        if( positions && positions[i] <= ( i ? positions[i-1] : pos_offset ) )
         {
-            rfm[ MAT_OFFS( from-1, to-1 ) ] += item->counts;
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
         }
-    }
 
-    return true;
-}
+        if( i || rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
+        {
+            int sign;
 
+            /* Slope has to reverse beyond hysteresis */
+            if( value_delta( rfc_ctx, &prev, &tp, &sign ) <= rfc_ctx->hysteresis || sign == slope )
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+            }
 
-/**
- * @brief      Get counts of a single element from the rainflow matrix
- *
- * @param      ctx       The rainflow context
- * @param      from_val  The cycles start value
- * @param      to_val    The cycles target value
- * @param[out] counts    The corresponding count from the matrix element (not cycles!), regardless of .full_inc!
- *
- * @return     true on success
- */
-bool RFC_rfm_peek( const void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t *counts )
-{
-    unsigned           from, to;
-    unsigned           class_count;
-    rfc_counts_t      *rfm;
+            slope = sign;
+        }
 
-    RFC_CTX_CHECK_AND_ASSIGN
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
-    {
-        return false;
+        prev = tp;
     }
 
-    class_count = rfc_ctx->class_count;
-
-    rfm = rfc_ctx->rfm;
-
-    if( !rfm || !class_count )
+    /* Process data */
+    for( i = 0; i < count; i++ )
     {
-        return false;
-    }
+        rfc_value_tuple_s tp = { values[i] };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
 
-    assert( from_val >= rfc_ctx->class_offset );
-    assert( to_val   >= rfc_ctx->class_offset );
+        /* Assign class and global position (base 1) */
+        tp.cls = QUANTIZE( rfc_ctx, tp.value );
+        tp.pos = rfc_ctx->internal.pos = positions ? positions[i] : pos_offset + i + 1;
 
-    from = QUANTIZE( rfc_ctx, from_val );
-    to   = QUANTIZE( rfc_ctx, to_val );
+#if RFC_DH_SUPPORT
+        /* Resize damage history if necessary */
+        if( !feed_once_dh( rfc_ctx, &tp ) )
+        {
+            return false;
+        }
+#endif /*RFC_DH_SUPPORT*/
 
-    if( from > class_count ) from = class_count;
-    if( to   > class_count ) to   = class_count;
+        if( rfc_ctx->state == RFC_STATE_INIT )
+        {
+            /* Very first point */
+            rfc_ctx->internal.extrema[0]           = 
+            rfc_ctx->internal.extrema[1]           = tp;
+            rfc_ctx->residue[rfc_ctx->residue_cnt] = tp;
+            rfc_ctx->state                         = RFC_STATE_BUSY_INTERIM;
 
-    if( counts )
-    {
-        *counts = rfm[ MAT_OFFS( from, to ) ];
-    }
+#if RFC_TP_SUPPORT
+            {
+                rfc_value_tuple_s *tp_residue = NULL;
 
-    return true;
-}
+                /* Save left margin and enqueue it as turning point */
+                if( !feed_once_tp_check_margin( rfc_ctx, &tp, &tp_residue ) )
+                {
+                    return false;
+                }
+            }
+#endif /*RFC_TP_SUPPORT*/
+        }
+        else
+        {
+            rfc_value_tuple_s tp_interim = rfc_ctx->residue[rfc_ctx->residue_cnt];
+            bool              is_margin  = false;
 
+            assert( rfc_ctx->state == RFC_STATE_BUSY_INTERIM );
 
-/**
- * @brief      Set (or increment) one matrix value of the rainflow matrix
- *
- * @param      ctx       The rainflow context
- * @param      from_val  The cycles start value
- * @param      to_val    The cycles target value
- * @param      counts    The count value for the matrix element (not cycles!), regardless of .full_inc!
- * @param      add_only  Value is added if set to true
- *
- * @return     true on success
- */
-bool RFC_rfm_poke( void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t counts, bool add_only )
-{
-    unsigned           from, to;
-    unsigned           class_count;
-    rfc_counts_t      *rfm;
+            /* Interim turning point is confirmed by the new point */
+            if( rfc_ctx->follower_cnt && !follower_feed( rfc_ctx, &tp_interim ) )
+            {
+                return false;
+            }
 
-    RFC_CTX_CHECK_AND_ASSIGN
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
-    {
-        return false;
-    }
+#if RFC_TP_SUPPORT
+            {
+                rfc_value_tuple_s *tp_residue = &rfc_ctx->residue[rfc_ctx->residue_cnt];
 
-    class_count = rfc_ctx->class_count;
+                /* Check if tp influences margins (tp_residue is set to NULL, if the interim turning point is the left margin) */
+                if( !feed_once_tp_check_margin( rfc_ctx, &tp, &tp_residue ) )
+                {
+                    return false;
+                }
 
-    rfm = rfc_ctx->rfm;
+                if( !tp_residue )
+                {
+                    assert( rfc_ctx->residue_cnt + 2 < rfc_ctx->residue_cap );
 
-    if( !rfm || !class_count )
-    {
-        return false;
-    }
+                    /* Keep the interim turning point in the residue, it refers the left margin already */
+                    rfc_ctx->residue_cnt++;
+                    is_margin = true;
+                }
+            }
+#endif /*RFC_TP_SUPPORT*/
 
-    assert( from_val >= rfc_ctx->class_offset );
-    assert( to_val   >= rfc_ctx->class_offset );
+            if( !is_margin && !feed_once_tp( rfc_ctx, &tp_interim ) )
+            {
+                return false;
+            }
 
-    from = QUANTIZE( rfc_ctx, from_val );
-    to   = QUANTIZE( rfc_ctx, to_val );
+            /* New interim turning point */
+            (void)value_delta( rfc_ctx, &tp_interim, &tp, &rfc_ctx->internal.slope );
+            rfc_ctx->residue[rfc_ctx->residue_cnt] = tp;
 
-    if( from > class_count ) from = class_count;
-    if( to   > class_count ) to   = class_count;
+#if RFC_GLOBAL_EXTREMA
+            /* Build global extrema */
+            if( tp.value < rfc_ctx->internal.extrema[0].value )
+            {
+                rfc_ctx->internal.extrema[0] = tp;
+                rfc_ctx->internal.extrema_changed = true;
+            }
+            else if( tp.value > rfc_ctx->internal.extrema[1].value )
+            {
+                rfc_ctx->internal.extrema[1] = tp;
+                rfc_ctx->internal.extrema_changed = true;
+            }
+#endif /*RFC_GLOBAL_EXTREMA*/
+        }
+    }
 
-    if( add_only )
+    if( rfc_ctx->snapshot_tiles )
     {
-        rfm[ MAT_OFFS( from, to ) ] += counts;
+        snapshot_publish( rfc_ctx );
     }
-    else
+
+    if( rfc_ctx->region )
     {
-        rfm[ MAT_OFFS( from, to ) ] = counts;
+        region_publish( rfc_ctx );
     }
 
     return true;
@@ -2083,271 +2765,355 @@ bool RFC_rfm_poke( void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_coun
 
 
 /**
- * @brief      Sum cycles of a rainflow matrix region
+ * @brief         Feed counting algorithm with data tuples (tp_pos is kept maintaining). 
  *
- * @param      ctx         The rainflow context
- * @param      from_first  The first start class (row)
- * @param      from_last   The last start class (row)
- * @param      to_first    The first target class (col)
- * @param      to_last     The last target class (col)
- * @param      count       The sum of the matrix region
+ * @param         ctx         The rainflow context
+ * @param[in,out] data        The data tuples
+ * @param         data_count  The data count
  *
- * @return     true on success
- * @note       The sum is natively built, regardless of .full_inc!
+ * @return        true on success
  */
-bool RFC_rfm_sum( const void *ctx, unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, rfc_counts_t *count )
+bool RFC_feed_tuple( void *ctx, rfc_value_tuple_s *data, size_t data_count )
 {
-    unsigned         from, to;
-    unsigned         class_count;
-    rfc_counts_t    *rfm;
-
     RFC_CTX_CHECK_AND_ASSIGN
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
-    {
-        return false;
-    }
-
-    class_count = rfc_ctx->class_count;
 
-    rfm = rfc_ctx->rfm;
+    if( data_count && !data ) return false;
 
-    if( !rfm || !class_count )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    assert( from_first < class_count );
-    assert( from_last  < class_count );
-    assert( to_first   < class_count );
-    assert( to_last    < class_count );
-    assert( from_first < from_last );
-    assert( to_first   < to_last );
-
-    if( count )
+    /* Process data */
+    while( data_count-- )
     {
-        rfc_counts_t sum = 0;
-
-        for( from = from_first; from <= from_last; from++ )
+        if( rfc_ctx->class_count && ( data->cls >= rfc_ctx->class_count || data->value < rfc_ctx->class_offset ) )
         {
-            for( to = to_first; to < to_last; to++ )
+#if RFC_FLAGS_AUTORESIZE
+            unsigned cls = QUANTIZE( ctx, data->value );
+
+            if( data->cls != cls )
             {
-                sum += rfm[ MAT_OFFS( from, to ) ];
+                return error_raise( rfc_ctx, RFC_ERROR_DATA_INCONSISTENT );
+            }
+            else
+#endif /*RFC_FLAGS_AUTORESIZE*/
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
             }
         }
+        
+        if( !feed_once( rfc_ctx, data++, rfc_ctx->internal.flags ) ) return false;
+    }
 
-        *count = sum;
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
     }
 
     return true;
 }
+#endif /*!RFC_MINIMAL*/
 
 
 /**
- * @brief      Calculates the sum of damages for a rainflow matrix
- *             region
+ * @brief      Finalize pending counts and turning point storage.
  *
- * @param      ctx         The rainflow context
- * @param      from_first  The first start class (row)
- * @param      from_last   The last start class (row)
- * @param      to_first    The first target class (col)
- * @param      to_last     The last target class (col)
- * @param[out] damage      The result (sum)
+ * @param      ctx              The rainflow context
+ * @param      residual_method  The residual method (RFC_RES_...)
  *
  * @return     true on success
  */
-bool RFC_rfm_damage( const void *ctx, unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, double *damage )
+bool RFC_finalize( void *ctx, rfc_res_method_e residual_method )
 {
-    unsigned          from, to;
-    unsigned          class_count;
-    rfc_counts_t     *rfm;
-
+    double damage;
+    bool ok;
     RFC_CTX_CHECK_AND_ASSIGN
     
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    class_count = rfc_ctx->class_count;
+#if _DEBUG
+    rfc_ctx->internal.finalizing = true;
+#endif /*_DEBUG*/
 
-    rfm = rfc_ctx->rfm;
+    damage = rfc_ctx->damage;
 
-    if( !rfm || !class_count )
+#if !RFC_MINIMAL
+    if( VALUE_MODE( rfc_ctx ) && !value_mode_check( rfc_ctx ) )
     {
         return false;
     }
 
-    assert( from_first < class_count );
-    assert( from_last  < class_count );
-    assert( to_first   < class_count );
-    assert( to_last    < class_count );
-    assert( from_first < from_last );
-    assert( to_first   < to_last );
-
-    if( damage )
-    {
-        double sum = 0.0;
-        for( from = from_first; from <= from_last; from++ )
-        {
-            for( to = to_first; to < to_last; to++ )
-            {
-                rfc_counts_t count = rfm[ MAT_OFFS( from, to ) ];
-                double damage_i;
-                
-                if( !damage_calc( rfc_ctx, from, to, &damage_i, NULL /*Sa_ret*/ ) )
-                {
-                    return false;
-                }
-
-                sum += damage_i * count;
-            }
-        }
-
-        *damage = sum / rfc_ctx->full_inc;
-    }
-
-    return true;
-}
-
-
-/**
- * @brief      Check the consistency of the rainflow matrix
- *
- * @param      rfc_ctx  The rfc context
- *
- * @return     true on success
- */
-bool RFC_rfm_check( const void *ctx )
-{
-    unsigned          class_count;
-    rfc_counts_t     *rfm;
-
-    RFC_CTX_CHECK_AND_ASSIGN
-    
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    /* Followers get the interim turning point and finalize alike */
+    if( rfc_ctx->follower_cnt && !follower_finalize( rfc_ctx, residual_method ) )
     {
         return false;
     }
+#endif /*!RFC_MINIMAL*/
 
-    class_count = rfc_ctx->class_count;
-
-    rfm = rfc_ctx->rfm;
-
-    if( !rfm || !class_count )
+#if RFC_USE_DELEGATES
+    if( rfc_ctx->finalize_fcn )
     {
-        return false;
+        ok = rfc_ctx->finalize_fcn( rfc_ctx, residual_method );
     }
     else
+#endif /*RFC_USE_DELEGATES*/
     {
-        int i;
+        int flags = rfc_ctx->internal.flags;
 
-        for( i = 0; i < (int)class_count; i++ )
+#if !RFC_MINIMAL
+        /* Level crossing counting is already considered for residue */
+        flags &= ~RFC_FLAGS_COUNT_LC;
+#endif /*!RFC_MINIMAL*/
+
+        switch( residual_method )
         {
-            /* Matrix diagonal must be all zero */
-            if( rfm[ MAT_OFFS( i, i ) ] != 0 )
-            {
-                return false;
-            }
+            case RFC_RES_NONE:
+                /* FALLTHROUGH */
+            case RFC_RES_IGNORE:
+                ok = finalize_res_ignore( rfc_ctx, flags );
+                break;
+            case RFC_RES_NO_FINALIZE:
+                ok = finalize_res_no_finalize( rfc_ctx, flags );
+                break;
+#if !RFC_MINIMAL
+            case RFC_RES_DISCARD:
+                ok = finalize_res_discard( rfc_ctx, flags );
+                break;
+            case RFC_RES_HALFCYCLES:
+                ok = finalize_res_weight_cycles( rfc_ctx, rfc_ctx->half_inc, flags );
+                break;
+            case RFC_RES_FULLCYCLES:
+                ok = finalize_res_weight_cycles( rfc_ctx, rfc_ctx->full_inc, flags );
+                break;
+            case RFC_RES_CLORMANN_SEEGER:
+                ok = finalize_res_clormann_seeger( rfc_ctx, flags );
+                break;
+            case RFC_RES_REPEATED:
+                ok = finalize_res_repeated( rfc_ctx, flags );
+                break;
+            case RFC_RES_RP_DIN45667:
+                ok = finalize_res_rp_DIN45667( rfc_ctx, flags );
+                break;
+#endif /*!RFC_MINIMAL*/
+            default:
+                assert( false );
+                ok = error_raise( rfc_ctx, RFC_ERROR_INVARG );
         }
+
+        /* Counting raises errors (e.g. on memory allocation) without return value */
+        if( rfc_ctx->state == RFC_STATE_ERROR )
+        {
+            ok = false;
+        }
+        assert( !ok || rfc_ctx->state == RFC_STATE_FINALIZE );
     }
-    return true;
+
+#if !RFC_MINIMAL
+    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_NONE || ( !rfc_ctx->class_count && !VALUE_MODE( rfc_ctx ) ) )
+    {
+#else /*RFC_MINIMAL*/
+    if( !rfc_ctx->class_count )
+    {
+#endif /*!RFC_MINIMAL*/
+        rfc_ctx->residue_cnt = 0;
+    }
+
+    rfc_ctx->damage_residue = rfc_ctx->damage - damage;
+    rfc_ctx->state          = ok ? RFC_STATE_FINISHED : RFC_STATE_ERROR;
+
+#if _DEBUG
+    rfc_ctx->internal.finalizing = false;
+#endif /*_DEBUG*/
+
+#if RFC_DH_SUPPORT
+    if( ok )
+    {
+        ok = spread_damage_map_tp( rfc_ctx );
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+#if !RFC_MINIMAL
+    if( rfc_ctx->snapshot_tiles )
+    {
+        snapshot_publish( rfc_ctx );
+    }
+
+    if( rfc_ctx->region )
+    {
+        region_publish( rfc_ctx );
+    }
+#endif /*!RFC_MINIMAL*/
+
+    return ok;
 }
 
 
+#if !RFC_MINIMAL
 /**
- * @brief      Repeat countings basen on given rainflow matrix
+ * @brief      Evaluate several residual methods at once. Closed cycles are
+ *             counted once, each residual method is applied to a private
+ *             copy of the residue and counts. Results are given as deltas
+ *             on the counts of the context.
  *
- * @param      ctx              The rainflow context
- * @param[in]  new_hysteresis   The new hysteresis
- * @param[in]  new_class_param  The new class parameter, may be NULL
+ * @param      ctx      The rainflow context
+ * @param[in]  methods  The residual methods (RFC_RES_...)
+ * @param[out] results  The results per residual method
+ * @param      count    The number of methods
  *
  * @return     true on success
+ * 
+ * @note       The context itself isn't finalized, it keeps the counts of
+ *             closed cycles and may be fed further.
+ *             Counting in value domain is not supported.
  */
-bool RFC_rfm_refeed( void *ctx, rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param )
+bool RFC_finalize_multi( void *ctx, const rfc_res_method_e *methods, rfc_res_result_s *results, unsigned count )
 {
-    rfc_class_param_s old_class_param;
-    rfc_value_tuple_s from = {0}, 
-                      to   = {0};
-    rfc_rfm_item_s   *buffer;
-    unsigned          count, i;
-    rfc_counts_t      j;
+    unsigned class_count;
+    unsigned i;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    if( count && ( !methods || !results ) )
     {
-        return false;
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    if( !rfc_ctx->rfm || !rfc_ctx->class_count )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state >= RFC_STATE_FINALIZE )
     {
-        return RFC_clear_counts( rfc_ctx );
+        return false;
     }
 
-    if( !RFC_rfm_get( rfc_ctx, &buffer, &count ) )
+    if( VALUE_MODE( rfc_ctx ) )
     {
-        return false;
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
     }
 
-    if( !RFC_clear_counts( rfc_ctx ) )
+    class_count = rfc_ctx->class_count;
+
+    for( i = 0; i < count; i++ )
     {
-        return false;
+        rfc_ctx_s         fork;
+        rfc_res_result_s *result = &results[i];
+        size_t            j;
+
+        if( !finalize_fork_init( rfc_ctx, &fork ) )
+        {
+            return false;
+        }
+
+        if( !RFC_finalize( &fork, methods[i] ) )
+        {
+            (void)ctx_clone_deinit( &fork );
+            return error_raise( rfc_ctx, fork.error ? fork.error : RFC_ERROR_INVARG );
+        }
+
+        result->damage         = fork.damage;
+        result->damage_residue = fork.damage - rfc_ctx->damage;
+
+        if( result->rfm )
+        {
+            for( j = 0; j < (size_t)class_count * class_count; j++ )
+            {
+                result->rfm[j] = rfc_ctx->rfm ? fork.rfm[j] - rfc_ctx->rfm[j] : 0;
+            }
+        }
+
+        if( result->rp )
+        {
+            for( j = 0; j < class_count; j++ )
+            {
+                result->rp[j] = rfc_ctx->rp ? fork.rp[j] - rfc_ctx->rp[j] : 0;
+            }
+        }
+
+        if( result->lc )
+        {
+            for( j = 0; j < class_count; j++ )
+            {
+                result->lc[j] = rfc_ctx->lc ? fork.lc[j] - rfc_ctx->lc[j] : 0;
+            }
+        }
+
+        (void)ctx_clone_deinit( &fork );
     }
 
-    if( !RFC_class_param_get( rfc_ctx, &old_class_param ) )
+    return true;
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+/**
+ * @brief      Make rainflow matrix symmetrical
+ *
+ * @param      ctx   The rainflow context
+ *
+ * @return     true on success
+ */
+bool RFC_rfm_make_symmetric( void *ctx )
+{
+    unsigned       class_count;
+    unsigned       from, to;
+    rfc_counts_t  *rfm;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-#if RFC_DAMAGE_FAST
-    if( new_class_param && 
-        ( !RFC_class_param_set( rfc_ctx, new_class_param ) ||
-          !damage_lut_init( rfc_ctx ) ) )
-#else /*!RFC_DAMAGE_FAST*/
-    if( new_class_param && 
-        !RFC_class_param_set( rfc_ctx, new_class_param ) )
-#endif /*RFC_DAMAGE_FAST*/
+    rfm = rfc_ctx->rfm;
+
+    if( !rfm )
     {
         return false;
     }
 
-    rfc_ctx->hysteresis = new_hysteresis;
+    class_count = rfc_ctx->class_count;
 
-    for( i = 0; i < count; i++ )
+    /* Cumulate entries symmetric by major diagonal */
+    for( from = 0; from < class_count; from++ )
     {
-        from.value = old_class_param.width * buffer[i].from + old_class_param.offset + old_class_param.width / 2;
-        from.cls   = QUANTIZE( rfc_ctx, from.value );
-        to.value   = old_class_param.width * buffer[i].to   + old_class_param.offset + old_class_param.width / 2;
-        to.cls     = QUANTIZE( rfc_ctx, to.value );
-
-        for( j = 0; j < buffer[i].counts; j+= rfc_ctx->full_inc )
+        for( to = from + 1; to < class_count; to++ )
         {
-            cycle_process_counts( rfc_ctx, &from, &to, /*next*/ NULL, rfc_ctx->internal.flags );
+            /* to > from, always */
+            rfm[ MAT_OFFS( from, to ) ] += rfm[ MAT_OFFS( to, from ) ];
+            rfm[ MAT_OFFS( to, from ) ]  = 0;
         }
     }
 
+    rfc_ctx->rfm_rev++;
+
     return true;
 }
 
 
 /**
- * @brief      Get level crossing histogram
+ * @brief      Returns the number of non zero entries in rainflow matrix
  *
- * @param      ctx    The rainflow context
- * @param[out] lc     The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
- * @param[out] level  The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param[in]  ctx   The rainflow context
  *
  * @return     true on success
  */
-bool RFC_lc_get( const void *ctx, rfc_counts_t *lc, rfc_value_t *level )
+bool RFC_rfm_non_zeros( const void *ctx, unsigned *count )
 {
-    unsigned i;
-    unsigned class_count;
+    unsigned            class_count;
+    unsigned            from, to;
+    rfc_counts_t       *rfm_it;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !lc )
+    if( !count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
@@ -2359,18 +3125,19 @@ bool RFC_lc_get( const void *ctx, rfc_counts_t *lc, rfc_value_t *level )
 
     class_count = rfc_ctx->class_count;
 
-    if( !rfc_ctx->lc || !lc || !class_count )
+    rfm_it = rfc_ctx->rfm;
+
+    if( !rfm_it || !class_count )
     {
         return false;
     }
 
-    for( i = 0; i < class_count; i++ )
+    *count = 0;
+    for( from = 0; from < class_count; from++ )
     {
-        lc[i] = rfc_ctx->lc[i];
-
-        if( level )
+        for( to = 0; to < class_count; to++ )
         {
-            level[i] = CLASS_UPPER( rfc_ctx, i );
+            if( *rfm_it++ ) (*count)++;
         }
     }
 
@@ -2379,88 +3146,86 @@ bool RFC_lc_get( const void *ctx, rfc_counts_t *lc, rfc_value_t *level )
 
 
 /**
- * @brief      Create level crossing histogram from rainflow matrix
+ * @brief      Get the rainflow matrix as sparse elements
  *
  * @param      ctx     The rainflow context
- * @param[out] lc      The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
- * @param[out] level   The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
- * @param[in]  rfm     The input rainflow matrix to use instead of ctx rfm, may be NULL
- * @param      flags   The flags
+ * @param[out] buffer  The elements buffer, if NULL memory will be allocated
+ * @param[out] count   The number of elements in buffer
  *
  * @return     true on success
- * @note       Returned lc usually differs from .lc, when counting is finalized with any flag other than RFC_RES_NONE!
- */
-bool RFC_lc_from_rfm( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_counts_t *rfm, rfc_flags_e flags )
+ * @note       The counts are natively returned, regardless of .full_inc!
+*/
+bool RFC_rfm_get( const void *ctx, rfc_rfm_item_s **buffer, unsigned *count )
 {
-    unsigned             from, to, i;
-    unsigned             class_count;
-    bool                 up = flags & RFC_FLAGS_COUNT_LC_UP;
-    bool                 dn = flags & RFC_FLAGS_COUNT_LC_DN;
+    unsigned            class_count;
+    unsigned            from, to;
+    unsigned            count_old;
+    rfc_counts_t       *rfm_it;
+    rfc_rfm_item_s     *item;
+
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !lc )
+    if( !buffer || !count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
-
+    
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    if( !rfm )
-    {
-        rfm = rfc_ctx->rfm;
-    }
-
     class_count = rfc_ctx->class_count;
-    
-    if( !rfm || !class_count )
+
+    rfm_it = rfc_ctx->rfm;
+
+
+    if( !rfm_it || !class_count )
     {
         return false;
     }
 
-    memset( lc, 0, sizeof(rfc_counts_t) * class_count );
+    /* *buffer = NULL; */
+    count_old  = *count;
+    *count     = 0;
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++, rfm_it++ )
+        {
+            if( *rfm_it )
+            {
+                (*count)++;
+            }
+        }
+    }
 
-    for( i = 0; i < class_count; i++ ) 
+    if( *count > count_old )
     {
-        rfc_counts_t sum = 0;
+        *buffer = rfc_ctx->mem_alloc( *buffer, *count, sizeof(rfc_rfm_item_s), RFC_MEM_AIM_RFM_ELEMENTS );
 
-        /* First index (0) counts crossings of upper class limit of the first class */
-        if( level )
+        if( !*buffer )
         {
-            level[i] = CLASS_UPPER( rfc_ctx, i );
-        }
+            error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+            return false;
+        }
+    }
         
-        for( from = 0; from <= i; from++ )
+    item   = *buffer;
+    rfm_it = rfc_ctx->rfm;
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++, rfm_it++ )
         {
-            for( to = i + 1; to < class_count; to++ )
+            if( *rfm_it )
             {
-                /* One closed cycle has always a rising and a falling slope */
-                 
-                if( up )
-                {
-                    /* Count rising slopes */
-                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
-                    sum += rfm[ MAT_OFFS( from, to ) ];
-
-                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
-                    sum += rfm[ MAT_OFFS( to, from ) ];
-                }
-                if( dn )
-                {
-                    /* Count falling slopes */
-                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
-                    sum += rfm[ MAT_OFFS( from, to ) ];
+                item->from   = from;
+                item->to     = to;
+                item->counts = *rfm_it;
 
-                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
-                    sum += rfm[ MAT_OFFS( to, from ) ];
-                }
+                item++;
             }
         }
-
-        lc[i] = sum;
     }
 
     return true;
@@ -2468,78 +3233,77 @@ bool RFC_lc_from_rfm( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, con
 
 
 /**
- * Calculate level crossing counts from rainflow matrix, write results to lc
- * histogram buffer.
+ * @brief      Visit the non-zero elements of the rainflow matrix in a
+ *             single pass, row by row, without allocating memory.
  *
- * @param      ctx          The rainflow context
- * @param[out] lc           The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
- * @param[out] level        The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
- * @param[in]  residue      The residue to use instead of ctx residue (may be NULL)
- * @param[in]  residue_cnt  The length of the residue
- * @param      flags        The flags
+ * @param      ctx    The rainflow context
+ * @param      visit  The visitor, returning false stops iteration
+ * @param      user   The user data passed to the visitor
  *
  * @return     true on success
+ * @note       The counts are natively passed, regardless of .full_inc!
  */
-bool RFC_lc_from_residue( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_value_t* residue, unsigned residue_cnt, rfc_flags_e flags )
+bool RFC_rfm_foreach( const void *ctx, rfc_rfm_visit_fcn_t visit, void *user )
 {
-    rfc_value_tuple_s* residue_tuples;
-    unsigned i;
-    bool result;
+    unsigned            class_count;
+    unsigned            from, to;
+    const rfc_counts_t *rfm_it;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !residue || !residue_cnt )
+    if( !visit )
     {
-        return RFC_lc_from_residue_tuples( ctx, lc, level, NULL, 0, flags );
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    residue_tuples = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, rfc_ctx->residue_cap,
-                                                             sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
-
-    if( !residue_tuples )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    for( i = 0; i < residue_cnt; i++ )
+    class_count = rfc_ctx->class_count;
+    rfm_it      = rfc_ctx->rfm;
+
+    if( !rfm_it || !class_count )
     {
-        residue_tuples[i].value = residue[i];
-        residue_tuples[i].cls   = QUANTIZE( rfc_ctx, residue[i] );
-        residue_tuples[i].pos   = 0;
+        return false;
     }
 
-    result = RFC_lc_from_residue_tuples( ctx, lc, level, residue_tuples, residue_cnt, flags );
-
-    rfc_ctx->mem_alloc( residue_tuples, 0, 0, RFC_MEM_AIM_RESIDUE);
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++, rfm_it++ )
+        {
+            if( *rfm_it && !visit( user, from, to, *rfm_it ) )
+            {
+                return true;
+            }
+        }
+    }
 
-    return result;
+    return true;
 }
 
 
 /**
- * Calculate level crossing counts from rainflow matrix, write results to lc
- * histogram buffer.
+ * @brief      Set (or increment) rainflow matrix with given elements
  *
- * @param      ctx          The rainflow context
- * @param[out] lc           The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
- * @param[out] level        The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
- * @param[in]  residue      The residue to use instead of ctx residue (may be NULL)
- * @param[in]  residue_cnt  The length of the residue
- * @param      flags        The flags
+ * @param      ctx       The rainflow context
+ * @param[in]  buffer    The elements buffer
+ * @param      count     The number of elements in buffer
+ * @param      add_only  Counts are added if set to true
  *
  * @return     true on success
+ * @note       The counts are natively added, regardless of .full_inc!
  */
-bool RFC_lc_from_residue_tuples( const void *ctx, rfc_counts_t* lc, rfc_value_t *level, const rfc_value_tuple_s *residue, unsigned residue_cnt, rfc_flags_e flags )
+bool RFC_rfm_set( void *ctx, const rfc_rfm_item_s *buffer, unsigned count, bool add_only )
 {
-          unsigned           i;
-          unsigned           class_count;
-          bool               up   = flags & RFC_FLAGS_COUNT_LC_UP;
-          bool               dn   = flags & RFC_FLAGS_COUNT_LC_DN;
-    const rfc_value_tuple_s *from;
+          unsigned           class_count, i;
+    const rfc_rfm_item_s    *item;
+          rfc_counts_t      *rfm;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !lc )
+    if( !buffer )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
@@ -2549,89 +3313,61 @@ bool RFC_lc_from_residue_tuples( const void *ctx, rfc_counts_t* lc, rfc_value_t
         return false;
     }
 
-    if( !residue )
-    {
-        residue     = rfc_ctx->residue;
-        residue_cnt = (int)rfc_ctx->residue_cnt;
-    }
-
     class_count = rfc_ctx->class_count;
 
-    if( !residue || !class_count )
+    rfm = rfc_ctx->rfm;
+
+    if( !rfm || !class_count )
     {
         return false;
     }
 
-    memset( lc, 0, sizeof(rfc_counts_t) * class_count );
-
-    if( level )
+    if( !add_only )
     {
-        for( i = 0; i < class_count; i++ )
-        {
-            level[i] = CLASS_UPPER( rfc_ctx, i );
-        }
+        /* Initialize with zeros */
+        memset( rfm, 0, sizeof(rfc_rfm_item_s) * class_count * class_count );
     }
 
-    from = residue;
-    for( i = 1; i < residue_cnt; i++ ) 
+    item = buffer;
+    for( i = 0; i < count; i++ )
     {
-        const rfc_value_tuple_s *to         = from + 1;
-              unsigned           class_from = from->cls;
-              unsigned           class_to   = to->cls;
+        unsigned from, to;
 
-        /* Level crossing, count rising and falling slopes.
-         * Level crossing histogram (vector storage)
-         * Counts class upper bound crossings
-         * Class upper bound value = (idx+1) * class_width + class_offset
-         */
-        if( class_from < class_to && up )
-        {
-            /* Count rising slopes */
-            unsigned idx;
-            for( idx = class_from; idx < class_to; idx++ )
-            {
-                assert( lc[idx] <= RFC_COUNTS_LIMIT );
-                lc[idx] += rfc_ctx->full_inc;
-            }
-        }
-        else if( class_to < class_from && dn )
+        from = ( item->from < 0 ) ? 1 : ( item->from + 1 );
+        to   = ( item->to   < 0 ) ? 1 : ( item->to   + 1 );
+
+        if( from > class_count ) from = class_count;
+        if( to   > class_count ) to   = class_count;
+
+        if( from > 0 && to > 0 )
         {
-            /* Count falling slopes */
-            unsigned idx;
-            for( idx = class_to; idx < class_from; idx++ )
-            {
-                assert( lc[idx] <= RFC_COUNTS_LIMIT );
-                lc[idx] += rfc_ctx->full_inc;
-            }
+            rfm[ MAT_OFFS( from-1, to-1 ) ] += item->counts;
         }
-
-        from = to;
     }
 
+    rfc_ctx->rfm_rev++;
+
     return true;
 }
 
 
 /**
- * @brief      Get range pair histogram
+ * @brief      Get counts of a single element from the rainflow matrix
  *
- * @param      ctx          The rainflow context
- * @param[out] rp           The histogram (counts), .full_inc represent one "cycle", space for 1..class_count values must be preserved!
- * @param[out] Sa           The amplitudes (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param      ctx       The rainflow context
+ * @param      from_val  The cycles start value
+ * @param      to_val    The cycles target value
+ * @param[out] counts    The corresponding count from the matrix element (not cycles!), regardless of .full_inc!
  *
  * @return     true on success
  */
-bool RFC_rp_get( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa )
+bool RFC_rfm_peek( const void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t *counts )
 {
-    unsigned i;
-    unsigned class_count;
+    unsigned           from, to;
+    unsigned           class_count;
+    rfc_counts_t      *rfm;
 
     RFC_CTX_CHECK_AND_ASSIGN
-
-    if( !rp )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-    }
     
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
@@ -2640,21 +3376,25 @@ bool RFC_rp_get( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa )
 
     class_count = rfc_ctx->class_count;
 
-    if( !rfc_ctx->rp || !rp || !class_count )
+    rfm = rfc_ctx->rfm;
+
+    if( !rfm || !class_count )
     {
         return false;
     }
 
-    memset( rp, 0, sizeof(rfc_counts_t) * class_count );
+    assert( from_val >= rfc_ctx->class_offset );
+    assert( to_val   >= rfc_ctx->class_offset );
 
-    for( i = 0; i < class_count; i++ )
-    {
-        rp[i] = rfc_ctx->rp[i];
+    from = QUANTIZE( rfc_ctx, from_val );
+    to   = QUANTIZE( rfc_ctx, to_val );
 
-        if( Sa )
-        {
-            Sa[i] = rfc_ctx->class_width * i / 2;  /* range / 2 */
-        }
+    if( from > class_count ) from = class_count;
+    if( to   > class_count ) to   = class_count;
+
+    if( counts )
+    {
+        *counts = rfm[ MAT_OFFS( from, to ) ];
     }
 
     return true;
@@ -2662,96 +3402,117 @@ bool RFC_rp_get( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa )
 
 
 /**
- * @brief      Generate range pair histogram from rainflow matrix
+ * @brief      Set (or increment) one matrix value of the rainflow matrix
  *
- * @param      ctx          The rainflow context
- * @param[out] rp           The buffer for range pair counts (not cycles!), .full_inc represents one "cycle", space for 1..class_count values must be preserved!
- * @param[out] Sa           The buffer for amplitudes (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
- * @param[in]  rfm          The input rainflow matrix to use instead of the ctx matrix (may be NULL)
+ * @param      ctx       The rainflow context
+ * @param      from_val  The cycles start value
+ * @param      to_val    The cycles target value
+ * @param      counts    The count value for the matrix element (not cycles!), regardless of .full_inc!
+ * @param      add_only  Value is added if set to true
  *
  * @return     true on success
  */
-bool RFC_rp_from_rfm( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa, const rfc_counts_t *rfm )
+bool RFC_rfm_poke( void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t counts, bool add_only )
 {
-    unsigned    i, j;
-    unsigned    class_count;
+    unsigned           from, to;
+    unsigned           class_count;
+    rfc_counts_t      *rfm;
 
     RFC_CTX_CHECK_AND_ASSIGN
-
-    if( !rp )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-    }
     
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    if( !rfm )
-    {
-        rfm = rfc_ctx->rfm;
-    }
-
     class_count = rfc_ctx->class_count;
 
+    rfm = rfc_ctx->rfm;
+
     if( !rfm || !class_count )
     {
         return false;
     }
 
-    memset( rp, 0, sizeof(rfc_counts_t) * class_count );
+    assert( from_val >= rfc_ctx->class_offset );
+    assert( to_val   >= rfc_ctx->class_offset );
 
-    for( i = 0; i < class_count; i++ ) 
-    {
-        rfc_counts_t sum = (rfc_counts_t)0;
+    from = QUANTIZE( rfc_ctx, from_val );
+    to   = QUANTIZE( rfc_ctx, to_val );
 
-        if( Sa )
-        {
-            Sa[i] = rfc_ctx->class_width * i / 2;  /* range / 2 */
-        }
+    if( from > class_count ) from = class_count;
+    if( to   > class_count ) to   = class_count;
 
-        for( j = i; j < class_count; j++ ) 
-        {
-            /* Count rising and falling slopes */
-            assert( sum < ( RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( j-i, j ) ] - rfm[ MAT_OFFS( j, j-i ) ] ) );
-            sum += rfm[ MAT_OFFS( j-i, j ) ];
-            sum += rfm[ MAT_OFFS( j, j-i ) ];
-        }
-
-        rp[i] = sum;
+    if( add_only )
+    {
+        rfm[ MAT_OFFS( from, to ) ] += counts;
+    }
+    else
+    {
+        rfm[ MAT_OFFS( from, to ) ] = counts;
     }
 
+    rfc_ctx->rfm_rev++;
+
     return true;
 }
 
 
 /**
- * @brief      Return cumulated damage
+ * @brief      Sum cycles of a rainflow matrix region
  *
- * @param      ctx             The rainflow context
- * @param[out] damage          The buffer for cumulated damage (including damage from residue)
- * @param[out] damage_residue  The buffer for partial damage from residue
+ * @param      ctx         The rainflow context
+ * @param      from_first  The first start class (row)
+ * @param      from_last   The last start class (row)
+ * @param      to_first    The first target class (col)
+ * @param      to_last     The last target class (col)
+ * @param      count       The sum of the matrix region
  *
  * @return     true on success
+ * @note       The sum is natively built, regardless of .full_inc!
  */
-bool RFC_damage( const void *ctx, rfc_value_t *damage, rfc_value_t *damage_residue )
+bool RFC_rfm_sum( const void *ctx, unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, rfc_counts_t *count )
 {
-    RFC_CTX_CHECK_AND_ASSIGN
+    unsigned         from, to;
+    unsigned         class_count;
+    rfc_counts_t    *rfm;
 
+    RFC_CTX_CHECK_AND_ASSIGN
+    
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    if( damage )
+    class_count = rfc_ctx->class_count;
+
+    rfm = rfc_ctx->rfm;
+
+    if( !rfm || !class_count )
     {
-        *damage = rfc_ctx->damage;
+        return false;
     }
 
-    if( damage_residue )
+    assert( from_first < class_count );
+    assert( from_last  < class_count );
+    assert( to_first   < class_count );
+    assert( to_last    < class_count );
+    assert( from_first < from_last );
+    assert( to_first   < to_last );
+
+    if( count )
     {
-        *damage_residue = rfc_ctx->damage_residue;
+        rfc_counts_t sum = 0;
+
+        for( from = from_first; from <= from_last; from++ )
+        {
+            for( to = to_first; to < to_last; to++ )
+            {
+                sum += rfm[ MAT_OFFS( from, to ) ];
+            }
+        }
+
+        *count = sum;
     }
 
     return true;
@@ -2759,759 +3520,1057 @@ bool RFC_damage( const void *ctx, rfc_value_t *damage, rfc_value_t *damage_resid
 
 
 /**
- * @brief      Calculate the damage from a range pair histogram
+ * @brief      Calculates the sum of damages for a rainflow matrix
+ *             region
  *
- * @param      ctx             The rainflow context
- * @param[out] damage          The buffer for cumulated damage
- * @param[in]  rp              The range pair counts to use instead of ctx rp, may be NULL (Mind that
- *                             full_inc describes 1 cycle!), space for 1..class_count values must be preserved!
- * @param[in]  Sa              The buffer for amplitudes respective rp, may be
- *                             NULL, space for 1..class_count values must be preserved!
- * @param      rp_calc_method  The rp calculate method
- *                             (RFC_RP_DAMAGE_CALC_METHOD_*)
+ * @param      ctx         The rainflow context
+ * @param      from_first  The first start class (row)
+ * @param      from_last   The last start class (row)
+ * @param      to_first    The first target class (col)
+ * @param      to_last     The last target class (col)
+ * @param[out] damage      The result (sum)
  *
  * @return     true on success
  */
-bool RFC_damage_from_rp( const void *ctx, double *damage, const rfc_counts_t *rp, const rfc_value_t *Sa, rfc_rp_damage_method_e rp_calc_method )
+bool RFC_rfm_damage( const void *ctx, unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, double *damage )
 {
-    const unsigned    from = 0;
-          unsigned    class_count;
-          double      D;             /* Cumulative damage */
-          int         i, j;
+    unsigned          from, to;
+    unsigned          class_count;
+    rfc_counts_t     *rfm;
 
     RFC_CTX_CHECK_AND_ASSIGN
-
-    if( !damage )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-    }
-
+    
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    if( !rp )
-    {
-        rp = rfc_ctx->rp;
-    }
-
     class_count = rfc_ctx->class_count;
 
-    if( !rp || !class_count )
-    {
-        return false;
-    }
+    rfm = rfc_ctx->rfm;
 
-    /* Sa must be sorted in ascending order */
-    for( i = 1; Sa && i < (int)class_count; i++ )
+    if( !rfm || !class_count )
     {
-        if( Sa[i] < Sa[i-1] )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-        }
+        return false;
     }
 
-    D = 0.0;
+    assert( from_first < class_count );
+    assert( from_last  < class_count );
+    assert( to_first   < class_count );
+    assert( to_last    < class_count );
+    assert( from_first < from_last );
+    assert( to_first   < to_last );
 
-    /* Calculate the "Miner Consequent" approach */
-    if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_CONSEQUENT )
+    if( damage )
     {
-        rfc_wl_param_s      wl;
-        double              q     = rfc_ctx->wl_q;   /* Fatigue strength depression exponent */
-        double              Sd    = rfc_ctx->wl_sd;  /* Fatigue strength SD for the unimpaired(!) part */
-        double              Nd    = rfc_ctx->wl_nd;  /* Fatigue strength cycle count ND for the unimpaired(!) part */
-        double              Sj    = Sd;              /* Current fatigue strength, impacted part */
-        double              D_inv = 0.0;             /* The inverse damage */
-        bool                ok    = true;
-
-        /* Omission not allowed here! */
-        if( rfc_ctx->wl_omission > 0.0 )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-        }
-
-        /* Backup WL parameters */
-        RFC_wl_param_get( rfc_ctx, &wl );
-
-        /* Remove fatigue strength temporarily */
-        rfc_ctx->wl_sd = 0.0;
-        rfc_ctx->wl_nd = DBL_MAX;
-
-        for( j = (int)class_count - 1; j >= -1 && ok; j-- )
+        double sum = 0.0;
+        for( from = from_first; from <= from_last; from++ )
         {
-            double D_j = 0.0;  /* Damage for partial histogram */
-            double Sa_j;       /* New fatigue strength */
-            double weight;     /* Weight for partial histogram */
-
-            /* Get the new degraded fatigue strength in Sa_j */
-            if( j >= 0 )
-            {
-                Sa_j = Sa ? Sa[j] : AMPLITUDE( rfc_ctx, j );
-            }
-            else
-            {
-                Sa_j = 0.0;
-            }
-
-            /* Forward until amplitude is below fatigue strength SD for the unimpaired part */
-            if( Sa_j >= Sd && Sd > 0.0 ) continue;
-
-            /**
-             *  The following lines of code reflect the original formulas as in [6] 3.2.11 and 3.2-59.
-             *  This realization resolves his approach to use partial damages instead of particular cycles from the histogram.
-             *  This procedure benefits from inserting an abstraction layer, which permits to use any representation of 
-             *  a Woehler curve with a given fatigue strength limit providing a damage per cycle representation. 
-             *  Note that the Miner Consequent approach, in contrast to Original/Elementary/Modified, is unsuitable when using 
-             *  an inappropriate Woehler curve, to estimate so called "pseudo damages".
-             */
-
-            /* Weighted damage */
-            weight = pow( Sj / Sd, q ) - pow( Sa_j / Sd, q );
-            Sj     = Sa_j;
-
-            if( weight <= 0.0 ) continue;
-
-            /* Calculate damage for partial histogram */
-            for( i = (int)class_count - 1; i > j; i-- )
+            for( to = to_first; to < to_last; to++ )
             {
-                double Sa_i = Sa ? Sa[i] : AMPLITUDE( rfc_ctx, i );
-                double D_i;
+                rfc_counts_t count = rfm[ MAT_OFFS( from, to ) ];
+                double damage_i;
                 
-                if( !damage_calc_amplitude( rfc_ctx, Sa_i, &D_i ) )
+                if( !damage_calc( rfc_ctx, from, to, &damage_i, NULL /*Sa_ret*/ ) )
                 {
-                    ok = false;
-                    break;
+                    return false;
                 }
 
-                D_j += D_i * rp[i];
-            }
-
-            if( D_j > 0.0 )
-            {
-                D_inv += weight / D_j;
+                sum += damage_i * count;
             }
         }
 
-        /* Restore WL parameters */
-        RFC_wl_param_set( rfc_ctx, &wl );
-
-        if( !ok ) return false;
-
-        /* Get the final damage value */
-        D = 1.0 / D_inv;
+        *damage = sum / rfc_ctx->full_inc;
     }
-    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_ELEMENTAR )
-    {
-        rfc_wl_param_s  wl;
-        bool ok;
 
-        (void)RFC_wl_param_get( rfc_ctx, &wl );
-
-        rfc_ctx->wl_sd = 0.0;
-        rfc_ctx->wl_nd = DBL_MAX;
-        rfc_ctx->wl_k2 = rfc_ctx->wl_k;
-        rfc_ctx->wl_q2 = rfc_ctx->wl_q2;
+    return true;
+}
 
-#if RFC_DAMAGE_FAST
-        {
-            rfc_ctx->damage_lut_inapt++;
-            ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
-            rfc_ctx->damage_lut_inapt--;
-        }
-#else /*!RFC_DAMAGE_FAST*/
-        ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
-#endif /*RFC_DAMAGE_FAST*/
 
-        (void)RFC_wl_param_set( rfc_ctx, &wl );
+/**
+ * @brief      Check the consistency of the rainflow matrix
+ *
+ * @param      rfc_ctx  The rfc context
+ *
+ * @return     true on success
+ */
+bool RFC_rfm_check( const void *ctx )
+{
+    unsigned          class_count;
+    rfc_counts_t     *rfm;
 
-        return ok;
-    }
-    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_MODIFIED)
+    RFC_CTX_CHECK_AND_ASSIGN
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
-        rfc_wl_param_s wl;
-        bool ok;
+        return false;
+    }
 
-        (void)RFC_wl_param_get( rfc_ctx, &wl );
+    class_count = rfc_ctx->class_count;
 
-        rfc_ctx->wl_sd = 0.0;
-        rfc_ctx->wl_nd = DBL_MAX;
+    rfm = rfc_ctx->rfm;
 
-#if RFC_DAMAGE_FAST
-        {
-            rfc_ctx->damage_lut_inapt++;
-            ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
-            rfc_ctx->damage_lut_inapt--;
-        }
-#else /*!RFC_DAMAGE_FAST*/
-        ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
-#endif /*RFC_DAMAGE_FAST*/
-
-        (void)RFC_wl_param_set( rfc_ctx, &wl );
-
-        return ok;
+    if( !rfm || !class_count )
+    {
+        return false;
     }
-    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_DEFAULT )
+    else
     {
+        int i;
+
         for( i = 0; i < (int)class_count; i++ )
         {
-            if( rp[i] )
+            /* Matrix diagonal must be all zero */
+            if( rfm[ MAT_OFFS( i, i ) ] != 0 )
             {
-                double D_i;
-
-                if( Sa )
-                {
-                    if( !damage_calc_amplitude( rfc_ctx, Sa[i], &D_i ) )
-                    {
-                        return false;
-                    }
-                    D += D_i * rp[i];
-                }
-                else
-                {
-                    if( !damage_calc( rfc_ctx, from, i /*to*/, &D_i, NULL /*Sa_ret*/ ) )
-                    {
-                        return false;
-                    }
-                    D += D_i * rp[i];
-                }
+                return false;
             }
         }
     }
-    else return false;
-
-    *damage = D / rfc_ctx->full_inc;
     return true;
 }
 
 
 /**
- * @brief      Calculate the damage from rainflow matrix
+ * @brief      Repeat countings basen on given rainflow matrix
  *
- * @param      ctx     The rainflow context
- * @param[out] damage  The buffer for cumulated damage
- * @param[in]  rfm     The input rainflow matrix to use instead of ctx rfm (may be NULL), .full_inc represents one "cycle"!
+ * @param      ctx              The rainflow context
+ * @param[in]  new_hysteresis   The new hysteresis
+ * @param[in]  new_class_param  The new class parameter, may be NULL
  *
  * @return     true on success
  */
-bool RFC_damage_from_rfm( const void *ctx, double *damage, const rfc_counts_t *rfm )
+bool RFC_rfm_refeed( void *ctx, rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param )
 {
-    unsigned    from, to;
-    unsigned    class_count;
-    double      D;
+    rfc_class_param_s old_class_param;
+    rfc_value_tuple_s from = {0}, 
+                      to   = {0};
+    rfc_rfm_item_s   *buffer = NULL;
+    unsigned          count  = 0, i;
+    rfc_counts_t      j;
+    bool              ok;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !damage )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-    }
-    
     if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    if( !rfm )
+    if( !rfc_ctx->rfm || !rfc_ctx->class_count )
     {
-        rfm = rfc_ctx->rfm;
+        return RFC_clear_counts( rfc_ctx );
     }
 
-    class_count = rfc_ctx->class_count;
+    /* Non-uniform classes can't be mapped onto new class parameters here, use RFC_rfm_resample() */
+    if( rfc_ctx->class_bounds && new_class_param )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
 
-    if( !rfm || !class_count )
+    if( !RFC_rfm_get( rfc_ctx, &buffer, &count ) )
     {
         return false;
     }
 
-    D = 0.0;
-    for( from = 0; from < class_count; from++ )
+    ok = RFC_clear_counts( rfc_ctx ) && RFC_class_param_get( rfc_ctx, &old_class_param );
+
+#if RFC_DAMAGE_FAST
+    if( ok && new_class_param && 
+        ( !RFC_class_param_set( rfc_ctx, new_class_param ) ||
+          !damage_lut_init( rfc_ctx ) ) )
+#else /*!RFC_DAMAGE_FAST*/
+    if( ok && new_class_param && 
+        !RFC_class_param_set( rfc_ctx, new_class_param ) )
+#endif /*RFC_DAMAGE_FAST*/
     {
-        for( to = 0; to < class_count; to++ )
+        ok = false;
+    }
+
+    if( !ok )
+    {
+        rfc_ctx->mem_alloc( buffer, 0, 0, RFC_MEM_AIM_RFM_ELEMENTS );
+        return false;
+    }
+
+    rfc_ctx->hysteresis = new_hysteresis;
+
+    for( i = 0; i < count; i++ )
+    {
+        if( rfc_ctx->class_bounds )
         {
-            if( rfm[ from * class_count + to ] )
-            {
-                double D_i;
+            from.value = CLASS_MEAN( rfc_ctx, buffer[i].from );
+            to.value   = CLASS_MEAN( rfc_ctx, buffer[i].to );
+        }
+        else
+        {
+            from.value = old_class_param.width * buffer[i].from + old_class_param.offset + old_class_param.width / 2;
+            to.value   = old_class_param.width * buffer[i].to   + old_class_param.offset + old_class_param.width / 2;
+        }
+        from.cls   = QUANTIZE( rfc_ctx, from.value );
+        to.cls     = QUANTIZE( rfc_ctx, to.value );
 
-                if( !damage_calc( rfc_ctx, from, to, &D_i, NULL /*Sa_ret*/ ) )
-                {
-                    return false;
-                }
-                D += D_i * rfm[ MAT_OFFS( from, to ) ];
-            }
+        for( j = 0; j < buffer[i].counts; j+= rfc_ctx->full_inc )
+        {
+            cycle_process_counts( rfc_ctx, &from, &to, /*next*/ NULL, rfc_ctx->internal.flags );
         }
     }
 
-    *damage = D / rfc_ctx->full_inc;
+    rfc_ctx->mem_alloc( buffer, 0, 0, RFC_MEM_AIM_RFM_ELEMENTS );
+
     return true;
 }
 
 
 /**
- * @brief      Calculate junction point between k and k2 for a Woehler curve
+ * @brief      Get the rainflow matrix of a coarser resolution level.
+ *             Level l has class width .class_width*2^l, the same class
+ *             offset and ceil(.class_count/2^l) classes. Levels are
+ *             materialized on demand and kept until counts change.
+ *             With non-uniform classes, level class k spans .class_bounds[k*2^l]
+ *             to .class_bounds[(k+1)*2^l] and the class width is an average.
+ *             Counts are aggregated from the finest grid, which approximates
+ *             counting on the coarser grid: Turning points falling into the
+ *             same coarse class may close cycles there, that are closed
+ *             otherwise on the finest grid.
  *
- * @param      ctx   The rainflow context
- * @param      s0    Any point on slope k
- * @param      n0    Any point on slope k
- * @param      k     Slope k
- * @param[out] sx    Junction point between k and k2
- * @param      nx    Junction point between k and k2
- * @param      k2    Slope k2
- * @param      sd    The fatigue strength
- * @param      nd    The cycle count at sd
+ * @param      ctx          The rainflow context
+ * @param      level        The level, 0 is the rainflow matrix itself
+ * @param[out] rfm          The level matrix (row-major, row=from, col=to), valid until counts change (may be NULL)
+ * @param[out] class_param  The class parameters of the level (may be NULL)
  *
  * @return     true on success
  */
-bool RFC_wl_calc_sx( const void *ctx, double s0, double n0, double k, double *sx, double nx, double k2, double sd, double nd )
+bool RFC_rfm_level( const void *ctx, unsigned level, const rfc_counts_t **rfm, rfc_class_param_s *class_param )
 {
-    double nom, den;
+    const rfc_counts_t *rfm_level;
+    unsigned            class_count;
+    unsigned            l;
 
-    k  = fabs(k);
-    k2 = fabs(k2);
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
-        /* sx <= 0.0    || */ nx <= 0.0    ||
-           sd <= 0.0    ||    nd <= 0.0    ||    !sx )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    nom = log(s0)*k - log(sd)*k2 + log(n0) - log(nd);
-    den = k - k2;
+    if( !rfc_ctx->rfm || !rfc_ctx->class_count )
+    {
+        return false;
+    }
 
-    if( den == 0.0 ) return false;
+    /* At least 2 classes on the coarsest level */
+    if( level >= 8 * sizeof(unsigned) || ( ( rfc_ctx->class_count - 1 ) >> level ) == 0 )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
-    *sx = exp( nom / den );
+    rfm_level   = rfc_ctx->rfm;
+    class_count = rfc_ctx->class_count;
+
+    if( level )
+    {
+        if( !rfm_pyramid_build( rfc_ctx, level ) )
+        {
+            return false;
+        }
+
+        rfm_level = rfc_ctx->rfm_pyr;
+        for( l = 1; l <= level; l++ )
+        {
+            if( l > 1 )
+            {
+                rfm_level += (size_t)class_count * class_count;
+            }
+            class_count = ( class_count + 1 ) / 2;
+        }
+    }
+
+    if( rfm )
+    {
+        *rfm = rfm_level;
+    }
+
+    if( class_param )
+    {
+        class_param->count  = class_count;
+        class_param->width  = rfc_ctx->class_width * ( 1u << level );
+        class_param->offset = rfc_ctx->class_offset;
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Calculate fatigue strength for a Woehler curve
+ * @brief      Get the rainflow matrix of a coarser resolution level as
+ *             sparse elements (see RFC_rfm_level())
  *
- * @param      ctx   The rainflow context
- * @param      s0    Any point on slope k
- * @param      n0    Any point on slope k
- * @param      k     Slope k
- * @param      sx    Junction point between k and k2
- * @param      nx    The cycle
- * @param      k2    Slope k2
- * @param[out] sd    The fatigue strength
- * @param      nd    The cycle count at sd
+ * @param      ctx     The rainflow context
+ * @param      level   The level, 0 is the rainflow matrix itself
+ * @param[out] buffer  The elements buffer, if NULL memory will be allocated
+ * @param[out] count   The number of elements in buffer
  *
  * @return     true on success
+ * @note       The counts are natively returned, regardless of .full_inc!
  */
-bool RFC_wl_calc_sd( const void *ctx, double s0, double n0, double k, double sx, double nx, double k2, double *sd, double nd )
+bool RFC_rfm_get_level( const void *ctx, unsigned level, rfc_rfm_item_s **buffer, unsigned *count )
 {
-    double nom, den;
+    const rfc_counts_t *rfm;
+    rfc_class_param_s   class_param;
+    unsigned            count_old;
+    unsigned            from, to;
+    rfc_rfm_item_s     *item;
 
-    k  = fabs(k);
-    k2 = fabs(k2);
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
-           sx <= 0.0    ||    nx <= 0.0    ||
-        /* sd <= 0.0    || */ nd <= 0.0    ||    !sd )
+    if( !buffer || !count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( !level )
+    {
+        return RFC_rfm_get( rfc_ctx, buffer, count );
+    }
+
+    if( !RFC_rfm_level( rfc_ctx, level, &rfm, &class_param ) )
     {
         return false;
     }
 
-    nom = log(s0)*k - log(sx)*(k-k2) + log(n0) - log(nd);
-    den = k2;
+    count_old = *count;
+    *count    = 0;
+    for( from = 0; from < class_param.count * class_param.count; from++ )
+    {
+        if( rfm[from] ) (*count)++;
+    }
 
-    if( den == 0.0 ) return false;
+    if( *count > count_old )
+    {
+        *buffer = rfc_ctx->mem_alloc( *buffer, *count, sizeof(rfc_rfm_item_s), RFC_MEM_AIM_RFM_ELEMENTS );
 
-    *sd = exp( nom / den );
+        if( !*buffer )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+    }
+
+    item = *buffer;
+    for( from = 0; from < class_param.count; from++ )
+    {
+        for( to = 0; to < class_param.count; to++, rfm++ )
+        {
+            if( *rfm )
+            {
+                item->from   = from;
+                item->to     = to;
+                item->counts = *rfm;
+
+                item++;
+            }
+        }
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Calculate the slope k2 for a Woehler curve
+ * @brief      Resample the rainflow matrix onto another class grid.
+ *             If the grid is a power of 2 coarsening of the current grid
+ *             (same offset, width .class_width*2^l), the pyramid level is
+ *             taken (see RFC_rfm_level()). Otherwise counts are redistributed
+ *             by class means, as RFC_rfm_refeed() does. Both approximate
+ *             counting on the target grid.
  *
- * @param      ctx   The rainflow context
- * @param      s0    Any point on slope k
- * @param      n0    Any point on slope k
- * @param      k     Slope k
- * @param      sx    Junction point between k and k2
- * @param      nx    Junction point between k and k2
- * @param[out] k2    Slope k2
- * @param      sd    The fatigue strength
- * @param      nd    The cycle count at sd
+ * @param      ctx          The rainflow context
+ * @param[in]  class_param  The target class parameters
+ * @param[out] rfm          The target matrix, space for class_param->count^2 values must be preserved!
  *
  * @return     true on success
+ * @note       A power of 2 coarsening must cover all classes of its level.
  */
-bool RFC_wl_calc_k2( const void *ctx, double s0, double n0, double k, double sx, double nx, double *k2, double sd, double nd )
+bool RFC_rfm_resample( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rfm )
 {
-    double nom, den;
+    unsigned            class_count;
+    unsigned            level;
+    unsigned            from, to;
 
-    k  = fabs(k);
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
-           sx <= 0.0    ||    nx <= 0.0    ||
-           sd <= 0.0    ||    nd <= 0.0    ||    !k2 )
+    if( !class_param || !rfm || !class_param->count || class_param->width <= 0.0 )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    nom = ( log(s0) - log(sx) ) * k + log(n0) - log(nd);
-    den =   log(sd) - log(sx);
+    class_count = rfc_ctx->class_count;
 
-    if( den == 0.0 )
+    if( !rfc_ctx->rfm || !class_count )
     {
-        *k2 = -DBL_MAX;  /* Negative infinity */
+        return false;
     }
-    else
+
+    memset( rfm, 0, sizeof(rfc_counts_t) * class_param->count * class_param->count );
+
+    /* Aggregation from pyramid level */
+    if( !rfc_ctx->class_bounds && class_param->offset == rfc_ctx->class_offset )
     {
-        *k2 = -fabs( nom / den );
+        for( level = 0; level < 8 * sizeof(unsigned) && ( ( class_count - 1 ) >> level ); level++ )
+        {
+            if( class_param->width == rfc_ctx->class_width * ( 1u << level ) )
+            {
+                const rfc_counts_t *rfm_level;
+                rfc_class_param_s   level_param;
+                unsigned            n;
+
+                if( !RFC_rfm_level( rfc_ctx, level, &rfm_level, &level_param ) )
+                {
+                    return false;
+                }
+
+                n = level_param.count;
+
+                if( class_param->count < n )
+                {
+                    /* Grid would truncate level classes */
+                    return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+                }
+
+                for( from = 0; from < n; from++ )
+                {
+                    for( to = 0; to < n; to++ )
+                    {
+                        rfm[ from * class_param->count + to ] = rfm_level[ from * level_param.count + to ];
+                    }
+                }
+
+                return true;
+            }
+        }
+    }
+
+    /* Weighted redistribution by class means */
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++ )
+        {
+            rfc_counts_t counts = rfc_ctx->rfm[ MAT_OFFS( from, to ) ];
+
+            if( counts )
+            {
+                double   from_val = CLASS_MEAN( rfc_ctx, from );
+                double   to_val   = CLASS_MEAN( rfc_ctx, to );
+                unsigned from_cls, to_cls;
+
+                if( from_val < class_param->offset || to_val < class_param->offset )
+                {
+                    continue;
+                }
+
+                from_cls = (unsigned)( ( from_val - class_param->offset ) / class_param->width );
+                to_cls   = (unsigned)( ( to_val   - class_param->offset ) / class_param->width );
+
+                if( from_cls >= class_param->count ) from_cls = class_param->count - 1;
+                if( to_cls   >= class_param->count ) to_cls   = class_param->count - 1;
+
+                if( from_cls != to_cls )
+                {
+                    rfm[ from_cls * class_param->count + to_cls ] += counts;
+                }
+            }
+        }
     }
 
     return true;
 }
 
+
 /**
- * @brief      Calculate a point on a Woehler slope
+ * @brief      Returns the number of non zero elements in the range-mean matrix
  *
- * @param      ctx   The rainflow context
- * @param      s0    Any point on the slope, Sa
- * @param      n0    Any point on the slope, N
- * @param      k     The Woehler slope
- * @param      n     Given cycles for required Sa
- * @param[out] sa    The buffer for Sa(N)
+ * @param      ctx    The rainflow context
+ * @param[out] count  The number of non zero elements
  *
  * @return     true on success
  */
-bool RFC_wl_calc_sa( const void *ctx, double s0, double n0, double k, double n, double *sa )
+bool RFC_rmm_non_zeros( const void *ctx, unsigned *count )
 {
-    /* (s0/Sa)^-k = n0/n */
-    /* (Sa/s0)^k  = n0/n */
+    unsigned            class_count;
+    size_t              i;
 
-    k  = fabs(k);
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
-           n  <= 0.0    ||   !sa           )
+    if( !count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return false;
     }
 
-    *sa = pow( n0 / n, 1.0 / k ) * s0;
+    class_count = rfc_ctx->class_count;
+
+    if( !rfc_ctx->rmm || !class_count )
+    {
+        return false;
+    }
+
+    *count = 0;
+    for( i = 0; i < RMM_SIZE( class_count ); i++ )
+    {
+        if( rfc_ctx->rmm[i] ) (*count)++;
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Calculate a point on a Woehler slope
+ * @brief      Get the range-mean matrix as sparse elements
  *
- * @param      ctx   The rainflow context
- * @param      s0    Any point on the slope, Sa
- * @param      n0    Any point on the slope, N
- * @param      k     The Woehler slope
- * @param      sa    Given amplitude Sa for required N
- * @param[out] n     The buffer for N(Sa)
+ * @param      ctx     The rainflow context
+ * @param[out] buffer  The elements buffer, if NULL memory will be allocated
+ * @param[out] count   The number of elements in buffer
  *
  * @return     true on success
- */
-bool RFC_wl_calc_n( const void *ctx, double s0, double n0, double k, double sa, double *n )
+ * @note       The counts are natively returned, regardless of .full_inc!
+*/
+bool RFC_rmm_get( const void *ctx, rfc_rmm_item_s **buffer, unsigned *count )
 {
-    /* (Sa/s0)^-k = n/n0 */
-    /* (s0/Sa)^k  = n/n0 */
+    unsigned            class_count;
+    unsigned            range, mean;
+    unsigned            count_old;
+    rfc_counts_t       *rmm_it;
+    rfc_rmm_item_s     *item;
 
-    k  = fabs(k);
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if( s0 <= 0.0 ||  n0 <= 0.0    ||
-        sa <= 0.0 || !n            )
+    if( !buffer || !count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    count_old = *count;
+
+    if( !RFC_rmm_non_zeros( rfc_ctx, count ) )
     {
         return false;
     }
 
-    *n = pow( s0 / sa, k ) * n0;
+    if( *count > count_old )
+    {
+        *buffer = rfc_ctx->mem_alloc( *buffer, *count, sizeof(rfc_rmm_item_s), RFC_MEM_AIM_RMM_ELEMENTS );
+
+        if( !*buffer )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+    }
+
+    class_count = rfc_ctx->class_count;
+    item        = *buffer;
+    rmm_it      = rfc_ctx->rmm;
+    for( range = 0; range < class_count; range++ )
+    {
+        for( mean = range; mean < 2 * class_count - 1 - range; mean += 2, rmm_it++ )
+        {
+            if( *rmm_it )
+            {
+                item->range  = range;
+                item->mean   = mean;
+                item->counts = *rmm_it;
+
+                item++;
+            }
+        }
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Set class parameter.
+ * @brief      Get counts of a single element from the range-mean matrix
  *
- * @param      ctx          The rainflow context
- * @param[in]  class_param  The new class parameter
+ * @param      ctx        The rainflow context
+ * @param      range_val  The cycles range
+ * @param      mean_val   The cycles mean value
+ * @param[out] counts     The corresponding count from the matrix element (not cycles!), regardless of .full_inc!
  *
  * @return     true on success
- * 
- * @note       Changing class parameters invalidate look-up tables!
  */
-bool RFC_class_param_set( void *ctx, const rfc_class_param_s *class_param )
+bool RFC_rmm_peek( const void *ctx, rfc_value_t range_val, rfc_value_t mean_val, rfc_counts_t *counts )
 {
-    RFC_CTX_CHECK_AND_ASSIGN
+    unsigned           range, mean;
+    unsigned           class_count;
 
-    if( !class_param                                || 
-         rfc_ctx->state     != RFC_STATE_INIT       || 
-         class_param->count != rfc_ctx->class_count ||
-         class_param->width  < 0.0                  )
+    RFC_CTX_CHECK_AND_ASSIGN
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        return false;
     }
 
-    if( class_param->count > 0.0 && class_param->width <= 0.0 )
+    class_count = rfc_ctx->class_count;
+
+    if( !rfc_ctx->rmm || !class_count || range_val < 0.0 || mean_val < rfc_ctx->class_offset )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        return false;
     }
 
-    rfc_ctx->class_count  = class_param->count;
-    rfc_ctx->class_width  = class_param->width;
-    rfc_ctx->class_offset = class_param->offset;
+    range = (unsigned)( range_val / rfc_ctx->class_width + 0.5 );
+    mean  = (unsigned)( 2.0 * ( mean_val - rfc_ctx->class_offset ) / rfc_ctx->class_width - 0.5 );
 
-#if RFC_DAMAGE_FAST
-    rfc_ctx->damage_lut_inapt++;
-#endif /*RFC_DAMAGE_FAST*/
+    if( counts )
+    {
+        *counts = 0;
+
+        /* Mean class must share the parity of the range class */
+        if( range < class_count && mean >= range && mean <= 2 * class_count - 2 - range && !( ( mean - range ) & 1 ) )
+        {
+            *counts = rfc_ctx->rmm[ RMM_OFFS( range, mean ) ];
+        }
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Get class parameter.
+ * @brief      Calculate the damage from range-mean matrix
  *
- * @param      ctx          The rainflow context
- * @param[out] class_param  The class parameter
+ * @param      ctx     The rainflow context
+ * @param[out] damage  The buffer for cumulated damage
+ * @param[in]  rmm     The input range-mean matrix to use instead of ctx rmm (may be NULL), .full_inc represents one "cycle"!
  *
  * @return     true on success
  */
-bool RFC_class_param_get( const void *ctx, rfc_class_param_s *class_param )
+bool RFC_rmm_damage( const void *ctx, double *damage, const rfc_counts_t *rmm )
 {
+    unsigned    range, mean;
+    unsigned    class_count;
+    double      D;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_param                     ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !damage )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-    class_param->count  = rfc_ctx->class_count;
-    class_param->width  = rfc_ctx->class_width;
-    class_param->offset = rfc_ctx->class_offset;
+    if( !rmm )
+    {
+        rmm = rfc_ctx->rmm;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rmm || !class_count )
+    {
+        return false;
+    }
+
+    D = 0.0;
+    for( range = 0; range < class_count; range++ )
+    {
+        for( mean = range; mean < 2 * class_count - 1 - range; mean += 2, rmm++ )
+        {
+            if( *rmm )
+            {
+                double D_i;
+
+                /* Rising slope, falling slopes give same damage */
+                if( !damage_calc( rfc_ctx, ( mean - range ) / 2, ( mean + range ) / 2, &D_i, NULL /*Sa_ret*/ ) )
+                {
+                    return false;
+                }
+                D += D_i * *rmm;
+            }
+        }
+    }
 
+    *damage = D / rfc_ctx->full_inc;
     return true;
 }
 
 
 /**
- * @brief      Get class number from value
+ * @brief      Generate range-mean matrix from rainflow matrix
  *
- * @param[in]  ctx           The rainflow context
- * @param[in]  value         The value
- * @param      class_number  The class number
+ * @param      ctx  The rainflow context
+ * @param[out] rmm  The buffer for range-mean matrix counts, space for class_count*(class_count+1)/2 values must be preserved!
+ * @param[in]  rfm  The input rainflow matrix to use instead of ctx rfm (may be NULL)
  *
  * @return     true on success
  */
-bool RFC_class_number( const void *ctx, rfc_value_t value, unsigned *class_number )
+bool RFC_rmm_from_rfm( const void *ctx, rfc_counts_t *rmm, const rfc_counts_t *rfm )
 {
+    unsigned    from, to;
+    unsigned    class_count;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_number                    ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !rmm )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-    *class_number = QUANTIZE( rfc_ctx, value );
+    if( !rfm )
+    {
+        rfm = rfc_ctx->rfm;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rfm || !class_count )
+    {
+        return false;
+    }
+
+    memset( rmm, 0, sizeof(rfc_counts_t) * RMM_SIZE( class_count ) );
+
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++ )
+        {
+            unsigned range = ( from > to ) ? ( from - to ) : ( to - from );
+
+            rmm[ RMM_OFFS( range, from + to ) ] += rfm[ MAT_OFFS( from, to ) ];
+        }
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Get class mean from class number
+ * @brief      Set the duration classes of the range-mean-duration histogram.
+ *             Class 0 holds durations below dur_min, class k holds durations
+ *             in [dur_min*dur_ratio^(k-1), dur_min*dur_ratio^k), the last
+ *             class is open-ended.
  *
- * @param[in]  ctx           The rainflow context
- * @param[in]  class_number  The class number
- * @param      class_mean    The class mean
+ * @param      ctx        The rainflow context
+ * @param      dur_min    The upper bound of duration class 0 [samples]
+ * @param      dur_ratio  The ratio between upper and lower bound of a class (>1)
+ * @param      dur_count  The number of duration classes
  *
  * @return     true on success
+ * @note       Only valid as long as the histogram is empty!
  */
-bool RFC_class_mean( const void *ctx, unsigned class_number, rfc_value_t *class_mean )
+bool RFC_rmd_init( void *ctx, double dur_min, double dur_ratio, unsigned dur_count )
 {
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_mean                      ||
-         rfc_ctx->state < RFC_STATE_INIT ||
-         class_number >= rfc_ctx->class_count )
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    *class_mean = CLASS_MEAN( rfc_ctx, class_number );
+    if( dur_min <= 0.0 || dur_ratio <= 1.0 || !dur_count || rfc_ctx->rmd_cnt )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    rfc_ctx->rmd_dur_min   = dur_min;
+    rfc_ctx->rmd_dur_ratio = dur_ratio;
+    rfc_ctx->rmd_dur_count = dur_count;
 
     return true;
 }
 
 
 /**
- * @brief      Get class upper value from class nummer
+ * @brief      Returns the number of non zero elements in the range-mean-duration histogram
  *
- * @param[in]  ctx           The rainflow context
- * @param[in]  class_number  The class number
- * @param      class_upper   The class upper
+ * @param      ctx    The rainflow context
+ * @param[out] count  The number of non zero elements
  *
  * @return     true on success
  */
-bool RFC_class_upper( const void *ctx, unsigned class_number, rfc_value_t *class_upper )
+bool RFC_rmd_non_zeros( const void *ctx, unsigned *count )
 {
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_upper                     ||
-         rfc_ctx->state < RFC_STATE_INIT ||
-         class_number >= rfc_ctx->class_count )
+    if( !count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-    *class_upper = CLASS_UPPER( rfc_ctx, class_number );
+    if( !rfc_ctx->rmd )
+    {
+        return false;
+    }
+
+    *count = (unsigned)rfc_ctx->rmd_cnt;
 
     return true;
 }
 
 
 /**
- * @brief      Get class count
+ * @brief      Get the range-mean-duration histogram as sparse elements,
+ *             ordered by range, mean and duration class
  *
- * @param[in]  ctx           The rainflow context
- * @param      class_count   The class count
+ * @param      ctx     The rainflow context
+ * @param[out] buffer  The elements buffer, if NULL memory will be allocated
+ * @param[out] count   The number of elements in buffer
  *
  * @return     true on success
- */
-bool RFC_class_count( const void *ctx, unsigned *class_count )
+ * @note       The counts are natively returned, regardless of .full_inc!
+*/
+bool RFC_rmd_get( const void *ctx, rfc_rmd_item_s **buffer, unsigned *count )
 {
+    unsigned            count_old;
+    size_t              i;
+    rfc_rmd_item_s     *item;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_count                     ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !buffer || !count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    *class_count = rfc_ctx->class_count;
+    count_old = *count;
+
+    if( !RFC_rmd_non_zeros( rfc_ctx, count ) )
+    {
+        return false;
+    }
+
+    if( *count > count_old )
+    {
+        *buffer = rfc_ctx->mem_alloc( *buffer, *count, sizeof(rfc_rmd_item_s), RFC_MEM_AIM_RMD_ELEMENTS );
+
+        if( !*buffer )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+    }
+
+    item = *buffer;
+    for( i = 0; i < rfc_ctx->rmd_cap; i++ )
+    {
+        if( rfc_ctx->rmd[i].counts )
+        {
+            *item++ = rfc_ctx->rmd[i];
+        }
+    }
+
+    if( *count > 1 )
+    {
+        qsort( *buffer, *count, sizeof(rfc_rmd_item_s), rmd_item_cmp );
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Get class offset
+ * @brief      Get the bounds of a duration class
  *
- * @param[in]  ctx           The rainflow context
- * @param      class_offset  The class offset
+ * @param      ctx        The rainflow context
+ * @param      duration   The duration class, base 0
+ * @param[out] dur_lower  The lower bound [samples] (may be NULL)
+ * @param[out] dur_upper  The upper bound [samples], DBL_MAX for the last class (may be NULL)
  *
  * @return     true on success
  */
-bool RFC_class_offset( const void *ctx, rfc_value_t *class_offset )
+bool RFC_rmd_duration( const void *ctx, unsigned duration, double *dur_lower, double *dur_upper )
 {
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_offset                    ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( duration >= rfc_ctx->rmd_dur_count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    *class_offset = rfc_ctx->class_offset;
+    if( dur_lower )
+    {
+        *dur_lower = duration ? rfc_ctx->rmd_dur_min * pow( rfc_ctx->rmd_dur_ratio, (double)duration - 1.0 ) : 0.0;
+    }
+
+    if( dur_upper )
+    {
+        *dur_upper = ( duration + 1 < rfc_ctx->rmd_dur_count ) ? rfc_ctx->rmd_dur_min * pow( rfc_ctx->rmd_dur_ratio, (double)duration ) : DBL_MAX;
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Get class width
+ * @brief      Get the cycles recorded in value domain (RFC_FLAGS_COUNT_VALUES)
  *
- * @param[in]  ctx           The rainflow context
- * @param      class_width   The class width
+ * @param      ctx     The rainflow context
+ * @param[out] cycles  The recorded cycles, valid until next feed
+ * @param[out] count   The number of cycles
  *
  * @return     true on success
+ * 
+ * @note       Cycles of equal value pairs are merged, whenever the storage
+ *             is full. The order of closing is not preserved then.
  */
-bool RFC_class_width( const void *ctx, rfc_value_t *class_width )
+bool RFC_cycles_get( const void *ctx, const rfc_cycle_item_s **cycles, size_t *count )
 {
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !class_width                     ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !cycles || !count )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    *class_width = rfc_ctx->class_width;
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfc_ctx->cycles )
+    {
+        return false;
+    }
+
+    *cycles = rfc_ctx->cycles;
+    *count  = rfc_ctx->cycles_cnt;
 
     return true;
 }
 
 
 /**
- * @brief      Get hysteresis
+ * @brief      Get class parameters covering all recorded cycles and the
+ *             residue. Extreme values are placed in the class mid of the
+ *             first and last class.
  *
- * @param[in]  ctx           The rainflow context
- * @param      hysteresis    The hysteresis
+ * @param      ctx          The rainflow context
+ * @param      class_count  The number of classes (at least 2)
+ * @param[out] class_param  The class parameters
  *
  * @return     true on success
  */
-bool RFC_hysteresis( const void *ctx, rfc_value_t *hysteresis )
+bool RFC_cycles_class_param( const void *ctx, unsigned class_count, rfc_class_param_s *class_param )
 {
+    rfc_value_t v_min = 0.0, v_max = 0.0;
+    bool        any   = false;
+    size_t      i;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !hysteresis                      ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !class_param || class_count < 2 )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    *hysteresis = rfc_ctx->hysteresis;
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfc_ctx->cycles )
+    {
+        return false;
+    }
+
+    for( i = 0; i < 2 * rfc_ctx->cycles_cnt + rfc_ctx->residue_cnt; i++ )
+    {
+        rfc_value_t value;
+
+        if( i < 2 * rfc_ctx->cycles_cnt )
+        {
+            value = ( i & 1 ) ? rfc_ctx->cycles[i/2].to : rfc_ctx->cycles[i/2].from;
+        }
+        else
+        {
+            value = rfc_ctx->residue[ i - 2 * rfc_ctx->cycles_cnt ].value;
+        }
+
+        if( !any || value < v_min ) v_min = value;
+        if( !any || value > v_max ) v_max = value;
+        any = true;
+    }
+
+    class_param->count  = class_count;
+    class_param->width  = ( v_max > v_min ) ? ( v_max - v_min ) / ( class_count - 1 ) : 1.0;
+    class_param->offset = v_min - class_param->width / 2;
 
     return true;
 }
 
 
 /**
- * @brief      Set flags
+ * @brief      Build a rainflow matrix from cycles recorded in value domain.
+ *             Values outside the class range are assigned to the first or
+ *             last class.
  *
- * @param      ctx        The rainflow context
- * @param[in]  flags      The flags
- * @param[in]  overwrite  Overwrites, if true
- * @param[in]  stack      ID of flags stack
+ * @param      ctx          The rainflow context
+ * @param[in]  class_param  The class parameters
+ * @param[out] rfm          The rainflow matrix, space for class_param->count^2 values must be preserved!
  *
  * @return     true on success
  */
-bool RFC_flags_set( void *ctx, int flags, int stack, bool overwrite )
+bool RFC_cycles_rfm( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rfm )
 {
+    unsigned    class_count;
+    size_t      i;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    switch( stack )
+    if( !class_param || !rfm || !class_param->count || class_param->width <= 0.0 )
     {
-        case 0:
-            if( overwrite )
-            {
-                rfc_ctx->internal.flags = (rfc_flags_e)flags;
-            }
-            else
-            {
-                rfc_ctx->internal.flags |= (rfc_flags_e)flags;
-            }
-            break;
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
-#if RFC_DEBUG_FLAGS
-        case 1:
-            if( overwrite )
-            {
-                rfc_ctx->internal.debug_flags = (rfc_debug_flags_e)flags;
-            }
-            else
-            {
-                rfc_ctx->internal.debug_flags |= (rfc_debug_flags_e)flags;
-            }
-            break;
-#endif /*RFC_DEBUG_FLAGS*/
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-        default:
-            return false;
+    if( !rfc_ctx->cycles )
+    {
+        return false;
+    }
+
+    class_count = class_param->count;
+
+    memset( rfm, 0, sizeof(rfc_counts_t) * class_count * class_count );
+
+    for( i = 0; i < rfc_ctx->cycles_cnt; i++ )
+    {
+        const rfc_cycle_item_s *cycle = &rfc_ctx->cycles[i];
+        double                  from  = ( cycle->from - class_param->offset ) / class_param->width;
+        double                  to    = ( cycle->to   - class_param->offset ) / class_param->width;
+        unsigned                class_from, class_to;
+
+        class_from = ( from < 0.0 ) ? 0 : ( from >= class_count ) ? class_count - 1 : (unsigned)from;
+        class_to   = ( to   < 0.0 ) ? 0 : ( to   >= class_count ) ? class_count - 1 : (unsigned)to;
+
+        if( class_from != class_to )
+        {
+            rfm[ MAT_OFFS( class_from, class_to ) ] += cycle->counts;
+        }
     }
 
     return true;
@@ -3519,32 +4578,52 @@ bool RFC_flags_set( void *ctx, int flags, int stack, bool overwrite )
 
 
 /**
- * @brief      Unset flags (mask)
+ * @brief      Build a range pair histogram from cycles recorded in value
+ *             domain (see RFC_cycles_rfm())
  *
- * @param      ctx        The rainflow context
- * @param[in]  flags      The flags
- * @param[in]  stack      ID of flags stack
+ * @param      ctx          The rainflow context
+ * @param[in]  class_param  The class parameters
+ * @param[out] rp           The range pair counts, space for class_param->count values must be preserved!
  *
  * @return     true on success
  */
-bool RFC_flags_unset( void *ctx, int flags, int stack )
+bool RFC_cycles_rp( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rp )
 {
+    unsigned    class_count;
+    size_t      i;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    switch( stack )
+    if( !class_param || !rp || !class_param->count || class_param->width <= 0.0 )
     {
-        case 0:
-            rfc_ctx->internal.flags &= (rfc_flags_e)~flags;
-            break;
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
-#if RFC_DEBUG_FLAGS
-        case 1:
-            rfc_ctx->internal.debug_flags &= (rfc_debug_flags_e)~flags;
-            break;
-#endif /*RFC_DEBUG_FLAGS*/
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-        default:
-            return false;
+    if( !rfc_ctx->cycles )
+    {
+        return false;
+    }
+
+    class_count = class_param->count;
+
+    memset( rp, 0, sizeof(rfc_counts_t) * class_count );
+
+    for( i = 0; i < rfc_ctx->cycles_cnt; i++ )
+    {
+        const rfc_cycle_item_s *cycle = &rfc_ctx->cycles[i];
+        double                  from  = ( cycle->from - class_param->offset ) / class_param->width;
+        double                  to    = ( cycle->to   - class_param->offset ) / class_param->width;
+        unsigned                class_from, class_to;
+
+        class_from = ( from < 0.0 ) ? 0 : ( from >= class_count ) ? class_count - 1 : (unsigned)from;
+        class_to   = ( to   < 0.0 ) ? 0 : ( to   >= class_count ) ? class_count - 1 : (unsigned)to;
+
+        rp[ abs( (int)class_from - (int)class_to ) ] += cycle->counts;
     }
 
     return true;
@@ -3552,1860 +4631,6769 @@ bool RFC_flags_unset( void *ctx, int flags, int stack )
 
 
 /**
- * @brief      Get flags
+ * @brief      Calculate the damage from cycles recorded in value domain.
+ *             Amplitudes are taken unquantized.
  *
- * @param      ctx    The rainflow context
- * @param[out] flags  Flag for debugging flags
- * @param[in]  stack  ID of flags stack
+ * @param      ctx     The rainflow context
+ * @param[out] damage  The cumulated damage
  *
  * @return     true on success
  */
-bool RFC_flags_get( const void *ctx, int *flags, int stack )
+bool RFC_cycles_damage( const void *ctx, double *damage )
 {
+    double      D = 0.0;
+    size_t      i;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    switch( stack )
+    if( !damage )
     {
-        case 0:
-            *flags = (int)rfc_ctx->internal.flags;
-            break;
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
-#if RFC_DEBUG_FLAGS
-        case 1:
-            *flags = (int)rfc_ctx->internal.debug_flags;
-            break;
-#endif /*RFC_DEBUG_FLAGS*/
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
 
-        default:
+    if( !rfc_ctx->cycles )
+    {
+        return false;
+    }
+
+    for( i = 0; i < rfc_ctx->cycles_cnt; i++ )
+    {
+        const rfc_cycle_item_s *cycle = &rfc_ctx->cycles[i];
+        double                  D_i;
+
+        if( !damage_calc_amplitude( rfc_ctx, fabs( (double)cycle->from - (double)cycle->to ) / 2, &D_i ) )
+        {
             return false;
+        }
+
+        D += D_i * cycle->counts;
     }
 
+    *damage = D / rfc_ctx->full_inc;
+
     return true;
 }
 
 
 /**
- * @brief      Check flags
+ * @brief      Initialize tracking of the most damaging cycles.
+ *             The cycles are kept in a bounded min-heap, updated on every
+ *             closed cycle. Memory consumption doesn't depend on the
+ *             stream length and no turning point storage is needed.
  *
- * @param      ctx              The rainflow context
- * @param[in]  flags_to_check   flags to test if set
- * @param[in]  stack            ID of flags stack
+ * @param      ctx   The rainflow context
+ * @param      cap   The number of cycles to keep (0 disables tracking)
+ * @param      key   The ranking of cycles (damage or range)
  *
- * @return     true if flags are set
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding!
  */
-bool RFC_flags_check( const void *ctx, int flags_to_check, int stack )
+bool RFC_top_init( void *ctx, size_t cap, rfc_top_key_e key )
 {
+    rfc_top_item_s *top = NULL;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    int flags;
+    if( rfc_ctx->state != RFC_STATE_INIT || key < RFC_TOP_KEY_DAMAGE || key > RFC_TOP_KEY_RANGE )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
-    if( !RFC_flags_get( ctx, &flags, stack ) )
+    if( cap )
     {
-        return false;
+        top = (rfc_top_item_s*)rfc_ctx->mem_alloc( NULL, cap, sizeof(rfc_top_item_s), RFC_MEM_AIM_TOP );
+
+        if( !top )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
     }
 
-    return ( flags & flags_to_check ) == flags_to_check;
+    if( rfc_ctx->top ) rfc_ctx->mem_alloc( rfc_ctx->top, 0, 0, RFC_MEM_AIM_TOP );
+
+    rfc_ctx->top     = top;
+    rfc_ctx->top_cap = cap;
+    rfc_ctx->top_cnt = 0;
+    rfc_ctx->top_key = key;
+
+    return true;
 }
 
 
 /**
- * @brief      Set Woehler curve parameters
+ * @brief      Get the most damaging cycles, in descending order.
  *
- * @param      ctx       The rainflow context
- * @param[in]  wl_param  The Woehler curve parameters
+ * @param      ctx         The rainflow context
+ * @param[out] items       The buffer receiving the cycles
+ * @param[in,out] count    Capacity of items on input, number of cycles on output
  *
  * @return     true on success
  */
-bool RFC_wl_param_set( void *ctx, const rfc_wl_param_s *wl_param )
+bool RFC_top_get( const void *ctx, rfc_top_item_s *items, size_t *count )
 {
+    size_t n;
+
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
-    {
-        return false;
-    }
-    
-    if( !wl_param                        ||
-         rfc_ctx->state < RFC_STATE_INIT )
+    if( !count || ( *count && !items ) )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    rfc_ctx->wl_sx          = wl_param->sx;
-    rfc_ctx->wl_nx          = wl_param->nx;
-    rfc_ctx->wl_k           = wl_param->k;
-    rfc_ctx->wl_q           = wl_param->q;
-    rfc_ctx->wl_sd          = wl_param->sd;
-    rfc_ctx->wl_nd          = wl_param->nd;
-    rfc_ctx->wl_k2          = wl_param->k2;
-    rfc_ctx->wl_q2          = wl_param->q2;
-    rfc_ctx->wl_omission    = wl_param->omission;
-
-    return true;
-}
-
-
-/**
- * @brief      Get Woehler curve parameters
- *
- * @param      ctx       The rainflow context
- * @param[out] wl_param  The Woehler curve parameters
- *
- * @return     true on success
- */
-bool RFC_wl_param_get( const void *ctx, rfc_wl_param_s *wl_param )
-{
-    RFC_CTX_CHECK_AND_ASSIGN
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED || !rfc_ctx->top )
+    {
+        return false;
+    }
 
-    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    if( *count < rfc_ctx->top_cnt )
     {
+        /* Buffer too small, report the needed capacity */
+        *count = rfc_ctx->top_cnt;
         return false;
     }
-    
-    if( !wl_param                        ||
-         rfc_ctx->state < RFC_STATE_INIT )
+
+    n = rfc_ctx->top_cnt;
+
+    if( n )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        memcpy( items, rfc_ctx->top, sizeof(rfc_top_item_s) * n );
+        qsort( items, n, sizeof(rfc_top_item_s), 
+               ( rfc_ctx->top_key == RFC_TOP_KEY_RANGE ) ? top_item_cmp_range : top_item_cmp_damage );
     }
 
-    wl_param->sx            = rfc_ctx->wl_sx;
-    wl_param->nx            = rfc_ctx->wl_nx;
-    wl_param->k             = rfc_ctx->wl_k;
-    wl_param->q             = rfc_ctx->wl_q;
-    wl_param->sd            = rfc_ctx->wl_sd;
-    wl_param->nd            = rfc_ctx->wl_nd;
-    wl_param->q2            = rfc_ctx->wl_q2;
-    wl_param->k2            = rfc_ctx->wl_k2;
-    wl_param->omission      = rfc_ctx->wl_omission;
-    wl_param->D             = 0.0;
+    *count = n;
 
     return true;
 }
-#endif /*!RFC_MINIMAL*/
-
 
 
-#if RFC_AT_SUPPORT
 /**
- * @brief      Amplitude transformation to take mean load influence into
- *             account.
+ * @brief      Enable snapshots for concurrent readers.
+ *             After each feed and on finalizing, damage, position, state,
+ *             rfm and lc are published into one of two buffers, guarded by
+ *             a sequence counter (seqlock). Only tiles of the rfm touched
+ *             since the buffers last publication are copied. Readers never
+ *             block the feeding thread, see RFC_snapshot_get().
  *
- * @param      ctx             The rainflow context
- * @param      Sa              Amplitude
- * @param      Sm              Mean load
- * @param[out] Sa_transformed  Transformed amplitude Sa
+ * @param      ctx     The rainflow context
+ * @param      enable  true to enable, false to disable snapshots
  *
  * @return     true on success
+ * 
+ * @note       Only valid before feeding! Auto resizing is not supported.
+ *             Unsupported, if no memory barrier is known for the compiler.
  */
-bool RFC_at_transform( const void *ctx, double Sa, double Sm, double *Sa_transformed )
+bool RFC_snapshot_init( void *ctx, bool enable )
 {
-    double Sa_transform = Sa;
+    unsigned class_count;
+    unsigned tiles;
+    int      b;
 
     RFC_CTX_CHECK_AND_ASSIGN
 
-    if( !Sa_transformed )
+    if( rfc_ctx->state != RFC_STATE_INIT )
     {
         return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
-    
-    /* Amplitude is always positive */
-    Sa = fabs( Sa );
 
-#if RFC_USE_DELEGATES
-    if( rfc_ctx->at_transform_fcn )
+#if MEMORY_BARRIER_NONE
+    if( enable )
     {
-        return rfc_ctx->at_transform_fcn( rfc_ctx, Sa, Sm, Sa_transformed );
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
     }
-#endif
+#endif /*MEMORY_BARRIER_NONE*/
 
-    if( !rfc_ctx->at.count )
+#if RFC_AR_SUPPORT
+    if( enable && ( rfc_ctx->internal.flags & RFC_FLAGS_AUTORESIZE ) )
     {
-        /* No reference curve given, return original amplitude */
-        *Sa_transformed = Sa;
-        return true;
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
     }
+#endif /*RFC_AR_SUPPORT*/
 
-    if( Sa == 0.0 )
+    snapshot_free( rfc_ctx );
+
+    if( !enable )
     {
-        /* Zero amplitude */
-        Sa_transform = 0.0;
+        return true;
     }
-    else
+
+    class_count = rfc_ctx->class_count;
+    tiles       = class_count ? ( class_count + SNAPSHOT_TILE - 1 ) / SNAPSHOT_TILE : 1;
+
+    for( b = 0; b < 2; b++ )
     {
-        double Sm_norm_base;
-        double Sm_norm_target;
-        double alleviation_base;
-        double alleviation_target;
+        struct snapshot_buf *buf = &rfc_ctx->snapshot[b];
 
-        /* Normalize Sm (Sa=1) */
-        Sm_norm_base = Sm / Sa;
-        if( !at_alleviation( rfc_ctx, Sm_norm_base, &alleviation_base ) )
+        buf->dirty = (unsigned char*)rfc_ctx->mem_alloc( NULL, (size_t)tiles * tiles, sizeof(unsigned char), RFC_MEM_AIM_SNAPSHOT );
+
+        if( rfc_ctx->rfm )
         {
-            return false;
+            buf->rfm = (rfc_counts_t*)rfc_ctx->mem_alloc( NULL, (size_t)class_count * class_count, sizeof(rfc_counts_t), RFC_MEM_AIM_SNAPSHOT );
         }
 
-        if( rfc_ctx->at.R_pinned )
+        if( rfc_ctx->lc )
         {
-            /* Calculate intersection of R slope and M slope */
-            if( !at_R_to_Sm_norm( rfc_ctx, rfc_ctx->at.R_rig, &Sm_norm_target ) )
-            {
-                return false;
-            }
-
-            if( !at_alleviation( rfc_ctx, Sm_norm_target, &alleviation_target ) )
-            {
-                return false;
-            }
-
-            Sa_transform = Sa / alleviation_base * alleviation_target;
+            buf->lc = (rfc_counts_t*)rfc_ctx->mem_alloc( NULL, class_count, sizeof(rfc_counts_t), RFC_MEM_AIM_SNAPSHOT );
         }
-        else
-        {
-            /* Calculate intersection of mean load on test rig (Sm_rig) with curve taken from Haigh diagram */
-            const double   *Sa_   = rfc_ctx->at.Sa;
-            const double   *Sm_   = rfc_ctx->at.Sm;
-                  unsigned  count = rfc_ctx->at.count;
-                  unsigned  n;
-                  double    Sa_lhs, Sa_rhs;
-                  double    Sm_lhs, Sm_rhs;
-
-            /* Check each segment from the reference curve */
-            for( n = 0; n <= count; n++ )
-            {
-                if( n )
-                {
-                    Sa_lhs = Sa_rhs;
-                    Sm_lhs = Sm_rhs;
 
-                    if( n < count )
-                    {
-                        if( !at_alleviation( rfc_ctx, Sm_[n] / Sa_[n], &alleviation_target ) )
-                        {
-                            return false;
-                        }
+        if( !buf->dirty || ( rfc_ctx->rfm && !buf->rfm ) || ( rfc_ctx->lc && !buf->lc ) )
+        {
+            snapshot_free( rfc_ctx );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
 
-                        /* Next segment */
-                        Sa_rhs = Sa / alleviation_base * alleviation_target;
-                        Sm_rhs = Sa_rhs / Sa_[n] * Sm_[n];
-                    }
-                    else
-                    {
-                        /* Last segment */
-                        assert( Sm_lhs <= rfc_ctx->at.Sm_rig );
+        /* Buffers are copied completely on their first publication */
+        memset( buf->dirty, 1, (size_t)tiles * tiles );
+    }
 
-                        Sa_transform = Sa_lhs;
-                    }
-                }
-                else /* n == 0 */
-                {
-                    if( !at_alleviation( rfc_ctx, Sm_[0] / Sa_[0], &alleviation_target ) )
-                    {
-                        return false;
-                    }
+    rfc_ctx->snapshot_tiles   = tiles;
+    rfc_ctx->snapshot_rfm_rev = rfc_ctx->rfm_rev;
 
-                    /* First segment */
-                    Sa_rhs = Sa / alleviation_base * alleviation_target;
-                    Sm_rhs = Sa_rhs / Sa_[0] * Sm_[0];
+    /* Readers get valid results from now on */
+    snapshot_publish( rfc_ctx );
 
-                    if( rfc_ctx->at.Sm_rig <= Sm_rhs)
-                    {
-                        Sa_transform = Sa_rhs;
-                        break;
-                    }
-                    else continue;
-                }
+    return true;
+}
 
-                /* Interpolate intermediate points */
-                if( Sm_lhs <= rfc_ctx->at.Sm_rig && rfc_ctx->at.Sm_rig <= Sm_rhs )
-                {
-                    double frac, denom;
 
-                    denom = Sm_rhs - Sm_lhs;
+/**
+ * @brief      Get a consistent snapshot of results, while another thread
+ *             may feed the context. Reading is retried, if the feeding
+ *             thread has overtaken the reader.
+ *
+ * @param      ctx       The rainflow context
+ * @param[out] snapshot  The scalar results, may be NULL
+ * @param[out] rfm       The rainflow matrix (class_count^2 values), may be NULL
+ * @param[out] lc        The level crossings (class_count values), may be NULL
+ *
+ * @return     true on success
+ * 
+ * @note       Doesn't raise errors, since the context is owned by the
+ *             feeding thread.
+ */
+bool RFC_snapshot_get( const void *ctx, rfc_snapshot_s *snapshot, rfc_counts_t *rfm, rfc_counts_t *lc )
+{
+    size_t class_count;
 
-                    frac = ( denom < 1e-20 ) ? 1.0 : ( ( rfc_ctx->at.Sm_rig - Sm_lhs ) / denom );
+    RFC_CTX_CHECK_AND_ASSIGN
 
-                    Sa_transform = Sa_lhs * ( 1.0 - frac ) + Sa_rhs * frac;
-                    break;
-                }
-            }
-        }
+    if( !rfc_ctx->snapshot_tiles || ( rfm && !rfc_ctx->snapshot[0].rfm ) || ( lc && !rfc_ctx->snapshot[0].lc ) )
+    {
+        return false;
     }
 
-    *Sa_transformed = Sa_transform;
+    class_count = rfc_ctx->class_count;
 
-    return true;
-}
-#endif /*RFC_AT_SUPPORT*/
+    for(;;)
+    {
+        const struct snapshot_buf *buf;
+        size_t                     epoch, seq;
 
-#if RFC_DEBUG_FLAGS
-int RFC_debug_fprintf( void *ctx, FILE *stream, const char *fmt, ... )
-{
-    int result;
-    va_list arg;
+        epoch = rfc_ctx->snapshot_epoch;
+        MEMORY_BARRIER();
+        buf   = &rfc_ctx->snapshot[ epoch & 1 ];
+        seq   = buf->seq;
+        MEMORY_BARRIER();
 
-    RFC_CTX_CHECK_AND_ASSIGN
+        if( seq & 1 )
+        {
+            /* Writer is busy with this buffer */
+            continue;
+        }
 
-    va_start( arg, fmt );
+        if( snapshot ) *snapshot = buf->scalars;
+        if( rfm )      memcpy( rfm, buf->rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        if( lc )       memcpy( lc,  buf->lc,  sizeof(rfc_counts_t) * class_count );
 
-#if RFC_USE_DELEGATES
-    if( rfc_ctx->debug_vfprintf_fcn )
-    {
-        result = rfc_ctx->debug_vfprintf_fcn( rfc_ctx, stream, fmt, arg );
-    }
-    else
-#endif /*RFC_USE_DELEGATES*/
-    {
-        result = vfprintf( stream, fmt, arg );
-    }
+        MEMORY_BARRIER();
 
-    va_end( arg );
+        if( buf->seq == seq )
+        {
+            break;
+        }
+    }
 
-    return result;
+    return true;
 }
-#endif /*RFC_DEBUG_FLAGS*/
-
 
 
+/**
+ * @brief      Get the size of a result region for the current context.
+ *
+ * @param      ctx   The rainflow context
+ * @param[out] size  The size in bytes
+ *
+ * @return     true on success
+ */
+bool RFC_region_size( const void *ctx, size_t *size )
+{
+    size_t class_count;
+    size_t n;
 
+    RFC_CTX_CHECK_AND_ASSIGN
 
+    if( !size )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
 
+    class_count = rfc_ctx->class_count;
+    n           = ( sizeof(rfc_region_header_s) + sizeof(double) - 1 ) / sizeof(double) * sizeof(double);
 
+    if( rfc_ctx->rfm ) n += sizeof(rfc_counts_t) * class_count * class_count;
+    if( rfc_ctx->rp )  n += sizeof(rfc_counts_t) * class_count;
+    if( rfc_ctx->lc )  n += sizeof(rfc_counts_t) * class_count;
 
+    *size = n;
 
+    return true;
+}
 
-/*** Implementation static functions ***/
 
-#if RFC_AT_SUPPORT
 /**
- * @brief      Clear all data for amplitude transformation
+ * @brief      Attach a result region. After each feed and on finalizing,
+ *             damage, position, state, residue summary, rfm, rp and lc are
+ *             published into the region, guarded by a sequence counter in
+ *             its header. Placed in memory shared between processes (see
+ *             RFC_shm_create()), consumers read the results in place.
  *
- * @param      rfc_ctx  The rainflow context
+ * @param      ctx     The rainflow context
+ * @param      region  The region (aligned to double), NULL to detach
+ * @param      size    The size of the region in bytes, see RFC_region_size()
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Auto resizing is not supported.
+ *             The context doesn't take ownership of the region.
+ *             Unsupported, if no memory barrier is known for the compiler.
  */
-static
-void clear_at( rfc_ctx_s *rfc_ctx )
+bool RFC_region_attach( void *ctx, void *region, size_t size )
 {
-    assert( rfc_ctx );
+    rfc_region_header_s *header = (rfc_region_header_s*)region;
+    unsigned             class_count;
+    unsigned             tiles;
+    size_t               needed;
+    size_t               offset;
 
-    rfc_ctx->at.Sa                      = NULL;
-    rfc_ctx->at.Sm                      = NULL;
-    rfc_ctx->at.count                   = 0;
-    rfc_ctx->at.M                       = 0.0;
-    rfc_ctx->at.Sm_rig                  = 0.0;
-    rfc_ctx->at.R_rig                   = 0.0;
-    rfc_ctx->at.R_pinned                = false;
-
-    rfc_ctx->internal.at_haigh.count    = 0;
-
-}
-#endif /*RFC_AT_SUPPORT*/
-
-
-#if RFC_DAMAGE_FAST
-static
-void clear_lut( rfc_ctx_s *rfc_ctx )
-{
-    assert( rfc_ctx && rfc_ctx->state >= RFC_STATE_INIT );
+    RFC_CTX_CHECK_AND_ASSIGN
 
-    if( rfc_ctx->damage_lut )
+    if( rfc_ctx->state != RFC_STATE_INIT )
     {
-        memset( rfc_ctx->damage_lut, 0, sizeof(double) * rfc_ctx->class_count * rfc_ctx->class_count );
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
-    rfc_ctx->damage_lut_inapt = 1;
 
-#if RFC_AT_SUPPORT
-    if( rfc_ctx->amplitude_lut )
+#if MEMORY_BARRIER_NONE
+    if( region )
     {
-        memset( rfc_ctx->amplitude_lut, 0, sizeof(double) * rfc_ctx->class_count * rfc_ctx->class_count );
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
     }
-#endif /*RFC_AT_SUPPORT*/
-}
-#endif /*RFC_DH_SUPPORT*/
-
+#endif /*MEMORY_BARRIER_NONE*/
 
 #if RFC_AR_SUPPORT
-static
-bool autoresize( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s* pt )
-{
-    unsigned     cls             = QUANTIZE( rfc_ctx, pt->value );
-    unsigned     class_count     = rfc_ctx->class_count,
-                 class_count_old = class_count,
-                 class_shift     = 0;
-    rfc_value_t  class_offset    = rfc_ctx->class_offset;
-    void        *ptr;
-    size_t       i, j;
+    if( region && ( rfc_ctx->internal.flags & RFC_FLAGS_AUTORESIZE ) )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_AR_SUPPORT*/
 
-    if( pt->value < rfc_ctx->class_offset )
+    region_free( rfc_ctx );
+
+    if( !region )
     {
-        class_shift   = (unsigned)ceil( ( class_offset - (rfc_value_t)(pt->value) ) / rfc_ctx->class_width + 0.5 );
-        class_count  += class_shift;
-        class_offset -= rfc_ctx->class_width * class_shift;
+        return true;
     }
-    else if( pt->cls >= class_count )
+
+    if( !RFC_region_size( rfc_ctx, &needed ) )
     {
-        class_count = (unsigned)ceil( ( (rfc_value_t)(pt->value) - class_offset ) / rfc_ctx->class_width + 0.5 );
+        return false;
     }
-    else
+
+    if( size < needed || (size_t)region % sizeof(double) )
     {
-        return true;
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
 
-    if( class_count > RFC_CLASS_COUNT_MAX )
+    class_count = rfc_ctx->class_count;
+    tiles       = class_count ? ( class_count + SNAPSHOT_TILE - 1 ) / SNAPSHOT_TILE : 1;
+
+    rfc_ctx->region_dirty = (unsigned char*)rfc_ctx->mem_alloc( NULL, (size_t)tiles * tiles, sizeof(unsigned char), RFC_MEM_AIM_REGION );
+
+    if( !rfc_ctx->region_dirty )
     {
         return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
     }
 
-    rfc_ctx->class_count  = class_count;
-    rfc_ctx->class_offset = class_offset;
+    /* The region is copied completely on its first publication */
+    memset( rfc_ctx->region_dirty, 1, (size_t)tiles * tiles );
+    memset( region, 0, needed );
 
-    pt->cls = QUANTIZE( rfc_ctx, pt->value );
+    offset = ( sizeof(rfc_region_header_s) + sizeof(double) - 1 ) / sizeof(double) * sizeof(double);
 
-#if RFC_DAMAGE_FAST
-    {
-        rfc_state_e old_state = rfc_ctx->state;
+    header->magic        = RFC_REGION_MAGIC;
+    header->version      = RFC_REGION_VERSION;
+    header->header_size  = (unsigned)sizeof(rfc_region_header_s);
+    header->counts_size  = (unsigned)sizeof(rfc_counts_t);
+    header->size         = needed;
+    header->class_count  = class_count;
+    header->class_width  = rfc_ctx->class_width;
+    header->class_offset = rfc_ctx->class_offset;
 
-        if( rfc_ctx->damage_lut )
-        {
-            ptr = rfc_ctx->mem_alloc( rfc_ctx->damage_lut, class_count * class_count, 
-                                      sizeof(double), RFC_MEM_AIM_DLUT );
-            if( !ptr )
-            {
-                rfc_ctx->state = old_state;
-                return false;
-            }
-            else
-            {
-                rfc_ctx->damage_lut       = (double*)ptr;
-                rfc_ctx->damage_lut_inapt = 1;
-            }
-        }
+    if( rfc_ctx->rfm )
+    {
+        header->rfm_offset = offset;
+        offset += sizeof(rfc_counts_t) * class_count * class_count;
+    }
 
-#if RFC_AT_SUPPORT
-        if( rfc_ctx->amplitude_lut )
-        {
-            ptr = rfc_ctx->mem_alloc( rfc_ctx->amplitude_lut, class_count * class_count, 
-                                      sizeof(double), RFC_MEM_AIM_ALUT );
-            if( !ptr )
-            {
-                rfc_ctx->state = old_state;
-                return false;
-            }
-            else
-            {
-                rfc_ctx->amplitude_lut = (double*)ptr;
-            }
-        }
-#endif /*RFC_AT_SUPPORT*/
-    
-        rfc_ctx->state = RFC_STATE_INIT;
-        damage_lut_init( rfc_ctx );
-        rfc_ctx->state = old_state;
+    if( rfc_ctx->rp )
+    {
+        header->rp_offset = offset;
+        offset += sizeof(rfc_counts_t) * class_count;
     }
-#endif /*RFC_DAMAGE_FAST*/
 
-    if( rfc_ctx->residue )
+    if( rfc_ctx->lc )
     {
-        size_t residue_cap = 2 * class_count + 1;
+        header->lc_offset = offset;
+    }
 
-        ptr = rfc_ctx->mem_alloc( rfc_ctx->residue, residue_cap, 
-                                  sizeof( rfc_value_tuple_s ), RFC_MEM_AIM_RESIDUE );
+    rfc_ctx->region         = header;
+    rfc_ctx->region_tiles   = tiles;
+    rfc_ctx->region_rfm_rev = rfc_ctx->rfm_rev;
 
-        if( !ptr )
-        {
-            return false;
-        }
+    /* Readers get valid results from now on */
+    region_publish( rfc_ctx );
 
-        rfc_ctx->residue     = (rfc_value_tuple_s*)ptr;
-        rfc_ctx->residue_cap = residue_cap;
+    return true;
+}
 
-        /* Residuum */
-        for( i = 0; i < rfc_ctx->residue_cnt; i++ )
-        {
-            rfc_ctx->residue[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->residue[i].value );
-        }
-    }
 
-    for( i = 0; i < rfc_ctx->internal.residue_cap; i++ )
+/**
+ * @brief      Begin reading a result region. Arrays are read in place,
+ *             the results are consistent, if RFC_region_read_end() succeeds
+ *             with the same sequence number afterwards.
+ *
+ * @param      region  The region
+ * @param[out] seq     The sequence number
+ *
+ * @return     false, if the region is invalid or the writer is busy
+ * 
+ * @note       No context involved, may be called from another process.
+ */
+bool RFC_region_read_begin( const void *region, size_t *seq )
+{
+    const rfc_region_header_s *header = (const rfc_region_header_s*)region;
+
+    if( !header || !seq || header->magic != RFC_REGION_MAGIC || header->version != RFC_REGION_VERSION ||
+        header->header_size != sizeof(rfc_region_header_s) || header->counts_size != sizeof(rfc_counts_t) )
     {
-        rfc_ctx->internal.residue[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.residue[i].value );
+        return false;
     }
 
-    /* RFM */
-    if( rfc_ctx->rfm )
-    {
-        ptr = rfc_ctx->mem_alloc( NULL, class_count * class_count, 
-                                  sizeof(rfc_counts_t), RFC_MEM_AIM_MATRIX );    
-        if( !ptr )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-        }
-        else
-        {
-            rfc_counts_t *rfm = (rfc_counts_t*)ptr;
+    *seq = header->seq;
+    MEMORY_BARRIER();
 
-            for( i = 0; i < class_count_old; i++ )
-            {
-                for( j = 0; j < class_count_old; j++ )
-                {
-                    rfm[ MAT_OFFS( i + class_shift, j + class_shift ) ] = rfc_ctx->rfm[ i * class_count_old + j ];
-                }
-            }
+    return !( *seq & 1 );
+}
 
-            ptr = rfc_ctx->rfm;
-            rfc_ctx->rfm = rfm;
-            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_MATRIX );
-        }
-    }
 
-#if !RFC_MINIMAL
-    /* LC */
-    if( rfc_ctx->lc )
+/**
+ * @brief      End reading a result region.
+ *
+ * @param      region  The region
+ * @param      seq     The sequence number from RFC_region_read_begin()
+ *
+ * @return     true, if the results read are consistent
+ */
+bool RFC_region_read_end( const void *region, size_t seq )
+{
+    const rfc_region_header_s *header = (const rfc_region_header_s*)region;
+
+    if( !header )
     {
-        ptr = rfc_ctx->mem_alloc( NULL, class_count,
-                                  sizeof(rfc_counts_t), RFC_MEM_AIM_LC );
-        if( !ptr )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-        }
-        else
-        {
-            rfc_counts_t* lc = (rfc_counts_t*)ptr;
+        return false;
+    }
 
-            for( i = 0; i < class_count_old; i++ )
-            {
-                lc[i + class_shift] = rfc_ctx->lc[i];
-            }
+    MEMORY_BARRIER();
 
-            ptr = rfc_ctx->lc;
-            rfc_ctx->lc = lc;
-            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_LC );
-        }
+    return header->seq == seq;
+}
 
-        /* RP */
-        ptr = rfc_ctx->mem_alloc( NULL, class_count,
-                                  sizeof(rfc_counts_t), RFC_MEM_AIM_RP );
-        if( !ptr )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-        }
-        else
-        {
-            rfc_counts_t* rp = (rfc_counts_t*)ptr;
 
-            for( i = 0; i < class_count_old; i++ )
-            {
-                rp[i] = rfc_ctx->rp[i];
-            }
+#if RFC_SHM_SUPPORT
+/**
+ * @brief      Create a POSIX shared memory segment and attach it as result
+ *             region, see RFC_region_attach(). The segment is unlinked
+ *             when detached or on deinitialization.
+ *
+ * @param      ctx   The rainflow context
+ * @param      name  The name of the segment (e.g. "/rfc_results")
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Fails with RFC_ERROR_SHM, if a
+ *             segment of that name already exists.
+ */
+bool RFC_shm_create( void *ctx, const char *name )
+{
+    size_t  size;
+    char   *name_copy;
+    void   *region;
+    int     fd;
 
-            ptr = rfc_ctx->rp;
-            rfc_ctx->rp = rp;
-            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_RP );
-        }
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !name || rfc_ctx->state != RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
     }
-#endif /*!RFC_MINIMAL*/
 
-#if RFC_TP_SUPPORT
-    /* RFC_STATE_BUSY_INTERIM affects residue only */
-    for( i = 0; i < rfc_ctx->tp_cnt; i++ )
+    region_free( rfc_ctx );
+
+    if( !RFC_region_size( rfc_ctx, &size ) )
     {
-#if RFC_USE_DELEGATES
-        if( rfc_ctx->tp_get_fcn || rfc_ctx->tp_set_fcn )
-        {
-            rfc_value_tuple_s *pt;
+        return false;
+    }
 
-            tp_get( rfc_ctx, i + 1, &pt );  /* tp_pos is base 1 */
-            pt->cls = QUANTIZE( rfc_ctx, pt->value );
-            tp_set( rfc_ctx, i + 1, pt );  /* tp_pos is base 1 */
-        }
-#else /*!RFC_USE_DELEGATES*/
-        rfc_ctx->tp[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->tp[i].value );
-#endif /*RFC_USE_DELEGATES*/
+    name_copy = (char*)rfc_ctx->mem_alloc( NULL, strlen( name ) + 1, sizeof(char), RFC_MEM_AIM_REGION );
+
+    if( !name_copy )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
     }
 
-    rfc_ctx->internal.margin[0].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.margin[0].value );
-    rfc_ctx->internal.margin[1].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.margin[1].value );
+    strcpy( name_copy, name );
 
-#endif /*RFC_TP_SUPPORT*/
+    /* Never take over (and truncate) a segment of another owner */
+    fd = shm_open( name, O_CREAT | O_EXCL | O_RDWR, 0644 );
 
-#if RFC_GLOBAL_EXTREMA
-    rfc_ctx->internal.extrema[0].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.extrema[0].value );
-    rfc_ctx->internal.extrema[1].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.extrema[1].value );
-#endif /*RFC_GLOBAL_EXTREMA*/
+    if( fd < 0 )
+    {
+        rfc_ctx->mem_alloc( name_copy, 0, 0, RFC_MEM_AIM_REGION );
+        return error_raise( rfc_ctx, RFC_ERROR_SHM );
+    }
+
+    region = ( ftruncate( fd, (off_t)size ) == 0 ) ? mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) : MAP_FAILED;
+
+    /* The mapping persists without descriptor */
+    close( fd );
+
+    if( region == MAP_FAILED )
+    {
+        shm_unlink( name );
+        rfc_ctx->mem_alloc( name_copy, 0, 0, RFC_MEM_AIM_REGION );
+        return error_raise( rfc_ctx, RFC_ERROR_SHM );
+    }
+
+    if( !RFC_region_attach( rfc_ctx, region, size ) )
+    {
+        munmap( region, size );
+        shm_unlink( name );
+        rfc_ctx->mem_alloc( name_copy, 0, 0, RFC_MEM_AIM_REGION );
+        return false;
+    }
+
+    rfc_ctx->region_shm_name = name_copy;
+
+    return true;
+}
+
+
+/**
+ * @brief      Map a result region, published in a POSIX shared memory
+ *             segment, read-only.
+ *
+ * @param      name    The name of the segment
+ * @param[out] region  The region
+ * @param[out] size    The size of the region in bytes
+ *
+ * @return     true on success
+ * 
+ * @note       No context involved, may be called from another process.
+ *             Unmap the region by RFC_shm_close().
+ */
+bool RFC_shm_open( const char *name, const void **region, size_t *size )
+{
+    struct stat st;
+    void       *mapped;
+    int         fd;
+
+    if( !name || !region || !size )
+    {
+        return false;
+    }
+
+    fd = shm_open( name, O_RDONLY, 0 );
+
+    if( fd < 0 )
+    {
+        return false;
+    }
+
+    if( fstat( fd, &st ) != 0 || (size_t)st.st_size < sizeof(rfc_region_header_s) )
+    {
+        close( fd );
+        return false;
+    }
+
+    mapped = mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+
+    if( mapped == MAP_FAILED )
+    {
+        return false;
+    }
+
+    if( ((const rfc_region_header_s*)mapped)->magic != RFC_REGION_MAGIC )
+    {
+        munmap( mapped, (size_t)st.st_size );
+        return false;
+    }
+
+    *region = mapped;
+    *size   = (size_t)st.st_size;
+
+    return true;
+}
+
+
+/**
+ * @brief      Unmap a result region, mapped by RFC_shm_open().
+ *
+ * @param      region  The region
+ * @param      size    The size of the region in bytes
+ *
+ * @return     true on success
+ */
+bool RFC_shm_close( const void *region, size_t size )
+{
+    return region && munmap( (void*)region, size ) == 0;
+}
+#endif /*RFC_SHM_SUPPORT*/
+
+
+/**
+ * @brief      Initialize a multiplexer of streams. Contexts are allocated
+ *             in one arena, initialize each by RFC_init( RFC_mux_ctx( mux, i ), ... ).
+ *             Streams are independent, threads of a fixed worker pool may
+ *             push and flush disjoint sets of streams concurrently, which
+ *             keeps the order within each stream. Assign a contiguous range
+ *             of streams to each worker (as RFC_mux_flush() takes them):
+ *             Contexts, buffers and counters of adjacent streams share cache
+ *             lines, interleaved assignment (e.g. stream % workers) causes
+ *             false sharing.
+ *             Contexts with damage history (RFC_dh_init()) are not supported,
+ *             since batches are fed from the packet buffers.
+ *
+ * @param      mux           The multiplexer
+ * @param      stream_count  The number of streams
+ * @param      batch_size    The capacity of each packet buffer (number of values)
+ *
+ * @return     true on success
+ */
+bool RFC_mux_init( rfc_mux_s *mux, unsigned stream_count, unsigned batch_size )
+{
+    unsigned i;
+
+    if( !mux || mux->version != sizeof(rfc_mux_s) || mux->ctx || !stream_count || !batch_size )
+    {
+        return false;
+    }
+
+    if( !mux->mem_alloc )
+    {
+        mux->mem_alloc = mem_alloc;
+    }
+
+    mux->ctx        = (rfc_ctx_s*)mux->mem_alloc( NULL, stream_count, sizeof(rfc_ctx_s), RFC_MEM_AIM_MUX );
+    mux->buffer     = (rfc_value_t*)mux->mem_alloc( NULL, (size_t)stream_count * batch_size, sizeof(rfc_value_t), RFC_MEM_AIM_MUX );
+    mux->buffer_cnt = (unsigned*)mux->mem_alloc( NULL, stream_count, sizeof(unsigned), RFC_MEM_AIM_MUX );
+
+    if( !mux->ctx || !mux->buffer || !mux->buffer_cnt )
+    {
+        if( mux->ctx )        mux->mem_alloc( mux->ctx,        0, 0, RFC_MEM_AIM_MUX );
+        if( mux->buffer )     mux->mem_alloc( mux->buffer,     0, 0, RFC_MEM_AIM_MUX );
+        if( mux->buffer_cnt ) mux->mem_alloc( mux->buffer_cnt, 0, 0, RFC_MEM_AIM_MUX );
+
+        mux->ctx        = NULL;
+        mux->buffer     = NULL;
+        mux->buffer_cnt = NULL;
+
+        return false;
+    }
+
+    memset( mux->ctx, 0, sizeof(rfc_ctx_s) * stream_count );
+
+    for( i = 0; i < stream_count; i++ )
+    {
+        mux->ctx[i].version   = sizeof(rfc_ctx_s);
+        mux->ctx[i].mem_alloc = mux->mem_alloc;
+        mux->buffer_cnt[i]    = 0;
+    }
+
+    mux->stream_count = stream_count;
+    mux->batch_size   = batch_size;
+
+    return true;
+}
+
+
+/**
+ * @brief      Deinitialize a multiplexer, deinitializes all contexts.
+ *             Buffered values, not flushed yet, are discarded.
+ *
+ * @param      mux   The multiplexer
+ *
+ * @return     true on success
+ */
+bool RFC_mux_deinit( rfc_mux_s *mux )
+{
+    unsigned i;
+
+    if( !mux || mux->version != sizeof(rfc_mux_s) || !mux->ctx )
+    {
+        return false;
+    }
+
+    for( i = 0; i < mux->stream_count; i++ )
+    {
+        if( mux->ctx[i].state >= RFC_STATE_INIT )
+        {
+            RFC_deinit( &mux->ctx[i] );
+        }
+    }
+
+    mux->mem_alloc( mux->ctx,        0, 0, RFC_MEM_AIM_MUX );
+    mux->mem_alloc( mux->buffer,     0, 0, RFC_MEM_AIM_MUX );
+    mux->mem_alloc( mux->buffer_cnt, 0, 0, RFC_MEM_AIM_MUX );
+
+    mux->ctx          = NULL;
+    mux->buffer       = NULL;
+    mux->buffer_cnt   = NULL;
+    mux->stream_count = 0;
+    mux->batch_size   = 0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get the rainflow context of a stream.
+ *
+ * @param      mux     The multiplexer
+ * @param      stream  The stream index, base 0
+ *
+ * @return     The rainflow context or NULL on invalid arguments
+ */
+void * RFC_mux_ctx( rfc_mux_s *mux, unsigned stream )
+{
+    if( !mux || !mux->ctx || stream >= mux->stream_count )
+    {
+        return NULL;
+    }
+
+    return &mux->ctx[stream];
+}
+
+
+/**
+ * @brief      Push a packet of a stream. Values are buffered and fed, as
+ *             soon as the buffer of the stream is full. Packets larger than
+ *             the buffer are fed directly.
+ *
+ * @param      mux     The multiplexer
+ * @param      stream  The stream index, base 0
+ * @param      data    The data
+ * @param      count   The number of values
+ *
+ * @return     true on success, see the context of the stream on errors
+ */
+bool RFC_mux_push( rfc_mux_s *mux, unsigned stream, const rfc_value_t *data, size_t count )
+{
+    rfc_ctx_s   *rfc_ctx;
+    rfc_value_t *buffer;
+    unsigned    *buffer_cnt;
+    unsigned     batch_size;
+
+    if( !mux || !mux->ctx || stream >= mux->stream_count || ( !data && count ) )
+    {
+        return false;
+    }
+
+    rfc_ctx    = &mux->ctx[stream];
+    batch_size = mux->batch_size;
+    buffer     = mux->buffer + (size_t)stream * batch_size;
+    buffer_cnt = &mux->buffer_cnt[stream];
+
+    while( count )
+    {
+        size_t n;
+
+        if( !*buffer_cnt && count >= batch_size )
+        {
+            /* Nothing pending, feed without copy */
+            return mux_feed( rfc_ctx, data, count );
+        }
+
+        n = batch_size - *buffer_cnt;
+        if( n > count ) n = count;
+
+        memcpy( buffer + *buffer_cnt, data, sizeof(rfc_value_t) * n );
+        *buffer_cnt += (unsigned)n;
+        data        += n;
+        count       -= n;
+
+        if( *buffer_cnt == batch_size )
+        {
+            /* Hot stream, feed a whole batch */
+            *buffer_cnt = 0;
+
+            if( !mux_feed( rfc_ctx, buffer, batch_size ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Feed the values buffered for a range of streams.
+ *
+ * @param      mux     The multiplexer
+ * @param      first   The first stream index, base 0
+ * @param      count   The number of streams
+ *
+ * @return     true on success, false if any stream failed
+ */
+bool RFC_mux_flush( rfc_mux_s *mux, unsigned first, unsigned count )
+{
+    bool     ok = true;
+    unsigned i;
+
+    if( !mux || !mux->ctx || first > mux->stream_count || count > mux->stream_count - first )
+    {
+        return false;
+    }
+
+    for( i = first; i < first + count; i++ )
+    {
+        unsigned n = mux->buffer_cnt[i];
+
+        if( n )
+        {
+            mux->buffer_cnt[i] = 0;
+
+            if( !mux_feed( &mux->ctx[i], mux->buffer + (size_t)i * mux->batch_size, n ) )
+            {
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+
+/**
+ * @brief      Add a follower. Turning points found by the context (the
+ *             leader) are passed to its followers, which count them by
+ *             their own counting method, residue and results. Thus several
+ *             counting methods share one hysteresis filtering pass.
+ *             Finalizing the leader finalizes its followers likewise.
+ *
+ * @param      ctx       The rainflow context (leader)
+ * @param      follower  The follower, an initialized rainflow context
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Class parameters of leader and
+ *             follower must be identical, auto resizing is not supported.
+ *             Don't feed followers directly. The leader doesn't take
+ *             ownership of its followers, release them after the leader.
+ *             Followers can't enforce margins, and damage history
+ *             spread methods reading the input stream (RFC_SD_TRANSIENT_23,
+ *             RFC_SD_TRANSIENT_23c) are not supported for followers.
+ */
+bool RFC_follower_add( void *ctx, void *follower )
+{
+    rfc_ctx_s *rfc_follower = (rfc_ctx_s*)follower;
+    void     **followers;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( !rfc_follower || rfc_follower == rfc_ctx || rfc_follower->version != sizeof(rfc_ctx_s) || 
+        rfc_follower->state != RFC_STATE_INIT || rfc_follower->follower_cnt )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_follower->class_count  != rfc_ctx->class_count  ||
+        rfc_follower->class_width  != rfc_ctx->class_width  ||
+        rfc_follower->class_offset != rfc_ctx->class_offset )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+#if RFC_AR_SUPPORT
+    if( ( rfc_ctx->internal.flags | rfc_follower->internal.flags ) & RFC_FLAGS_AUTORESIZE )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_AR_SUPPORT*/
+
+#if RFC_TP_SUPPORT
+    /* Margins are the leader's business */
+    if( rfc_follower->internal.flags & RFC_FLAGS_ENFORCE_MARGIN )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_TP_SUPPORT*/
+
+#if RFC_DH_SUPPORT
+    /* Followers don't see the input stream */
+    if( rfc_follower->dh && ( rfc_follower->spread_damage_method == RFC_SD_TRANSIENT_23 || 
+                              rfc_follower->spread_damage_method == RFC_SD_TRANSIENT_23c ) )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    followers = (void**)rfc_ctx->mem_alloc( rfc_ctx->followers, rfc_ctx->follower_cnt + 1, sizeof(void*), RFC_MEM_AIM_FOLLOWERS );
+
+    if( !followers )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+
+    followers[rfc_ctx->follower_cnt++] = follower;
+    rfc_ctx->followers = followers;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get level crossing histogram
+ *
+ * @param      ctx    The rainflow context
+ * @param[out] lc     The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
+ * @param[out] level  The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ *
+ * @return     true on success
+ */
+bool RFC_lc_get( const void *ctx, rfc_counts_t *lc, rfc_value_t *level )
+{
+    unsigned i;
+    unsigned class_count;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !lc )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rfc_ctx->lc || !lc || !class_count )
+    {
+        return false;
+    }
+
+    for( i = 0; i < class_count; i++ )
+    {
+        lc[i] = rfc_ctx->lc[i];
+
+        if( level )
+        {
+            level[i] = CLASS_UPPER( rfc_ctx, i );
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Create level crossing histogram from rainflow matrix
+ *
+ * @param      ctx     The rainflow context
+ * @param[out] lc      The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
+ * @param[out] level   The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param[in]  rfm     The input rainflow matrix to use instead of ctx rfm, may be NULL
+ * @param      flags   The flags
+ *
+ * @return     true on success
+ * @note       Returned lc usually differs from .lc, when counting is finalized with any flag other than RFC_RES_NONE!
+ */
+bool RFC_lc_from_rfm( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_counts_t *rfm, rfc_flags_e flags )
+{
+    unsigned             from, to, i;
+    unsigned             class_count;
+    bool                 up = flags & RFC_FLAGS_COUNT_LC_UP;
+    bool                 dn = flags & RFC_FLAGS_COUNT_LC_DN;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !lc )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfm )
+    {
+        rfm = rfc_ctx->rfm;
+    }
+
+    class_count = rfc_ctx->class_count;
+    
+    if( !rfm || !class_count )
+    {
+        return false;
+    }
+
+    memset( lc, 0, sizeof(rfc_counts_t) * class_count );
+
+    for( i = 0; i < class_count; i++ ) 
+    {
+        rfc_counts_t sum = 0;
+
+        /* First index (0) counts crossings of upper class limit of the first class */
+        if( level )
+        {
+            level[i] = CLASS_UPPER( rfc_ctx, i );
+        }
+        
+        for( from = 0; from <= i; from++ )
+        {
+            for( to = i + 1; to < class_count; to++ )
+            {
+                /* One closed cycle has always a rising and a falling slope */
+                 
+                if( up )
+                {
+                    /* Count rising slopes */
+                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
+                    sum += rfm[ MAT_OFFS( from, to ) ];
+
+                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
+                    sum += rfm[ MAT_OFFS( to, from ) ];
+                }
+                if( dn )
+                {
+                    /* Count falling slopes */
+                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
+                    sum += rfm[ MAT_OFFS( from, to ) ];
+
+                    assert( sum < RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( from, to ) ] );
+                    sum += rfm[ MAT_OFFS( to, from ) ];
+                }
+            }
+        }
+
+        lc[i] = sum;
+    }
+
+    return true;
+}
+
+
+/**
+ * Calculate level crossing counts from rainflow matrix, write results to lc
+ * histogram buffer.
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] lc           The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
+ * @param[out] level        The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param[in]  residue      The residue to use instead of ctx residue (may be NULL)
+ * @param[in]  residue_cnt  The length of the residue
+ * @param      flags        The flags
+ *
+ * @return     true on success
+ */
+bool RFC_lc_from_residue( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_value_t* residue, unsigned residue_cnt, rfc_flags_e flags )
+{
+    rfc_value_tuple_s* residue_tuples;
+    unsigned i;
+    bool result;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !residue || !residue_cnt )
+    {
+        return RFC_lc_from_residue_tuples( ctx, lc, level, NULL, 0, flags );
+    }
+
+    residue_tuples = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, rfc_ctx->residue_cap,
+                                                             sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
+
+    if( !residue_tuples )
+    {
+        return false;
+    }
+
+    for( i = 0; i < residue_cnt; i++ )
+    {
+        residue_tuples[i].value = residue[i];
+        residue_tuples[i].cls   = QUANTIZE( rfc_ctx, residue[i] );
+        residue_tuples[i].pos   = 0;
+    }
+
+    result = RFC_lc_from_residue_tuples( ctx, lc, level, residue_tuples, residue_cnt, flags );
+
+    rfc_ctx->mem_alloc( residue_tuples, 0, 0, RFC_MEM_AIM_RESIDUE);
+
+    return result;
+}
+
+
+/**
+ * Calculate level crossing counts from rainflow matrix, write results to lc
+ * histogram buffer.
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] lc           The buffer for LC histogram (counts), .full_inc represents one "count", space for 1..class_count values must be preserved!
+ * @param[out] level        The buffer for LC upper class borders (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param[in]  residue      The residue to use instead of ctx residue (may be NULL)
+ * @param[in]  residue_cnt  The length of the residue
+ * @param      flags        The flags
+ *
+ * @return     true on success
+ */
+bool RFC_lc_from_residue_tuples( const void *ctx, rfc_counts_t* lc, rfc_value_t *level, const rfc_value_tuple_s *residue, unsigned residue_cnt, rfc_flags_e flags )
+{
+          unsigned           i;
+          unsigned           class_count;
+          bool               up   = flags & RFC_FLAGS_COUNT_LC_UP;
+          bool               dn   = flags & RFC_FLAGS_COUNT_LC_DN;
+    const rfc_value_tuple_s *from;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !lc )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !residue )
+    {
+        residue     = rfc_ctx->residue;
+        residue_cnt = (int)rfc_ctx->residue_cnt;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !residue || !class_count )
+    {
+        return false;
+    }
+
+    memset( lc, 0, sizeof(rfc_counts_t) * class_count );
+
+    if( level )
+    {
+        for( i = 0; i < class_count; i++ )
+        {
+            level[i] = CLASS_UPPER( rfc_ctx, i );
+        }
+    }
+
+    from = residue;
+    for( i = 1; i < residue_cnt; i++ ) 
+    {
+        const rfc_value_tuple_s *to         = from + 1;
+              unsigned           class_from = from->cls;
+              unsigned           class_to   = to->cls;
+
+        /* Level crossing, count rising and falling slopes.
+         * Level crossing histogram (vector storage)
+         * Counts class upper bound crossings
+         * Class upper bound value = (idx+1) * class_width + class_offset
+         */
+        if( class_from < class_to && up )
+        {
+            /* Count rising slopes */
+            unsigned idx;
+            for( idx = class_from; idx < class_to; idx++ )
+            {
+                assert( lc[idx] <= RFC_COUNTS_LIMIT );
+                lc[idx] += rfc_ctx->full_inc;
+            }
+        }
+        else if( class_to < class_from && dn )
+        {
+            /* Count falling slopes */
+            unsigned idx;
+            for( idx = class_to; idx < class_from; idx++ )
+            {
+                assert( lc[idx] <= RFC_COUNTS_LIMIT );
+                lc[idx] += rfc_ctx->full_inc;
+            }
+        }
+
+        from = to;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Get time at level (number of samples per class)
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] tal          The number of samples per class, space for class_count values must be preserved!
+ * @param[out] level        The class means (dropped if NULL, otherwise space for class_count values must be preserved!)
+ *
+ * @return     true on success
+ * @note       Only samples fed by RFC_feed(), RFC_feed_scaled() and RFC_feed_cond() are taken into account,
+ *             refeeding turning points or matrices doesn't restore time at level.
+ */
+bool RFC_tal_get( const void *ctx, size_t *tal, rfc_value_t *level )
+{
+    unsigned i;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !tal )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfc_ctx->tal || !rfc_ctx->class_count )
+    {
+        return false;
+    }
+
+    for( i = 0; i < rfc_ctx->class_count; i++ )
+    {
+        tal[i] = rfc_ctx->tal[i];
+
+        if( level )
+        {
+            level[i] = CLASS_MEAN( rfc_ctx, i );
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Get range pair histogram
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] rp           The histogram (counts), .full_inc represent one "cycle", space for 1..class_count values must be preserved!
+ * @param[out] Sa           The amplitudes (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ *
+ * @return     true on success
+ */
+bool RFC_rp_get( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa )
+{
+    unsigned i;
+    unsigned class_count;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !rp )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rfc_ctx->rp || !rp || !class_count )
+    {
+        return false;
+    }
+
+    memset( rp, 0, sizeof(rfc_counts_t) * class_count );
+
+    for( i = 0; i < class_count; i++ )
+    {
+        rp[i] = rfc_ctx->rp[i];
+
+        if( Sa )
+        {
+            Sa[i] = AMPLITUDE( rfc_ctx, i );  /* range / 2 */
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Generate range pair histogram from rainflow matrix
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] rp           The buffer for range pair counts (not cycles!), .full_inc represents one "cycle", space for 1..class_count values must be preserved!
+ * @param[out] Sa           The buffer for amplitudes (dropped if NULL, otherwise space for 1..class_count values must be preserved!)
+ * @param[in]  rfm          The input rainflow matrix to use instead of the ctx matrix (may be NULL)
+ *
+ * @return     true on success
+ */
+bool RFC_rp_from_rfm( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa, const rfc_counts_t *rfm )
+{
+    unsigned    i, j;
+    unsigned    class_count;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !rp )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfm )
+    {
+        rfm = rfc_ctx->rfm;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rfm || !class_count )
+    {
+        return false;
+    }
+
+    memset( rp, 0, sizeof(rfc_counts_t) * class_count );
+
+    if( rfc_ctx->class_bounds )
+    {
+        /* Non-uniform classes: ranges don't follow the diagonals */
+        for( i = 0; i < class_count; i++ )
+        {
+            if( Sa )
+            {
+                Sa[i] = AMPLITUDE( rfc_ctx, i );  /* range / 2 */
+            }
+
+            for( j = 0; j < class_count; j++ )
+            {
+                unsigned idx = range_class( rfc_ctx, i, j );
+
+                assert( rp[idx] <= RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( i, j ) ] );
+                rp[idx] += rfm[ MAT_OFFS( i, j ) ];
+            }
+        }
+
+        return true;
+    }
+
+    for( i = 0; i < class_count; i++ ) 
+    {
+        rfc_counts_t sum = (rfc_counts_t)0;
+
+        if( Sa )
+        {
+            Sa[i] = AMPLITUDE( rfc_ctx, i );  /* range / 2 */
+        }
+
+        for( j = i; j < class_count; j++ ) 
+        {
+            /* Count rising and falling slopes */
+            assert( sum < ( RFC_COUNTS_LIMIT - rfm[ MAT_OFFS( j-i, j ) ] - rfm[ MAT_OFFS( j, j-i ) ] ) );
+            sum += rfm[ MAT_OFFS( j-i, j ) ];
+            sum += rfm[ MAT_OFFS( j, j-i ) ];
+        }
+
+        rp[i] = sum;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Return cumulated damage
+ *
+ * @param      ctx             The rainflow context
+ * @param[out] damage          The buffer for cumulated damage (including damage from residue)
+ * @param[out] damage_residue  The buffer for partial damage from residue
+ *
+ * @return     true on success
+ */
+bool RFC_damage( const void *ctx, rfc_value_t *damage, rfc_value_t *damage_residue )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( damage )
+    {
+        *damage = rfc_ctx->damage;
+    }
+
+    if( damage_residue )
+    {
+        *damage_residue = rfc_ctx->damage_residue;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate the damage from a range pair histogram
+ *
+ * @param      ctx             The rainflow context
+ * @param[out] damage          The buffer for cumulated damage
+ * @param[in]  rp              The range pair counts to use instead of ctx rp, may be NULL (Mind that
+ *                             full_inc describes 1 cycle!), space for 1..class_count values must be preserved!
+ * @param[in]  Sa              The buffer for amplitudes respective rp, may be
+ *                             NULL, space for 1..class_count values must be preserved!
+ * @param      rp_calc_method  The rp calculate method
+ *                             (RFC_RP_DAMAGE_CALC_METHOD_*)
+ *
+ * @return     true on success
+ */
+bool RFC_damage_from_rp( const void *ctx, double *damage, const rfc_counts_t *rp, const rfc_value_t *Sa, rfc_rp_damage_method_e rp_calc_method )
+{
+    const unsigned    from = 0;
+          unsigned    class_count;
+          double      D;             /* Cumulative damage */
+          int         i, j;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !damage )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rp )
+    {
+        rp = rfc_ctx->rp;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rp || !class_count )
+    {
+        return false;
+    }
+
+    /* Sa must be sorted in ascending order */
+    for( i = 1; Sa && i < (int)class_count; i++ )
+    {
+        if( Sa[i] < Sa[i-1] )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        }
+    }
+
+    D = 0.0;
+
+    /* Calculate the "Miner Consequent" approach */
+    if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_CONSEQUENT )
+    {
+        rfc_wl_param_s      wl;
+        double              q     = rfc_ctx->wl_q;   /* Fatigue strength depression exponent */
+        double              Sd    = rfc_ctx->wl_sd;  /* Fatigue strength SD for the unimpaired(!) part */
+        double              Nd    = rfc_ctx->wl_nd;  /* Fatigue strength cycle count ND for the unimpaired(!) part */
+        double              Sj    = Sd;              /* Current fatigue strength, impacted part */
+        double              D_inv = 0.0;             /* The inverse damage */
+        bool                ok    = true;
+
+        /* Omission not allowed here! */
+        if( rfc_ctx->wl_omission > 0.0 )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        }
+
+        /* Backup WL parameters */
+        RFC_wl_param_get( rfc_ctx, &wl );
+
+        /* Remove fatigue strength temporarily */
+        rfc_ctx->wl_sd = 0.0;
+        rfc_ctx->wl_nd = DBL_MAX;
+
+        for( j = (int)class_count - 1; j >= -1 && ok; j-- )
+        {
+            double D_j = 0.0;  /* Damage for partial histogram */
+            double Sa_j;       /* New fatigue strength */
+            double weight;     /* Weight for partial histogram */
+
+            /* Get the new degraded fatigue strength in Sa_j */
+            if( j >= 0 )
+            {
+                Sa_j = Sa ? Sa[j] : AMPLITUDE( rfc_ctx, j );
+            }
+            else
+            {
+                Sa_j = 0.0;
+            }
+
+            /* Forward until amplitude is below fatigue strength SD for the unimpaired part */
+            if( Sa_j >= Sd && Sd > 0.0 ) continue;
+
+            /**
+             *  The following lines of code reflect the original formulas as in [6] 3.2.11 and 3.2-59.
+             *  This realization resolves his approach to use partial damages instead of particular cycles from the histogram.
+             *  This procedure benefits from inserting an abstraction layer, which permits to use any representation of 
+             *  a Woehler curve with a given fatigue strength limit providing a damage per cycle representation. 
+             *  Note that the Miner Consequent approach, in contrast to Original/Elementary/Modified, is unsuitable when using 
+             *  an inappropriate Woehler curve, to estimate so called "pseudo damages".
+             */
+
+            /* Weighted damage */
+            weight = pow( Sj / Sd, q ) - pow( Sa_j / Sd, q );
+            Sj     = Sa_j;
+
+            if( weight <= 0.0 ) continue;
+
+            /* Calculate damage for partial histogram */
+            for( i = (int)class_count - 1; i > j; i-- )
+            {
+                double Sa_i = Sa ? Sa[i] : AMPLITUDE( rfc_ctx, i );
+                double D_i;
+                
+                if( !damage_calc_amplitude( rfc_ctx, Sa_i, &D_i ) )
+                {
+                    ok = false;
+                    break;
+                }
+
+                D_j += D_i * rp[i];
+            }
+
+            if( D_j > 0.0 )
+            {
+                D_inv += weight / D_j;
+            }
+        }
+
+        /* Restore WL parameters */
+        RFC_wl_param_set( rfc_ctx, &wl );
+
+        if( !ok ) return false;
+
+        /* Get the final damage value */
+        D = 1.0 / D_inv;
+    }
+    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_ELEMENTAR )
+    {
+        rfc_wl_param_s  wl;
+        bool ok;
+
+        (void)RFC_wl_param_get( rfc_ctx, &wl );
+
+        rfc_ctx->wl_sd = 0.0;
+        rfc_ctx->wl_nd = DBL_MAX;
+        rfc_ctx->wl_k2 = rfc_ctx->wl_k;
+        rfc_ctx->wl_q2 = rfc_ctx->wl_q2;
+
+#if RFC_DAMAGE_FAST
+        {
+            rfc_ctx->damage_lut_inapt++;
+            ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
+            rfc_ctx->damage_lut_inapt--;
+        }
+#else /*!RFC_DAMAGE_FAST*/
+        ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
+#endif /*RFC_DAMAGE_FAST*/
+
+        (void)RFC_wl_param_set( rfc_ctx, &wl );
+
+        return ok;
+    }
+    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_MODIFIED)
+    {
+        rfc_wl_param_s wl;
+        bool ok;
+
+        (void)RFC_wl_param_get( rfc_ctx, &wl );
+
+        rfc_ctx->wl_sd = 0.0;
+        rfc_ctx->wl_nd = DBL_MAX;
+
+#if RFC_DAMAGE_FAST
+        {
+            rfc_ctx->damage_lut_inapt++;
+            ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
+            rfc_ctx->damage_lut_inapt--;
+        }
+#else /*!RFC_DAMAGE_FAST*/
+        ok = RFC_damage_from_rp( rfc_ctx, damage, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT );
+#endif /*RFC_DAMAGE_FAST*/
+
+        (void)RFC_wl_param_set( rfc_ctx, &wl );
+
+        return ok;
+    }
+    else if( rp_calc_method == RFC_RP_DAMAGE_CALC_METHOD_DEFAULT )
+    {
+        for( i = 0; i < (int)class_count; i++ )
+        {
+            if( rp[i] )
+            {
+                double D_i;
+
+                if( Sa )
+                {
+                    if( !damage_calc_amplitude( rfc_ctx, Sa[i], &D_i ) )
+                    {
+                        return false;
+                    }
+                    D += D_i * rp[i];
+                }
+                else
+                {
+                    if( !damage_calc( rfc_ctx, from, i /*to*/, &D_i, NULL /*Sa_ret*/ ) )
+                    {
+                        return false;
+                    }
+                    D += D_i * rp[i];
+                }
+            }
+        }
+    }
+    else return false;
+
+    *damage = D / rfc_ctx->full_inc;
+    return true;
+}
+
+
+/**
+ * @brief      Calculate the damage from rainflow matrix
+ *
+ * @param      ctx     The rainflow context
+ * @param[out] damage  The buffer for cumulated damage
+ * @param[in]  rfm     The input rainflow matrix to use instead of ctx rfm (may be NULL), .full_inc represents one "cycle"!
+ *
+ * @return     true on success
+ */
+bool RFC_damage_from_rfm( const void *ctx, double *damage, const rfc_counts_t *rfm )
+{
+    unsigned    from, to;
+    unsigned    class_count;
+    double      D;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !damage )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( !rfm )
+    {
+        rfm = rfc_ctx->rfm;
+    }
+
+    class_count = rfc_ctx->class_count;
+
+    if( !rfm || !class_count )
+    {
+        return false;
+    }
+
+    D = 0.0;
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++ )
+        {
+            if( rfm[ from * class_count + to ] )
+            {
+                double D_i;
+
+                if( !damage_calc( rfc_ctx, from, to, &D_i, NULL /*Sa_ret*/ ) )
+                {
+                    return false;
+                }
+                D += D_i * rfm[ MAT_OFFS( from, to ) ];
+            }
+        }
+    }
+
+    *damage = D / rfc_ctx->full_inc;
+    return true;
+}
+
+
+/**
+ * @brief      Critical plane damage. Projects a multiaxial series (e.g. stress
+ *             tensor components) onto a set of candidate planes and counts
+ *             each projection, without materializing the projected series.
+ *             Projections are computed block-wise (RFC_CP_BLOCK_SIZE samples)
+ *             and fed into one counting state per plane. ctx serves as
+ *             template for all planes (class parameters, hysteresis, Woehler
+ *             curve, counting method) and stays untouched, its damage look-up
+ *             table is shared among all planes. Planes are fed without
+ *             conditions, Woehler curves per condition (RFC_wl_bins_init())
+ *             are shared as well and the curve of condition 0 applies.
+ *
+ * @param      ctx              The rainflow context (template, must be initialized, but not fed)
+ * @param[in]  data             The component channels, interleaved (data[i*comp_count+c])
+ * @param      data_count       The number of samples
+ * @param      comp_count       The number of components per sample
+ * @param[in]  coeffs           The projection coefficients (plane_count vectors of comp_count elements)
+ * @param      plane_count      The number of planes
+ * @param      residual_method  The residual method (RFC_RES_...)
+ * @param[out] damage           The buffer for the damage of each plane (plane_count values, may be NULL)
+ * @param[out] critical_plane   The index of the plane taking the maximum damage (may be NULL)
+ *
+ * @return     true on success
+ */
+bool RFC_cp_damage( const void *ctx, const rfc_value_t *data, size_t data_count, unsigned comp_count, 
+                    const double *coeffs, unsigned plane_count, rfc_res_method_e residual_method, 
+                    double *damage, unsigned *critical_plane )
+{
+    union cp_plane *planes;
+    rfc_value_t     block[RFC_CP_BLOCK_SIZE];
+    size_t          offset;
+    unsigned        plane_cnt;
+    unsigned        i;
+    double          D_max   = -1.0;
+    bool            ok      = true;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( ( data_count && !data ) || !comp_count || !coeffs || !plane_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state != RFC_STATE_INIT || !rfc_ctx->class_count )
+    {
+        return false;
+    }
+
+    planes = (union cp_plane*)rfc_ctx->mem_alloc( NULL, plane_count, sizeof(union cp_plane), RFC_MEM_AIM_CP );
+    if( !planes )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+
+    /* One counting state per plane */
+    for( plane_cnt = 0; plane_cnt < plane_count; plane_cnt++ )
+    {
+        if( !cp_plane_init( rfc_ctx, &planes[plane_cnt].ctx ) )
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    /* Project and count block-wise, each block of data is touched while it resides in cache */
+    for( offset = 0; ok && offset < data_count; offset += RFC_CP_BLOCK_SIZE )
+    {
+        size_t n = data_count - offset;
+
+        if( n > RFC_CP_BLOCK_SIZE )
+        {
+            n = RFC_CP_BLOCK_SIZE;
+        }
+
+        for( i = 0; ok && i < plane_count; i++ )
+        {
+            const rfc_value_t  *row   = data   + offset * comp_count;
+            const double       *coeff = coeffs + (size_t)i * comp_count;
+            size_t              j;
+
+            for( j = 0; j < n; j++, row += comp_count )
+            {
+                double   value = 0.0;
+                unsigned c;
+
+                for( c = 0; c < comp_count; c++ )
+                {
+                    value += coeff[c] * row[c];
+                }
+                block[j] = (rfc_value_t)value;
+            }
+
+            ok = RFC_feed( &planes[i].ctx, block, n );
+        }
+    }
+
+    for( i = 0; ok && i < plane_count; i++ )
+    {
+        ok = RFC_finalize( &planes[i].ctx, residual_method );
+
+        if( ok )
+        {
+            if( damage )
+            {
+                damage[i] = planes[i].ctx.damage;
+            }
+
+            if( planes[i].ctx.damage > D_max )
+            {
+                D_max = planes[i].ctx.damage;
+                if( critical_plane )
+                {
+                    *critical_plane = i;
+                }
+            }
+        }
+    }
+
+    /* Propagate the first error */
+    for( i = 0; !ok && i < plane_cnt; i++ )
+    {
+        if( planes[i].ctx.error != RFC_ERROR_NOERROR )
+        {
+            (void)error_raise( rfc_ctx, planes[i].ctx.error );
+            break;
+        }
+    }
+
+    for( i = 0; i < plane_cnt; i++ )
+    {
+        (void)ctx_clone_deinit( &planes[i].ctx );
+    }
+    rfc_ctx->mem_alloc( planes, 0, 0, RFC_MEM_AIM_CP );
+
+    return ok;
+}
+
+
+/**
+ * @brief      Estimate the one-sided power spectral density of a data series
+ *             (Welch's method, Hann window, 50% overlap). The PSD is scaled
+ *             such that its integral equals the variance of data.
+ *
+ * @param      ctx         The rainflow context
+ * @param[in]  data        The data
+ * @param      data_count  The data count (at least nfft)
+ * @param      fs          The sample rate
+ * @param      nfft        The segment length, must be a power of 2
+ * @param[out] psd         The buffer for the PSD (nfft/2+1 values at frequencies i*fs/nfft)
+ *
+ * @return     true on success
+ */
+bool RFC_spectral_psd( const void *ctx, const rfc_value_t *data, size_t data_count, double fs, unsigned nfft, double *psd )
+{
+    const double    two_pi      = 6.28318530717958647692;
+    double         *re, *im;
+    double          mean        = 0.0;
+    double          wsum        = 0.0;
+    size_t          offset;
+    size_t          seg_count   = 0;
+    unsigned        i;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !data || !psd || fs <= 0.0 || nfft < 2 || ( nfft & ( nfft - 1 ) ) || data_count < nfft )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    re = (double*)rfc_ctx->mem_alloc( NULL, 2 * nfft, sizeof(double), RFC_MEM_AIM_TEMP );
+    if( !re )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+    im = re + nfft;
+
+    for( offset = 0; offset < data_count; offset++ )
+    {
+        mean += data[offset];
+    }
+    mean /= data_count;
+
+    for( i = 0; i < nfft; i++ )
+    {
+        double w = 0.5 - 0.5 * cos( two_pi * i / nfft );
+
+        wsum += w * w;
+    }
+
+    memset( psd, 0, sizeof(double) * ( nfft / 2 + 1 ) );
+
+    for( offset = 0; offset + nfft <= data_count; offset += nfft / 2 )
+    {
+        for( i = 0; i < nfft; i++ )
+        {
+            double w = 0.5 - 0.5 * cos( two_pi * i / nfft );
+
+            re[i] = ( data[offset + i] - mean ) * w;
+            im[i] = 0.0;
+        }
+
+        spectral_fft( re, im, nfft );
+
+        for( i = 0; i <= nfft / 2; i++ )
+        {
+            psd[i] += re[i] * re[i] + im[i] * im[i];
+        }
+        seg_count++;
+    }
+
+    /* Average and fold to one-sided density */
+    for( i = 0; i <= nfft / 2; i++ )
+    {
+        psd[i] /= seg_count * fs * wsum;
+
+        if( i > 0 && i < nfft / 2 )
+        {
+            psd[i] *= 2.0;
+        }
+    }
+
+    rfc_ctx->mem_alloc( re, 0, 0, RFC_MEM_AIM_TEMP );
+
+    return true;
+}
+
+
+/**
+ * @brief      Spectral (frequency domain) damage estimation for a stationary
+ *             Gaussian process, given by its one-sided PSD. Uses the Woehler
+ *             curve parameters from ctx. Optionally returns the estimated
+ *             cycle distribution in range pair format (see RFC_rp_get()).
+ *
+ * @param      ctx        The rainflow context
+ * @param[in]  psd        The one-sided PSD (psd_count values at frequencies i*df)
+ * @param      psd_count  The number of PSD values
+ * @param      df         The frequency resolution
+ * @param      T          The duration to estimate damage for
+ * @param      method     The estimation method (RFC_SPECTRAL_...)
+ * @param[out] damage     The buffer for the expected damage (may be NULL)
+ * @param[out] rp         The buffer for expected range pair counts (may be NULL), .full_inc represents one "cycle", space for class_count values must be preserved!
+ * @param[out] Sa         The buffer for amplitudes (may be NULL), space for class_count values must be preserved!
+ *
+ * @return     true on success
+ */
+bool RFC_spectral_damage( const void *ctx, const double *psd, size_t psd_count, double df, double T, rfc_spectral_method_e method, 
+                          double *damage, rfc_counts_t *rp, rfc_value_t *Sa )
+{
+    const size_t            steps   = 4000;
+    struct spectral_param   param;
+    double                  m[5]    = { 0.0 };
+    double                  alpha1, xm;
+    size_t                  i;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !psd || psd_count < 2 || df <= 0.0 || T < 0.0 || method < 0 || method >= RFC_SPECTRAL_COUNT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    if( ( rp || Sa ) && !rfc_ctx->class_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    memset( &param, 0, sizeof(param) );
+    param.method = method;
+
+    /* Spectral moments m0..m4 (trapezoidal rule) */
+    for( i = 0; i < psd_count; i++ )
+    {
+        double f = df * i;
+        double w = ( i == 0 || i == psd_count - 1 ) ? 0.5 * df : df;
+        double x = psd[i] * w;
+        int    n;
+
+        for( n = 0; n < 5; n++, x *= f )
+        {
+            m[n] += x;
+        }
+    }
+
+    if( m[0] <= 0.0 || m[2] <= 0.0 || m[4] <= 0.0 )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    param.m0     = m[0];
+    param.nu_0   = sqrt( m[2] / m[0] );
+    param.nu_p   = sqrt( m[4] / m[2] );
+    param.alpha2 = m[2] / sqrt( m[0] * m[4] );
+    alpha1       = m[1] / sqrt( m[0] * m[2] );
+    xm           = m[1] / m[0] * sqrt( m[2] / m[4] );
+
+    if( param.alpha2 > 1.0 - 1e-6 )
+    {
+        /* Ideal narrow band process, all methods coincide */
+        param.method = RFC_SPECTRAL_NARROW_BAND;
+    }
+
+    if( param.method == RFC_SPECTRAL_DIRLIK )
+    {
+        double a2 = param.alpha2;
+
+        param.D1 = 2.0 * ( xm - a2 * a2 ) / ( 1.0 + a2 * a2 );
+        param.R  = ( a2 - xm - param.D1 * param.D1 ) / ( 1.0 - a2 - param.D1 + param.D1 * param.D1 );
+        param.D2 = ( 1.0 - a2 - param.D1 + param.D1 * param.D1 ) / ( 1.0 - param.R );
+        param.D3 = 1.0 - param.D1 - param.D2;
+        param.Q  = 1.25 * ( a2 - param.D3 - param.D2 * param.R ) / param.D1;
+    }
+    else if( param.method == RFC_SPECTRAL_TOVO_BENASCIUTTI )
+    {
+        double a2 = param.alpha2;
+
+        param.b  = ( alpha1 - a2 ) * ( 1.112 * ( 1.0 + alpha1 * a2 - ( alpha1 + a2 ) ) * exp( 2.11 * a2 ) + ( alpha1 - a2 ) ) 
+                   / ( ( a2 - 1.0 ) * ( a2 - 1.0 ) );
+        param.b  = param.b < 0.0 ? 0.0 : param.b > 1.0 ? 1.0 : param.b;
+    }
+
+    if( damage )
+    {
+        double Sa_max = sqrt( param.m0 );
+        double E_hi, E_lo, D = 0.0;
+
+        /* Upper integration limit, where the exceedance rate becomes negligible */
+        while( spectral_exceedance( &param, Sa_max ) > 1e-15 * spectral_exceedance( &param, 0.0 ) )
+        {
+            Sa_max *= 1.5;
+        }
+
+        E_lo = spectral_exceedance( &param, 0.0 );
+        for( i = 0; i < steps; i++ )
+        {
+            double D_i;
+
+            E_hi = spectral_exceedance( &param, Sa_max * ( i + 1 ) / steps );
+            if( !damage_calc_amplitude( rfc_ctx, Sa_max * ( i + 0.5 ) / steps, &D_i ) )
+            {
+                return false;
+            }
+            D    += ( E_lo - E_hi ) * D_i;
+            E_lo  = E_hi;
+        }
+
+        *damage = D * T;
+    }
+
+    if( rp || Sa )
+    {
+        unsigned class_count = rfc_ctx->class_count;
+        unsigned j;
+
+        for( j = 0; j < class_count; j++ )
+        {
+            /* Range class j holds ranges from (j-0.5)*class_width to (j+0.5)*class_width */
+            double Sa_lo = j ? ( AMPLITUDE( rfc_ctx, j - 1 ) + AMPLITUDE( rfc_ctx, j ) ) / 2 : 0.0;
+            double Sa_hi = ( AMPLITUDE( rfc_ctx, j ) + AMPLITUDE( rfc_ctx, j + 1 ) ) / 2;
+            double N     = spectral_exceedance( &param, Sa_lo );
+
+            if( j + 1 < class_count )
+            {
+                N -= spectral_exceedance( &param, Sa_hi );
+            }
+
+            if( rp )
+            {
+#if RFC_USE_INTEGRAL_COUNTS
+                rp[j] = (rfc_counts_t)floor( N * T * rfc_ctx->full_inc + 0.5 );
+#else /*!RFC_USE_INTEGRAL_COUNTS*/
+                rp[j] = (rfc_counts_t)( N * T * rfc_ctx->full_inc );
+#endif /*RFC_USE_INTEGRAL_COUNTS*/
+            }
+
+            if( Sa )
+            {
+                Sa[j] = AMPLITUDE( rfc_ctx, j );  /* range / 2 */
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate junction point between k and k2 for a Woehler curve
+ *
+ * @param      ctx   The rainflow context
+ * @param      s0    Any point on slope k
+ * @param      n0    Any point on slope k
+ * @param      k     Slope k
+ * @param[out] sx    Junction point between k and k2
+ * @param      nx    Junction point between k and k2
+ * @param      k2    Slope k2
+ * @param      sd    The fatigue strength
+ * @param      nd    The cycle count at sd
+ *
+ * @return     true on success
+ */
+bool RFC_wl_calc_sx( const void *ctx, double s0, double n0, double k, double *sx, double nx, double k2, double sd, double nd )
+{
+    double nom, den;
+
+    k  = fabs(k);
+    k2 = fabs(k2);
+
+    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
+        /* sx <= 0.0    || */ nx <= 0.0    ||
+           sd <= 0.0    ||    nd <= 0.0    ||    !sx )
+    {
+        return false;
+    }
+
+    nom = log(s0)*k - log(sd)*k2 + log(n0) - log(nd);
+    den = k - k2;
+
+    if( den == 0.0 ) return false;
+
+    *sx = exp( nom / den );
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate fatigue strength for a Woehler curve
+ *
+ * @param      ctx   The rainflow context
+ * @param      s0    Any point on slope k
+ * @param      n0    Any point on slope k
+ * @param      k     Slope k
+ * @param      sx    Junction point between k and k2
+ * @param      nx    The cycle
+ * @param      k2    Slope k2
+ * @param[out] sd    The fatigue strength
+ * @param      nd    The cycle count at sd
+ *
+ * @return     true on success
+ */
+bool RFC_wl_calc_sd( const void *ctx, double s0, double n0, double k, double sx, double nx, double k2, double *sd, double nd )
+{
+    double nom, den;
+
+    k  = fabs(k);
+    k2 = fabs(k2);
+
+    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
+           sx <= 0.0    ||    nx <= 0.0    ||
+        /* sd <= 0.0    || */ nd <= 0.0    ||    !sd )
+    {
+        return false;
+    }
+
+    nom = log(s0)*k - log(sx)*(k-k2) + log(n0) - log(nd);
+    den = k2;
+
+    if( den == 0.0 ) return false;
+
+    *sd = exp( nom / den );
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate the slope k2 for a Woehler curve
+ *
+ * @param      ctx   The rainflow context
+ * @param      s0    Any point on slope k
+ * @param      n0    Any point on slope k
+ * @param      k     Slope k
+ * @param      sx    Junction point between k and k2
+ * @param      nx    Junction point between k and k2
+ * @param[out] k2    Slope k2
+ * @param      sd    The fatigue strength
+ * @param      nd    The cycle count at sd
+ *
+ * @return     true on success
+ */
+bool RFC_wl_calc_k2( const void *ctx, double s0, double n0, double k, double sx, double nx, double *k2, double sd, double nd )
+{
+    double nom, den;
+
+    k  = fabs(k);
+
+    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
+           sx <= 0.0    ||    nx <= 0.0    ||
+           sd <= 0.0    ||    nd <= 0.0    ||    !k2 )
+    {
+        return false;
+    }
+
+    nom = ( log(s0) - log(sx) ) * k + log(n0) - log(nd);
+    den =   log(sd) - log(sx);
+
+    if( den == 0.0 )
+    {
+        *k2 = -DBL_MAX;  /* Negative infinity */
+    }
+    else
+    {
+        *k2 = -fabs( nom / den );
+    }
+
+    return true;
+}
+
+/**
+ * @brief      Calculate a point on a Woehler slope
+ *
+ * @param      ctx   The rainflow context
+ * @param      s0    Any point on the slope, Sa
+ * @param      n0    Any point on the slope, N
+ * @param      k     The Woehler slope
+ * @param      n     Given cycles for required Sa
+ * @param[out] sa    The buffer for Sa(N)
+ *
+ * @return     true on success
+ */
+bool RFC_wl_calc_sa( const void *ctx, double s0, double n0, double k, double n, double *sa )
+{
+    /* (s0/Sa)^-k = n0/n */
+    /* (Sa/s0)^k  = n0/n */
+
+    k  = fabs(k);
+
+    if(    s0 <= 0.0    ||    n0 <= 0.0    ||
+           n  <= 0.0    ||   !sa           )
+    {
+        return false;
+    }
+
+    *sa = pow( n0 / n, 1.0 / k ) * s0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate a point on a Woehler slope
+ *
+ * @param      ctx   The rainflow context
+ * @param      s0    Any point on the slope, Sa
+ * @param      n0    Any point on the slope, N
+ * @param      k     The Woehler slope
+ * @param      sa    Given amplitude Sa for required N
+ * @param[out] n     The buffer for N(Sa)
+ *
+ * @return     true on success
+ */
+bool RFC_wl_calc_n( const void *ctx, double s0, double n0, double k, double sa, double *n )
+{
+    /* (Sa/s0)^-k = n/n0 */
+    /* (s0/Sa)^k  = n/n0 */
+
+    k  = fabs(k);
+
+    if( s0 <= 0.0 ||  n0 <= 0.0    ||
+        sa <= 0.0 || !n            )
+    {
+        return false;
+    }
+
+    *n = pow( s0 / sa, k ) * n0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Set class parameter.
+ *
+ * @param      ctx          The rainflow context
+ * @param[in]  class_param  The new class parameter
+ *
+ * @return     true on success
+ * 
+ * @note       Changing class parameters invalidate look-up tables!
+ */
+bool RFC_class_param_set( void *ctx, const rfc_class_param_s *class_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_param                                || 
+         rfc_ctx->state     != RFC_STATE_INIT       || 
+         class_param->count != rfc_ctx->class_count ||
+         class_param->width  < 0.0                  )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( class_param->count > 0.0 && class_param->width <= 0.0 )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    /* Equidistant classes replace non-uniform class boundaries */
+    if( rfc_ctx->class_bounds && !RFC_class_bounds_set( rfc_ctx, NULL, rfc_ctx->class_count ) )
+    {
+        return false;
+    }
+
+    rfc_ctx->class_count  = class_param->count;
+    rfc_ctx->class_width  = class_param->width;
+    rfc_ctx->class_offset = class_param->offset;
+
+#if RFC_DAMAGE_FAST
+    rfc_ctx->damage_lut_inapt++;
+#endif /*RFC_DAMAGE_FAST*/
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class parameter.
+ *
+ * @param      ctx          The rainflow context
+ * @param[out] class_param  The class parameter
+ *
+ * @return     true on success
+ */
+bool RFC_class_param_get( const void *ctx, rfc_class_param_s *class_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_param                     ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    class_param->count  = rfc_ctx->class_count;
+    class_param->width  = rfc_ctx->class_width;
+    class_param->offset = rfc_ctx->class_offset;
+
+    return true;
+}
+
+
+/**
+ * @brief      Set non-uniform class boundaries (e.g. logarithmic classes).
+ *             Class i holds values from bounds[i] (inclusive) to bounds[i+1].
+ *             Class offset becomes bounds[0], class width the average width.
+ *             Range pair counts refer to ranges bounds[i] - bounds[0].
+ *
+ * @param      ctx     The rainflow context
+ * @param[in]  bounds  The class boundaries, count+1 strictly increasing values 
+ *                     (NULL restores equidistant classes of average width)
+ * @param[in]  count   The class count, must match the current class count
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding, invalidates look-up tables!
+ *             Range-mean matrix/histogram and auto resizing need equidistant classes.
+ */
+bool RFC_class_bounds_set( void *ctx, const rfc_value_t *bounds, unsigned count )
+{
+    rfc_value_t        *class_bounds = NULL;
+    unsigned           *lut          = NULL;
+    unsigned            lut_count    = 0;
+    double              width_min;
+    unsigned            i, j;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT || count != rfc_ctx->class_count || !count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( bounds )
+    {
+        if( rfc_ctx->rmm || rfc_ctx->rmd )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+        }
+#if RFC_AR_SUPPORT
+        if( rfc_ctx->internal.flags & RFC_FLAGS_AUTORESIZE )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+        }
+#endif /*RFC_AR_SUPPORT*/
+
+        width_min = bounds[count] - bounds[0];
+        for( i = 0; i < count; i++ )
+        {
+            if( !( bounds[i+1] > bounds[i] ) )
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+            }
+            if( bounds[i+1] - bounds[i] < width_min )
+            {
+                width_min = bounds[i+1] - bounds[i];
+            }
+        }
+
+        /* Cells not wider than the narrowest class, limited to 64 cells per class */
+        lut_count = (unsigned)ceil( ( bounds[count] - bounds[0] ) / width_min );
+        if( lut_count > 64 * count )
+        {
+            lut_count = 64 * count;
+        }
+
+        class_bounds = (rfc_value_t*)rfc_ctx->mem_alloc( NULL, count + 1, sizeof(rfc_value_t), RFC_MEM_AIM_CLASS_BOUNDS );
+        lut          = (unsigned*)rfc_ctx->mem_alloc( NULL, lut_count, sizeof(unsigned), RFC_MEM_AIM_CLASS_BOUNDS );
+
+        if( !class_bounds || !lut )
+        {
+            if( class_bounds ) rfc_ctx->mem_alloc( class_bounds, 0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+            if( lut )          rfc_ctx->mem_alloc( lut,          0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( class_bounds, bounds, sizeof(rfc_value_t) * ( count + 1 ) );
+
+        /* Class holding the lower edge of each cell */
+        for( i = 0, j = 0; i < lut_count; i++ )
+        {
+            double edge = bounds[0] + ( bounds[count] - bounds[0] ) * i / lut_count;
+
+            while( j + 1 < count && edge >= bounds[j+1] )
+            {
+                j++;
+            }
+            lut[i] = j;
+        }
+    }
+
+    if( rfc_ctx->class_bounds )     rfc_ctx->mem_alloc( rfc_ctx->class_bounds,     0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+    if( rfc_ctx->class_bounds_lut ) rfc_ctx->mem_alloc( rfc_ctx->class_bounds_lut, 0, 0, RFC_MEM_AIM_CLASS_BOUNDS );
+
+    rfc_ctx->class_bounds           = class_bounds;
+    rfc_ctx->class_bounds_lut       = lut;
+    rfc_ctx->class_bounds_lut_count = lut_count;
+
+    if( bounds )
+    {
+        rfc_ctx->class_offset           = bounds[0];
+        rfc_ctx->class_width            = ( bounds[count] - bounds[0] ) / count;
+        rfc_ctx->class_bounds_lut_scale = lut_count / ( (double)bounds[count] - bounds[0] );
+    }
+
+#if RFC_DAMAGE_FAST
+    return damage_lut_init( rfc_ctx );
+#else /*!RFC_DAMAGE_FAST*/
+    return true;
+#endif /*RFC_DAMAGE_FAST*/
+}
+
+
+/**
+ * @brief      Get non-uniform class boundaries.
+ *
+ * @param      ctx     The rainflow context
+ * @param[out] bounds  The class boundaries (class_count+1 values, NULL for equidistant classes)
+ * @param[out] count   The class count (may be NULL)
+ *
+ * @return     true on success
+ */
+bool RFC_class_bounds_get( const void *ctx, const rfc_value_t **bounds, unsigned *count )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !bounds                          ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *bounds = rfc_ctx->class_bounds;
+
+    if( count )
+    {
+        *count = rfc_ctx->class_count;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Initialize conditional counting.
+ *             Cycles get attributed to the condition (state of an auxiliary
+ *             channel, e.g. gear or speed bin) according to the given rule
+ *             and are counted into a rainflow matrix and damage per condition,
+ *             beside the overall countings. Feed data by RFC_feed_cond().
+ *
+ * @param      ctx         The rainflow context
+ * @param      cond_count  The number of conditions (0 disables conditional counting)
+ * @param      rule        The rule to attribute cycles to conditions
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Auto resizing is not supported.
+ */
+bool RFC_cond_init( void *ctx, unsigned cond_count, rfc_cond_rule_e rule )
+{
+    rfc_counts_t       *cond_rfm    = NULL;
+    double             *cond_damage = NULL;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT || rule < RFC_COND_RULE_FROM || rule > RFC_COND_RULE_MAX )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+#if RFC_AR_SUPPORT
+    if( cond_count && ( rfc_ctx->internal.flags & RFC_FLAGS_AUTORESIZE ) )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_AR_SUPPORT*/
+
+    if( cond_count )
+    {
+        cond_damage = (double*)rfc_ctx->mem_alloc( NULL, cond_count, sizeof(double), RFC_MEM_AIM_COND );
+
+        if( rfc_ctx->rfm )
+        {
+            cond_rfm = (rfc_counts_t*)rfc_ctx->mem_alloc( NULL, (size_t)cond_count * rfc_ctx->class_count * rfc_ctx->class_count, 
+                                                          sizeof(rfc_counts_t), RFC_MEM_AIM_COND );
+        }
+
+        if( !cond_damage || ( rfc_ctx->rfm && !cond_rfm ) )
+        {
+            if( cond_damage ) rfc_ctx->mem_alloc( cond_damage, 0, 0, RFC_MEM_AIM_COND );
+            if( cond_rfm )    rfc_ctx->mem_alloc( cond_rfm,    0, 0, RFC_MEM_AIM_COND );
+
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memset( cond_damage, 0, sizeof(double) * cond_count );
+        if( cond_rfm )
+        {
+            memset( cond_rfm, 0, sizeof(rfc_counts_t) * cond_count * rfc_ctx->class_count * rfc_ctx->class_count );
+        }
+    }
+
+    if( rfc_ctx->cond_rfm )    rfc_ctx->mem_alloc( rfc_ctx->cond_rfm,    0, 0, RFC_MEM_AIM_COND );
+    if( rfc_ctx->cond_damage ) rfc_ctx->mem_alloc( rfc_ctx->cond_damage, 0, 0, RFC_MEM_AIM_COND );
+
+    rfc_ctx->cond_count  = cond_count;
+    rfc_ctx->cond_rule   = rule;
+    rfc_ctx->cond_rfm    = cond_rfm;
+    rfc_ctx->cond_damage = cond_damage;
+
+    /* Woehler curves per condition don't match any longer */
+    if( rfc_ctx->wl_bin_count != cond_count )
+    {
+        (void)RFC_wl_bins_init( rfc_ctx, NULL, 0 );
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Get the rainflow matrix of a condition.
+ *
+ * @param      ctx   The rainflow context
+ * @param      cond  The condition, base 0
+ * @param[out] rfm   The matrix (row-major, row=from, col=to), class_count^2 values
+ *
+ * @return     true on success
+ */
+bool RFC_cond_rfm( const void *ctx, unsigned cond, const rfc_counts_t **rfm )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !rfm || cond >= rfc_ctx->cond_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED || !rfc_ctx->cond_rfm )
+    {
+        return false;
+    }
+
+    *rfm = rfc_ctx->cond_rfm + (size_t)cond * rfc_ctx->class_count * rfc_ctx->class_count;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get the damage of a condition.
+ *
+ * @param      ctx     The rainflow context
+ * @param      cond    The condition, base 0
+ * @param[out] damage  The damage
+ *
+ * @return     true on success
+ */
+bool RFC_cond_damage( const void *ctx, unsigned cond, double *damage )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !damage || cond >= rfc_ctx->cond_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED || !rfc_ctx->cond_damage )
+    {
+        return false;
+    }
+
+    *damage = rfc_ctx->cond_damage[cond];
+
+    return true;
+}
+
+
+/**
+ * @brief      Initialize Woehler curves per condition.
+ *             Each condition (e.g. temperature bin) gets its own Woehler
+ *             curve. Damage per closed cycle is tabulated for each of them
+ *             in advance, so damage counting just looks up the table of
+ *             the condition the cycle is attributed to (see RFC_cond_init()).
+ *
+ * @param      ctx        The rainflow context
+ * @param      wl_params  The Woehler curve parameters, one set per condition
+ * @param      count      The number of parameter sets, must equal the number
+ *                        of conditions (0 drops Woehler curves per condition)
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Needs a class grid (class_count > 0),
+ *             since damage is tabulated per class. Miners' consequent rule is
+ *             not applied and RFC_damage_from_rfm() still refers to the 
+ *             common Woehler curve. Not available with the local strain
+ *             approach (see RFC_sl_param_set()), which doesn't regard
+ *             Woehler curves at all.
+ */
+bool RFC_wl_bins_init( void *ctx, const rfc_wl_param_s *wl_params, unsigned count )
+{
+    rfc_wl_param_s  wl_bak;
+    double         *lut = NULL;
+    unsigned        class_count;
+    unsigned        b, from, to;
+    bool            ok  = true;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT || ( count && ( !wl_params || count != rfc_ctx->cond_count ) ) )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( count && !rfc_ctx->class_count )
+    {
+        /* Damage is tabulated on the class grid */
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( count && rfc_ctx->sl.model != RFC_SL_MODEL_NONE )
+    {
+        /* Tabulated damage would ignore wl_params */
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+
+    class_count = rfc_ctx->class_count;
+    memset( &wl_bak, 0, sizeof(wl_bak) );
+
+    if( count )
+    {
+        lut = (double*)rfc_ctx->mem_alloc( NULL, (size_t)count * class_count * class_count, sizeof(double), RFC_MEM_AIM_WL_BINS );
+
+        if( !lut )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        /* Backup common Woehler curve parameters */
+        RFC_wl_param_get( rfc_ctx, &wl_bak );
+#if RFC_DAMAGE_FAST
+        /* Look-up table is only valid for the common Woehler curve */
+        rfc_ctx->damage_lut_inapt++;
+#endif /*RFC_DAMAGE_FAST*/
+
+        for( b = 0; ok && b < count; b++ )
+        {
+            double *lut_bin = lut + (size_t)b * class_count * class_count;
+
+            ok = RFC_wl_param_set( rfc_ctx, wl_params + b );
+
+            for( from = 0; ok && from < class_count; from++ )
+            {
+                for( to = 0; ok && to < class_count; to++ )
+                {
+                    ok = damage_calc( rfc_ctx, from, to, &lut_bin[ from * class_count + to ], NULL /*Sa_ret*/ );
+                }
+            }
+        }
+
+#if RFC_DAMAGE_FAST
+        rfc_ctx->damage_lut_inapt--;
+#endif /*RFC_DAMAGE_FAST*/
+        (void)RFC_wl_param_set( rfc_ctx, &wl_bak );
+
+        if( !ok )
+        {
+            rfc_ctx->mem_alloc( lut, 0, 0, RFC_MEM_AIM_WL_BINS );
+            return false;
+        }
+    }
+
+    if( rfc_ctx->wl_bin_lut ) rfc_ctx->mem_alloc( rfc_ctx->wl_bin_lut, 0, 0, RFC_MEM_AIM_WL_BINS );
+
+    rfc_ctx->wl_bin_count = lut ? count : 0;
+    rfc_ctx->wl_bin_lut   = lut;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class number from value
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param[in]  value         The value
+ * @param      class_number  The class number
+ *
+ * @return     true on success
+ */
+bool RFC_class_number( const void *ctx, rfc_value_t value, unsigned *class_number )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_number                    ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_number = QUANTIZE( rfc_ctx, value );
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class mean from class number
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param[in]  class_number  The class number
+ * @param      class_mean    The class mean
+ *
+ * @return     true on success
+ */
+bool RFC_class_mean( const void *ctx, unsigned class_number, rfc_value_t *class_mean )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_mean                      ||
+         rfc_ctx->state < RFC_STATE_INIT ||
+         class_number >= rfc_ctx->class_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_mean = CLASS_MEAN( rfc_ctx, class_number );
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class upper value from class nummer
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param[in]  class_number  The class number
+ * @param      class_upper   The class upper
+ *
+ * @return     true on success
+ */
+bool RFC_class_upper( const void *ctx, unsigned class_number, rfc_value_t *class_upper )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_upper                     ||
+         rfc_ctx->state < RFC_STATE_INIT ||
+         class_number >= rfc_ctx->class_count )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_upper = CLASS_UPPER( rfc_ctx, class_number );
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class count
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param      class_count   The class count
+ *
+ * @return     true on success
+ */
+bool RFC_class_count( const void *ctx, unsigned *class_count )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_count                     ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_count = rfc_ctx->class_count;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class offset
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param      class_offset  The class offset
+ *
+ * @return     true on success
+ */
+bool RFC_class_offset( const void *ctx, rfc_value_t *class_offset )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_offset                    ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_offset = rfc_ctx->class_offset;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get class width
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param      class_width   The class width
+ *
+ * @return     true on success
+ */
+bool RFC_class_width( const void *ctx, rfc_value_t *class_width )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !class_width                     ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *class_width = rfc_ctx->class_width;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get hysteresis
+ *
+ * @param[in]  ctx           The rainflow context
+ * @param      hysteresis    The hysteresis
+ *
+ * @return     true on success
+ */
+bool RFC_hysteresis( const void *ctx, rfc_value_t *hysteresis )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !hysteresis                      ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    *hysteresis = rfc_ctx->hysteresis;
+
+    return true;
+}
+
+
+/**
+ * @brief      Widen the hysteresis, so that every reversal filtered forms
+ *             cycles with negligible damage only. A reversal of delta
+ *             spans at most floor(delta/w)+1 classes (w the narrowest class
+ *             width), the largest span whose cycles all stay below the
+ *             damage limit (at any mean and condition) gives the
+ *             hysteresis. Turning points filtered never reach residue,
+ *             turning point storage or damage history.
+ *
+ * @param      ctx           The rainflow context
+ * @param      fraction      The damage limit per cycle, as fraction of the
+ *                           damage of one cycle at the reference point of
+ *                           the Woehler curve (1/wl_nx)
+ * @param[out] damage_bound  The maximum damage of one cycle filtered, may be NULL.
+ *                           The damage error is bounded by damage_bound per
+ *                           reversal filtered.
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! The hysteresis is never narrowed.
+ */
+bool RFC_hysteresis_from_damage( void *ctx, double fraction, double *damage_bound )
+{
+    unsigned class_count;
+    unsigned span, span_max = 0;
+    double   width, D_limit, D_max = 0.0;
+    unsigned i;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT || !rfc_ctx->class_count || fraction < 0.0 )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    class_count = rfc_ctx->class_count;
+    D_limit     = fraction / rfc_ctx->wl_nx;
+    width       = rfc_ctx->class_width;
+
+    if( rfc_ctx->class_bounds )
+    {
+        width = rfc_ctx->class_bounds[1] - rfc_ctx->class_bounds[0];
+
+        for( i = 1; i < class_count; i++ )
+        {
+            double w = rfc_ctx->class_bounds[i+1] - rfc_ctx->class_bounds[i];
+
+            if( w < width ) width = w;
+        }
+    }
+
+    for( span = 1; span < class_count; span++ )
+    {
+        double   D_span = 0.0;
+        unsigned conds  = rfc_ctx->wl_bin_lut ? rfc_ctx->wl_bin_count : 1;
+        unsigned cond;
+
+        for( i = 0; i + span < class_count; i++ )
+        {
+            for( cond = 0; cond < conds; cond++ )
+            {
+                double D_up, D_down;
+
+                if( rfc_ctx->wl_bin_lut )
+                {
+                    if( !damage_calc_cond( rfc_ctx, cond, i, i + span, &D_up,   NULL ) ||
+                        !damage_calc_cond( rfc_ctx, cond, i + span, i, &D_down, NULL ) )
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    if( !damage_calc( rfc_ctx, i, i + span, &D_up,   NULL ) ||
+                        !damage_calc( rfc_ctx, i + span, i, &D_down, NULL ) )
+                    {
+                        return false;
+                    }
+                }
+
+                if( D_up   > D_span ) D_span = D_up;
+                if( D_down > D_span ) D_span = D_down;
+            }
+        }
+
+        if( D_span > D_limit )
+        {
+            break;
+        }
+
+        if( D_span > D_max ) D_max = D_span;
+        span_max = span;
+    }
+
+    /* Reversals up to (span_max-1)*width span at most span_max classes */
+    if( span_max > 1 && ( span_max - 1 ) * width > rfc_ctx->hysteresis )
+    {
+        rfc_ctx->hysteresis = (rfc_value_t)( ( span_max - 1 ) * width );
+    }
+
+    if( damage_bound )
+    {
+        *damage_bound = D_max;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Set flags
+ *
+ * @param      ctx        The rainflow context
+ * @param[in]  flags      The flags
+ * @param[in]  overwrite  Overwrites, if true
+ * @param[in]  stack      ID of flags stack
+ *
+ * @return     true on success
+ */
+bool RFC_flags_set( void *ctx, int flags, int stack, bool overwrite )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    switch( stack )
+    {
+        case 0:
+            if( overwrite )
+            {
+                rfc_ctx->internal.flags = (rfc_flags_e)flags;
+            }
+            else
+            {
+                rfc_ctx->internal.flags |= (rfc_flags_e)flags;
+            }
+            break;
+
+#if RFC_DEBUG_FLAGS
+        case 1:
+            if( overwrite )
+            {
+                rfc_ctx->internal.debug_flags = (rfc_debug_flags_e)flags;
+            }
+            else
+            {
+                rfc_ctx->internal.debug_flags |= (rfc_debug_flags_e)flags;
+            }
+            break;
+#endif /*RFC_DEBUG_FLAGS*/
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Unset flags (mask)
+ *
+ * @param      ctx        The rainflow context
+ * @param[in]  flags      The flags
+ * @param[in]  stack      ID of flags stack
+ *
+ * @return     true on success
+ */
+bool RFC_flags_unset( void *ctx, int flags, int stack )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    switch( stack )
+    {
+        case 0:
+            rfc_ctx->internal.flags &= (rfc_flags_e)~flags;
+            break;
+
+#if RFC_DEBUG_FLAGS
+        case 1:
+            rfc_ctx->internal.debug_flags &= (rfc_debug_flags_e)~flags;
+            break;
+#endif /*RFC_DEBUG_FLAGS*/
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Get flags
+ *
+ * @param      ctx    The rainflow context
+ * @param[out] flags  Flag for debugging flags
+ * @param[in]  stack  ID of flags stack
+ *
+ * @return     true on success
+ */
+bool RFC_flags_get( const void *ctx, int *flags, int stack )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    switch( stack )
+    {
+        case 0:
+            *flags = (int)rfc_ctx->internal.flags;
+            break;
+
+#if RFC_DEBUG_FLAGS
+        case 1:
+            *flags = (int)rfc_ctx->internal.debug_flags;
+            break;
+#endif /*RFC_DEBUG_FLAGS*/
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Check flags
+ *
+ * @param      ctx              The rainflow context
+ * @param[in]  flags_to_check   flags to test if set
+ * @param[in]  stack            ID of flags stack
+ *
+ * @return     true if flags are set
+ */
+bool RFC_flags_check( const void *ctx, int flags_to_check, int stack )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    int flags;
+
+    if( !RFC_flags_get( ctx, &flags, stack ) )
+    {
+        return false;
+    }
+
+    return ( flags & flags_to_check ) == flags_to_check;
+}
+
+
+/**
+ * @brief      Set Woehler curve parameters
+ *
+ * @param      ctx       The rainflow context
+ * @param[in]  wl_param  The Woehler curve parameters
+ *
+ * @return     true on success
+ */
+bool RFC_wl_param_set( void *ctx, const rfc_wl_param_s *wl_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+    
+    if( !wl_param                        ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    rfc_ctx->wl_sx          = wl_param->sx;
+    rfc_ctx->wl_nx          = wl_param->nx;
+    rfc_ctx->wl_k           = wl_param->k;
+    rfc_ctx->wl_q           = wl_param->q;
+    rfc_ctx->wl_sd          = wl_param->sd;
+    rfc_ctx->wl_nd          = wl_param->nd;
+    rfc_ctx->wl_k2          = wl_param->k2;
+    rfc_ctx->wl_q2          = wl_param->q2;
+    rfc_ctx->wl_omission    = wl_param->omission;
+
+    return true;
+}
+
+
+/**
+ * @brief      Get Woehler curve parameters
+ *
+ * @param      ctx       The rainflow context
+ * @param[out] wl_param  The Woehler curve parameters
+ *
+ * @return     true on success
+ */
+bool RFC_wl_param_get( const void *ctx, rfc_wl_param_s *wl_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+    
+    if( !wl_param                        ||
+         rfc_ctx->state < RFC_STATE_INIT )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    wl_param->sx            = rfc_ctx->wl_sx;
+    wl_param->nx            = rfc_ctx->wl_nx;
+    wl_param->k             = rfc_ctx->wl_k;
+    wl_param->q             = rfc_ctx->wl_q;
+    wl_param->sd            = rfc_ctx->wl_sd;
+    wl_param->nd            = rfc_ctx->wl_nd;
+    wl_param->q2            = rfc_ctx->wl_q2;
+    wl_param->k2            = rfc_ctx->wl_k2;
+    wl_param->omission      = rfc_ctx->wl_omission;
+    wl_param->D             = 0.0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Set parameters for the local strain approach.
+ *             Closed cycles are converted into local stresses and strains
+ *             (Neuber, Ramberg-Osgood, Masing) and assessed by the strain-life
+ *             curve (SWT or Morrow). The damage look-up table is rebuilt, so
+ *             the per cycle costs equal the nominal stress approach.
+ *
+ * @param      ctx       The rainflow context
+ * @param      sl_param  The local strain approach parameters, 
+ *                       sl_param->model = RFC_SL_MODEL_NONE returns to the Woehler curve
+ *
+ * @return     true on success
+ * 
+ * @note       Only valid before feeding! Miners' consequent rule and 
+ *             amplitude transformation don't apply, the damage parameter 
+ *             regards mean stress itself. Woehler curves per condition
+ *             (RFC_wl_bins_init()) are not supported.
+ */
+bool RFC_sl_param_set( void *ctx, const rfc_sl_param_s *sl_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( rfc_ctx->state != RFC_STATE_INIT || !sl_param )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( sl_param->model != RFC_SL_MODEL_NONE )
+    {
+        if( ( sl_param->model != RFC_SL_MODEL_SWT && sl_param->model != RFC_SL_MODEL_MORROW ) ||
+            !( sl_param->E  > 0.0 ) || !( sl_param->K  > 0.0 ) || !( sl_param->n > 0.0 ) ||
+            !( sl_param->sf > 0.0 ) || !( sl_param->ef > 0.0 ) || !( sl_param->b < 0.0 ) ||
+            !( sl_param->c  < 0.0 ) || !( sl_param->Kt > 0.0 ) )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        }
+
+        if( rfc_ctx->wl_bin_lut )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+        }
+    }
+
+    rfc_ctx->sl = *sl_param;
+
+#if RFC_DAMAGE_FAST
+    if( rfc_ctx->damage_lut )
+    {
+        return damage_lut_init( rfc_ctx );
+    }
+#endif /*RFC_DAMAGE_FAST*/
+
+    return true;
+}
+
+
+/**
+ * @brief      Get parameters for the local strain approach.
+ *
+ * @param      ctx       The rainflow context
+ * @param[out] sl_param  The local strain approach parameters
+ *
+ * @return     true on success
+ */
+bool RFC_sl_param_get( const void *ctx, rfc_sl_param_s *sl_param )
+{
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !sl_param )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_FINISHED )
+    {
+        return false;
+    }
+
+    *sl_param = rfc_ctx->sl;
+
+    return true;
+}
+#endif /*!RFC_MINIMAL*/
+
+
+
+#if RFC_AT_SUPPORT
+/**
+ * @brief      Amplitude transformation to take mean load influence into
+ *             account.
+ *
+ * @param      ctx             The rainflow context
+ * @param      Sa              Amplitude
+ * @param      Sm              Mean load
+ * @param[out] Sa_transformed  Transformed amplitude Sa
+ *
+ * @return     true on success
+ */
+bool RFC_at_transform( const void *ctx, double Sa, double Sm, double *Sa_transformed )
+{
+    double Sa_transform = Sa;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    if( !Sa_transformed )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+    
+    /* Amplitude is always positive */
+    Sa = fabs( Sa );
+
+#if RFC_USE_DELEGATES
+    if( rfc_ctx->at_transform_fcn )
+    {
+        return rfc_ctx->at_transform_fcn( rfc_ctx, Sa, Sm, Sa_transformed );
+    }
+#endif
+
+    if( !rfc_ctx->at.count )
+    {
+        /* No reference curve given, return original amplitude */
+        *Sa_transformed = Sa;
+        return true;
+    }
+
+    if( Sa == 0.0 )
+    {
+        /* Zero amplitude */
+        Sa_transform = 0.0;
+    }
+    else
+    {
+        double Sm_norm_base;
+        double Sm_norm_target;
+        double alleviation_base;
+        double alleviation_target;
+
+        /* Normalize Sm (Sa=1) */
+        Sm_norm_base = Sm / Sa;
+        if( !at_alleviation( rfc_ctx, Sm_norm_base, &alleviation_base ) )
+        {
+            return false;
+        }
+
+        if( rfc_ctx->at.R_pinned )
+        {
+            /* Calculate intersection of R slope and M slope */
+            if( !at_R_to_Sm_norm( rfc_ctx, rfc_ctx->at.R_rig, &Sm_norm_target ) )
+            {
+                return false;
+            }
+
+            if( !at_alleviation( rfc_ctx, Sm_norm_target, &alleviation_target ) )
+            {
+                return false;
+            }
+
+            Sa_transform = Sa / alleviation_base * alleviation_target;
+        }
+        else
+        {
+            /* Calculate intersection of mean load on test rig (Sm_rig) with curve taken from Haigh diagram */
+            const double   *Sa_   = rfc_ctx->at.Sa;
+            const double   *Sm_   = rfc_ctx->at.Sm;
+                  unsigned  count = rfc_ctx->at.count;
+                  unsigned  n;
+                  double    Sa_lhs, Sa_rhs;
+                  double    Sm_lhs, Sm_rhs;
+
+            /* Check each segment from the reference curve */
+            for( n = 0; n <= count; n++ )
+            {
+                if( n )
+                {
+                    Sa_lhs = Sa_rhs;
+                    Sm_lhs = Sm_rhs;
+
+                    if( n < count )
+                    {
+                        if( !at_alleviation( rfc_ctx, Sm_[n] / Sa_[n], &alleviation_target ) )
+                        {
+                            return false;
+                        }
+
+                        /* Next segment */
+                        Sa_rhs = Sa / alleviation_base * alleviation_target;
+                        Sm_rhs = Sa_rhs / Sa_[n] * Sm_[n];
+                    }
+                    else
+                    {
+                        /* Last segment */
+                        assert( Sm_lhs <= rfc_ctx->at.Sm_rig );
+
+                        Sa_transform = Sa_lhs;
+                    }
+                }
+                else /* n == 0 */
+                {
+                    if( !at_alleviation( rfc_ctx, Sm_[0] / Sa_[0], &alleviation_target ) )
+                    {
+                        return false;
+                    }
+
+                    /* First segment */
+                    Sa_rhs = Sa / alleviation_base * alleviation_target;
+                    Sm_rhs = Sa_rhs / Sa_[0] * Sm_[0];
+
+                    if( rfc_ctx->at.Sm_rig <= Sm_rhs)
+                    {
+                        Sa_transform = Sa_rhs;
+                        break;
+                    }
+                    else continue;
+                }
+
+                /* Interpolate intermediate points */
+                if( Sm_lhs <= rfc_ctx->at.Sm_rig && rfc_ctx->at.Sm_rig <= Sm_rhs )
+                {
+                    double frac, denom;
+
+                    denom = Sm_rhs - Sm_lhs;
+
+                    frac = ( denom < 1e-20 ) ? 1.0 : ( ( rfc_ctx->at.Sm_rig - Sm_lhs ) / denom );
+
+                    Sa_transform = Sa_lhs * ( 1.0 - frac ) + Sa_rhs * frac;
+                    break;
+                }
+            }
+        }
+    }
+
+    *Sa_transformed = Sa_transform;
+
+    return true;
+}
+#endif /*RFC_AT_SUPPORT*/
+
+#if RFC_DEBUG_FLAGS
+int RFC_debug_fprintf( void *ctx, FILE *stream, const char *fmt, ... )
+{
+    int result;
+    va_list arg;
+
+    RFC_CTX_CHECK_AND_ASSIGN
+
+    va_start( arg, fmt );
+
+#if RFC_USE_DELEGATES
+    if( rfc_ctx->debug_vfprintf_fcn )
+    {
+        result = rfc_ctx->debug_vfprintf_fcn( rfc_ctx, stream, fmt, arg );
+    }
+    else
+#endif /*RFC_USE_DELEGATES*/
+    {
+        result = vfprintf( stream, fmt, arg );
+    }
+
+    va_end( arg );
+
+    return result;
+}
+#endif /*RFC_DEBUG_FLAGS*/
+
+
+
+
+
+
+
+
+
+
+/*** Implementation static functions ***/
+
+#if RFC_AT_SUPPORT
+/**
+ * @brief      Clear all data for amplitude transformation
+ *
+ * @param      rfc_ctx  The rainflow context
+ */
+static
+void clear_at( rfc_ctx_s *rfc_ctx )
+{
+    assert( rfc_ctx );
+
+    rfc_ctx->at.Sa                      = NULL;
+    rfc_ctx->at.Sm                      = NULL;
+    rfc_ctx->at.count                   = 0;
+    rfc_ctx->at.M                       = 0.0;
+    rfc_ctx->at.Sm_rig                  = 0.0;
+    rfc_ctx->at.R_rig                   = 0.0;
+    rfc_ctx->at.R_pinned                = false;
+
+    rfc_ctx->internal.at_haigh.count    = 0;
+
+}
+#endif /*RFC_AT_SUPPORT*/
+
+
+#if RFC_DAMAGE_FAST
+static
+void clear_lut( rfc_ctx_s *rfc_ctx )
+{
+    assert( rfc_ctx && rfc_ctx->state >= RFC_STATE_INIT );
+
+    if( rfc_ctx->damage_lut )
+    {
+        memset( rfc_ctx->damage_lut, 0, sizeof(double) * rfc_ctx->class_count * rfc_ctx->class_count );
+    }
+    rfc_ctx->damage_lut_inapt = 1;
+
+#if RFC_AT_SUPPORT
+    if( rfc_ctx->amplitude_lut )
+    {
+        memset( rfc_ctx->amplitude_lut, 0, sizeof(double) * rfc_ctx->class_count * rfc_ctx->class_count );
+    }
+#endif /*RFC_AT_SUPPORT*/
+}
+#endif /*RFC_DH_SUPPORT*/
+
+
+#if RFC_AR_SUPPORT
+static
+bool autoresize( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s* pt )
+{
+    unsigned     cls             = QUANTIZE( rfc_ctx, pt->value );
+    unsigned     class_count     = rfc_ctx->class_count,
+                 class_count_old = class_count,
+                 class_shift     = 0;
+    rfc_value_t  class_offset    = rfc_ctx->class_offset;
+    void        *ptr;
+    size_t       i, j;
+
+    if( pt->value < rfc_ctx->class_offset )
+    {
+        class_shift   = (unsigned)ceil( ( class_offset - (rfc_value_t)(pt->value) ) / rfc_ctx->class_width + 0.5 );
+        class_count  += class_shift;
+        class_offset -= rfc_ctx->class_width * class_shift;
+    }
+    else if( pt->cls >= class_count )
+    {
+        class_count = (unsigned)ceil( ( (rfc_value_t)(pt->value) - class_offset ) / rfc_ctx->class_width + 0.5 );
+    }
+    else
+    {
+        return true;
+    }
+
+    /* Non-uniform classes and conditional matrices can't be extended */
+    if( rfc_ctx->class_bounds || rfc_ctx->cond_rfm )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_DATA_OUT_OF_RANGE );
+    }
+
+    if( class_count > RFC_CLASS_COUNT_MAX )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+
+    rfc_ctx->class_count  = class_count;
+    rfc_ctx->class_offset = class_offset;
+
+    pt->cls = QUANTIZE( rfc_ctx, pt->value );
+
+#if RFC_DAMAGE_FAST
+    {
+        rfc_state_e old_state = rfc_ctx->state;
+
+        if( rfc_ctx->damage_lut )
+        {
+            ptr = rfc_ctx->mem_alloc( rfc_ctx->damage_lut, class_count * class_count, 
+                                      sizeof(double), RFC_MEM_AIM_DLUT );
+            if( !ptr )
+            {
+                rfc_ctx->state = old_state;
+                return false;
+            }
+            else
+            {
+                rfc_ctx->damage_lut       = (double*)ptr;
+                rfc_ctx->damage_lut_inapt = 1;
+            }
+        }
+
+#if RFC_AT_SUPPORT
+        if( rfc_ctx->amplitude_lut )
+        {
+            ptr = rfc_ctx->mem_alloc( rfc_ctx->amplitude_lut, class_count * class_count, 
+                                      sizeof(double), RFC_MEM_AIM_ALUT );
+            if( !ptr )
+            {
+                rfc_ctx->state = old_state;
+                return false;
+            }
+            else
+            {
+                rfc_ctx->amplitude_lut = (double*)ptr;
+            }
+        }
+#endif /*RFC_AT_SUPPORT*/
+    
+        rfc_ctx->state = RFC_STATE_INIT;
+        damage_lut_init( rfc_ctx );
+        rfc_ctx->state = old_state;
+    }
+#endif /*RFC_DAMAGE_FAST*/
+
+    if( rfc_ctx->residue )
+    {
+        size_t residue_cap = 2 * class_count + 1;
+
+        if( residue_cap < rfc_ctx->residue_cap )
+        {
+            /* Never shrink (value domain counting may have grown the residue) */
+            residue_cap = rfc_ctx->residue_cap;
+        }
+
+        ptr = rfc_ctx->mem_alloc( rfc_ctx->residue, residue_cap, 
+                                  sizeof( rfc_value_tuple_s ), RFC_MEM_AIM_RESIDUE );
+
+        if( !ptr )
+        {
+            return false;
+        }
+
+        rfc_ctx->residue     = (rfc_value_tuple_s*)ptr;
+        rfc_ctx->residue_cap = residue_cap;
+
+        /* Residuum */
+        for( i = 0; i < rfc_ctx->residue_cnt; i++ )
+        {
+            rfc_ctx->residue[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->residue[i].value );
+        }
+    }
+
+    for( i = 0; i < rfc_ctx->internal.residue_cap; i++ )
+    {
+        rfc_ctx->internal.residue[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.residue[i].value );
+    }
+
+    /* RFM */
+    if( rfc_ctx->rfm )
+    {
+        ptr = rfc_ctx->mem_alloc( NULL, class_count * class_count, 
+                                  sizeof(rfc_counts_t), RFC_MEM_AIM_MATRIX );    
+        if( !ptr )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            rfc_counts_t *rfm = (rfc_counts_t*)ptr;
+
+            for( i = 0; i < class_count_old; i++ )
+            {
+                for( j = 0; j < class_count_old; j++ )
+                {
+                    rfm[ MAT_OFFS( i + class_shift, j + class_shift ) ] = rfc_ctx->rfm[ i * class_count_old + j ];
+                }
+            }
+
+            ptr = rfc_ctx->rfm;
+            rfc_ctx->rfm = rfm;
+            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_MATRIX );
+        }
+    }
+
+#if !RFC_MINIMAL
+    /* Rainflow matrix pyramid has to be rebuilt on the new grid */
+    rfc_ctx->rfm_rev++;
+
+    /* LC */
+    if( rfc_ctx->lc )
+    {
+        ptr = rfc_ctx->mem_alloc( NULL, class_count,
+                                  sizeof(rfc_counts_t), RFC_MEM_AIM_LC );
+        if( !ptr )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            rfc_counts_t* lc = (rfc_counts_t*)ptr;
+
+            for( i = 0; i < class_count_old; i++ )
+            {
+                lc[i + class_shift] = rfc_ctx->lc[i];
+            }
+
+            ptr = rfc_ctx->lc;
+            rfc_ctx->lc = lc;
+            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_LC );
+        }
+
+        /* RP */
+        ptr = rfc_ctx->mem_alloc( NULL, class_count,
+                                  sizeof(rfc_counts_t), RFC_MEM_AIM_RP );
+        if( !ptr )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            rfc_counts_t* rp = (rfc_counts_t*)ptr;
+
+            for( i = 0; i < class_count_old; i++ )
+            {
+                rp[i] = rfc_ctx->rp[i];
+            }
+
+            ptr = rfc_ctx->rp;
+            rfc_ctx->rp = rp;
+            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_RP );
+        }
+    }
+
+    /* TAL */
+    if( rfc_ctx->tal )
+    {
+        ptr = rfc_ctx->mem_alloc( NULL, class_count,
+                                  sizeof(size_t), RFC_MEM_AIM_TAL );
+        if( !ptr )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            size_t* tal = (size_t*)ptr;
+
+            for( i = 0; i < class_count_old; i++ )
+            {
+                tal[i + class_shift] = rfc_ctx->tal[i];
+            }
+
+            ptr = rfc_ctx->tal;
+            rfc_ctx->tal = tal;
+            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_TAL );
+        }
+    }
+
+    /* RMM */
+    if( rfc_ctx->rmm )
+    {
+        ptr = rfc_ctx->mem_alloc( NULL, RMM_SIZE( class_count ),
+                                  sizeof(rfc_counts_t), RFC_MEM_AIM_RMM );
+        if( !ptr )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            rfc_counts_t *rmm = (rfc_counts_t*)ptr;
+            rfc_counts_t *rmm_it = rfc_ctx->rmm;
+
+            /* Range classes are kept, mean classes (i+j) are shifted by 2*class_shift */
+            for( i = 0; i < class_count_old; i++ )
+            {
+                for( j = 0; j < class_count_old - i; j++ )
+                {
+                    rmm[ RMM_OFFS( i, i + 2 * ( j + class_shift ) ) ] = *rmm_it++;
+                }
+            }
+
+            ptr = rfc_ctx->rmm;
+            rfc_ctx->rmm = rmm;
+            rfc_ctx->mem_alloc( ptr, 0, 0, RFC_MEM_AIM_RMM );
+        }
+    }
+
+    /* RMD, range and duration classes are kept, mean classes are shifted by 2*class_shift */
+    if( rfc_ctx->rmd && class_shift && !rmd_rehash( rfc_ctx, rfc_ctx->rmd_cap, 2 * class_shift ) )
+    {
+        return false;
+    }
+#endif /*!RFC_MINIMAL*/
+
+#if RFC_TP_SUPPORT
+    /* RFC_STATE_BUSY_INTERIM affects residue only */
+    for( i = 0; i < rfc_ctx->tp_cnt; i++ )
+    {
+#if RFC_USE_DELEGATES
+        if( rfc_ctx->tp_get_fcn || rfc_ctx->tp_set_fcn )
+        {
+            rfc_value_tuple_s *pt;
+
+            tp_get( rfc_ctx, i + 1, &pt );  /* tp_pos is base 1 */
+            pt->cls = QUANTIZE( rfc_ctx, pt->value );
+            tp_set( rfc_ctx, i + 1, pt );  /* tp_pos is base 1 */
+        }
+#else /*!RFC_USE_DELEGATES*/
+        rfc_ctx->tp[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->tp[i].value );
+#endif /*RFC_USE_DELEGATES*/
+    }
+
+    rfc_ctx->internal.margin[0].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.margin[0].value );
+    rfc_ctx->internal.margin[1].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.margin[1].value );
+
+#endif /*RFC_TP_SUPPORT*/
+
+#if RFC_GLOBAL_EXTREMA
+    rfc_ctx->internal.extrema[0].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.extrema[0].value );
+    rfc_ctx->internal.extrema[1].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.extrema[1].value );
+#endif /*RFC_GLOBAL_EXTREMA*/
+
+#if RFC_HCM_SUPPORT
+    for( i = 0; i < rfc_ctx->internal.hcm.stack_cap; i++ )
+    {
+        rfc_ctx->internal.hcm.stack[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.hcm.stack[i].value );
+    }
+#endif /*RFC_HCM_SUPPORT*/
+
+    return true;
+}
+
+#endif /*RFC_AR_SUPPORT*/
+
+
+/**
+ * @brief      Processing one data point. Find turning points and check for
+ *             closed cycles.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param[in]  pt       The data tuple
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool feed_once( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt, rfc_flags_e flags )
+{
+    rfc_value_tuple_s *tp_residue;  /* Pointer to residue element */
+
+    assert( rfc_ctx && pt );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+#if RFC_DH_SUPPORT
+    /* Resize damage history if necessary */
+    if( !feed_once_dh( rfc_ctx, pt ) )
+    {
+        return false;
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    /* Check for next turning point and update residue. tp_residue is NULL, if there is no turning point */
+    /* Otherwise tp_residue refers the forelast element in member rfc_ctx->residue */
+    tp_residue = feed_filter_pt( rfc_ctx, pt );
+
+#if !RFC_MINIMAL
+    /* Fan out new turning point to followers */
+    if( tp_residue && rfc_ctx->follower_cnt && !follower_feed( rfc_ctx, tp_residue ) )
+    {
+        return false;
+    }
+#endif /*!RFC_MINIMAL*/
+
+#if RFC_TP_SUPPORT
+    /* Check if pt influences margins (tp_residue may be set to NULL then!) */
+    if( !feed_once_tp_check_margin( rfc_ctx, pt, &tp_residue ) )
+    {
+        return false;
+    }
+#endif /*RFC_TP_SUPPORT*/
+
+    /* Countings */
+
+    /* Add turning point and check for closed cycles */
+    if( tp_residue )
+    {
+#if RFC_TP_SUPPORT
+        /* Add a copy of tp_residue to rfc_ctx->tp and alter tp_residue->tp_pos to its position in rfc_ctx->tp */
+        if( !tp_set( rfc_ctx, 0, tp_residue ) )
+        {
+            return false;
+        }
+#endif /*RFC_TP_SUPPORT*/
+
+#if !RFC_MINIMAL
+        /* New turning point, do LC count */
+        cycle_process_lc( rfc_ctx, flags & (RFC_FLAGS_COUNT_LC | RFC_FLAGS_ENFORCE_MARGIN) );
+        flags &= ~RFC_FLAGS_COUNT_LC;
+
+        if( VALUE_MODE( rfc_ctx ) && !value_mode_check( rfc_ctx ) )
+        {
+            return false;
+        }
+#endif /*!RFC_MINIMAL*/
+
+        if( rfc_ctx->class_count || VALUE_MODE( rfc_ctx ) )
+        {
+            /* Check for closed cycles and count. Modifies residue! */
+            cycle_find( rfc_ctx, flags );
+
+            /* Counting raises errors (e.g. on memory allocation) without return value */
+            if( rfc_ctx->state == RFC_STATE_ERROR )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if( rfc_ctx->residue_cnt > 1 )
+            {
+                residue_remove_item( rfc_ctx, 0, 1 );
+            }
+        }
+    }
+
+    return true;
+}
+
+
+#if !RFC_MINIMAL
+/**
+ * @brief      Processing one turning point found elsewhere (by a leader
+ *             or given as such), bypassing the filter. Append it to the
+ *             residue and check for closed cycles. The interim turning
+ *             point is left unset.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param[in]  tp       The new turning point
+ *
+ * @return     true on success
+ */
+static
+bool feed_once_tp( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s *tp )
+{
+    rfc_value_tuple_s *tp_residue;
+    rfc_flags_e        flags = rfc_ctx->internal.flags;
+
+    assert( rfc_ctx && tp );
+
+    if( rfc_ctx->state < RFC_STATE_INIT || rfc_ctx->state > RFC_STATE_BUSY_INTERIM )
+    {
+        return false;
+    }
+
+#if RFC_DH_SUPPORT
+    if( !feed_once_dh( rfc_ctx, tp ) )
+    {
+        return false;
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    /* In value domain, residue length isn't bounded by class count */
+    if( rfc_ctx->residue_cnt + 2 >= rfc_ctx->residue_cap && VALUE_MODE( rfc_ctx ) && !residue_grow( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    /* Append turning point, the slot following is the interim turning point */
+    assert( rfc_ctx->residue_cnt + 1 < rfc_ctx->residue_cap );
+    tp_residue     = &rfc_ctx->residue[rfc_ctx->residue_cnt++];
+    *tp_residue    = *tp;
+    rfc_ctx->state = RFC_STATE_BUSY_INTERIM;
+
+#if RFC_TP_SUPPORT
+    tp_residue->tp_pos = 0;
+
+    if( !tp_set( rfc_ctx, 0, tp_residue ) )
+    {
+        return false;
+    }
+#endif /*RFC_TP_SUPPORT*/
+
+    /* New turning point, do LC count */
+    cycle_process_lc( rfc_ctx, flags & (RFC_FLAGS_COUNT_LC | RFC_FLAGS_ENFORCE_MARGIN) );
+    flags &= ~RFC_FLAGS_COUNT_LC;
+
+    if( VALUE_MODE( rfc_ctx ) && !value_mode_check( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    if( rfc_ctx->class_count || VALUE_MODE( rfc_ctx ) )
+    {
+        cycle_find( rfc_ctx, flags );
+
+        /* Counting raises errors (e.g. on memory allocation) without return value */
+        if( rfc_ctx->state == RFC_STATE_ERROR )
+        {
+            return false;
+        }
+    }
+    else if( rfc_ctx->residue_cnt > 1 )
+    {
+        residue_remove_item( rfc_ctx, 0, 1 );
+    }
+
+    return true;
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if RFC_DH_SUPPORT
+/**
+ * @brief      Resize damage history if necessary.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param[in]  pt       The data tuple
+ *
+ * @return     true on success
+ */
+static
+bool feed_once_dh( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt )
+{
+    assert( rfc_ctx );
+    assert( pt );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    if( rfc_ctx->dh )
+    {
+        if( pt->pos > rfc_ctx->dh_cap )
+        {
+            double *new_ptr = NULL;
+            size_t new_cap = (size_t)1024 * ( pt->pos / 640 + 1 ); /* + 60% + 1024 */
+
+            new_ptr = (double*)rfc_ctx->mem_alloc( rfc_ctx->dh, new_cap, 
+                                                   sizeof(rfc_value_t), RFC_MEM_AIM_DH );
+
+            if( !new_ptr )
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+            }
+
+            memset( new_ptr + rfc_ctx->dh_cnt, 0, sizeof(rfc_value_t) * ( new_cap - rfc_ctx->dh_cap ) );
+            rfc_ctx->dh = new_ptr;
+            rfc_ctx->dh_cap = new_cap;
+        }
+
+        rfc_ctx->dh_cnt = pt->pos;
+    }
+
+    return true;
+}
+#endif /*RFC_DH_SUPPORT*/
+
+
+#if RFC_TP_SUPPORT
+/**
+ * @brief         Check if pt influences margins.
+ *
+ * @param         rfc_ctx     The rainflow context
+ * @param[in]     pt          The new data tuple
+ * @param[in,out] tp_residue  The new turning point (or NULL)
+ *
+ * @return        true on success
+ */
+bool feed_once_tp_check_margin( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt, rfc_value_tuple_s** tp_residue )
+{
+    bool do_margin;
+
+    assert( rfc_ctx && tp_residue );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    do_margin = rfc_ctx->internal.flags & RFC_FLAGS_ENFORCE_MARGIN;
+
+    if( do_margin && !rfc_ctx->tp_locked )
+    {
+        /* Check for left and right margin */
+        switch( rfc_ctx->internal.margin_stage )
+        {
+            case 0:
+            {
+                rfc_value_tuple_s pt_left = *pt;
+
+                assert( *tp_residue == NULL );
+
+                /* Save left margin */
+                rfc_ctx->internal.margin[0]  = *pt;
+
+                /* Enqueue left margin as turning point */
+                if( !tp_set( rfc_ctx, 0, &pt_left ) ) return false;
+
+                rfc_ctx->internal.margin_stage = 1;
+                break;
+            }
+
+            case 1:
+            {
+                /* Save right margin so far */
+                rfc_ctx->internal.margin[1] = *pt;
+
+                /* Prevent storing 1st point twice */
+                if( *tp_residue )
+                {
+                    /* First turning point found */
+                    rfc_ctx->internal.margin_stage = 2;
+
+                    if( (*tp_residue)->value == rfc_ctx->internal.margin[0].value )
+                    {
+                        assert( rfc_ctx->tp_cnt <= 1 );
+
+                        /* Left margin and first turning point are identical, set reference in residue */
+                        (*tp_residue)->tp_pos = 1;
+                        (*tp_residue) = 0;  /* Avoid further processing of this turning point */
+                    }
+                }
+                break;
+            }
+
+            case 2:
+                /* Save right margin so far */
+                rfc_ctx->internal.margin[1] = *pt;
+                break;
+
+            default:
+                assert( false );
+        }
+    }
+
+    return true;
+}
+#endif /*RFC_TP_SUPPORT*/
+
+
+/**
+ * @brief      Handling interim turning point and margin. If there are still
+ *             unhandled turning point left, "finalizing" takes this into
+ *             account for the rainflow algorithm.
+ *
+ * @param      rfc_ctx  The rainflow context
+ *
+ * @return     true on success
+ */
+static
+bool feed_finalize( rfc_ctx_s *rfc_ctx )
+{
+    rfc_value_tuple_s *tp_interim = NULL;
+
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    if( rfc_ctx->state < RFC_STATE_FINALIZE )
+    {
+        /* Adjust residue: Incorporate interim turning point */
+        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
+        {
+            tp_interim = &rfc_ctx->residue[rfc_ctx->residue_cnt];
+            rfc_ctx->residue_cnt++;
+
+            rfc_ctx->state = RFC_STATE_BUSY;
+        }
+
+#if RFC_TP_SUPPORT
+        /* Finalize turning point storage */
+        if( !feed_finalize_tp( rfc_ctx, tp_interim, rfc_ctx->internal.flags ) )
+        {
+            return false;
+        }
+#endif /*RFC_TP_SUPPORT*/
+
+        if( tp_interim )
+        {
+            int flags = rfc_ctx->internal.flags;
+#if !RFC_MINIMAL
+            /* New turning point, do LC count */
+            cycle_process_lc( rfc_ctx, rfc_ctx->internal.flags & (RFC_FLAGS_COUNT_LC | RFC_FLAGS_ENFORCE_MARGIN) );
+            flags &= ~RFC_FLAGS_COUNT_LC;
+#endif /*!RFC_MINIMAL*/
+
+            /* Check once more if a new cycle is closed now */
+#if RFC_TP_SUPPORT
+            /* feed_finalize_tp(...) has locked the tp storage, but we may need to alter .pos and .adj_pos */
+            tp_lock( rfc_ctx, false );
+            cycle_find( rfc_ctx, flags );
+            tp_lock( rfc_ctx, true );
+#else /*!RFC_TP_SUPPORT*/
+            cycle_find( rfc_ctx, flags );
+#endif /*RFC_TP_SUPPORT*/
+        }
+
+#if RFC_HCM_SUPPORT
+        if( !feed_finalize_hcm( rfc_ctx, rfc_ctx->internal.flags ) )
+        {
+            return false;
+        }
+#endif /*RFC_HCM_SUPPORT*/
+
+        rfc_ctx->state = RFC_STATE_FINALIZE;
+    }
+
+    return true;
+}
+
+
+#if RFC_TP_SUPPORT
+/**
+ * @brief         Finalize turning point storage.
+ *
+ * @param         rfc_ctx     The rainflow context
+ * @param[in,out] tp_interim  The interim turning point (or NULL)
+ * @param         flags       Only flag RFC_FLAGS_ENFORCE_MARGIN encounters
+ *
+ * @return        true on success
+ */
+static
+bool feed_finalize_tp( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *tp_interim, rfc_flags_e flags )
+{
+    bool do_margin;
+
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    
+    /* Finalize turning points storage */
+    do_margin = rfc_ctx->internal.flags & RFC_FLAGS_ENFORCE_MARGIN;
+    if( do_margin && !rfc_ctx->tp_locked )
+    {
+        rfc_value_tuple_s *pt_right = &rfc_ctx->internal.margin[1];
+
+        if( tp_interim )
+        {
+            if( rfc_ctx->internal.margin_stage > 0 && tp_interim->value == pt_right->value )
+            {
+                if( !tp_set( rfc_ctx, 0, pt_right ) ) return false;
+                tp_interim->tp_pos = pt_right->tp_pos;
+            }
+            else
+            {
+                if( !tp_set( rfc_ctx, 0, tp_interim ) ) return false;
+                if( !tp_set( rfc_ctx, 0, pt_right ) )   return false;
+            }
+        }
+        else if( pt_right->pos > 0 )
+        {
+            if( !tp_set( rfc_ctx, 0, pt_right ) )   return false;
+        }
+    }
+    else if( tp_interim )
+    {
+        if( !tp_set( rfc_ctx, 0, tp_interim ) ) return false;
+    }
+
+    /* Lock turning points storage */
+    tp_lock( rfc_ctx, true );
+    return true;
+}
+#endif /*RFC_TP_SUPPORT*/
+
+
+#if RFC_HCM_SUPPORT
+/**
+ * @brief      Finalize HCM algorithm: copy residue.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool feed_finalize_hcm( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Move HCM stack to residue */
+    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_HCM )
+    {
+        int stack_cnt = rfc_ctx->internal.hcm.IZ; /* Number of turning points in HCM stack */
+
+        if( stack_cnt )
+        {
+            /* Reallocate residue */
+            rfc_ctx->residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( rfc_ctx->residue, (size_t)stack_cnt, 
+                                                                       sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
+
+            if( !rfc_ctx->residue )
+            {
+                return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+            }
+
+            memcpy( rfc_ctx->residue, rfc_ctx->internal.hcm.stack, sizeof(rfc_value_tuple_s) * stack_cnt );
+
+            rfc_ctx->residue_cap = stack_cnt;
+            rfc_ctx->residue_cnt = stack_cnt;
+
+            /* Make HCM stack empty */
+            rfc_ctx->internal.hcm.IZ = 0;
+            rfc_ctx->internal.hcm.IR = 1;
+        }
+    }
+
+    return true;
+}
+#endif /*RFC_HCM_SUPPORT*/
+
+
+/**
+ * @brief      Finalize pending counts, ignore residue.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_ignore( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Include interim turning point */
+    return feed_finalize( rfc_ctx );
+}
+
+
+/**
+ * @brief      Finalize pending counts, ignore residue, don't finalize
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_no_finalize( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    rfc_ctx->state = RFC_STATE_FINALIZE;
+
+    return true;
+}
+
+
+#if !RFC_MINIMAL
+/**
+ * @brief      Finalize pending counts, discard residue.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_discard( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Include interim turning point */
+    if( !feed_finalize( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    /* Empty residue */
+    rfc_ctx->residue_cnt = 0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Finalize pending counts, weight unclosed cycles into RP,
+ *             RF-matrix and damage and discard residue.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      weight   The weight for closed cycles
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_weight_cycles( rfc_ctx_s *rfc_ctx, rfc_counts_t weight, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Include interim turning point */
+    if( !feed_finalize( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    /* Count every unclosed cycle with the given weight */
+    if( rfc_ctx->residue && rfc_ctx->residue_cnt >= 2 )
+    {
+        size_t             i;
+        int                flags    = rfc_ctx->internal.flags;
+        rfc_value_tuple_s *from     = rfc_ctx->residue;
+        rfc_counts_t       old_inc  = rfc_ctx->curr_inc;
+
+        rfc_ctx->curr_inc = weight;
+
+        for( i = 0; i + 1 < rfc_ctx->residue_cnt; i++ )
+        {
+            rfc_value_tuple_s *to   = from + 1;
+            rfc_value_tuple_s *next = ( i + 2 < rfc_ctx->residue_cnt ) ? to + 1 : NULL;
+
+            cycle_process_counts( rfc_ctx, from, to, next, flags );
+
+            from = to;
+        }
+
+        rfc_ctx->curr_inc = old_inc;
+    }
+
+    /* Empty residue */
+    rfc_ctx->residue_cnt = 0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Finalize pending counts to fit HCM results.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_clormann_seeger( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    size_t i;
+
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Include interim turning point */
+    if( !feed_finalize( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_4PTM )
+    {
+        /* Counting correction on residue */
+
+        for( i = 0; i + 4 < rfc_ctx->residue_cnt; )
+        {
+            size_t idx = rfc_ctx->residue_cnt + i;
+
+            double A = (double)rfc_ctx->residue[idx+0].value;
+            double B = (double)rfc_ctx->residue[idx+1].value;
+            double C = (double)rfc_ctx->residue[idx+2].value;
+            double D = (double)rfc_ctx->residue[idx+3].value;
+
+            if( B * C < 0.0 && fabs(D) >= fabs(B) && fabs(B) >= fabs(C) )
+            {
+                rfc_value_tuple_s *from = &rfc_ctx->residue[idx+1];
+                rfc_value_tuple_s *to   = &rfc_ctx->residue[idx+2];
+
+                cycle_process_counts( rfc_ctx, from, to, to + 1, flags );
+
+                /* Remove two inner turning points (idx+1 and idx+2) */
+                residue_remove_item( rfc_ctx, i + 1, 2 );
+                rfc_ctx->residue_cnt -= 2;
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Finalize pending counts, DIN method.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_rp_DIN45667( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Include interim turning point */
+    if( !feed_finalize( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    if( flags && rfc_ctx->residue_cnt > 2 )
+    {
+        int i, j, k;
+        int slopes_cnt = (int)rfc_ctx->residue_cnt - 1;
+        struct slopes
+        {
+            int slope;
+            rfc_value_tuple_s *lhs;
+            rfc_value_tuple_s *rhs;
+        } *slopes, tmp;
+
+        slopes = (struct slopes*)rfc_ctx->mem_alloc( NULL, slopes_cnt, sizeof( slopes[0] ), RFC_MEM_AIM_TEMP );
+
+        if( !slopes )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        /* Evaluate slopes */
+        for( i = 0; i < slopes_cnt; i++ )
+        {
+            slopes[i].lhs   = &rfc_ctx->residue[i];
+            slopes[i].rhs   = &rfc_ctx->residue[i+1];
+            slopes[i].slope = (int)slopes[i].rhs->cls - slopes[i].lhs->cls;
+        }
+
+        /* Order slopes (simple "bubble sort") */
+        k = 0;
+        for( i = 0; i < slopes_cnt; i++ )
+        {
+            /* Drag higher ranks */
+            for( j = slopes_cnt - 2; j >= i; j-- )
+            {
+                bool do_swap = false;
+
+                if( ( slopes[j].slope > 0 ) == ( slopes[j+1].slope > 0 ) )
+                {
+                    do_swap = abs( slopes[j].slope ) < abs( slopes[j+1].slope );
+                }
+                else
+                {
+                    do_swap = slopes[j].slope < 0;
+                    k       = j + 1;  /* k indicates the first falling slope now */
+                }
+
+                if( do_swap )
+                {
+                    tmp         = slopes[j];
+                    slopes[j]   = slopes[j+1];
+                    slopes[j+1] = tmp;
+                }
+            }
+        }
+
+        assert( k > 0 );
+
+        /* Compare positive slopes with adjacent negative slopes */
+        for( i = 0; i < k && i + k < slopes_cnt; i++ )
+        {
+            /* Get the smaller slope of two adjacent. On equality choose the primarily in time */
+            int lh_slope = slopes[i].slope;
+            int rh_slope = slopes[i+k].slope;
+
+            if( abs( lh_slope ) == abs( rh_slope ) )
+            {
+                j = ( slopes[i].rhs->pos < slopes[i+k].rhs->pos ) ? i : (i+k);
+            }
+            else
+            {
+                j = ( abs( lh_slope ) < abs( rh_slope ) ) ? i : (i+k);
+            }
+
+            /* Do the countings for the matching slope */
+            cycle_process_counts( rfc_ctx, slopes[j].lhs, slopes[j].rhs, NULL, flags );
+        }
+
+        rfc_ctx->mem_alloc( slopes, 0, 0, RFC_MEM_AIM_TEMP );
+    }
+
+    /* Empty residue */
+    rfc_ctx->residue_cnt = 0;
+
+    return true;
+}
+
+
+/**
+ * @brief      Finalize pending counts, repeated residue method.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      flags    The flags
+ *
+ * @return     true on success
+ */
+static
+bool finalize_res_repeated( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+
+    /* Process only, if residue is present */
+    if( rfc_ctx->residue && rfc_ctx->residue_cnt && flags )
+    {
+        /* Feed again with the content of the residue itself */
+        size_t              cnt     = rfc_ctx->residue_cnt;
+        rfc_value_tuple_s  *residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, cnt + 1, 
+                                                                              sizeof(rfc_value_tuple_s), RFC_MEM_AIM_TEMP );
+
+        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
+        {
+            cnt++;
+        }
+
+        if( !residue )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+        else
+        {
+            /* Make a copy of the residue */
+            bool                     ok;
+            size_t                   n         = cnt; 
+            int                      old_flags = rfc_ctx->internal.flags;
+            const rfc_value_tuple_s *from      = rfc_ctx->residue;
+                  rfc_value_tuple_s *to        = residue;
+
+            while( n-- )
+            {
+                *to++ = *from++;
+            }
+
+            rfc_ctx->internal.flags = flags;
+
+            /* 
+             * Feed again with the copy, no new turning points are generated, since residue[].tp_pos
+             * but last cycle might not be closed due to interim state of the last point.
+             * Remove that cycle before feeding with the residue again:
+             */
+            if( cnt >= 4 )
+            {
+                size_t idx = cnt - 4;
+
+                unsigned A = residue[idx+0].cls;
+                unsigned B = residue[idx+1].cls;
+                unsigned C = residue[idx+2].cls;
+                unsigned D = residue[idx+3].cls;
+
+                if( B > C )
+                {
+                    unsigned temp = B;
+                    B = C;
+                    C = temp;
+                }
+
+                if( A > D )
+                {
+                    unsigned temp = A;
+                    A = D;
+                    D = temp;
+                }
+
+                /* Check for closed cycles [3] */
+                if( A <= B && C <= D )
+                {
+                    residue[idx+1] = residue[idx+3];
+                    cnt -= 2;
+                }
+            }
+
+#if RFC_TP_SUPPORT
+            do
+            {
+                size_t tp_cnt = rfc_ctx->tp_cnt;
+
+                /* Feed with all but the last data point, which will be handled later */
+                ok = RFC_feed_tuple( rfc_ctx, residue, cnt - 1 );
+
+                if( ok )
+                {
+                    /* The only scenario in which the number of turning points increases, is when
+                       the interim turning point gets a real turning point */
+                    if( rfc_ctx->tp_cnt > tp_cnt )
+                    {
+                        /* Interim turning point became a turning point, fix the copy */
+                        residue[cnt-1].tp_pos = tp_cnt + 1;
+                    }
+                    /* Process the last data point */
+                    ok = RFC_feed_tuple( rfc_ctx, residue + cnt - 1, 1 );
+                }
+            } while(0);
+#else /*!RFC_TP_SUPPORT*/
+            ok = RFC_feed_tuple( rfc_ctx, residue, cnt );
+#endif /*RFC_TP_SUPPORT*/
+
+            rfc_ctx->internal.flags = old_flags;
+
+            /* Free temporary residue */
+            rfc_ctx->mem_alloc( residue, 0, 0, RFC_MEM_AIM_TEMP );
+
+            if( !ok )
+            {
+                return false;
+            }
+        }
+    }
+
+    /* Include interim turning point */
+    if( !feed_finalize( rfc_ctx ) )
+    {
+        return false;
+    }
+
+    /* Empty residue */
+    rfc_ctx->residue_cnt = 0;
+
+    return true;
+}
+
+
+/**
+ * @brief         Backup/restore of residue
+ *
+ * @param         rfc_ctx      The rainflow context
+ * @param[in,out] residue      The copy of the current residue
+ * @param[out]    residue_cap  The capacity of the given residue
+ * @param[out]    residue_cnt  The number of points in the given residue
+ * @param         restore      true->restore, false->backup
+ *
+ * @return        true on success
+ */
+static
+bool residue_exchange( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s **residue, size_t *residue_cap, size_t *residue_cnt, bool restore )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    assert( residue && residue_cap && residue_cnt );
+    assert( rfc_ctx->residue_cap > 0 );
+
+    if( !restore )
+    {
+        /* Backup */
+        *residue_cap = rfc_ctx->residue_cap;
+        *residue_cnt = rfc_ctx->residue_cnt;
+        *residue     = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, *residue_cap, 
+                                                               sizeof(rfc_value_tuple_s), RFC_MEM_AIM_TEMP );
+
+        if( !*residue )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( *residue, rfc_ctx->residue, *residue_cnt * sizeof(rfc_value_tuple_s) );
+    }
+    else
+    {
+        /* Restore */
+
+        /* Release residue */
+        (rfc_value_tuple_s*)rfc_ctx->mem_alloc( rfc_ctx->residue, /*num*/ 0, /*size*/ 0, RFC_MEM_AIM_TEMP );
+
+        /* Assign backup */
+        rfc_ctx->residue_cap = *residue_cap;
+        rfc_ctx->residue_cnt = *residue_cnt;
+        rfc_ctx->residue     = *residue;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief      Initialize a clone of the counting state. Members owning memory
+ *             are detached from the original, residue (and HCM stack) are
+ *             copied, look-up tables are shared and other results are
+ *             omitted. Release by ctx_clone_deinit() only.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param[out] clone    The clone
+ *
+ * @return     true on success
+ */
+static
+bool ctx_clone_init( rfc_ctx_s *rfc_ctx, rfc_ctx_s *clone )
+{
+    assert( rfc_ctx && clone );
+
+    *clone = *rfc_ctx;
+
+#if RFC_USE_DELEGATES
+    clone->internal.obj                 = NULL;
+#endif /*RFC_USE_DELEGATES*/
+
+    clone->residue                      = NULL;
+    clone->rfm                          = NULL;
+    clone->rp                           = NULL;
+    clone->lc                           = NULL;
+    clone->rmm                          = NULL;
+    clone->rmd                          = NULL;
+    clone->rmd_cap                      = 0;
+    clone->rmd_cnt                      = 0;
+    clone->rfm_pyr                      = NULL;
+    clone->rfm_pyr_cap                  = 0;
+    clone->rfm_pyr_levels               = 0;
+    clone->cycles                       = NULL;
+    clone->cycles_cap                   = 0;
+    clone->cycles_cnt                   = 0;
+    clone->cond_rfm                     = NULL;
+    clone->cond_damage                  = NULL;
+    clone->tal                          = NULL;
+    clone->top                          = NULL;
+    clone->top_cap                      = 0;
+    clone->top_cnt                      = 0;
+    memset( clone->snapshot, 0, sizeof(clone->snapshot) );
+    clone->snapshot_epoch               = 0;
+    clone->snapshot_tiles               = 0;
+    clone->region                       = NULL;
+    clone->region_dirty                 = NULL;
+    clone->region_tiles                 = 0;
+#if RFC_SHM_SUPPORT
+    clone->region_shm_name              = NULL;
+#endif /*RFC_SHM_SUPPORT*/
+    clone->followers                    = NULL;
+    clone->follower_cnt                 = 0;
+
+#if RFC_TP_SUPPORT
+    clone->tp                           = NULL;
+    clone->tp_cap                       = 0;
+    clone->tp_cnt                       = 0;
+    clone->tp_locked                    = 0;
+    clone->internal.tp_static           = false;
+#if RFC_USE_DELEGATES
+    clone->tp_next_fcn                  = NULL;
+    clone->tp_set_fcn                   = NULL;
+    clone->tp_get_fcn                   = NULL;
+    clone->tp_inc_damage_fcn            = NULL;
+#endif /*RFC_USE_DELEGATES*/
+#endif /*RFC_TP_SUPPORT*/
+
+#if RFC_DH_SUPPORT
+    clone->dh                           = NULL;
+    clone->dh_cap                       = 0;
+    clone->dh_cnt                       = 0;
+    clone->internal.dh_static           = false;
+#if RFC_USE_DELEGATES
+    clone->spread_damage_fcn            = NULL;
+#endif /*RFC_USE_DELEGATES*/
+#endif /*RFC_DH_SUPPORT*/
 
 #if RFC_HCM_SUPPORT
-    for( i = 0; i < rfc_ctx->internal.hcm.stack_cap; i++ )
+    clone->internal.hcm.stack           = NULL;
+#endif /*RFC_HCM_SUPPORT*/
+
+    /* Residue, including the interim turning point */
+    if( rfc_ctx->internal.res_static )
+    {
+        clone->residue                  = clone->internal.residue;
+    }
+    else
+    {
+        clone->residue                  = (rfc_value_tuple_s*)clone->mem_alloc( NULL, clone->residue_cap,
+                                                                                sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
+        if( !clone->residue )
+        {
+            (void)ctx_clone_deinit( clone );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( clone->residue, rfc_ctx->residue, sizeof(rfc_value_tuple_s) * rfc_ctx->residue_cap );
+    }
+
+#if RFC_HCM_SUPPORT
+    if( rfc_ctx->internal.hcm.stack )
+    {
+        clone->internal.hcm.stack       = (rfc_value_tuple_s*)clone->mem_alloc( NULL, clone->internal.hcm.stack_cap,
+                                                                                sizeof(rfc_value_tuple_s), RFC_MEM_AIM_HCM );
+        if( !clone->internal.hcm.stack )
+        {
+            (void)ctx_clone_deinit( clone );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( clone->internal.hcm.stack, rfc_ctx->internal.hcm.stack, sizeof(rfc_value_tuple_s) * clone->internal.hcm.stack_cap );
+    }
+#endif /*RFC_HCM_SUPPORT*/
+
+    return true;
+}
+
+
+/**
+ * @brief      Release a clone of the counting state.
+ *             Shared look-up tables stay untouched.
+ *
+ * @param      clone  The clone
+ *
+ * @return     true on success
+ */
+static
+bool ctx_clone_deinit( rfc_ctx_s *clone )
+{
+    assert( clone );
+
+    clone->class_bounds                 = NULL;
+    clone->class_bounds_lut             = NULL;
+    clone->wl_bin_lut                   = NULL;
+#if RFC_DAMAGE_FAST
+    clone->damage_lut                   = NULL;
+#if RFC_AT_SUPPORT
+    clone->amplitude_lut                = NULL;
+#endif /*RFC_AT_SUPPORT*/
+#endif /*RFC_DAMAGE_FAST*/
+
+    return RFC_deinit( clone );
+}
+
+
+/**
+ * @brief      Initialize a fork of the counting state for finalizing.
+ *             Residue and counts are copied, look-up tables are shared,
+ *             other results are omitted.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param[out] fork     The fork
+ *
+ * @return     true on success
+ */
+static
+bool finalize_fork_init( rfc_ctx_s *rfc_ctx, rfc_ctx_s *fork )
+{
+    size_t class_count;
+
+    assert( rfc_ctx && fork );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINALIZE );
+
+    class_count = rfc_ctx->class_count;
+
+    if( !ctx_clone_init( rfc_ctx, fork ) )
+    {
+        return false;
+    }
+
+#if RFC_DH_SUPPORT
+    fork->internal.flags               &= ~RFC_FLAGS_COUNT_DH;
+#endif /*RFC_DH_SUPPORT*/
+#if RFC_TP_SUPPORT
+    fork->internal.flags               &= ~RFC_FLAGS_TPAUTOPRUNE;
+#endif /*RFC_TP_SUPPORT*/
+#if RFC_AR_SUPPORT
+    fork->internal.flags               &= ~RFC_FLAGS_AUTORESIZE;
+#endif /*RFC_AR_SUPPORT*/
+
+    /* Counts */
+    if( rfc_ctx->rfm )
+    {
+        fork->rfm = (rfc_counts_t*)fork->mem_alloc( NULL, class_count * class_count, sizeof(rfc_counts_t), RFC_MEM_AIM_MATRIX );
+        if( !fork->rfm )
+        {
+            (void)ctx_clone_deinit( fork );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( fork->rfm, rfc_ctx->rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    }
+
+    if( rfc_ctx->rp )
+    {
+        fork->rp = (rfc_counts_t*)fork->mem_alloc( NULL, class_count, sizeof(rfc_counts_t), RFC_MEM_AIM_RP );
+        if( !fork->rp )
+        {
+            (void)ctx_clone_deinit( fork );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( fork->rp, rfc_ctx->rp, sizeof(rfc_counts_t) * class_count );
+    }
+
+    if( rfc_ctx->lc )
+    {
+        fork->lc = (rfc_counts_t*)fork->mem_alloc( NULL, class_count, sizeof(rfc_counts_t), RFC_MEM_AIM_LC );
+        if( !fork->lc )
+        {
+            (void)ctx_clone_deinit( fork );
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+        }
+
+        memcpy( fork->lc, rfc_ctx->lc, sizeof(rfc_counts_t) * class_count );
+    }
+
+    return true;
+}
+#endif /*!RFC_MINIMAL*/
+
+
+/**
+ * @brief      Remove items (points) from the residue
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      index    The item position in residue, base 0
+ * @param      count    The number of elements to remove
+ */
+static
+void residue_remove_item( rfc_ctx_s *rfc_ctx, size_t index, size_t count )
+{
+    size_t  from = index + count,
+            to   = index, 
+            end;
+
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    assert( rfc_ctx->residue && index + count <= rfc_ctx->residue_cnt );
+
+    end = (int)rfc_ctx->residue_cnt;
+
+    /* Example
+                         |cnt(5)
+                         v
+               |O|O|X|O|O|
+                   ^
+                   |index(2)
+
+        elements = 2    (5-2-1+0 = 2, no interim turning point)
+    */
+
+    if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
+    {
+        /* Include interim turning point */
+        end++;
+    }
+
+    /* Shift points */
+    while( from < end )
+    {
+        rfc_ctx->residue[to++] = rfc_ctx->residue[from++];
+    }
+
+    rfc_ctx->residue_cnt -= count;
+}
+
+
+/**
+ * @brief      Double the residue capacity (needed in value domain counting,
+ *             where residue length isn't bounded by class count).
+ *
+ * @param      rfc_ctx  The rainflow context
+ *
+ * @return     true on success
+ */
+static
+bool residue_grow( rfc_ctx_s *rfc_ctx )
+{
+    rfc_value_tuple_s  *residue;
+    size_t              residue_cap;
+
+    assert( rfc_ctx && rfc_ctx->residue );
+
+    residue_cap = 2 * rfc_ctx->residue_cap;
+
+    if( rfc_ctx->internal.res_static )
+    {
+        residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, residue_cap, 
+                                                          sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
+        if( residue )
+        {
+            memcpy( residue, rfc_ctx->residue, sizeof(rfc_value_tuple_s) * rfc_ctx->residue_cap );
+            rfc_ctx->internal.res_static = false;
+        }
+    }
+    else
+    {
+        residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( rfc_ctx->residue, residue_cap, 
+                                                          sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
+    }
+
+    if( !residue )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+    }
+
+    rfc_ctx->residue     = residue;
+    rfc_ctx->residue_cap = residue_cap;
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate damage for one cycle with given amplitude Sa
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      Sa       The amplitude
+ * @param[out] damage   The damage
+ *
+ * @return     true on success
+ */
+static
+bool damage_calc_amplitude( rfc_ctx_s *rfc_ctx, double Sa, double *damage )
+{
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT );
+
+    do {
+        /* Damage */
+        double D = 0.0;
+
+        if( Sa >= 0.0 )
+        {
+            /* D =           h /    ND   *    ( Sa /    SD)  ^ ABS(k)   */
+            /* D = exp(  log(h /    ND)  + log( Sa /    SD)  * ABS(k) ) */
+            /* D = exp( (log(h)-log(ND)) + (log(Sa)-log(SD)) * ABS(k) ) */
+            /* D = exp(      0 -log(ND)  + (log(Sa)-log(SD)) * ABS(k) ) */
+
+            /* If D is integer format count:
+             * 
+             * D_integer = (double)(int)range ^ ABS(k)  // where range is 0..class_count-1
+             * 
+             * D = D_integer_sum * exp( log( ND * 2*SD/class_width ) * -ABS(k) )
+             * 
+             */
+
+#if !RFC_MINIMAL
+            if( Sa > rfc_ctx->wl_omission )
+            {
+                /* Constants for the Woehler curve */
+                const double SX_log = log(rfc_ctx->wl_sx);
+                const double NX_log = log(rfc_ctx->wl_nx);
+
+                if( Sa > rfc_ctx->wl_sx )
+                {
+                    const double k = rfc_ctx->wl_k;
+                    
+                    /* Upper slope, finite life scope */
+                    D = exp( fabs(k) * ( log(Sa) - SX_log ) - NX_log );
+                }
+                else if( Sa > rfc_ctx->wl_sd )
+                {
+                    const double k2 = rfc_ctx->wl_k2;
+
+                    /* Lower slope, transition scope, modified Miners' rule */
+                    D = exp( fabs(k2) * ( log(Sa) - SX_log ) - NX_log );
+                }
+                /* Amplitudes below fatigue strength have no influence */
+            }
+#else /*RFC_MINIMAL*/
+            /* Constants for the Woehler curve */
+            const double SX_log = log(rfc_ctx->wl_sx);
+            const double NX_log = log(rfc_ctx->wl_nx);
+            const double k      = rfc_ctx->wl_k;
+
+            /* Miner original */
+            D = exp( fabs(k)  * ( log(Sa) - SX_log ) - NX_log );
+#endif /*!RFC_MINIMAL*/
+        }
+        else
+        {
+            assert( false );
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+        }
+
+        *damage = D;
+        
+    } while(0);
+
+    return true;
+}
+
+
+#if RFC_AT_SUPPORT
+/**
+ * @brief      Calculate the normalized mean load (Sa=1) for a given load ratio
+ *             "R"
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      R        Load ratio (Su/So)
+ * @param[out] Sm_norm  Normalized mean load
+ *
+ * @return     true on success
+ */
+static
+bool at_R_to_Sm_norm( rfc_ctx_s *rfc_ctx, double R, double *Sm_norm )
+{
+    if( isinf( R ) || !Sm_norm )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_AT );
+    }
+
+    /* Su      = Sm - Sa */
+    /* So      = Sm + Sa */
+    /* R       = Su / So */
+    /* Sm      = Sa * ( 1 + R ) / ( 1 - R ) */
+    /* Sm_norm = Sm / Sa */
+
+    *Sm_norm = ( 1 + R ) / ( 1 - R );
+
+    return true;
+}
+
+
+/**
+ * @brief      Calculate the influence of (normalized, Sa=1) mean load on
+ *             fatigue strength (Haigh-diagram)
+ *
+ * @param      rfc_ctx      The rainflow context
+ * @param      Sm_norm      Mean load, normalized (Sm/Sa)
+ * @param[out] alleviation  Alleviation factor on reference curve
+ *
+ * @return     true on success
+ */
+static
+bool at_alleviation( rfc_ctx_s *rfc_ctx, double Sm_norm, double *alleviation )
+{
+    assert( rfc_ctx );
+
+    if( !alleviation )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_AT );
+    }
+
+    if( !rfc_ctx->at.count )
+    {
+        /* No reference curve given, no transformation */
+        *alleviation = 1.0;
+    }
+    else
+    {
+        /* Reference curve */
+        const double   *Sa_   = rfc_ctx->at.Sa;
+        const double   *Sm_   = rfc_ctx->at.Sm;
+              unsigned  count = rfc_ctx->at.count;
+
+        assert( rfc_ctx && Sm_ && Sa_ );
+
+        if( Sm_norm <= Sm_[0] / Sa_[0] )
+        {
+            /* First segment */
+            *alleviation = Sa_[0];  /* Clip to first point */
+        }
+        else if( Sm_norm >= Sm_[count-1] / Sa_[count-1] )
+        {
+            /* Last segment */
+            *alleviation = Sa_[count-1];  /* Clip to last point */
+        }
+        else
+        {
+            unsigned i;
+            bool done = false;
+
+            /* Select correct segment */
+            for( i = 1; !done && i < count; i++ )
+            {
+                assert( Sa_[i-1] > 0.0 && Sa_[i] > 0.0 && Sm_[i-1] <= Sm_[i] );
+
+                if( Sm_norm > Sm_[i-1] / Sa_[i-1] && Sm_norm <= Sm_[i] / Sa_[i] )
+                {
+                    /* Intersection of R slope and M slope */
+                    double M_signed = ( Sa_[i] - Sa_[i-1] ) / ( Sm_[i] - Sm_[i-1] );
+
+                    *alleviation = ( Sa_[i-1] - M_signed * Sm_[i-1] ) / ( 1.0 - M_signed * Sm_norm );
+                    done = true;
+                }
+            }
+
+            if( !done )
+            {
+                assert( false );
+                return error_raise( rfc_ctx, RFC_ERROR_AT );
+            }
+        }
+    }
+
+    return true;
+}
+#endif /*RFC_AT_SUPPORT*/
+
+
+/**
+ * @brief      Calculate pseudo damage for one closed (full) cycle.
+ *
+ * @param      rfc_ctx     The rainflow context
+ * @param      class_from  The starting class
+ * @param      class_to    The ending class
+ * @param[out] damage      The damage value for the closed cycle
+ * @param[out] Sa_ret      The amplitude, may be NULL
+ *
+ * @return     true on success
+ */
+static
+bool damage_calc( rfc_ctx_s *rfc_ctx, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret )
+{
+    double Sa = -1.0;  /* Negative amplitude states undefined */
+    double D  =  0.0;
+
+    assert( damage );
+    assert( rfc_ctx );
+    assert( rfc_ctx->state >= RFC_STATE_INIT );
+
+#if RFC_DAMAGE_FAST
+    if( rfc_ctx->damage_lut && !rfc_ctx->damage_lut_inapt)
+    {
+        if( !damage_calc_fast( rfc_ctx, class_from, class_to, &D, &Sa ) )
+        {
+            return false;
+        }
+    } 
+    else
+#endif /*RFC_DAMAGE_FAST*/
+
+#if RFC_USE_DELEGATES
+    if( rfc_ctx->damage_calc_fcn )
+    {
+        if( !rfc_ctx->damage_calc_fcn( rfc_ctx, class_from, class_to, &D, &Sa ) )
+        {
+            return false;
+        }
+    }
+    else
+#endif /*RFC_USE_DELEGATES*/
+
+
+    if( class_from != class_to )
+    {
+#if RFC_MINIMAL
+        Sa = CYCLE_SA( rfc_ctx, class_from, class_to );
+
+        if( !damage_calc_amplitude( rfc_ctx, Sa, &D ) )
+        {
+            return false;
+        }
+#else /*!RFC_MINIMAL*/
+        double Sa_i = CYCLE_SA( rfc_ctx, class_from, class_to );
+        double Sm_i = CYCLE_SM( rfc_ctx, class_from, class_to );
+
+        if( rfc_ctx->sl.model != RFC_SL_MODEL_NONE )
+        {
+            /* Local strain approach, amplitude stays undefined */
+            if( !sl_damage_calc( rfc_ctx, Sa_i, Sm_i, &D ) )
+            {
+                return false;
+            }
+        }
+        else if( Sa_i > 0.0 )
+        {
+#if RFC_AT_SUPPORT
+            /* Calculate transformation factor with normalized mean value */
+            if( !RFC_at_transform( rfc_ctx, Sa_i, Sm_i, &Sa ) )
+            {
+                return false;
+            }
+#else /*!RFC_AT_SUPPORT*/
+            Sa = Sa_i;
+#endif /*RFC_AT_SUPPORT*/
+
+            if( !damage_calc_amplitude( rfc_ctx, Sa, &D ) )
+            {
+                return false;
+            }
+        }
+#endif /*RFC_MINIMAL*/
+    }
+
+    if( Sa_ret )
+    {
+        *Sa_ret = Sa;
+    }
+
+    *damage = D;
+
+    return true;
+}
+
+
+#if !RFC_MINIMAL
+/**
+ * @brief      Get the condition a cycle is attributed to.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      from     The starting point
+ * @param      to       The ending point
+ *
+ * @return     The condition, base 0 (0 if conditional counting is off)
+ */
+static
+unsigned cycle_cond( const rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s *from, const rfc_value_tuple_s *to )
+{
+    unsigned cond;
+
+    assert( rfc_ctx && from && to );
+
+    if( !rfc_ctx->cond_count )
+    {
+        return 0;
+    }
+
+    switch( rfc_ctx->cond_rule )
     {
-        rfc_ctx->internal.hcm.stack[i].cls = QUANTIZE( rfc_ctx, rfc_ctx->internal.hcm.stack[i].value );
+        case RFC_COND_RULE_TO:
+            cond = to->cond;
+            break;
+        case RFC_COND_RULE_MAX:
+            cond = ( to->value > from->value ) ? to->cond : from->cond;
+            break;
+        default:
+            cond = from->cond;
+            break;
     }
-#endif /*RFC_HCM_SUPPORT*/
 
-    return true;
+    return ( cond < rfc_ctx->cond_count ) ? cond : rfc_ctx->cond_count - 1;
 }
 
-#endif /*RFC_AR_SUPPORT*/
-
 
 /**
- * @brief      Processing one data point. Find turning points and check for
- *             closed cycles.
+ * @brief      Calculate pseudo damage for one closed (full) cycle, 
+ *             regarding the Woehler curve of its condition.
  *
- * @param      rfc_ctx  The rainflow context
- * @param[in]  pt       The data tuple
- * @param      flags    The flags
+ * @param      rfc_ctx     The rainflow context
+ * @param      cond        The condition, base 0
+ * @param      class_from  The starting class
+ * @param      class_to    The ending class
+ * @param[out] damage      The damage value for the closed cycle
+ * @param[out] Sa_ret      The amplitude, may be NULL (undefined for
+ *                         Woehler curves per condition)
  *
  * @return     true on success
  */
 static
-bool feed_once( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt, rfc_flags_e flags )
+bool damage_calc_cond( rfc_ctx_s *rfc_ctx, unsigned cond, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret )
 {
-    rfc_value_tuple_s *tp_residue;  /* Pointer to residue element */
-
-    assert( rfc_ctx && pt );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    assert( damage );
+    assert( rfc_ctx );
 
-#if RFC_DH_SUPPORT
-    /* Resize damage history if necessary */
-    if( !feed_once_dh( rfc_ctx, pt ) )
+    if( !rfc_ctx->wl_bin_lut )
     {
-        return false;
+        return damage_calc( rfc_ctx, class_from, class_to, damage, Sa_ret );
     }
-#endif /*RFC_DH_SUPPORT*/
-
-    /* Check for next turning point and update residue. tp_residue is NULL, if there is no turning point */
-    /* Otherwise tp_residue refers the forelast element in member rfc_ctx->residue */
-    tp_residue = feed_filter_pt( rfc_ctx, pt );
 
-#if RFC_TP_SUPPORT
-    /* Check if pt influences margins (tp_residue may be set to NULL then!) */
-    if( !feed_once_tp_check_margin( rfc_ctx, pt, &tp_residue ) )
-    {
-        return false;
-    }
-#endif /*RFC_TP_SUPPORT*/
+    assert( cond < rfc_ctx->wl_bin_count );
+    assert( class_from < rfc_ctx->class_count && class_to < rfc_ctx->class_count );
 
-    /* Countings */
+    *damage = rfc_ctx->wl_bin_lut[ ( (size_t)cond * rfc_ctx->class_count + class_from ) * rfc_ctx->class_count + class_to ];
 
-    /* Add turning point and check for closed cycles */
-    if( tp_residue )
+    if( Sa_ret )
     {
-#if RFC_TP_SUPPORT
-        /* Add a copy of tp_residue to rfc_ctx->tp and alter tp_residue->tp_pos to its position in rfc_ctx->tp */
-        if( !tp_set( rfc_ctx, 0, tp_residue ) )
-        {
-            return false;
-        }
-#endif /*RFC_TP_SUPPORT*/
-
-#if !RFC_MINIMAL
-        /* New turning point, do LC count */
-        cycle_process_lc( rfc_ctx, flags & (RFC_FLAGS_COUNT_LC | RFC_FLAGS_ENFORCE_MARGIN) );
-        flags &= ~RFC_FLAGS_COUNT_LC;
-#endif /*!RFC_MINIMAL*/
-
-        if( rfc_ctx->class_count )
-        {
-            /* Check for closed cycles and count. Modifies residue! */
-            cycle_find( rfc_ctx, flags );
-        }
-        else
-        {
-            if( rfc_ctx->residue_cnt > 1 )
-            {
-                residue_remove_item( rfc_ctx, 0, 1 );
-            }
-        }
+        /* Negative amplitude states undefined */
+        *Sa_ret = -1.0;
     }
 
     return true;
 }
 
 
-#if RFC_DH_SUPPORT
 /**
- * @brief      Resize damage history if necessary.
+ * @brief      Local stress by Neuber's rule on the cyclic stress-strain curve
+ *             (m = 1) or on the hysteresis branch (Masing, m = 2).
+ *             sigma * eps(sigma) = (Kt*S)^2/E, with
+ *             eps(sigma) = sigma/E + m*(sigma/(m*K))^(1/n)
  *
- * @param      rfc_ctx  The rainflow context
- * @param[in]  pt       The data tuple
+ * @param      sl    The local strain approach parameters
+ * @param      S     The nominal value (or range, if m = 2), not negative
+ * @param      m     The scaling of the curve
  *
- * @return     true on success
+ * @return     The local stress (or range)
  */
 static
-bool feed_once_dh( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt )
+double sl_neuber( const rfc_sl_param_s *sl, double S, double m )
 {
-    assert( rfc_ctx );
-    assert( pt );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
-
-    if( rfc_ctx->dh )
-    {
-        if( pt->pos > rfc_ctx->dh_cap )
-        {
-            double *new_ptr = NULL;
-            size_t new_cap = (size_t)1024 * ( pt->pos / 640 + 1 ); /* + 60% + 1024 */
-
-            new_ptr = (double*)rfc_ctx->mem_alloc( rfc_ctx->dh, new_cap, 
-                                                   sizeof(rfc_value_t), RFC_MEM_AIM_DH );
+    double   rhs = sl->Kt * S * sl->Kt * S / sl->E;
+    double   lo  = 0.0;
+    double   hi  = sl->Kt * S;  /* Linear elastic solution is the upper limit */
+    unsigned i;
 
-            if( !new_ptr )
-            {
-                return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-            }
+    assert( sl && S >= 0.0 );
 
-            memset( new_ptr + rfc_ctx->dh_cnt, 0, sizeof(rfc_value_t) * ( new_cap - rfc_ctx->dh_cap ) );
-            rfc_ctx->dh = new_ptr;
-            rfc_ctx->dh_cap = new_cap;
-        }
+    /* Left hand side increases monotonically, bisection converges safely */
+    for( i = 0; i < 64; i++ )
+    {
+        double sigma = ( lo + hi ) / 2;
+        double eps   = sigma / sl->E + m * pow( sigma / ( m * sl->K ), 1.0 / sl->n );
 
-        rfc_ctx->dh_cnt = pt->pos;
+        if( sigma * eps > rhs ) hi = sigma;
+        else                    lo = sigma;
     }
 
-    return true;
+    return ( lo + hi ) / 2;
 }
-#endif /*RFC_DH_SUPPORT*/
 
 
-#if RFC_TP_SUPPORT
 /**
- * @brief         Check if pt influences margins.
+ * @brief      Solve A*(2N)^p + B*(2N)^q = L for the number of cycles N.
  *
- * @param         rfc_ctx     The rainflow context
- * @param[in]     pt          The new data tuple
- * @param[in,out] tp_residue  The new turning point (or NULL)
+ * @param      A     The elastic coefficient, not negative
+ * @param      p     The elastic exponent, negative
+ * @param      B     The plastic coefficient, positive
+ * @param      q     The plastic exponent, negative
+ * @param      L     The left hand side (damage parameter)
  *
- * @return        true on success
+ * @return     The number of cycles (0.5 at least, DBL_MAX if L isn't positive)
  */
-bool feed_once_tp_check_margin( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s* pt, rfc_value_tuple_s** tp_residue )
+static
+double sl_life( double A, double p, double B, double q, double L )
 {
-    bool do_margin;
+    double   lo = 0.0;   /* ln(2N) */
+    double   hi = 1.0;
+    unsigned i;
 
-    assert( rfc_ctx && tp_residue );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    if( !( L > 0.0 ) )
+    {
+        return DBL_MAX;
+    }
 
-    do_margin = rfc_ctx->internal.flags & RFC_FLAGS_ENFORCE_MARGIN;
+    /* Right hand side decreases monotonically in ln(2N) */
+    if( A + B <= L )
+    {
+        return 0.5;
+    }
 
-    if( do_margin && !rfc_ctx->tp_locked )
+    while( A * exp( p * hi ) + B * exp( q * hi ) > L )
     {
-        /* Check for left and right margin */
-        switch( rfc_ctx->internal.margin_stage )
+        lo  = hi;
+        hi *= 2;
+
+        if( hi > 700.0 )
         {
-            case 0:
-            {
-                rfc_value_tuple_s pt_left = *pt;
+            return DBL_MAX;
+        }
+    }
 
-                assert( *tp_residue == NULL );
+    for( i = 0; i < 64; i++ )
+    {
+        double x = ( lo + hi ) / 2;
 
-                /* Save left margin */
-                rfc_ctx->internal.margin[0]  = *pt;
+        if( A * exp( p * x ) + B * exp( q * x ) > L ) lo = x;
+        else                                          hi = x;
+    }
 
-                /* Enqueue left margin as turning point */
-                if( !tp_set( rfc_ctx, 0, &pt_left ) ) return false;
+    return exp( ( lo + hi ) / 2 ) / 2;
+}
 
-                rfc_ctx->internal.margin_stage = 1;
-                break;
-            }
 
-            case 1:
-            {
-                /* Save right margin so far */
-                rfc_ctx->internal.margin[1] = *pt;
+/**
+ * @brief      Calculate damage for one closed (full) cycle by the local
+ *             strain approach. The local maximum follows from the cyclic
+ *             stress-strain curve, the range from the hysteresis branch.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      Sa       The nominal amplitude
+ * @param      Sm       The nominal mean value
+ * @param[out] damage   The damage value for the closed cycle
+ *
+ * @return     true on success
+ */
+static
+bool sl_damage_calc( rfc_ctx_s *rfc_ctx, double Sa, double Sm, double *damage )
+{
+    const rfc_sl_param_s *sl = &rfc_ctx->sl;
+    double                S_max, sigma_max, sigma_r, sigma_m, eps_a, N;
 
-                /* Prevent storing 1st point twice */
-                if( *tp_residue )
-                {
-                    /* First turning point found */
-                    rfc_ctx->internal.margin_stage = 2;
+    assert( rfc_ctx && damage );
 
-                    if( (*tp_residue)->value == rfc_ctx->internal.margin[0].value )
-                    {
-                        assert( rfc_ctx->tp_cnt <= 1 );
+    *damage = 0.0;
 
-                        /* Left margin and first turning point are identical, set reference in residue */
-                        (*tp_residue)->tp_pos = 1;
-                        (*tp_residue) = 0;  /* Avoid further processing of this turning point */
-                    }
-                }
-                break;
-            }
+    if( !( Sa > 0.0 ) )
+    {
+        return true;
+    }
 
-            case 2:
-                /* Save right margin so far */
-                rfc_ctx->internal.margin[1] = *pt;
-                break;
+    S_max     = Sm + Sa;
+    sigma_max = sl_neuber( sl, fabs( S_max ), 1.0 );
+    sigma_max = ( S_max < 0.0 ) ? -sigma_max : sigma_max;
+    sigma_r   = sl_neuber( sl, 2.0 * Sa, 2.0 );
+    sigma_m   = sigma_max - sigma_r / 2;
+    eps_a     = ( sigma_r / sl->E + 2.0 * pow( sigma_r / ( 2.0 * sl->K ), 1.0 / sl->n ) ) / 2;
 
-            default:
-                assert( false );
-        }
+    switch( sl->model )
+    {
+        case RFC_SL_MODEL_SWT:
+            /* sigma_max * eps_a = sf^2/E*(2N)^(2b) + sf*ef*(2N)^(b+c) */
+            N = sl_life( sl->sf * sl->sf / sl->E, 2.0 * sl->b, sl->sf * sl->ef, sl->b + sl->c, sigma_max * eps_a );
+            break;
+        case RFC_SL_MODEL_MORROW:
+            /* eps_a = (sf-sigma_m)/E*(2N)^b + ef*(2N)^c */
+            N = sl_life( ( sigma_m < sl->sf ) ? ( sl->sf - sigma_m ) / sl->E : 0.0, sl->b, sl->ef, sl->c, eps_a );
+            break;
+        default:
+            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    if( N < DBL_MAX )
+    {
+        *damage = 1.0 / N;
     }
 
     return true;
 }
-#endif /*RFC_TP_SUPPORT*/
+#endif /*!RFC_MINIMAL*/
 
 
+#if RFC_DAMAGE_FAST
 /**
- * @brief      Handling interim turning point and margin. If there are still
- *             unhandled turning point left, "finalizing" takes this into
- *             account for the rainflow algorithm.
+ * @brief      Initialize a look-up table of damages for closed cycles. In this
+ *             implementation the midrange doesn't matter!
  *
  * @param      rfc_ctx  The rainflow context
  *
- * @return     true on success
+ * @returns    true on success
  */
-static
-bool feed_finalize( rfc_ctx_s *rfc_ctx )
+static 
+bool damage_lut_init( rfc_ctx_s *rfc_ctx )
 {
-    rfc_value_tuple_s *tp_interim = NULL;
+    double   *lut;
+    unsigned  from, 
+              to;
+    double    Sa;
 
     assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    assert( rfc_ctx->state == RFC_STATE_INIT );
 
-    if( rfc_ctx->state < RFC_STATE_FINALIZE )
+    if( rfc_ctx->damage_lut )
     {
-        /* Adjust residue: Incorporate interim turning point */
-        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
-        {
-            tp_interim = &rfc_ctx->residue[rfc_ctx->residue_cnt];
-            rfc_ctx->residue_cnt++;
-
-            rfc_ctx->state = RFC_STATE_BUSY;
-        }
-
-#if RFC_TP_SUPPORT
-        /* Finalize turning point storage */
-        if( !feed_finalize_tp( rfc_ctx, tp_interim, rfc_ctx->internal.flags ) )
-        {
-            return false;
-        }
-#endif /*RFC_TP_SUPPORT*/
+        lut = rfc_ctx->damage_lut;
+        rfc_ctx->damage_lut = NULL;
 
-        if( tp_interim )
+        for( from = 0; from < rfc_ctx->class_count; from++ )
         {
-            int flags = rfc_ctx->internal.flags;
-#if !RFC_MINIMAL
-            /* New turning point, do LC count */
-            cycle_process_lc( rfc_ctx, rfc_ctx->internal.flags & (RFC_FLAGS_COUNT_LC | RFC_FLAGS_ENFORCE_MARGIN) );
-            flags &= ~RFC_FLAGS_COUNT_LC;
-#endif /*!RFC_MINIMAL*/
-
-            /* Check once more if a new cycle is closed now */
-#if RFC_TP_SUPPORT
-            /* feed_finalize_tp(...) has locked the tp storage, but we may need to alter .pos and .adj_pos */
-            tp_lock( rfc_ctx, false );
-            cycle_find( rfc_ctx, flags );
-            tp_lock( rfc_ctx, true );
-#else /*!RFC_TP_SUPPORT*/
-            cycle_find( rfc_ctx, flags );
-#endif /*RFC_TP_SUPPORT*/
-        }
+            for( to = 0; to < rfc_ctx->class_count; to++ )
+            {
+                double D;
 
-#if RFC_HCM_SUPPORT
-        if( !feed_finalize_hcm( rfc_ctx, rfc_ctx->internal.flags ) )
-        {
-            return false;
+                if( !damage_calc( rfc_ctx, from, to, &D, &Sa ) )
+                {
+                    rfc_ctx->mem_alloc( lut, 0, 0, RFC_MEM_AIM_DLUT );
+                    return false;
+                }
+                lut[from * rfc_ctx->class_count + to] = D;
+#if RFC_AT_SUPPORT
+                if( rfc_ctx->amplitude_lut )
+                {
+                    rfc_ctx->amplitude_lut[from * rfc_ctx->class_count + to] = Sa;
+                }
+#endif /*RFC_AT_SUPPORT*/
+            }
         }
-#endif /*RFC_HCM_SUPPORT*/
 
-        rfc_ctx->state = RFC_STATE_FINALIZE;
+        rfc_ctx->damage_lut          = lut;
+        rfc_ctx->damage_lut_inapt    = 0;
     }
 
     return true;
 }
 
 
-#if RFC_TP_SUPPORT
 /**
- * @brief         Finalize turning point storage.
+ * @brief      Calculate pseudo damage for one closed (full) cycle, using
+ *             look-up table.
  *
- * @param         rfc_ctx     The rainflow context
- * @param[in,out] tp_interim  The interim turning point (or NULL)
- * @param         flags       Only flag RFC_FLAGS_ENFORCE_MARGIN encounters
+ * @param      rfc_ctx     The rainflow context
+ * @param      class_from  The starting class
+ * @param      class_to    The ending class
+ * @param[out] damage      The damage value for the closed cycle
+ * @param[out] Sa_ret      The amplitude (-1 if not available), may be NULL
  *
- * @return        true on success
+ * @return     true on success
  */
 static
-bool feed_finalize_tp( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *tp_interim, rfc_flags_e flags )
+bool damage_calc_fast( rfc_ctx_s *rfc_ctx, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret )
 {
-    bool do_margin;
+    double Sa = -1;    /* -1 means "uninitialized" */
+    double D  =  0.0;
 
+    assert( damage );
     assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
-    
-    /* Finalize turning points storage */
-    do_margin = rfc_ctx->internal.flags & RFC_FLAGS_ENFORCE_MARGIN;
-    if( do_margin && !rfc_ctx->tp_locked )
+    assert( rfc_ctx->state >= RFC_STATE_INIT );
+    assert( class_from < rfc_ctx->class_count );
+    assert( class_to   < rfc_ctx->class_count );
+
+    if( rfc_ctx->damage_lut && !rfc_ctx->damage_lut_inapt )
     {
-        rfc_value_tuple_s *pt_right = &rfc_ctx->internal.margin[1];
+        D = rfc_ctx->damage_lut[class_from * rfc_ctx->class_count + class_to];
 
-        if( tp_interim )
+        if( Sa_ret )
         {
-            if( rfc_ctx->internal.margin_stage > 0 && tp_interim->value == pt_right->value )
-            {
-                if( !tp_set( rfc_ctx, 0, pt_right ) ) return false;
-                tp_interim->tp_pos = pt_right->tp_pos;
-            }
-            else
+#if RFC_AT_SUPPORT
+            if( rfc_ctx->amplitude_lut )
             {
-                if( !tp_set( rfc_ctx, 0, tp_interim ) ) return false;
-                if( !tp_set( rfc_ctx, 0, pt_right ) )   return false;
+                *Sa_ret = rfc_ctx->amplitude_lut[class_from * rfc_ctx->class_count + class_to];
             }
-        }
-        else if( pt_right->pos > 0 )
-        {
-            if( !tp_set( rfc_ctx, 0, pt_right ) )   return false;
+#else /*!RFC_AT_SUPPORT*/
+            *Sa_ret = CYCLE_SA( rfc_ctx, class_from, class_to );
+#endif /*RFC_AT_SUPPORT*/
         }
     }
-    else if( tp_interim )
+    else
     {
-        if( !tp_set( rfc_ctx, 0, tp_interim ) ) return false;
+        return error_raise( rfc_ctx, RFC_ERROR_LUT );
     }
 
-    /* Lock turning points storage */
-    tp_lock( rfc_ctx, true );
+    *damage = D;
+
     return true;
 }
-#endif /*RFC_TP_SUPPORT*/
+#endif /*RFC_DAMAGE_FAST*/
 
 
-#if RFC_HCM_SUPPORT
+#if !RFC_MINIMAL
 /**
- * @brief      Finalize HCM algorithm: copy residue.
+ * @brief      Initialize a counting state for one plane in critical plane
+ *             counting, as a clone of a template context. Only damage is
+ *             counted, look-up tables (including Woehler curves per condition)
+ *             and amplitude transformation parameters are shared with the
+ *             template.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @param      rfc_ctx  The rainflow context (template)
+ * @param[out] plane    The plane counting state
  *
  * @return     true on success
  */
 static
-bool feed_finalize_hcm( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+bool cp_plane_init( rfc_ctx_s *rfc_ctx, rfc_ctx_s *plane )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    assert( rfc_ctx && plane );
+    assert( rfc_ctx->state == RFC_STATE_INIT );
 
-    /* Move HCM stack to residue */
-    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_HCM )
+    if( !ctx_clone_init( rfc_ctx, plane ) )
     {
-        int stack_cnt = rfc_ctx->internal.hcm.IZ; /* Number of turning points in HCM stack */
-
-        if( stack_cnt )
-        {
-            /* Reallocate residue */
-            rfc_ctx->residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( rfc_ctx->residue, (size_t)stack_cnt, 
-                                                                       sizeof(rfc_value_tuple_s), RFC_MEM_AIM_RESIDUE );
-
-            if( !rfc_ctx->residue )
-            {
-                return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-            }
-
-            memcpy( rfc_ctx->residue, rfc_ctx->internal.hcm.stack, sizeof(rfc_value_tuple_s) * stack_cnt );
-
-            rfc_ctx->residue_cap = stack_cnt;
-            rfc_ctx->residue_cnt = stack_cnt;
-
-            /* Make HCM stack empty */
-            rfc_ctx->internal.hcm.IZ = 0;
-            rfc_ctx->internal.hcm.IR = 1;
-        }
+        return false;
     }
 
+    plane->internal.flags              &= RFC_FLAGS_COUNT_MK | RFC_FLAGS_ENFORCE_MARGIN;
+    plane->internal.flags              |= RFC_FLAGS_COUNT_DAMAGE;
+    plane->cond_count                   = 0;
+
     return true;
 }
-#endif /*RFC_HCM_SUPPORT*/
 
 
 /**
- * @brief      Finalize pending counts, ignore residue.
- *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @brief      In-place radix-2 fast fourier transform (forward).
  *
- * @return     true on success
+ * @param[in,out] re  The real parts
+ * @param[in,out] im  The imaginary parts
+ * @param         n   The number of values, must be a power of 2
  */
 static
-bool finalize_res_ignore( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+void spectral_fft( double *re, double *im, unsigned n )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    const double    two_pi  = 6.28318530717958647692;
+    unsigned        i, j, len;
 
-    /* Include interim turning point */
-    return feed_finalize( rfc_ctx );
+    /* Bit reversal permutation */
+    for( i = 1, j = 0; i < n; i++ )
+    {
+        unsigned bit = n >> 1;
+
+        for( ; j & bit; bit >>= 1 )
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if( i < j )
+        {
+            double t;
+
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    /* Butterflies */
+    for( len = 2; len <= n; len <<= 1 )
+    {
+        double w_re = cos( -two_pi / len );
+        double w_im = sin( -two_pi / len );
+
+        for( i = 0; i < n; i += len )
+        {
+            double u_re = 1.0, u_im = 0.0;
+
+            for( j = 0; j < len / 2; j++ )
+            {
+                unsigned    a    = i + j;
+                unsigned    b    = i + j + len / 2;
+                double      t_re = re[b] * u_re - im[b] * u_im;
+                double      t_im = re[b] * u_im + im[b] * u_re;
+                double      tmp;
+
+                re[b]  = re[a] - t_re;
+                im[b]  = im[a] - t_im;
+                re[a] += t_re;
+                im[a] += t_im;
+
+                tmp    = u_re * w_re - u_im * w_im;
+                u_im   = u_re * w_im + u_im * w_re;
+                u_re   = tmp;
+            }
+        }
+    }
 }
 
 
 /**
- * @brief      Finalize pending counts, ignore residue, don't finalize
+ * @brief      Rate of cycles with amplitudes exceeding Sa (spectral damage
+ *             estimation).
  *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @param      param  The distribution parameters
+ * @param      Sa     The amplitude
  *
- * @return     true on success
+ * @return     Cycles per unit time with amplitude greater than Sa
  */
 static
-bool finalize_res_no_finalize( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+double spectral_exceedance( const struct spectral_param *param, double Sa )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    double z = Sa / sqrt( param->m0 );
 
-    rfc_ctx->state = RFC_STATE_FINALIZE;
+    switch( param->method )
+    {
+        case RFC_SPECTRAL_DIRLIK:
+            /* Dirlik's range density in terms of Z = range / (2*sqrt(m0)), integrated */
+            return param->nu_p * ( param->D1 * exp( -z / param->Q ) + 
+                                   param->D2 * exp( -z * z / ( 2.0 * param->R * param->R ) ) + 
+                                   param->D3 * exp( -z * z / 2.0 ) );
 
-    return true;
+        case RFC_SPECTRAL_TOVO_BENASCIUTTI:
+            /* Narrow band and range counting, weighted by b */
+            return        param->b   * param->nu_0 * exp( -z * z / 2.0 ) + 
+                   ( 1.0 - param->b ) * param->nu_p * exp( -z * z / ( 2.0 * param->alpha2 * param->alpha2 ) );
+
+        case RFC_SPECTRAL_NARROW_BAND:
+        default:
+            /* Rayleigh distributed amplitudes, one cycle per mean upcrossing */
+            return param->nu_0 * exp( -z * z / 2.0 );
+    }
 }
 
 
-#if !RFC_MINIMAL
 /**
- * @brief      Finalize pending counts, discard residue.
+ * @brief      Rebuild the range-mean-duration hash table.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @param      rfc_ctx     The rainflow context
+ * @param      cap         The new capacity, must be a power of 2
+ * @param      mean_shift  Offset added to all mean classes (autoresize)
  *
  * @return     true on success
  */
 static
-bool finalize_res_discard( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+bool rmd_rehash( rfc_ctx_s *rfc_ctx, size_t cap, unsigned mean_shift )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    rfc_rmd_item_s *rmd_old = rfc_ctx->rmd;
+    size_t          cap_old = rfc_ctx->rmd_cap;
+    size_t          i;
 
-    /* Include interim turning point */
-    if( !feed_finalize( rfc_ctx ) )
+    assert( rfc_ctx && rfc_ctx->rmd );
+    assert( cap >= RMD_CAP_MIN && !( cap & ( cap - 1 ) ) && cap > rfc_ctx->rmd_cnt );
+
+    rfc_ctx->rmd = (rfc_rmd_item_s*)rfc_ctx->mem_alloc( NULL, cap, sizeof(rfc_rmd_item_s), RFC_MEM_AIM_RMD );
+
+    if( !rfc_ctx->rmd )
     {
-        return false;
+        rfc_ctx->rmd = rmd_old;
+        return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
     }
 
-    /* Empty residue */
-    rfc_ctx->residue_cnt = 0;
+    memset( rfc_ctx->rmd, 0, sizeof(rfc_rmd_item_s) * cap );
+    rfc_ctx->rmd_cap = cap;
+    rfc_ctx->rmd_cnt = 0;
+
+    for( i = 0; i < cap_old; i++ )
+    {
+        if( rmd_old[i].counts )
+        {
+            /* Can't fail, capacity is sufficient */
+            (void)rmd_add( rfc_ctx, rmd_old[i].range, rmd_old[i].mean + mean_shift, rmd_old[i].duration, rmd_old[i].counts );
+        }
+    }
+
+    rfc_ctx->mem_alloc( rmd_old, 0, 0, RFC_MEM_AIM_RMD );
 
     return true;
 }
 
 
 /**
- * @brief      Finalize pending counts, weight unclosed cycles into RP,
- *             RF-matrix and damage and discard residue.
+ * @brief      Add counts to an element of the range-mean-duration histogram.
+ *             The hash table grows, if its load exceeds 50%.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      weight   The weight for closed cycles
- * @param      flags    The flags
+ * @param      rfc_ctx   The rainflow context
+ * @param      range     The range class
+ * @param      mean      The sum of start and ending class
+ * @param      duration  The duration class
+ * @param      inc       The increment
  *
  * @return     true on success
  */
 static
-bool finalize_res_weight_cycles( rfc_ctx_s *rfc_ctx, rfc_counts_t weight, rfc_flags_e flags )
+bool rmd_add( rfc_ctx_s *rfc_ctx, unsigned range, unsigned mean, unsigned duration, rfc_counts_t inc )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    rfc_rmd_item_s *item;
+    size_t          mask, idx;
 
-    /* Include interim turning point */
-    if( !feed_finalize( rfc_ctx ) )
+    assert( rfc_ctx && rfc_ctx->rmd );
+
+    if( 2 * ( rfc_ctx->rmd_cnt + 1 ) > rfc_ctx->rmd_cap )
     {
-        return false;
+        if( !rmd_rehash( rfc_ctx, 2 * rfc_ctx->rmd_cap, /*mean_shift*/ 0 ) )
+        {
+            return false;
+        }
     }
 
-    /* Count every unclosed cycle with the given weight */
-    if( rfc_ctx->residue && rfc_ctx->residue_cnt >= 2 )
+    /* Linear probing */
+    mask = rfc_ctx->rmd_cap - 1;
+    for( idx = RMD_HASH( range, mean, duration ) & mask;; idx = ( idx + 1 ) & mask )
     {
-        size_t             i;
-        int                flags    = rfc_ctx->internal.flags;
-        rfc_value_tuple_s *from     = rfc_ctx->residue;
-        rfc_counts_t       old_inc  = rfc_ctx->curr_inc;
-
-        rfc_ctx->curr_inc = weight;
+        item = &rfc_ctx->rmd[idx];
 
-        for( i = 0; i + 1 < rfc_ctx->residue_cnt; i++ )
+        if( !item->counts )
         {
-            rfc_value_tuple_s *to   = from + 1;
-            rfc_value_tuple_s *next = ( i + 2 < rfc_ctx->residue_cnt ) ? to + 1 : NULL;
-
-            cycle_process_counts( rfc_ctx, from, to, next, flags );
-
-            from = to;
+            item->range     = range;
+            item->mean      = mean;
+            item->duration  = duration;
+            rfc_ctx->rmd_cnt++;
+            break;
         }
 
-        rfc_ctx->curr_inc = old_inc;
+        if( item->range == range && item->mean == mean && item->duration == duration )
+        {
+            break;
+        }
     }
 
-    /* Empty residue */
-    rfc_ctx->residue_cnt = 0;
+    assert( item->counts <= RFC_COUNTS_LIMIT );
+    item->counts += inc;
 
     return true;
 }
 
 
 /**
- * @brief      Finalize pending counts to fit HCM results.
+ * @brief      Get the duration class for a cycle duration.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @param      rfc_ctx   The rainflow context
+ * @param      duration  The cycle duration [samples]
  *
- * @return     true on success
+ * @return     The duration class, base 0
  */
 static
-bool finalize_res_clormann_seeger( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+unsigned rmd_duration_class( const rfc_ctx_s *rfc_ctx, double duration )
 {
-    size_t i;
-
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    double cls;
 
-    /* Include interim turning point */
-    if( !feed_finalize( rfc_ctx ) )
+    if( duration < rfc_ctx->rmd_dur_min )
     {
-        return false;
+        return 0;
     }
 
-    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_4PTM )
-    {
-        /* Counting correction on residue */
+    cls = floor( log( duration / rfc_ctx->rmd_dur_min ) / log( rfc_ctx->rmd_dur_ratio ) ) + 1.0;
 
-        for( i = 0; i + 4 < rfc_ctx->residue_cnt; )
-        {
-            size_t idx = rfc_ctx->residue_cnt + i;
+    return ( cls < (double)rfc_ctx->rmd_dur_count ) ? (unsigned)cls : rfc_ctx->rmd_dur_count - 1;
+}
 
-            double A = (double)rfc_ctx->residue[idx+0].value;
-            double B = (double)rfc_ctx->residue[idx+1].value;
-            double C = (double)rfc_ctx->residue[idx+2].value;
-            double D = (double)rfc_ctx->residue[idx+3].value;
 
-            if( B * C < 0.0 && fabs(D) >= fabs(B) && fabs(B) >= fabs(C) )
-            {
-                rfc_value_tuple_s *from = &rfc_ctx->residue[idx+1];
-                rfc_value_tuple_s *to   = &rfc_ctx->residue[idx+2];
+/**
+ * @brief      Compare two range-mean-duration elements (qsort), ordered by
+ *             range, mean and duration class.
+ *
+ * @param      lhs   The left hand side
+ * @param      rhs   The right hand side
+ *
+ * @return     Negative, zero or positive value as lhs is less, equal or greater than rhs
+ */
+static
+int rmd_item_cmp( const void *lhs, const void *rhs )
+{
+    const rfc_rmd_item_s *a = (const rfc_rmd_item_s*)lhs;
+    const rfc_rmd_item_s *b = (const rfc_rmd_item_s*)rhs;
+
+    if( a->range    != b->range    ) return ( a->range    < b->range    ) ? -1 : 1;
+    if( a->mean     != b->mean     ) return ( a->mean     < b->mean     ) ? -1 : 1;
+    if( a->duration != b->duration ) return ( a->duration < b->duration ) ? -1 : 1;
+
+    return 0;
+}
+
+
+/**
+ * @brief      Record a cycle in value domain. If the storage is full, cycles
+ *             of equal value pairs are merged first. The storage grows only,
+ *             if merging doesn't free a quarter of it.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      from     The start value
+ * @param      to       The ending value
+ * @param      inc      The increment
+ *
+ * @return     true on success
+ */
+static
+bool cycles_add( rfc_ctx_s *rfc_ctx, rfc_value_t from, rfc_value_t to, rfc_counts_t inc )
+{
+    rfc_cycle_item_s *cycle;
 
-                cycle_process_counts( rfc_ctx, from, to, to + 1, flags );
+    assert( rfc_ctx && rfc_ctx->cycles );
 
-                /* Remove two inner turning points (idx+1 and idx+2) */
-                residue_remove_item( rfc_ctx, i + 1, 2 );
-                rfc_ctx->residue_cnt -= 2;
+    if( rfc_ctx->cycles_cnt == rfc_ctx->cycles_cap )
+    {
+        cycles_compact( rfc_ctx );
+
+        if( rfc_ctx->cycles_cnt > rfc_ctx->cycles_cap - rfc_ctx->cycles_cap / 4 )
+        {
+            void *ptr = rfc_ctx->mem_alloc( rfc_ctx->cycles, 2 * rfc_ctx->cycles_cap,
+                                            sizeof(rfc_cycle_item_s), RFC_MEM_AIM_CYCLES );
+            if( ptr )
+            {
+                rfc_ctx->cycles      = (rfc_cycle_item_s*)ptr;
+                rfc_ctx->cycles_cap *= 2;
             }
-            else
+            else if( rfc_ctx->cycles_cnt == rfc_ctx->cycles_cap )
             {
-                i++;
+                return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
             }
         }
     }
 
+    cycle         = &rfc_ctx->cycles[rfc_ctx->cycles_cnt++];
+    cycle->from   = from;
+    cycle->to     = to;
+    cycle->counts = inc;
+
     return true;
 }
 
 
 /**
- * @brief      Finalize pending counts, DIN method.
+ * @brief      Merge recorded cycles of equal value pairs. Cycles get ordered
+ *             by start and ending value.
  *
  * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
- *
- * @return     true on success
  */
 static
-bool finalize_res_rp_DIN45667( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+void cycles_compact( rfc_ctx_s *rfc_ctx )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    rfc_cycle_item_s *cycles = rfc_ctx->cycles;
+    size_t            i, n;
 
-    /* Include interim turning point */
-    if( !feed_finalize( rfc_ctx ) )
+    if( rfc_ctx->cycles_cnt < 2 )
     {
-        return false;
+        return;
     }
 
-    if( flags && rfc_ctx->residue_cnt > 2 )
-    {
-        int i, j, k;
-        int slopes_cnt = (int)rfc_ctx->residue_cnt - 1;
-        struct slopes
-        {
-            int slope;
-            rfc_value_tuple_s *lhs;
-            rfc_value_tuple_s *rhs;
-        } *slopes, tmp;
-
-        slopes = (struct slopes*)rfc_ctx->mem_alloc( NULL, slopes_cnt, sizeof( slopes[0] ), RFC_MEM_AIM_TEMP );
+    qsort( cycles, rfc_ctx->cycles_cnt, sizeof(rfc_cycle_item_s), cycle_item_cmp );
 
-        if( !slopes )
+    for( i = 1, n = 0; i < rfc_ctx->cycles_cnt; i++ )
+    {
+        if( cycles[i].from == cycles[n].from && cycles[i].to == cycles[n].to )
         {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+            assert( cycles[n].counts <= RFC_COUNTS_LIMIT - cycles[i].counts );
+            cycles[n].counts += cycles[i].counts;
         }
-
-        /* Evaluate slopes */
-        for( i = 0; i < slopes_cnt; i++ )
+        else
         {
-            slopes[i].lhs   = &rfc_ctx->residue[i];
-            slopes[i].rhs   = &rfc_ctx->residue[i+1];
-            slopes[i].slope = (int)slopes[i].rhs->cls - slopes[i].lhs->cls;
+            cycles[++n] = cycles[i];
         }
+    }
 
-        /* Order slopes (simple "bubble sort") */
-        k = 0;
-        for( i = 0; i < slopes_cnt; i++ )
-        {
-            /* Drag higher ranks */
-            for( j = slopes_cnt - 2; j >= i; j-- )
-            {
-                bool do_swap = false;
+    rfc_ctx->cycles_cnt = n + 1;
+}
 
-                if( ( slopes[j].slope > 0 ) == ( slopes[j+1].slope > 0 ) )
-                {
-                    do_swap = abs( slopes[j].slope ) < abs( slopes[j+1].slope );
-                }
-                else
-                {
-                    do_swap = slopes[j].slope < 0;
-                    k       = j + 1;  /* k indicates the first falling slope now */
-                }
 
-                if( do_swap )
-                {
-                    tmp         = slopes[j];
-                    slopes[j]   = slopes[j+1];
-                    slopes[j+1] = tmp;
-                }
-            }
-        }
+/**
+ * @brief      Compare two cycles in value domain (qsort), ordered by start
+ *             and ending value.
+ *
+ * @param      lhs   The left hand side
+ * @param      rhs   The right hand side
+ *
+ * @return     Negative, zero or positive value as lhs is less, equal or greater than rhs
+ */
+static
+int cycle_item_cmp( const void *lhs, const void *rhs )
+{
+    const rfc_cycle_item_s *a = (const rfc_cycle_item_s*)lhs;
+    const rfc_cycle_item_s *b = (const rfc_cycle_item_s*)rhs;
 
-        assert( k > 0 );
+    if( a->from != b->from ) return ( a->from < b->from ) ? -1 : 1;
+    if( a->to   != b->to   ) return ( a->to   < b->to   ) ? -1 : 1;
 
-        /* Compare positive slopes with adjacent negative slopes */
-        for( i = 0; i < k && i + k < slopes_cnt; i++ )
-        {
-            /* Get the smaller slope of two adjacent. On equality choose the primarily in time */
-            int lh_slope = slopes[i].slope;
-            int rh_slope = slopes[i+k].slope;
+    return 0;
+}
 
-            if( abs( lh_slope ) == abs( rh_slope ) )
-            {
-                j = ( slopes[i].rhs->pos < slopes[i+k].rhs->pos ) ? i : (i+k);
-            }
-            else
-            {
-                j = ( abs( lh_slope ) < abs( rh_slope ) ) ? i : (i+k);
-            }
 
-            /* Do the countings for the matching slope */
-            cycle_process_counts( rfc_ctx, slopes[j].lhs, slopes[j].rhs, NULL, flags );
+/**
+ * @brief      Get the ranking key of a tracked cycle.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      item     The cycle
+ *
+ * @return     The key (damage or range)
+ */
+static
+double top_item_key( const rfc_ctx_s *rfc_ctx, const rfc_top_item_s *item )
+{
+    return ( rfc_ctx->top_key == RFC_TOP_KEY_RANGE ) ? fabs( (double)item->to - (double)item->from ) : item->damage;
+}
+
+
+/**
+ * @brief      Offer a closed cycle to the most damaging cycles.
+ *             The heap root holds the least ranked cycle, which gets
+ *             replaced, if the new cycle ranks higher.
+ *
+ * @param      rfc_ctx  The rainflow context
+ * @param      from     The starting point
+ * @param      to       The ending point
+ * @param      damage   The damage of the cycle, weighted by its counts
+ */
+static
+void top_add( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s *from, const rfc_value_tuple_s *to, double damage )
+{
+    rfc_top_item_s *heap = rfc_ctx->top;
+    rfc_top_item_s  item;
+    double          key;
+    size_t          i;
+
+    assert( rfc_ctx && rfc_ctx->top && from && to );
+
+    item.from     = from->value;
+    item.to       = to->value;
+    item.from_pos = from->pos;
+    item.to_pos   = to->pos;
+    item.damage   = damage;
+    item.counts   = rfc_ctx->curr_inc;
+    key           = top_item_key( rfc_ctx, &item );
+
+    if( rfc_ctx->top_cnt < rfc_ctx->top_cap )
+    {
+        /* Sift up */
+        i = rfc_ctx->top_cnt++;
+        while( i > 0 && top_item_key( rfc_ctx, &heap[(i-1)/2] ) > key )
+        {
+            heap[i] = heap[(i-1)/2];
+            i       = (i-1)/2;
         }
+        heap[i] = item;
+    }
+    else if( key > top_item_key( rfc_ctx, &heap[0] ) )
+    {
+        /* Replace root and sift down */
+        i = 0;
+        for(;;)
+        {
+            size_t child = 2 * i + 1;
 
-        rfc_ctx->mem_alloc( slopes, 0, 0, RFC_MEM_AIM_TEMP );
+            if( child >= rfc_ctx->top_cnt ) break;
+            if( child + 1 < rfc_ctx->top_cnt && top_item_key( rfc_ctx, &heap[child+1] ) < top_item_key( rfc_ctx, &heap[child] ) ) child++;
+            if( top_item_key( rfc_ctx, &heap[child] ) >= key ) break;
+
+            heap[i] = heap[child];
+            i       = child;
+        }
+        heap[i] = item;
     }
+}
 
-    /* Empty residue */
-    rfc_ctx->residue_cnt = 0;
 
-    return true;
+/**
+ * @brief      Compare tracked cycles by damage, descending
+ *
+ * @param      lhs   The left hand side
+ * @param      rhs   The right hand side
+ *
+ * @return     Result of comparison
+ */
+static
+int top_item_cmp_damage( const void *lhs, const void *rhs )
+{
+    const rfc_top_item_s *a = (const rfc_top_item_s*)lhs;
+    const rfc_top_item_s *b = (const rfc_top_item_s*)rhs;
+
+    if( a->damage   != b->damage   ) return ( a->damage   > b->damage   ) ? -1 : 1;
+    if( a->from_pos != b->from_pos ) return ( a->from_pos < b->from_pos ) ? -1 : 1;
+
+    return 0;
 }
 
 
 /**
- * @brief      Finalize pending counts, repeated residue method.
+ * @brief      Compare tracked cycles by range, descending
  *
- * @param      rfc_ctx  The rainflow context
- * @param      flags    The flags
+ * @param      lhs   The left hand side
+ * @param      rhs   The right hand side
  *
- * @return     true on success
+ * @return     Result of comparison
  */
 static
-bool finalize_res_repeated( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
+int top_item_cmp_range( const void *lhs, const void *rhs )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
+    const rfc_top_item_s *a = (const rfc_top_item_s*)lhs;
+    const rfc_top_item_s *b = (const rfc_top_item_s*)rhs;
+    double                ra = fabs( (double)a->to - (double)a->from );
+    double                rb = fabs( (double)b->to - (double)b->from );
 
-    /* Process only, if residue is present */
-    if( rfc_ctx->residue && rfc_ctx->residue_cnt && flags )
-    {
-        /* Feed again with the content of the residue itself */
-        size_t              cnt     = rfc_ctx->residue_cnt;
-        rfc_value_tuple_s  *residue = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, cnt + 1, 
-                                                                              sizeof(rfc_value_tuple_s), RFC_MEM_AIM_TEMP );
+    if( ra          != rb          ) return ( ra          > rb          ) ? -1 : 1;
+    if( a->from_pos != b->from_pos ) return ( a->from_pos < b->from_pos ) ? -1 : 1;
 
-        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
-        {
-            cnt++;
-        }
+    return 0;
+}
 
-        if( !residue )
-        {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
-        }
-        else
-        {
-            /* Make a copy of the residue */
-            bool                     ok;
-            size_t                   n         = cnt; 
-            int                      old_flags = rfc_ctx->internal.flags;
-            const rfc_value_tuple_s *from      = rfc_ctx->residue;
-                  rfc_value_tuple_s *to        = residue;
 
-            while( n-- )
-            {
-                *to++ = *from++;
-            }
+/**
+ * @brief      Publish results into the snapshot buffer not read from
+ *             currently, then direct readers to it.
+ *
+ * @param      rfc_ctx  The rainflow context
+ */
+static
+void snapshot_publish( rfc_ctx_s *rfc_ctx )
+{
+    struct snapshot_buf *buf;
+    size_t               epoch       = rfc_ctx->snapshot_epoch + 1;
+    unsigned             tiles       = rfc_ctx->snapshot_tiles;
+    unsigned             class_count = rfc_ctx->class_count;
+    unsigned             ti, tj, i;
 
-            rfc_ctx->internal.flags = flags;
+    assert( tiles );
 
-            /* 
-             * Feed again with the copy, no new turning points are generated, since residue[].tp_pos
-             * but last cycle might not be closed due to interim state of the last point.
-             * Remove that cycle before feeding with the residue again:
-             */
-            if( cnt >= 4 )
-            {
-                size_t idx = cnt - 4;
+    if( rfc_ctx->snapshot_rfm_rev != rfc_ctx->rfm_rev )
+    {
+        /* rfm changed apart from counting (e.g. RFC_rfm_set()), renew completely */
+        memset( rfc_ctx->snapshot[0].dirty, 1, (size_t)tiles * tiles );
+        memset( rfc_ctx->snapshot[1].dirty, 1, (size_t)tiles * tiles );
+        rfc_ctx->snapshot_rfm_rev = rfc_ctx->rfm_rev;
+    }
 
-                unsigned A = residue[idx+0].cls;
-                unsigned B = residue[idx+1].cls;
-                unsigned C = residue[idx+2].cls;
-                unsigned D = residue[idx+3].cls;
+    buf = &rfc_ctx->snapshot[ epoch & 1 ];
 
-                if( B > C )
-                {
-                    unsigned temp = B;
-                    B = C;
-                    C = temp;
-                }
+    buf->seq++;
+    MEMORY_BARRIER();
 
-                if( A > D )
-                {
-                    unsigned temp = A;
-                    A = D;
-                    D = temp;
-                }
+    if( buf->rfm )
+    {
+        for( ti = 0; ti < tiles; ti++ )
+        {
+            for( tj = 0; tj < tiles; tj++ )
+            {
+                unsigned from_lo = ti * SNAPSHOT_TILE;
+                unsigned from_hi = ( from_lo + SNAPSHOT_TILE < class_count ) ? from_lo + SNAPSHOT_TILE : class_count;
+                unsigned to_lo   = tj * SNAPSHOT_TILE;
+                unsigned to_hi   = ( to_lo + SNAPSHOT_TILE < class_count ) ? to_lo + SNAPSHOT_TILE : class_count;
 
-                /* Check for closed cycles [3] */
-                if( A <= B && C <= D )
+                if( !buf->dirty[ ti * tiles + tj ] ) continue;
+
+                for( i = from_lo; i < from_hi; i++ )
                 {
-                    residue[idx+1] = residue[idx+3];
-                    cnt -= 2;
+                    size_t idx = (size_t)i * class_count + to_lo;
+
+                    memcpy( buf->rfm + idx, rfc_ctx->rfm + idx, sizeof(rfc_counts_t) * ( to_hi - to_lo ) );
                 }
             }
+        }
+    }
+    memset( buf->dirty, 0, (size_t)tiles * tiles );
 
-#if RFC_TP_SUPPORT
-            do
-            {
-                size_t tp_cnt = rfc_ctx->tp_cnt;
+    if( buf->lc )
+    {
+        memcpy( buf->lc, rfc_ctx->lc, sizeof(rfc_counts_t) * class_count );
+    }
 
-                /* Feed with all but the last data point, which will be handled later */
-                ok = RFC_feed_tuple( rfc_ctx, residue, cnt - 1 );
+    buf->scalars.pos    = rfc_ctx->internal.pos;
+    buf->scalars.damage = rfc_ctx->damage;
+    buf->scalars.state  = rfc_ctx->state;
+    buf->scalars.epoch  = epoch;
 
-                if( ok )
-                {
-                    /* The only scenario in which the number of turning points increases, is when
-                       the interim turning point gets a real turning point */
-                    if( rfc_ctx->tp_cnt > tp_cnt )
-                    {
-                        /* Interim turning point became a turning point, fix the copy */
-                        residue[cnt-1].tp_pos = tp_cnt + 1;
-                    }
-                    /* Process the last data point */
-                    ok = RFC_feed_tuple( rfc_ctx, residue + cnt - 1, 1 );
-                }
-            } while(0);
-#else /*!RFC_TP_SUPPORT*/
-            ok = RFC_feed_tuple( rfc_ctx, residue, cnt );
-#endif /*RFC_TP_SUPPORT*/
+    MEMORY_BARRIER();
+    buf->seq++;
+    MEMORY_BARRIER();
 
-            rfc_ctx->internal.flags = old_flags;
+    rfc_ctx->snapshot_epoch = epoch;
+}
 
-            /* Free temporary residue */
-            rfc_ctx->mem_alloc( residue, 0, 0, RFC_MEM_AIM_TEMP );
 
-            if( !ok )
-            {
-                return false;
-            }
-        }
-    }
+/**
+ * @brief      Release snapshot buffers.
+ *
+ * @param      rfc_ctx  The rainflow context
+ */
+static
+void snapshot_free( rfc_ctx_s *rfc_ctx )
+{
+    int b;
 
-    /* Include interim turning point */
-    if( !feed_finalize( rfc_ctx ) )
+    for( b = 0; b < 2; b++ )
     {
-        return false;
-    }
+        struct snapshot_buf *buf = &rfc_ctx->snapshot[b];
 
-    /* Empty residue */
-    rfc_ctx->residue_cnt = 0;
+        if( buf->rfm )   rfc_ctx->mem_alloc( buf->rfm,   0, 0, RFC_MEM_AIM_SNAPSHOT );
+        if( buf->lc )    rfc_ctx->mem_alloc( buf->lc,    0, 0, RFC_MEM_AIM_SNAPSHOT );
+        if( buf->dirty ) rfc_ctx->mem_alloc( buf->dirty, 0, 0, RFC_MEM_AIM_SNAPSHOT );
 
-    return true;
+        buf->rfm   = NULL;
+        buf->lc    = NULL;
+        buf->dirty = NULL;
+    }
+
+    rfc_ctx->snapshot_tiles = 0;
 }
 
 
 /**
- * @brief         Backup/restore of residue
+ * @brief      Publish results into the attached result region.
  *
- * @param         rfc_ctx      The rainflow context
- * @param[in,out] residue      The copy of the current residue
- * @param[out]    residue_cap  The capacity of the given residue
- * @param[out]    residue_cnt  The number of points in the given residue
- * @param         restore      true->restore, false->backup
- *
- * @return        true on success
+ * @param      rfc_ctx  The rainflow context
  */
 static
-bool residue_exchange( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s **residue, size_t *residue_cap, size_t *residue_cnt, bool restore )
+void region_publish( rfc_ctx_s *rfc_ctx )
 {
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
-    assert( residue && residue_cap && residue_cnt );
-    assert( rfc_ctx->residue_cap > 0 );
+    rfc_region_header_s *header      = rfc_ctx->region;
+    unsigned char       *region      = (unsigned char*)header;
+    unsigned             tiles       = rfc_ctx->region_tiles;
+    unsigned             class_count = rfc_ctx->class_count;
+    unsigned             ti, tj, i;
+    size_t               n;
 
-    if( !restore )
+    assert( header && tiles );
+
+    if( rfc_ctx->region_rfm_rev != rfc_ctx->rfm_rev )
     {
-        /* Backup */
-        *residue_cap = rfc_ctx->residue_cap;
-        *residue_cnt = rfc_ctx->residue_cnt;
-        *residue     = (rfc_value_tuple_s*)rfc_ctx->mem_alloc( NULL, *residue_cap, 
-                                                               sizeof(rfc_value_tuple_s), RFC_MEM_AIM_TEMP );
+        /* rfm changed apart from counting (e.g. RFC_rfm_set()), renew completely */
+        memset( rfc_ctx->region_dirty, 1, (size_t)tiles * tiles );
+        rfc_ctx->region_rfm_rev = rfc_ctx->rfm_rev;
+    }
 
-        if( !*residue )
+    header->seq++;
+    MEMORY_BARRIER();
+
+    if( header->rfm_offset )
+    {
+        rfc_counts_t *rfm = (rfc_counts_t*)( region + header->rfm_offset );
+
+        for( ti = 0; ti < tiles; ti++ )
         {
-            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
+            for( tj = 0; tj < tiles; tj++ )
+            {
+                unsigned from_lo = ti * SNAPSHOT_TILE;
+                unsigned from_hi = ( from_lo + SNAPSHOT_TILE < class_count ) ? from_lo + SNAPSHOT_TILE : class_count;
+                unsigned to_lo   = tj * SNAPSHOT_TILE;
+                unsigned to_hi   = ( to_lo + SNAPSHOT_TILE < class_count ) ? to_lo + SNAPSHOT_TILE : class_count;
+
+                if( !rfc_ctx->region_dirty[ ti * tiles + tj ] ) continue;
+
+                for( i = from_lo; i < from_hi; i++ )
+                {
+                    size_t idx = (size_t)i * class_count + to_lo;
+
+                    memcpy( rfm + idx, rfc_ctx->rfm + idx, sizeof(rfc_counts_t) * ( to_hi - to_lo ) );
+                }
+            }
         }
+    }
+    memset( rfc_ctx->region_dirty, 0, (size_t)tiles * tiles );
 
-        memcpy( *residue, rfc_ctx->residue, *residue_cnt * sizeof(rfc_value_tuple_s) );
+    if( header->rp_offset )
+    {
+        memcpy( region + header->rp_offset, rfc_ctx->rp, sizeof(rfc_counts_t) * class_count );
     }
-    else
+
+    if( header->lc_offset )
     {
-        /* Restore */
+        memcpy( region + header->lc_offset, rfc_ctx->lc, sizeof(rfc_counts_t) * class_count );
+    }
 
-        /* Release residue */
-        (rfc_value_tuple_s*)rfc_ctx->mem_alloc( rfc_ctx->residue, /*num*/ 0, /*size*/ 0, RFC_MEM_AIM_TEMP );
+    header->residue_cnt = rfc_ctx->residue_cnt;
+    header->residue_min = 0.0;
+    header->residue_max = 0.0;
 
-        /* Assign backup */
-        rfc_ctx->residue_cap = *residue_cap;
-        rfc_ctx->residue_cnt = *residue_cnt;
-        rfc_ctx->residue     = *residue;
+    for( n = 0; n < rfc_ctx->residue_cnt; n++ )
+    {
+        double value = (double)rfc_ctx->residue[n].value;
+
+        if( !n || value < header->residue_min ) header->residue_min = value;
+        if( !n || value > header->residue_max ) header->residue_max = value;
     }
 
-    return true;
+    header->pos    = rfc_ctx->internal.pos;
+    header->damage = rfc_ctx->damage;
+    header->state  = (int)rfc_ctx->state;
+    header->epoch++;
+
+    MEMORY_BARRIER();
+    header->seq++;
 }
-#endif /*!RFC_MINIMAL*/
 
 
 /**
- * @brief      Remove items (points) from the residue
+ * @brief      Detach the result region, unmaps and unlinks a shared memory
+ *             segment owned.
  *
  * @param      rfc_ctx  The rainflow context
- * @param      index    The item position in residue, base 0
- * @param      count    The number of elements to remove
  */
 static
-void residue_remove_item( rfc_ctx_s *rfc_ctx, size_t index, size_t count )
+void region_free( rfc_ctx_s *rfc_ctx )
 {
-    size_t  from = index + count,
-            to   = index, 
-            end;
-
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
-    assert( rfc_ctx->residue && index + count <= rfc_ctx->residue_cnt );
-
-    end = (int)rfc_ctx->residue_cnt;
-
-    /* Example
-                         |cnt(5)
-                         v
-               |O|O|X|O|O|
-                   ^
-                   |index(2)
-
-        elements = 2    (5-2-1+0 = 2, no interim turning point)
-    */
-
-    if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
+#if RFC_SHM_SUPPORT
+    if( rfc_ctx->region_shm_name )
     {
-        /* Include interim turning point */
-        end++;
+        if( rfc_ctx->region )
+        {
+            munmap( rfc_ctx->region, rfc_ctx->region->size );
+        }
+
+        shm_unlink( rfc_ctx->region_shm_name );
+        rfc_ctx->mem_alloc( rfc_ctx->region_shm_name, 0, 0, RFC_MEM_AIM_REGION );
+        rfc_ctx->region_shm_name = NULL;
     }
+#endif /*RFC_SHM_SUPPORT*/
 
-    /* Shift points */
-    while( from < end )
+    if( rfc_ctx->region_dirty )
     {
-        rfc_ctx->residue[to++] = rfc_ctx->residue[from++];
+        rfc_ctx->mem_alloc( rfc_ctx->region_dirty, 0, 0, RFC_MEM_AIM_REGION );
     }
 
-    rfc_ctx->residue_cnt -= count;
+    rfc_ctx->region       = NULL;
+    rfc_ctx->region_dirty = NULL;
+    rfc_ctx->region_tiles = 0;
 }
 
 
 /**
- * @brief      Calculate damage for one cycle with given amplitude Sa
+ * @brief      Feed a packet or batch of a multiplexed stream.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      Sa       The amplitude
- * @param[out] damage   The damage
+ * @param      rfc_ctx  The rainflow context of the stream
+ * @param[in]  data     The data
+ * @param      count    The number of values
  *
  * @return     true on success
  */
 static
-bool damage_calc_amplitude( rfc_ctx_s *rfc_ctx, double Sa, double *damage )
+bool mux_feed( rfc_ctx_s *rfc_ctx, const rfc_value_t *data, size_t count )
 {
     assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT );
-
-    do {
-        /* Damage */
-        double D = 0.0;
-
-        if( Sa >= 0.0 )
-        {
-            /* D =           h /    ND   *    ( Sa /    SD)  ^ ABS(k)   */
-            /* D = exp(  log(h /    ND)  + log( Sa /    SD)  * ABS(k) ) */
-            /* D = exp( (log(h)-log(ND)) + (log(Sa)-log(SD)) * ABS(k) ) */
-            /* D = exp(      0 -log(ND)  + (log(Sa)-log(SD)) * ABS(k) ) */
-
-            /* If D is integer format count:
-             * 
-             * D_integer = (double)(int)range ^ ABS(k)  // where range is 0..class_count-1
-             * 
-             * D = D_integer_sum * exp( log( ND * 2*SD/class_width ) * -ABS(k) )
-             * 
-             */
-
-#if !RFC_MINIMAL
-            if( Sa > rfc_ctx->wl_omission )
-            {
-                /* Constants for the Woehler curve */
-                const double SX_log = log(rfc_ctx->wl_sx);
-                const double NX_log = log(rfc_ctx->wl_nx);
-
-                if( Sa > rfc_ctx->wl_sx )
-                {
-                    const double k = rfc_ctx->wl_k;
-                    
-                    /* Upper slope, finite life scope */
-                    D = exp( fabs(k) * ( log(Sa) - SX_log ) - NX_log );
-                }
-                else if( Sa > rfc_ctx->wl_sd )
-                {
-                    const double k2 = rfc_ctx->wl_k2;
-
-                    /* Lower slope, transition scope, modified Miners' rule */
-                    D = exp( fabs(k2) * ( log(Sa) - SX_log ) - NX_log );
-                }
-                /* Amplitudes below fatigue strength have no influence */
-            }
-#else /*RFC_MINIMAL*/
-            /* Constants for the Woehler curve */
-            const double SX_log = log(rfc_ctx->wl_sx);
-            const double NX_log = log(rfc_ctx->wl_nx);
-            const double k      = rfc_ctx->wl_k;
-
-            /* Miner original */
-            D = exp( fabs(k)  * ( log(Sa) - SX_log ) - NX_log );
-#endif /*!RFC_MINIMAL*/
-        }
-        else
-        {
-            assert( false );
-            return error_raise( rfc_ctx, RFC_ERROR_INVARG );
-        }
 
-        *damage = D;
-        
-    } while(0);
+#if RFC_DH_SUPPORT
+    /* Batches come from the packet buffer, damage history needs the input stream */
+    if( rfc_ctx->dh )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_DH_SUPPORT*/
 
-    return true;
+    return RFC_feed( rfc_ctx, data, count );
 }
 
 
-#if RFC_AT_SUPPORT
 /**
- * @brief      Calculate the normalized mean load (Sa=1) for a given load ratio
- *             "R"
+ * @brief      Pass a new turning point of the leader to its followers.
  *
- * @param      rfc_ctx  The rainflow context
- * @param      R        Load ratio (Su/So)
- * @param[out] Sm_norm  Normalized mean load
+ * @param      rfc_ctx  The rainflow context (leader)
+ * @param[in]  tp       The new turning point
  *
  * @return     true on success
  */
 static
-bool at_R_to_Sm_norm( rfc_ctx_s *rfc_ctx, double R, double *Sm_norm )
+bool follower_feed( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s *tp )
 {
-    if( isinf( R ) || !Sm_norm )
+    unsigned i;
+
+    assert( rfc_ctx && tp );
+
+    for( i = 0; i < rfc_ctx->follower_cnt; i++ )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_AT );
-    }
+        rfc_ctx_s *follower = (rfc_ctx_s*)rfc_ctx->followers[i];
 
-    /* Su      = Sm - Sa */
-    /* So      = Sm + Sa */
-    /* R       = Su / So */
-    /* Sm      = Sa * ( 1 + R ) / ( 1 - R ) */
-    /* Sm_norm = Sm / Sa */
+        /* Followers are finalized already, if the leader is finalizing (i.e. feeding its residue again) */
+        if( follower->state == RFC_STATE_FINISHED )
+        {
+            continue;
+        }
 
-    *Sm_norm = ( 1 + R ) / ( 1 - R );
+        follower->internal.pos = rfc_ctx->internal.pos;
+
+        if( !feed_once_tp( follower, tp ) )
+        {
+            return false;
+        }
+    }
 
     return true;
 }
 
 
 /**
- * @brief      Calculate the influence of (normalized, Sa=1) mean load on
- *             fatigue strength (Haigh-diagram)
+ * @brief      Pass the interim turning point of the leader to its followers
+ *             and finalize them.
  *
- * @param      rfc_ctx      The rainflow context
- * @param      Sm_norm      Mean load, normalized (Sm/Sa)
- * @param[out] alleviation  Alleviation factor on reference curve
+ * @param      rfc_ctx          The rainflow context (leader)
+ * @param      residual_method  The residual method (RFC_RES_...)
  *
  * @return     true on success
  */
 static
-bool at_alleviation( rfc_ctx_s *rfc_ctx, double Sm_norm, double *alleviation )
+bool follower_finalize( rfc_ctx_s *rfc_ctx, rfc_res_method_e residual_method )
 {
-    assert( rfc_ctx );
+    bool     ok = true;
+    unsigned i;
 
-    if( !alleviation )
-    {
-        return error_raise( rfc_ctx, RFC_ERROR_AT );
-    }
+    assert( rfc_ctx );
 
-    if( !rfc_ctx->at.count )
+    for( i = 0; i < rfc_ctx->follower_cnt; i++ )
     {
-        /* No reference curve given, no transformation */
-        *alleviation = 1.0;
-    }
-    else
-    {
-        /* Reference curve */
-        const double   *Sa_   = rfc_ctx->at.Sa;
-        const double   *Sm_   = rfc_ctx->at.Sm;
-              unsigned  count = rfc_ctx->at.count;
-
-        assert( rfc_ctx && Sm_ && Sa_ );
+        rfc_ctx_s *follower = (rfc_ctx_s*)rfc_ctx->followers[i];
 
-        if( Sm_norm <= Sm_[0] / Sa_[0] )
+        if( follower->state >= RFC_STATE_FINALIZE )
         {
-            /* First segment */
-            *alleviation = Sa_[0];  /* Clip to first point */
+            continue;
         }
-        else if( Sm_norm >= Sm_[count-1] / Sa_[count-1] )
+
+        if( rfc_ctx->state == RFC_STATE_BUSY_INTERIM )
         {
-            /* Last segment */
-            *alleviation = Sa_[count-1];  /* Clip to last point */
+            assert( follower->state == RFC_STATE_BUSY_INTERIM );
+            follower->residue[follower->residue_cnt] = rfc_ctx->residue[rfc_ctx->residue_cnt];
+#if RFC_TP_SUPPORT
+            follower->residue[follower->residue_cnt].tp_pos = 0;
+#endif /*RFC_TP_SUPPORT*/
         }
-        else
-        {
-            unsigned i;
-            bool done = false;
-
-            /* Select correct segment */
-            for( i = 1; !done && i < count; i++ )
-            {
-                assert( Sa_[i-1] > 0.0 && Sa_[i] > 0.0 && Sm_[i-1] <= Sm_[i] );
-
-                if( Sm_norm > Sm_[i-1] / Sa_[i-1] && Sm_norm <= Sm_[i] / Sa_[i] )
-                {
-                    /* Intersection of R slope and M slope */
-                    double M_signed = ( Sa_[i] - Sa_[i-1] ) / ( Sm_[i] - Sm_[i-1] );
 
-                    *alleviation = ( Sa_[i-1] - M_signed * Sm_[i-1] ) / ( 1.0 - M_signed * Sm_norm );
-                    done = true;
-                }
-            }
+        follower->internal.slope      = rfc_ctx->internal.slope;
+        follower->internal.extrema[0] = rfc_ctx->internal.extrema[0];
+        follower->internal.extrema[1] = rfc_ctx->internal.extrema[1];
+        follower->internal.pos        = rfc_ctx->internal.pos;
 
-            if( !done )
-            {
-                assert( false );
-                return error_raise( rfc_ctx, RFC_ERROR_AT );
-            }
+        if( !RFC_finalize( follower, residual_method ) )
+        {
+            ok = false;
         }
     }
 
-    return true;
+    return ok;
 }
-#endif /*RFC_AT_SUPPORT*/
 
 
 /**
- * @brief      Calculate pseudo damage for one closed (full) cycle.
+ * @brief      Materialize the rainflow matrix pyramid up to a given level.
+ *             Level l is built from level l-1 by summing up 2x2 blocks.
+ *             Class bounds of all levels coincide with bounds of the finest
+ *             grid. Cycles falling into a single class on the coarser grid
+ *             are discarded, as they would be in counting. The 4-point
+ *             method decides on classes though, so counting on the coarser
+ *             grid may differ (see RFC_rfm_level()).
  *
- * @param      rfc_ctx     The rainflow context
- * @param      class_from  The starting class
- * @param      class_to    The ending class
- * @param[out] damage      The damage value for the closed cycle
- * @param[out] Sa_ret      The amplitude, may be NULL
+ * @param      rfc_ctx  The rainflow context
+ * @param      level    The level (1 is half resolution of .rfm)
  *
  * @return     true on success
  */
 static
-bool damage_calc( rfc_ctx_s *rfc_ctx, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret )
+bool rfm_pyramid_build( rfc_ctx_s *rfc_ctx, unsigned level )
 {
-    double Sa = -1.0;  /* Negative amplitude states undefined */
-    double D  =  0.0;
+    unsigned            l, n_fine, n_coarse;
+    unsigned            from, to;
+    size_t              size;
+    const rfc_counts_t *fine;
+    rfc_counts_t       *coarse;
 
-    assert( damage );
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT );
+    assert( rfc_ctx && rfc_ctx->rfm && level );
 
-#if RFC_DAMAGE_FAST
-    if( rfc_ctx->damage_lut && !rfc_ctx->damage_lut_inapt)
+    if( rfc_ctx->rfm_pyr_rev != rfc_ctx->rfm_rev )
     {
-        if( !damage_calc_fast( rfc_ctx, class_from, class_to, &D, &Sa ) )
-        {
-            return false;
-        }
-    } 
-    else
-#endif /*RFC_DAMAGE_FAST*/
+        rfc_ctx->rfm_pyr_levels = 0;
+    }
 
-#if RFC_USE_DELEGATES
-    if( rfc_ctx->damage_calc_fcn )
+    if( rfc_ctx->rfm_pyr_levels >= level )
     {
-        if( !rfc_ctx->damage_calc_fcn( rfc_ctx, class_from, class_to, &D, &Sa ) )
-        {
-            return false;
-        }
+        return true;
     }
-    else
-#endif /*RFC_USE_DELEGATES*/
 
+    /* Total size of levels 1..level */
+    for( l = 1, n_coarse = rfc_ctx->class_count, size = 0; l <= level; l++ )
+    {
+        n_coarse = ( n_coarse + 1 ) / 2;
+        size    += (size_t)n_coarse * n_coarse;
+    }
 
-    if( class_from != class_to )
+    if( size > rfc_ctx->rfm_pyr_cap )
     {
-#if RFC_MINIMAL
-        Sa = fabs( (int)class_from - (int)class_to ) / 2.0 * rfc_ctx->class_width;
+        void *ptr = rfc_ctx->mem_alloc( rfc_ctx->rfm_pyr, size, sizeof(rfc_counts_t), RFC_MEM_AIM_RFM_PYRAMID );
 
-        if( !damage_calc_amplitude( rfc_ctx, Sa, &D ) )
+        if( !ptr )
         {
-            return false;
+            return error_raise( rfc_ctx, RFC_ERROR_MEMORY );
         }
-#else /*!RFC_MINIMAL*/
-        double Sa_i = (double)abs( (int)class_from - (int)class_to ) / 2.0 * rfc_ctx->class_width;
-        double Sm_i =            ( (int)class_from + (int)class_to ) / 2.0 * rfc_ctx->class_width + rfc_ctx->class_offset;
 
-        if( Sa_i > 0.0 )
-        {
-#if RFC_AT_SUPPORT
-            /* Calculate transformation factor with normalized mean value */
-            if( !RFC_at_transform( rfc_ctx, Sa_i, Sm_i, &Sa ) )
-            {
-                return false;
-            }
-#else /*!RFC_AT_SUPPORT*/
-            Sa = Sa_i;
-#endif /*RFC_AT_SUPPORT*/
+        rfc_ctx->rfm_pyr     = (rfc_counts_t*)ptr;
+        rfc_ctx->rfm_pyr_cap = size;
+    }
 
-            if( !damage_calc_amplitude( rfc_ctx, Sa, &D ) )
+    /* Skip levels already materialized */
+    fine   = rfc_ctx->rfm;
+    coarse = rfc_ctx->rfm_pyr;
+    n_fine = rfc_ctx->class_count;
+    for( l = 1; l <= rfc_ctx->rfm_pyr_levels; l++ )
+    {
+        n_fine  = ( n_fine + 1 ) / 2;
+        fine    = coarse;
+        coarse += (size_t)n_fine * n_fine;
+    }
+
+    for( ; l <= level; l++ )
+    {
+        n_coarse = ( n_fine + 1 ) / 2;
+        memset( coarse, 0, sizeof(rfc_counts_t) * n_coarse * n_coarse );
+
+        for( from = 0; from < n_fine; from++ )
+        {
+            for( to = 0; to < n_fine; to++ )
             {
-                return false;
+                if( from / 2 != to / 2 )
+                {
+                    coarse[ ( from / 2 ) * n_coarse + to / 2 ] += fine[ from * n_fine + to ];
+                }
             }
         }
-#endif /*RFC_MINIMAL*/
-    }
 
-    if( Sa_ret )
-    {
-        *Sa_ret = Sa;
+        n_fine  = n_coarse;
+        fine    = coarse;
+        coarse += (size_t)n_coarse * n_coarse;
     }
 
-    *damage = D;
+    rfc_ctx->rfm_pyr_levels = level;
+    rfc_ctx->rfm_pyr_rev    = rfc_ctx->rfm_rev;
 
     return true;
 }
 
 
-#if RFC_DAMAGE_FAST
 /**
- * @brief      Initialize a look-up table of damages for closed cycles. In this
- *             implementation the midrange doesn't matter!
+ * @brief      Quantize a value on non-uniform class boundaries.
+ *             The approximate index table maps equidistant cells over the
+ *             class range onto the class holding the lower cell edge, so
+ *             only few correction steps remain.
  *
  * @param      rfc_ctx  The rainflow context
+ * @param      value    The value
  *
- * @returns    true on success
+ * @return     The class number (class_count, if value exceeds the upper bound)
  */
-static 
-bool damage_lut_init( rfc_ctx_s *rfc_ctx )
+static
+unsigned quantize_bounds( const rfc_ctx_s *rfc_ctx, double value )
 {
-    double   *lut;
-    unsigned  from, 
-              to;
-    double    Sa;
+    const rfc_value_t  *bounds      = rfc_ctx->class_bounds;
+    unsigned            class_count = rfc_ctx->class_count;
+    double              cell;
+    unsigned            idx;
 
-    assert( rfc_ctx );
-    assert( rfc_ctx->state == RFC_STATE_INIT );
+    assert( bounds && rfc_ctx->class_bounds_lut );
 
-    if( rfc_ctx->damage_lut )
+    if( value < bounds[0] )
     {
-        lut = rfc_ctx->damage_lut;
-        rfc_ctx->damage_lut = NULL;
+        return 0;
+    }
 
-        for( from = 0; from < rfc_ctx->class_count; from++ )
-        {
-            for( to = 0; to < rfc_ctx->class_count; to++ )
-            {
-                double D;
+    cell = ( value - bounds[0] ) * rfc_ctx->class_bounds_lut_scale;
 
-                if( !damage_calc( rfc_ctx, from, to, &D, &Sa ) )
-                {
-                    rfc_ctx->mem_alloc( lut, 0, 0, RFC_MEM_AIM_DLUT );
-                    return false;
-                }
-                lut[from * rfc_ctx->class_count + to] = D;
-#if RFC_AT_SUPPORT
-                if( rfc_ctx->amplitude_lut )
-                {
-                    rfc_ctx->amplitude_lut[from * rfc_ctx->class_count + to] = Sa;
-                }
-#endif /*RFC_AT_SUPPORT*/
-            }
-        }
+    if( cell >= rfc_ctx->class_bounds_lut_count )
+    {
+        return ( value < bounds[class_count] ) ? class_count - 1 : class_count;
+    }
 
-        rfc_ctx->damage_lut          = lut;
-        rfc_ctx->damage_lut_inapt    = 0;
+    idx = rfc_ctx->class_bounds_lut[ (unsigned)cell ];
+
+    /* Correction */
+    while( idx > 0 && value < bounds[idx] )
+    {
+        idx--;
     }
 
-    return true;
+    while( idx < class_count && value >= bounds[idx+1] )
+    {
+        idx++;
+    }
+
+    return idx;
 }
 
 
 /**
- * @brief      Calculate pseudo damage for one closed (full) cycle, using
- *             look-up table.
+ * @brief      Range class of a cycle.
+ *             Range class i represents the range class_bounds[i] - class_bounds[0]
+ *             for non-uniform classes, the nearest one is chosen.
  *
  * @param      rfc_ctx     The rainflow context
  * @param      class_from  The starting class
  * @param      class_to    The ending class
- * @param[out] damage      The damage value for the closed cycle
- * @param[out] Sa_ret      The amplitude (-1 if not available), may be NULL
  *
- * @return     true on success
+ * @return     The range class
  */
 static
-bool damage_calc_fast( rfc_ctx_s *rfc_ctx, unsigned class_from, unsigned class_to, double *damage, double *Sa_ret )
+unsigned range_class( const rfc_ctx_s *rfc_ctx, unsigned class_from, unsigned class_to )
 {
-    double Sa = -1;    /* -1 means "uninitialized" */
-    double D  =  0.0;
-
-    assert( damage );
-    assert( rfc_ctx );
-    assert( rfc_ctx->state >= RFC_STATE_INIT );
-    assert( class_from < rfc_ctx->class_count );
-    assert( class_to   < rfc_ctx->class_count );
+    const rfc_value_t  *bounds = rfc_ctx->class_bounds;
+    double              value;
+    unsigned            idx;
 
-    if( rfc_ctx->damage_lut && !rfc_ctx->damage_lut_inapt )
+    if( !bounds )
     {
-        D = rfc_ctx->damage_lut[class_from * rfc_ctx->class_count + class_to];
-
-        if( Sa_ret )
-        {
-#if RFC_AT_SUPPORT
-            if( rfc_ctx->amplitude_lut )
-            {
-                *Sa_ret = rfc_ctx->amplitude_lut[class_from * rfc_ctx->class_count + class_to];
-            }
-#else /*!RFC_AT_SUPPORT*/
-            *Sa_ret = AMPLITUDE( rfc_ctx, fabs( (int)class_from - (int)class_to ) );
-#endif /*RFC_AT_SUPPORT*/
-        }
+        return (unsigned)abs( (int)class_from - (int)class_to );
     }
-    else
+
+    /* Range never exceeds bounds[class_count-1] - bounds[0] */
+    value = bounds[0] + fabs( (double)bounds[class_from] - bounds[class_to] );
+    idx   = quantize_bounds( rfc_ctx, value );
+
+    if( idx + 1 < rfc_ctx->class_count && bounds[idx+1] - value < value - bounds[idx] )
     {
-        return error_raise( rfc_ctx, RFC_ERROR_LUT );
+        idx++;
     }
 
-    *damage = D;
-
-    return true;
+    return idx;
 }
-#endif /*RFC_DAMAGE_FAST*/
+#endif /*!RFC_MINIMAL*/
 
 
 /**
@@ -5575,6 +11563,12 @@ rfc_value_tuple_s * feed_filter_pt( rfc_ctx_s *rfc_ctx, const rfc_value_tuple_s
     {
         assert( rfc_ctx->state == RFC_STATE_BUSY_INTERIM );
 
+        /* In value domain, residue length isn't bounded by class count */
+        if( rfc_ctx->residue_cnt + 2 >= rfc_ctx->residue_cap && VALUE_MODE( rfc_ctx ) && !residue_grow( rfc_ctx ) )
+        {
+            return NULL;
+        }
+
         /* Increment and set new interim turning point */
         assert( rfc_ctx->residue_cnt + 1 < rfc_ctx->residue_cap );
         rfc_ctx->residue[++rfc_ctx->residue_cnt] = *pt;
@@ -5635,7 +11629,7 @@ void cycle_find( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
     }
 
     /* If no rainflow counting is done, just look out for turning points, discard residue */
-    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_NONE || !rfc_ctx->class_count )
+    if( rfc_ctx->counting_method == RFC_COUNTING_METHOD_NONE || ( !rfc_ctx->class_count && !VALUE_MODE( rfc_ctx ) ) )
     {
         /* Prune residue */
         if( rfc_ctx->residue_cnt > 1 )
@@ -5645,6 +11639,32 @@ void cycle_find( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
     }
 
 }
+
+
+/**
+ * @brief      Check the counting method for value domain counting
+ *             (RFC_FLAGS_COUNT_VALUES). Only the 4-point method compares
+ *             values, the others rely on classes (and HCM on its stack,
+ *             sized by class_count). counting_method may be changed after
+ *             initialization, so this is checked on counting.
+ *
+ * @param      rfc_ctx  The rainflow context
+ *
+ * @return     true on success
+ */
+static
+bool value_mode_check( rfc_ctx_s *rfc_ctx )
+{
+    assert( rfc_ctx && VALUE_MODE( rfc_ctx ) );
+
+    if( rfc_ctx->counting_method != RFC_COUNTING_METHOD_4PTM &&
+        rfc_ctx->counting_method != RFC_COUNTING_METHOD_NONE )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_UNSUPPORTED );
+    }
+
+    return true;
+}
 #endif /*!RFC_MINIMAL*/
 
 
@@ -5663,28 +11683,60 @@ void cycle_find_4ptm( rfc_ctx_s *rfc_ctx, rfc_flags_e flags )
     while( rfc_ctx->residue_cnt >= 4 )
     {
         size_t idx = rfc_ctx->residue_cnt - 4;
+        bool   is_closed;
 
-        unsigned A = rfc_ctx->residue[idx+0].cls;
-        unsigned B = rfc_ctx->residue[idx+1].cls;
-        unsigned C = rfc_ctx->residue[idx+2].cls;
-        unsigned D = rfc_ctx->residue[idx+3].cls;
-
-        if( B > C )
+#if !RFC_MINIMAL
+        if( VALUE_MODE( rfc_ctx ) )
         {
-            unsigned temp = B;
-            B = C;
-            C = temp;
-        }
+            /* Compare values, class parameters don't matter */
+            rfc_value_t A = rfc_ctx->residue[idx+0].value;
+            rfc_value_t B = rfc_ctx->residue[idx+1].value;
+            rfc_value_t C = rfc_ctx->residue[idx+2].value;
+            rfc_value_t D = rfc_ctx->residue[idx+3].value;
+
+            if( B > C )
+            {
+                rfc_value_t temp = B;
+                B = C;
+                C = temp;
+            }
 
-        if( A > D )
+            if( A > D )
+            {
+                rfc_value_t temp = A;
+                A = D;
+                D = temp;
+            }
+
+            is_closed = A <= B && C <= D;
+        }
+        else
+#endif /*!RFC_MINIMAL*/
         {
-            unsigned temp = A;
-            A = D;
-            D = temp;
+            unsigned A = rfc_ctx->residue[idx+0].cls;
+            unsigned B = rfc_ctx->residue[idx+1].cls;
+            unsigned C = rfc_ctx->residue[idx+2].cls;
+            unsigned D = rfc_ctx->residue[idx+3].cls;
+
+            if( B > C )
+            {
+                unsigned temp = B;
+                B = C;
+                C = temp;
+            }
+
+            if( A > D )
+            {
+                unsigned temp = A;
+                A = D;
+                D = temp;
+            }
+
+            is_closed = A <= B && C <= D;
         }
 
         /* Check for closed cycles [3] */
-        if( A <= B && C <= D )
+        if( is_closed )
         {
             rfc_value_tuple_s *from = &rfc_ctx->residue[idx+1];
             rfc_value_tuple_s *to   = &rfc_ctx->residue[idx+2];
@@ -5931,6 +11983,9 @@ static
 void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_value_tuple_s *to, rfc_value_tuple_s *next, rfc_flags_e flags )
 {
     unsigned class_from, class_to;
+#if !RFC_MINIMAL
+    unsigned cond = 0;
+#endif /*!RFC_MINIMAL*/
 
     assert( rfc_ctx );
     assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
@@ -5955,6 +12010,24 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
     }
 #endif /*RFC_TP_SUPPORT*/
 
+#if !RFC_MINIMAL
+    /* Cycles in value domain */
+    if( rfc_ctx->cycles && ( flags & RFC_FLAGS_COUNT_VALUES ) && from->value != to->value )
+    {
+        /* On failure, cycles_add() has already raised RFC_ERROR_MEMORY.
+           The remaining counts are completed nevertheless, to keep them consistent among each other */
+        (void)cycles_add( rfc_ctx, from->value, to->value, rfc_ctx->curr_inc );
+    }
+
+    if( !rfc_ctx->class_count )
+    {
+        return;
+    }
+
+    /* Condition the cycle is attributed to */
+    cond = cycle_cond( rfc_ctx, from, to );
+#endif /*!RFC_MINIMAL*/
+
     /* Quantized "from" */
     class_from = from->cls;
 
@@ -5970,6 +12043,10 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
     /* Do several counts, according to "flags" */
     if( class_from != class_to )
     {
+#if !RFC_MINIMAL
+        double D_cycle = -1.0;  /* Damage of the current cycle with its actual weight (negative while not calculated) */
+#endif /*!RFC_MINIMAL*/
+
 #if RFC_DEBUG_FLAGS
         if( rfc_ctx->internal.debug_flags & RFC_FLAGS_LOG_CLOSED_CYCLES &&
             flags & (RFC_FLAGS_COUNT_ALL & ~RFC_FLAGS_COUNT_LC) )
@@ -6031,7 +12108,11 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
             double Sa_i;
             double D_i;
 
+#if RFC_MINIMAL
             if( !damage_calc( rfc_ctx, class_from, class_to, &D_i, &Sa_i ) )
+#else /*!RFC_MINIMAL*/
+            if( !damage_calc_cond( rfc_ctx, cond, class_from, class_to, &D_i, &Sa_i ) )
+#endif /*RFC_MINIMAL*/
             {
                 return;
             }
@@ -6039,16 +12120,24 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
             /* Adding damage for the current cycle, with its actual weight */
             rfc_ctx->damage += D_i * rfc_ctx->curr_inc / rfc_ctx->full_inc;
 #if !RFC_MINIMAL
+            D_cycle = D_i * rfc_ctx->curr_inc / rfc_ctx->full_inc;
+
+            if( rfc_ctx->cond_damage )
+            {
+                rfc_ctx->cond_damage[cond] += D_cycle;
+            }
+
             /* Fatigue strength Sd(D) depresses in subject to cumulative damage D.
                Sd(D)/Sd = (1-D)^(1/q), [6] chapter 3.2.9, formula 3.2-44 and 3.2-46
                Only cycles exceeding Sd(D) have damaging effect. */
-            if( Sa_i >= rfc_ctx->internal.wl.sd && ( flags & RFC_FLAGS_COUNT_MK ) )
+            if( Sa_i >= rfc_ctx->internal.wl.sd && ( flags & RFC_FLAGS_COUNT_MK ) && !rfc_ctx->wl_bin_lut )
             {
                 rfc_wl_param_s  wl_unimp;                          /* WL parameters unimpaired part */
                 rfc_wl_param_s *wl_imp = &rfc_ctx->internal.wl;    /* WL parameters impaired part */
                 double          D_con;                             /* Current damage, Miners' consequent rule */
 
                 /* Backup Woehler curve parameters and use shadowed ones for the impaired part instead */
+                memset( &wl_unimp, 0, sizeof(wl_unimp) );
                 RFC_wl_param_get( rfc_ctx, &wl_unimp );
                 RFC_wl_param_set( rfc_ctx,  wl_imp );
 
@@ -6109,6 +12198,27 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
 #endif /*!RFC_MINIMAL*/
         }
 
+#if !RFC_MINIMAL
+        /* Most damaging cycles */
+        if( rfc_ctx->top && ( flags & ( RFC_FLAGS_COUNT_ALL & ~RFC_FLAGS_COUNT_LC ) ) )
+        {
+            if( D_cycle < 0.0 )
+            {
+                /* Damage isn't counted, calculate it for ranking only */
+                double D_i;
+
+                if( !damage_calc_cond( rfc_ctx, cond, class_from, class_to, &D_i, NULL /*Sa_ret*/ ) )
+                {
+                    return;
+                }
+
+                D_cycle = D_i * rfc_ctx->curr_inc / rfc_ctx->full_inc;
+            }
+
+            top_add( rfc_ctx, from, to, D_cycle );
+        }
+#endif /*!RFC_MINIMAL*/
+
         /* Rainflow matrix */
         if( rfc_ctx->rfm && ( flags & RFC_FLAGS_COUNT_RFM ) )
         {
@@ -6126,6 +12236,34 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
             
             assert( rfc_ctx->rfm[idx] <= RFC_COUNTS_LIMIT );
             rfc_ctx->rfm[idx] += rfc_ctx->curr_inc;
+#if !RFC_MINIMAL
+            rfc_ctx->rfm_rev++;
+
+            if( rfc_ctx->snapshot_tiles )
+            {
+                /* Mark the tile dirty for both snapshot buffers */
+                size_t tile = (size_t)( class_from / SNAPSHOT_TILE ) * rfc_ctx->snapshot_tiles + class_to / SNAPSHOT_TILE;
+
+                rfc_ctx->snapshot[0].dirty[tile] = 1;
+                rfc_ctx->snapshot[1].dirty[tile] = 1;
+                rfc_ctx->snapshot_rfm_rev++;
+            }
+
+            if( rfc_ctx->region_dirty )
+            {
+                size_t tile = (size_t)( class_from / SNAPSHOT_TILE ) * rfc_ctx->region_tiles + class_to / SNAPSHOT_TILE;
+
+                rfc_ctx->region_dirty[tile] = 1;
+                rfc_ctx->region_rfm_rev++;
+            }
+
+            if( rfc_ctx->cond_rfm )
+            {
+                idx += (size_t)cond * rfc_ctx->class_count * rfc_ctx->class_count;
+                assert( rfc_ctx->cond_rfm[idx] <= RFC_COUNTS_LIMIT );
+                rfc_ctx->cond_rfm[idx] += rfc_ctx->curr_inc;
+            }
+#endif /*!RFC_MINIMAL*/
         }
 
 #if !RFC_MINIMAL
@@ -6135,13 +12273,59 @@ void cycle_process_counts( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from, rfc_valu
             /* 
              * Range pair histogram (vector storage)
              * Range value = idx * class_width  (=2x Amplitude)
+             * (non-uniform classes: nearest class_bounds[idx] - class_bounds[0])
              */
-            int idx = abs( (int)class_from - (int)class_to );
+            unsigned idx = range_class( rfc_ctx, class_from, class_to );
             
             assert( rfc_ctx->rp[idx] <= RFC_COUNTS_LIMIT );
             rfc_ctx->rp[idx] += rfc_ctx->curr_inc;
         }
 
+        /* Range-mean matrix */
+        if( rfc_ctx->rmm && ( flags & RFC_FLAGS_COUNT_RMM ) )
+        {
+            /*
+             * Range-mean matrix (triangular storage, direction folded)
+             * Row "range" holds class_count-range mean classes, where 
+             * mean = class_from + class_to runs from range to 2*class_count-2-range in steps of 2
+             */
+            unsigned class_count = rfc_ctx->class_count;
+            unsigned range       = (unsigned)abs( (int)class_from - (int)class_to );
+            size_t   idx         = RMM_OFFS( range, class_from + class_to );
+
+            assert( rfc_ctx->rmm[idx] <= RFC_COUNTS_LIMIT );
+            rfc_ctx->rmm[idx] += rfc_ctx->curr_inc;
+        }
+
+        /* Range-mean-duration histogram */
+        if( rfc_ctx->rmd && ( flags & RFC_FLAGS_COUNT_RMD ) && from->pos && to->pos )
+        {
+            /*
+             * Cycle duration (period) in samples, estimated from stream positions:
+             * Half cycle from "from" to "to", plus the time on the slope "to"->"next"
+             * until the level of "from" is regained (linear interpolation).
+             * Without "next" (HCM, residue), the cycle is assumed to be symmetric.
+             */
+            double   duration = fabs( (double)to->pos - (double)from->pos );
+            unsigned range    = (unsigned)abs( (int)class_from - (int)class_to );
+
+            if( next && next->pos > to->pos && next->value != to->value )
+            {
+                double ratio = fabs( (double)from->value - (double)to->value ) / 
+                               fabs( (double)next->value - (double)to->value );
+
+                duration += (double)( next->pos - to->pos ) * ( ( ratio < 1.0 ) ? ratio : 1.0 );
+            }
+            else
+            {
+                duration *= 2.0;
+            }
+
+            /* On failure, rmd_rehash() has already raised RFC_ERROR_MEMORY.
+               The remaining counts are completed nevertheless, to keep them consistent among each other */
+            (void)rmd_add( rfc_ctx, range, class_from + class_to, rmd_duration_class( rfc_ctx, duration ), rfc_ctx->curr_inc );
+        }
+
         /* Level crossing, count rising and falling slopes */
         if( rfc_ctx->lc && ( flags & RFC_FLAGS_COUNT_LC ) )
         {
@@ -6630,6 +12814,458 @@ bool tp_refeed( rfc_ctx_s *rfc_ctx, rfc_value_t new_hysteresis, const rfc_class_
         return RFC_feed_tuple( rfc_ctx, rfc_ctx->tp, tp_cnt );
     }
 }
+
+
+/**
+ * @brief      Store an unsigned integer (little endian).
+ *
+ * @param[out] p      The destination
+ * @param      v      The value
+ * @param      bytes  The number of bytes
+ */
+static
+void archive_put_uint( unsigned char *p, uint64_t v, int bytes )
+{
+    int i;
+
+    for( i = 0; i < bytes; i++ )
+    {
+        p[i] = (unsigned char)( v >> ( 8 * i ) );
+    }
+}
+
+
+/**
+ * @brief      Load an unsigned integer (little endian).
+ *
+ * @param      p      The source
+ * @param      bytes  The number of bytes
+ *
+ * @return     The value
+ */
+static
+uint64_t archive_get_uint( const unsigned char *p, int bytes )
+{
+    uint64_t v = 0;
+    int      i;
+
+    for( i = 0; i < bytes; i++ )
+    {
+        v |= (uint64_t)p[i] << ( 8 * i );
+    }
+
+    return v;
+}
+
+
+/**
+ * @brief      Store a variable length integer (7 bits per byte).
+ *
+ * @param[out] p     The destination, may be NULL to count bytes only
+ * @param      v     The value
+ *
+ * @return     The number of bytes
+ */
+static
+size_t archive_put_varint( unsigned char *p, uint64_t v )
+{
+    size_t n = 0;
+
+    do
+    {
+        unsigned char byte = (unsigned char)( v & 0x7f );
+
+        v >>= 7;
+        if( v ) byte |= 0x80;
+        if( p ) p[n] = byte;
+        n++;
+    } while( v );
+
+    return n;
+}
+
+
+/**
+ * @brief      Load a variable length integer.
+ *
+ * @param[in,out] p    The source, advanced behind the value
+ * @param         end  The end of the source
+ * @param[out]    v    The value
+ *
+ * @return     true on success
+ */
+static
+bool archive_get_varint( const unsigned char **p, const unsigned char *end, uint64_t *v )
+{
+    int shift = 0;
+
+    *v = 0;
+
+    while( *p < end && shift < 64 )
+    {
+        unsigned char byte = *(*p)++;
+
+        *v |= (uint64_t)( byte & 0x7f ) << shift;
+
+        if( !( byte & 0x80 ) )
+        {
+            return true;
+        }
+
+        shift += 7;
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief      Store the XOR of two values, zero bytes at both ends are
+ *             omitted. A control byte holds the trailing zero bytes (high
+ *             nibble) and the number of bytes stored (low nibble).
+ *
+ * @param[out] p     The destination, may be NULL to count bytes only
+ * @param      x     The XOR of both values bits
+ *
+ * @return     The number of bytes
+ */
+static
+size_t archive_put_xor( unsigned char *p, uint64_t x )
+{
+    int tz = 0, n = 8;
+
+    if( !x )
+    {
+        if( p ) p[0] = 0;
+        return 1;
+    }
+
+    while( !( x & 0xff ) )
+    {
+        x >>= 8;
+        tz++;
+        n--;
+    }
+
+    while( n > 1 && !( x >> ( 8 * ( n - 1 ) ) ) )
+    {
+        n--;
+    }
+
+    if( p )
+    {
+        p[0] = (unsigned char)( ( tz << 4 ) | n );
+        archive_put_uint( p + 1, x, n );
+    }
+
+    return 1 + n;
+}
+
+
+/**
+ * @brief      Encode the turning point storage as archive.
+ *
+ * @param      rfc_ctx     The rainflow context
+ * @param[out] archive     The archive, may be NULL to count bytes only
+ * @param      chunk_size  The number of turning points per chunk
+ * @param      scale       The quantization (0 for XOR coding)
+ * @param[out] size        The size of the archive in bytes
+ *
+ * @return     true on success
+ */
+static
+bool archive_encode( rfc_ctx_s *rfc_ctx, unsigned char *archive, unsigned chunk_size, double scale, size_t *size )
+{
+    size_t    tp_count    = rfc_ctx->tp_cnt;
+    size_t    chunk_count = ( tp_count + chunk_size - 1 ) / chunk_size;
+    size_t    n, i;
+    uint64_t  prev[2]     = { 0, 0 };
+    size_t    pos_prev    = 0;
+    bool      has_cond    = false;
+    bool      quantized   = scale > 0.0;
+
+    assert( chunk_size );
+
+    if( (uint64_t)chunk_count > 0xffffffffu )
+    {
+        return error_raise( rfc_ctx, RFC_ERROR_INVARG );
+    }
+
+    for( i = 0; i < tp_count; i++ )
+    {
+        rfc_value_tuple_s *tp;
+
+        if( !tp_get( rfc_ctx, i + 1, &tp ) )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_TP );
+        }
+
+        if( tp->cond )
+        {
+            has_cond = true;
+        }
+
+        if( quantized )
+        {
+            /* Quantization must be lossless */
+            double q = floor( (double)tp->value * scale + 0.5 );
+
+            if( fabs( q ) > 4.5e15 || (rfc_value_t)( q / scale ) != tp->value )
+            {
+                quantized = false;
+            }
+        }
+    }
+
+    if( archive )
+    {
+        double   h    = (double)rfc_ctx->hysteresis;
+        double   q    = quantized ? scale : 0.0;
+        uint64_t bits;
+
+        memset( archive, 0, ARCHIVE_HEADER_SIZE );
+        memcpy( archive, ARCHIVE_MAGIC, 4 );
+        archive[4] = ARCHIVE_VERSION;
+        archive[5] = has_cond ? 1 : 0;
+        memcpy( &bits, &h, sizeof(bits) );
+        archive_put_uint( archive +  8, bits, 8 );
+        archive_put_uint( archive + 16, rfc_ctx->internal.pos, 8 );
+        archive_put_uint( archive + 24, tp_count, 8 );
+        archive_put_uint( archive + 32, chunk_size, 4 );
+        archive_put_uint( archive + 36, chunk_count, 4 );
+        memcpy( &bits, &q, sizeof(bits) );
+        archive_put_uint( archive + 40, bits, 8 );
+    }
+
+    n = ARCHIVE_HEADER_SIZE + 8 * chunk_count;
+
+    for( i = 0; i < tp_count; i++ )
+    {
+        rfc_value_tuple_s *tp;
+        size_t             k = i % chunk_size;
+        uint64_t           bits;
+
+        if( !tp_get( rfc_ctx, i + 1, &tp ) )
+        {
+            return error_raise( rfc_ctx, RFC_ERROR_TP );
+        }
+
+        if( quantized )
+        {
+            /* Quantized value as two's complement */
+            bits = (uint64_t)(int64_t)floor( (double)tp->value * scale + 0.5 );
+        }
+        else
+        {
+            double value = (double)tp->value;
+
+            memcpy( &bits, &value, sizeof(bits) );
+        }
+
+        if( !k )
+        {
+            /* Chunk starts with absolute position and value */
+            if( archive ) archive_put_uint( archive + ARCHIVE_HEADER_SIZE + 8 * ( i / chunk_size ), n, 8 );
+
+            n += archive_put_varint( archive ? archive + n : NULL, tp->pos );
+
+            if( quantized )
+            {
+                n += archive_put_varint( archive ? archive + n : NULL, ARCHIVE_ZIGZAG( bits, 0 ) );
+            }
+            else
+            {
+                if( archive ) archive_put_uint( archive + n, bits, 8 );
+                n += 8;
+            }
+
+            prev[0] = prev[1] = bits;
+        }
+        else
+        {
+            /* Position delta, value relative to the turning point of same slope */
+            uint64_t ref = ( k >= 2 ) ? prev[0] : prev[1];
+
+            n += archive_put_varint( archive ? archive + n : NULL, ARCHIVE_ZIGZAG( tp->pos, pos_prev ) );
+
+            if( quantized )
+            {
+                n += archive_put_varint( archive ? archive + n : NULL, ARCHIVE_ZIGZAG( bits, ref ) );
+            }
+            else
+            {
+                n += archive_put_xor( archive ? archive + n : NULL, bits ^ ref );
+            }
+
+            prev[0] = prev[1];
+            prev[1] = bits;
+        }
+
+        if( has_cond )
+        {
+            n += archive_put_varint( archive ? archive + n : NULL, tp->cond );
+        }
+
+        pos_prev = tp->pos;
+    }
+
+    *size = n;
+
+    return true;
+}
+
+
+/**
+ * @brief      Decode turning points of one archive chunk.
+ *
+ * @param      archive  The archive
+ * @param      size     The size of the archive in bytes
+ * @param      chunk    The chunk, base 0
+ * @param      skip     The number of turning points to skip in chunk
+ * @param[out] tp       The turning points
+ * @param      count    The capacity of tp
+ * @param[out] decoded  The number of turning points decoded
+ *
+ * @return     true on success
+ */
+static
+bool archive_decode_chunk( const unsigned char *archive, size_t size, size_t chunk, size_t skip, rfc_value_tuple_s *tp, size_t count, size_t *decoded )
+{
+    const unsigned char *p, *end = archive + size;
+    size_t               tp_count    = (size_t)archive_get_uint( archive + 24, 8 );
+    size_t               chunk_size  = (size_t)archive_get_uint( archive + 32, 4 );
+    size_t               chunk_count = (size_t)archive_get_uint( archive + 36, 4 );
+    bool                 has_cond    = archive[5] & 1;
+    uint64_t             prev[2]     = { 0, 0 };
+    uint64_t             offset, pos = 0;
+    size_t               k, k_end, out = 0;
+    double               scale;
+
+    if( !chunk_size || chunk >= chunk_count || ARCHIVE_HEADER_SIZE + 8 * chunk_count > size )
+    {
+        return false;
+    }
+
+    offset = archive_get_uint( archive + 40, 8 );
+    memcpy( &scale, &offset, sizeof(scale) );
+    offset = archive_get_uint( archive + ARCHIVE_HEADER_SIZE + 8 * chunk, 8 );
+
+    if( offset >= size )
+    {
+        return false;
+    }
+
+    p     = archive + offset;
+    k_end = ( tp_count - chunk * chunk_size < chunk_size ) ? tp_count - chunk * chunk_size : chunk_size;
+
+    for( k = 0; k < k_end && out < count; k++ )
+    {
+        uint64_t bits, v, cond = 0;
+
+        if( !k )
+        {
+            if( !archive_get_varint( &p, end, &pos ) )
+            {
+                return false;
+            }
+
+            if( scale > 0.0 )
+            {
+                if( !archive_get_varint( &p, end, &v ) )
+                {
+                    return false;
+                }
+
+                bits = ARCHIVE_UNZIGZAG( v, 0 );
+            }
+            else
+            {
+                if( end - p < 8 )
+                {
+                    return false;
+                }
+
+                bits = archive_get_uint( p, 8 );
+                p   += 8;
+            }
+
+            prev[0] = prev[1] = bits;
+        }
+        else
+        {
+            uint64_t ref = ( k >= 2 ) ? prev[0] : prev[1];
+
+            if( !archive_get_varint( &p, end, &v ) )
+            {
+                return false;
+            }
+
+            pos = ARCHIVE_UNZIGZAG( v, pos );
+
+            if( scale > 0.0 )
+            {
+                if( !archive_get_varint( &p, end, &v ) )
+                {
+                    return false;
+                }
+
+                bits = ARCHIVE_UNZIGZAG( v, ref );
+            }
+            else
+            {
+                int tz, n;
+
+                if( p >= end )
+                {
+                    return false;
+                }
+
+                tz = *p >> 4;
+                n  = *p++ & 0x0f;
+
+                if( tz + n > 8 || end - p < n )
+                {
+                    return false;
+                }
+
+                bits = ( archive_get_uint( p, n ) << ( 8 * tz ) ) ^ ref;
+                p   += n;
+            }
+
+            prev[0] = prev[1];
+            prev[1] = bits;
+        }
+
+        if( has_cond && !archive_get_varint( &p, end, &cond ) )
+        {
+            return false;
+        }
+
+        if( k >= skip )
+        {
+            rfc_value_tuple_s t = { 0.0 };  /* All other members are zero-initialized, see ISO/IEC 9899:TC3, 6.7.8 (21) */
+            double            value;
+
+            if( scale > 0.0 )
+            {
+                value = (double)(int64_t)bits / scale;
+            }
+            else
+            {
+                memcpy( &value, &bits, sizeof(value) );
+            }
+
+            t.value   = (rfc_value_t)value;
+            t.pos     = (size_t)pos;
+            t.cond    = (unsigned)cond;
+            tp[out++] = t;
+        }
+    }
+
+    *decoded = out;
+
+    return true;
+}
 #endif /*RFC_TP_SUPPORT*/
 
 
@@ -6651,8 +13287,9 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
                                         rfc_value_tuple_s *to, 
                                         rfc_value_tuple_s *next, rfc_flags_e flags )
 {
-    int    spread_damage_method;
-    double D = 0.0;
+    int      spread_damage_method;
+    double   D    = 0.0;
+    unsigned cond = cycle_cond( rfc_ctx, from, to );  /* Selects the Woehler curve, if given per condition */
 
     assert( rfc_ctx );
     assert( rfc_ctx->state >= RFC_STATE_INIT && rfc_ctx->state < RFC_STATE_FINISHED );
@@ -6680,7 +13317,7 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
         {
             double damage_lhs, damage_rhs;
 
-            if( !damage_calc( rfc_ctx, from->cls, to->cls, &D, NULL /*Sa_ret*/ ) )
+            if( !damage_calc_cond( rfc_ctx, cond, from->cls, to->cls, &D, NULL /*Sa_ret*/ ) )
             {
                 return false;
             }
@@ -6764,7 +13401,7 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
             from_cls = from->cls;
             to_cls   = to->cls;
 
-            if( !damage_calc( rfc_ctx, from_cls, to_cls, &D_cycle, NULL /*Sa_ret*/ ) )
+            if( !damage_calc_cond( rfc_ctx, cond, from_cls, to_cls, &D_cycle, NULL /*Sa_ret*/ ) )
             {
                 return false;
             }
@@ -6887,7 +13524,7 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
                 {
                     if( ( (class_new > class_now) ^ (to->cls > from->cls) ) == 0 )
                     {
-                        if( !damage_calc( rfc_ctx, from->cls, class_new, &D_new, /*Sa*/ NULL ) )
+                        if( !damage_calc_cond( rfc_ctx, cond, from->cls, class_new, &D_new, /*Sa*/ NULL ) )
                         {
                             return error_raise( rfc_ctx, RFC_ERROR_DH );
                         }
@@ -6983,7 +13620,7 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
                         /* Slope direction */
                         if( ( (class_new > class_now) ^ (to->cls > from->cls) ) == 0 )
                         {
-                            if( !damage_calc( rfc_ctx, from->cls, class_new, &D_new, /*Sa*/ NULL ) )
+                            if( !damage_calc_cond( rfc_ctx, cond, from->cls, class_new, &D_new, /*Sa*/ NULL ) )
                             {
                                 return error_raise( rfc_ctx, RFC_ERROR_DH );
                             }
@@ -6998,7 +13635,7 @@ bool spread_damage( rfc_ctx_s *rfc_ctx, rfc_value_tuple_s *from,
                         /* Opposite direction */
                         if( ( (class_new > class_now) ^ (to->cls > from->cls) ) != 0 )
                         {
-                            if( !damage_calc( rfc_ctx, to->cls, class_new, &D_new, /*Sa*/ NULL ) )
+                            if( !damage_calc_cond( rfc_ctx, cond, to->cls, class_new, &D_new, /*Sa*/ NULL ) )
                             {
                                 return error_raise( rfc_ctx, RFC_ERROR_DH );
                             }
@@ -7142,7 +13779,15 @@ rfc_value_t value_delta( rfc_ctx_s* rfc_ctx, const rfc_value_tuple_s* pt_from, c
 #if RFC_USE_HYSTERESIS_FILTER
     delta = (double)pt_to->value - (double)pt_from->value;
 #else /*RFC_USE_HYSTERESIS_FILTER*/
-    delta = rfc_ctx->class_width * ( (int)pt_to->cls - (int)pt_from->cls );
+    if( VALUE_MODE( rfc_ctx ) )
+    {
+        /* No classes in value mode */
+        delta = (double)pt_to->value - (double)pt_from->value;
+    }
+    else
+    {
+        delta = rfc_ctx->class_width * ( (int)pt_to->cls - (int)pt_from->cls );
+    }
 #endif /*RFC_USE_HYSTERESIS_FILTER*/
 
     if( sign_ptr )
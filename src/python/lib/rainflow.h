@@ -120,6 +120,14 @@
 
 #define RFC_CLASS_COUNT_MAX (1024)
 
+#ifndef RFC_CP_BLOCK_SIZE
+#define RFC_CP_BLOCK_SIZE   (256)   /* Samples per projection block in RFC_cp_damage() */
+#endif /*RFC_CP_BLOCK_SIZE*/
+
+#ifndef RFC_RMD_DUR_COUNT_DEFAULT
+#define RFC_RMD_DUR_COUNT_DEFAULT (32)  /* Number of (logarithmic) duration classes in range-mean-duration histogram */
+#endif /*RFC_RMD_DUR_COUNT_DEFAULT*/
+
 #ifndef RFC_VALUE_TYPE
 #define RFC_VALUE_TYPE double
 #endif /*RFC_VALUE_TYPE*/
@@ -155,6 +163,8 @@
 #define RFC_GLOBAL_EXTREMA   OFF
 #undef  RFC_DAMAGE_FAST
 #define RFC_DAMAGE_FAST      OFF
+#undef  RFC_SHM_SUPPORT
+#define RFC_SHM_SUPPORT      OFF
 #else /*!RFC_MINIMAL*/
 #ifndef RFC_MINIMAL
 #define RFC_MINIMAL OFF
@@ -189,6 +199,9 @@
 #ifndef RFC_DEBUG_FLAGS
 #define RFC_DEBUG_FLAGS OFF
 #endif /*RFC_DEBUG_FLAGS*/
+#ifndef RFC_SHM_SUPPORT
+#define RFC_SHM_SUPPORT OFF
+#endif /*RFC_SHM_SUPPORT*/
 #endif /*RFC_MINIMAL*/
 
 
@@ -248,6 +261,23 @@ enum rfc_mem_aim
 #endif
 #if !RFC_MINIMAL
     RFC_MEM_AIM_RFM_ELEMENTS        = 10,                           /**< Error on accessing memory for rf matrix elements */
+    RFC_MEM_AIM_CP                  = 11,                           /**< Error on accessing memory for critical plane counting states */
+    RFC_MEM_AIM_RMM                 = 12,                           /**< Error on accessing memory for range-mean matrix */
+    RFC_MEM_AIM_RMM_ELEMENTS        = 13,                           /**< Error on accessing memory for range-mean matrix elements */
+    RFC_MEM_AIM_RMD                 = 14,                           /**< Error on accessing memory for range-mean-duration histogram */
+    RFC_MEM_AIM_RMD_ELEMENTS        = 15,                           /**< Error on accessing memory for range-mean-duration histogram elements */
+    RFC_MEM_AIM_RFM_PYRAMID         = 16,                           /**< Error on accessing memory for rainflow matrix pyramid */
+    RFC_MEM_AIM_CYCLES              = 17,                           /**< Error on accessing memory for cycles in value domain */
+    RFC_MEM_AIM_CLASS_BOUNDS        = 18,                           /**< Error on accessing memory for non-uniform class boundaries */
+    RFC_MEM_AIM_COND                = 19,                           /**< Error on accessing memory for conditional counting */
+    RFC_MEM_AIM_TAL                 = 20,                           /**< Error on accessing memory for time at level */
+    RFC_MEM_AIM_WL_BINS             = 21,                           /**< Error on accessing memory for Woehler curves per condition */
+    RFC_MEM_AIM_TOP                 = 22,                           /**< Error on accessing memory for most damaging cycles */
+    RFC_MEM_AIM_SNAPSHOT            = 23,                           /**< Error on accessing memory for snapshots */
+    RFC_MEM_AIM_REGION              = 24,                           /**< Error on accessing memory for result regions */
+    RFC_MEM_AIM_MUX                 = 25,                           /**< Error on accessing memory for stream multiplexers */
+    RFC_MEM_AIM_ARCHIVE             = 26,                           /**< Error on accessing memory for turning point archives */
+    RFC_MEM_AIM_FOLLOWERS           = 27,                           /**< Error on accessing memory for followers */
 #endif /*!RFC_MINIMAL*/
 };
 
@@ -288,6 +318,12 @@ enum rfc_flags
 #if RFC_AR_SUPPORT
     RFC_FLAGS_AUTORESIZE            =  1 << 11,                     /**< Automatically resize buffers for rp, lc, and rfm */
 #endif /*RFC_AR_SUPPORT*/
+#if !RFC_MINIMAL
+    RFC_FLAGS_COUNT_RMM             =  1 << 12,                     /**< Count into range-mean matrix */
+    RFC_FLAGS_COUNT_RMD             =  1 << 13,                     /**< Count into range-mean-duration histogram */
+    RFC_FLAGS_COUNT_VALUES          =  1 << 14,                     /**< Close cycles on values (4PTM only) and record them as value pairs, class grid is chosen at readout */
+    RFC_FLAGS_COUNT_TAL             =  1 << 15,                     /**< Count samples per class (time at level) */
+#endif /*!RFC_MINIMAL*/
 };
 
 
@@ -318,6 +354,29 @@ enum rfc_lc_count_method
     RFC_LC_COUNT_METHOD_SLOPES_DOWN  = 1,                           /**< Count on falling slopes only */
     RFC_LC_COUNT_METHOD_SLOPES_ALL   = 2,                           /**< Count on rising AND falling slopes */
 };
+
+/* See RFC_cond_init() */
+enum rfc_cond_rule
+{
+    RFC_COND_RULE_FROM               = 0,                           /**< Cycle belongs to the condition at its starting turning point */
+    RFC_COND_RULE_TO                 = 1,                           /**< Cycle belongs to the condition at its ending turning point */
+    RFC_COND_RULE_MAX                = 2,                           /**< Cycle belongs to the condition at its maximum turning point */
+};
+
+/* See RFC_sl_param_set() */
+enum rfc_sl_model
+{
+    RFC_SL_MODEL_NONE                = 0,                           /**< Nominal stress approach, Woehler curve */
+    RFC_SL_MODEL_SWT                 = 1,                           /**< Local strain approach, damage parameter of Smith, Watson and Topper */
+    RFC_SL_MODEL_MORROW              = 2,                           /**< Local strain approach, strain-life curve with Morrow mean stress correction */
+};
+
+/* See RFC_top_init() */
+enum rfc_top_key
+{
+    RFC_TOP_KEY_DAMAGE               = 0,                           /**< Rank cycles by damage */
+    RFC_TOP_KEY_RANGE                = 1,                           /**< Rank cycles by range */
+};
 #endif /*!RFC_MINIMAL*/
 
 
@@ -355,6 +414,9 @@ enum rfc_error
 #endif /*RFC_DAMAGE_FAST*/
     RFC_ERROR_DATA_OUT_OF_RANGE     =  9,                           /**< Input data leaves classrange */
     RFC_ERROR_DATA_INCONSISTENT     =  10,                          /**< Processed data is inconsistent (internal error) */
+#if RFC_SHM_SUPPORT
+    RFC_ERROR_SHM                   =  11,                          /**< Error on creating or mapping a shared memory segment */
+#endif /*RFC_SHM_SUPPORT*/
 };
 
 
@@ -411,6 +473,18 @@ enum rfc_sd_method
 #endif /*RFC_DH_SUPPORT*/
 
 
+#if !RFC_MINIMAL
+/* See RFC_spectral_damage() */
+enum rfc_spectral_method
+{
+    RFC_SPECTRAL_NARROW_BAND        =  0,                           /**< Narrow band approximation (Rayleigh distributed amplitudes) */
+    RFC_SPECTRAL_DIRLIK             =  1,                           /**< Dirlik's empirical rainflow range distribution */
+    RFC_SPECTRAL_TOVO_BENASCIUTTI   =  2,                           /**< Tovo-Benasciutti, weighted narrow band and range counting */
+    RFC_SPECTRAL_COUNT                                              /**< Number of options */
+};
+#endif /*!RFC_MINIMAL*/
+
+
 enum rfc_wl_defaults
 {
     RFC_WL_SD_DEFAULT               =  1000,                        /**< Fatigue strength amplitude (Miner original) */
@@ -434,16 +508,32 @@ typedef     enum        rfc_res_method          rfc_res_method_e;           /**
 typedef     enum        rfc_counting_method     rfc_counting_method_e;      /** Counting method, see RFC_COUNTING... */
 typedef     enum        rfc_rp_damage_method    rfc_rp_damage_method_e;     /** Method when calculating damage from range pair counting, see RFC_RP_DAMAGE_CALC_METHOD... */
 typedef     enum        rfc_lc_count_method     rfc_lc_count_method_e;      /** Controls which slopes to take into account, when doing the level crossing counting */
+typedef     enum        rfc_cond_rule           rfc_cond_rule_e;            /** Rule to attribute cycles to conditions, see RFC_COND_RULE... */
+typedef     enum        rfc_sl_model            rfc_sl_model_e;             /** Local strain damage model, see RFC_SL_MODEL... */
+typedef     enum        rfc_top_key             rfc_top_key_e;              /** Ranking of most damaging cycles, see RFC_TOP_KEY... */
+typedef     enum        rfc_spectral_method     rfc_spectral_method_e;      /** Spectral damage estimation method, see RFC_SPECTRAL... */
 #if RFC_DH_SUPPORT
 typedef     enum        rfc_sd_method           rfc_sd_method_e;            /** Spread damage method, see RFC_SD... */
 #endif /*RFC_DH_SUPPORT*/
 typedef     struct      rfc_class_param         rfc_class_param_s;          /** Class parameters (width, offset, count) */
 typedef     struct      rfc_wl_param            rfc_wl_param_s;             /** Woehler curve parameters (sd, nd, k, k2, omission) */
+typedef     struct      rfc_sl_param            rfc_sl_param_s;             /** Local strain approach parameters (material, notch) */
 typedef     struct      rfc_rfm_item            rfc_rfm_item_s;             /** Rainflow matrix element */
+typedef     struct      rfc_rmm_item            rfc_rmm_item_s;             /** Range-mean matrix element */
+typedef     struct      rfc_rmd_item            rfc_rmd_item_s;             /** Range-mean-duration histogram element */
+typedef     struct      rfc_cycle_item          rfc_cycle_item_s;           /** Cycle in value domain */
+typedef     struct      rfc_top_item            rfc_top_item_s;             /** Cycle ranked among the most damaging */
+typedef     struct      rfc_snapshot            rfc_snapshot_s;             /** Scalar results of a snapshot */
+typedef     struct      rfc_region_header       rfc_region_header_s;        /** Header of a result region, see RFC_region_attach() */
+typedef     struct      rfc_mux                 rfc_mux_s;                  /** Multiplexer of streams, see RFC_mux_init() */
+typedef     struct      rfc_res_result          rfc_res_result_s;           /** Results of a residual method, see RFC_finalize_multi() */
 #endif /*!RFC_MINIMAL*/
 
 /* Memory allocation functions typedef */
 typedef     void *   ( *rfc_mem_alloc_fcn_t )   ( void *, size_t num, size_t size, int aim );     /** Memory allocation functor */
+#if !RFC_MINIMAL
+typedef     bool     ( *rfc_rfm_visit_fcn_t )   ( void *user, unsigned from, unsigned to, rfc_counts_t counts );  /** Rainflow matrix visitor, see RFC_rfm_foreach() */
+#endif /*!RFC_MINIMAL*/
 
 /* Core functions */
 bool        RFC_init                    (       void *ctx, unsigned class_count, rfc_value_t class_width, rfc_value_t class_offset, 
@@ -463,13 +553,19 @@ bool        RFC_feed                    (       void *ctx, const rfc_value_t* da
 bool        RFC_cycle_process_counts    (       void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_flags_e flags );
 bool        RFC_feed_scaled             (       void *ctx, const rfc_value_t* data, size_t count, double factor );
 bool        RFC_feed_tuple              (       void *ctx, rfc_value_tuple_s *data, size_t count );
+bool        RFC_feed_cond               (       void *ctx, const rfc_value_t* data, const unsigned *cond, size_t count );
+bool        RFC_feed_rle                (       void *ctx, const rfc_value_t* values, const size_t *repeats, size_t count );
+bool        RFC_feed_classes            (       void *ctx, const uint16_t *cls, size_t count );
+bool        RFC_feed_tp                 (       void *ctx, const rfc_value_t *values, const size_t *positions, size_t count );
 #endif /*!RFC_MINIMAL*/
 bool        RFC_finalize                (       void *ctx, rfc_res_method_e residual_method );
 #if !RFC_MINIMAL
+bool        RFC_finalize_multi          (       void *ctx, const rfc_res_method_e *methods, rfc_res_result_s *results, unsigned count );
 /* Functions on rainflow matrix */
 bool        RFC_rfm_make_symmetric      (       void *ctx );
 bool        RFC_rfm_non_zeros           ( const void *ctx, unsigned *count );
 bool        RFC_rfm_get                 ( const void *ctx, rfc_rfm_item_s **buffer, unsigned *count );
+bool        RFC_rfm_foreach             ( const void *ctx, rfc_rfm_visit_fcn_t visit, void *user );
 bool        RFC_rfm_set                 (       void *ctx, const rfc_rfm_item_s *buffer, unsigned count, bool add_only );
 bool        RFC_rfm_peek                ( const void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t *counts );
 bool        RFC_rfm_poke                (       void *ctx, rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t counts, bool add_only );
@@ -477,15 +573,66 @@ bool        RFC_rfm_sum                 ( const void *ctx, unsigned from_first,
 bool        RFC_rfm_damage              ( const void *ctx, unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, double *damage );
 bool        RFC_rfm_check               ( const void *ctx );
 bool        RFC_rfm_refeed              (       void *ctx, rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param );
+bool        RFC_rfm_level               ( const void *ctx, unsigned level, const rfc_counts_t **rfm, rfc_class_param_s *class_param );
+bool        RFC_rfm_get_level           ( const void *ctx, unsigned level, rfc_rfm_item_s **buffer, unsigned *count );
+bool        RFC_rfm_resample            ( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rfm );
+/* Functions on range-mean matrix */
+bool        RFC_rmm_non_zeros           ( const void *ctx, unsigned *count );
+bool        RFC_rmm_get                 ( const void *ctx, rfc_rmm_item_s **buffer, unsigned *count );
+bool        RFC_rmm_peek                ( const void *ctx, rfc_value_t range_val, rfc_value_t mean_val, rfc_counts_t *counts );
+bool        RFC_rmm_damage              ( const void *ctx, double *damage, const rfc_counts_t *rmm );
+bool        RFC_rmm_from_rfm            ( const void *ctx, rfc_counts_t *rmm, const rfc_counts_t *rfm );
+/* Functions on range-mean-duration histogram */
+bool        RFC_rmd_init                (       void *ctx, double dur_min, double dur_ratio, unsigned dur_count );
+bool        RFC_rmd_non_zeros           ( const void *ctx, unsigned *count );
+bool        RFC_rmd_get                 ( const void *ctx, rfc_rmd_item_s **buffer, unsigned *count );
+bool        RFC_rmd_duration            ( const void *ctx, unsigned duration, double *dur_lower, double *dur_upper );
+/* Functions on cycles in value domain */
+bool        RFC_cycles_get              ( const void *ctx, const rfc_cycle_item_s **cycles, size_t *count );
+bool        RFC_cycles_class_param      ( const void *ctx, unsigned class_count, rfc_class_param_s *class_param );
+bool        RFC_cycles_rfm              ( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rfm );
+bool        RFC_cycles_rp               ( const void *ctx, const rfc_class_param_s *class_param, rfc_counts_t *rp );
+bool        RFC_cycles_damage           ( const void *ctx, double *damage );
+/* Functions on most damaging cycles */
+bool        RFC_top_init                (       void *ctx, size_t cap, rfc_top_key_e key );
+bool        RFC_top_get                 ( const void *ctx, rfc_top_item_s *items, size_t *count );
+/* Snapshots for concurrent readers */
+bool        RFC_snapshot_init           (       void *ctx, bool enable );
+bool        RFC_snapshot_get            ( const void *ctx, rfc_snapshot_s *snapshot, rfc_counts_t *rfm, rfc_counts_t *lc );
+/* Result regions for other processes */
+bool        RFC_region_size             ( const void *ctx, size_t *size );
+bool        RFC_region_attach           (       void *ctx, void *region, size_t size );
+bool        RFC_region_read_begin       ( const void *region, size_t *seq );
+bool        RFC_region_read_end         ( const void *region, size_t seq );
+#if RFC_SHM_SUPPORT
+bool        RFC_shm_create              (       void *ctx, const char *name );
+bool        RFC_shm_open                ( const char *name, const void **region, size_t *size );
+bool        RFC_shm_close               ( const void *region, size_t size );
+#endif /*RFC_SHM_SUPPORT*/
+/* Multiplexer of many low-rate streams */
+bool        RFC_mux_init                ( rfc_mux_s *mux, unsigned stream_count, unsigned batch_size );
+bool        RFC_mux_deinit              ( rfc_mux_s *mux );
+void *      RFC_mux_ctx                 ( rfc_mux_s *mux, unsigned stream );
+bool        RFC_mux_push                ( rfc_mux_s *mux, unsigned stream, const rfc_value_t *data, size_t count );
+bool        RFC_mux_flush               ( rfc_mux_s *mux, unsigned first, unsigned count );
+/* Several counting methods over one filter pass */
+bool        RFC_follower_add            (       void *ctx, void *follower );
 bool        RFC_lc_get                  ( const void *ctx, rfc_counts_t *lc, rfc_value_t *level );
 bool        RFC_lc_from_rfm             ( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_counts_t *rfm, rfc_flags_e flags );
 bool        RFC_lc_from_residue_tuples  ( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_value_tuple_s* residue, unsigned residue_cnt, rfc_flags_e flags );
 bool        RFC_lc_from_residue         ( const void *ctx, rfc_counts_t *lc, rfc_value_t *level, const rfc_value_t* residue, unsigned residue_cnt, rfc_flags_e flags );
 bool        RFC_rp_get                  ( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa );
+bool        RFC_tal_get                 ( const void *ctx, size_t *tal, rfc_value_t *level );
 bool        RFC_rp_from_rfm             ( const void *ctx, rfc_counts_t *rp, rfc_value_t *Sa, const rfc_counts_t *rfm );
 bool        RFC_damage                  ( const void *ctx, rfc_value_t *damage, rfc_value_t *damage_residue );
 bool        RFC_damage_from_rp          ( const void *ctx, double *damage, const rfc_counts_t *counts, const rfc_value_t *Sa, rfc_rp_damage_method_e rp_calc_type );
 bool        RFC_damage_from_rfm         ( const void *ctx, double *damage, const rfc_counts_t *rfm );
+bool        RFC_cp_damage               ( const void *ctx, const rfc_value_t *data, size_t data_count, unsigned comp_count, 
+                                                           const double *coeffs, unsigned plane_count, rfc_res_method_e residual_method, 
+                                                           double *damage, unsigned *critical_plane );
+bool        RFC_spectral_psd            ( const void *ctx, const rfc_value_t *data, size_t data_count, double fs, unsigned nfft, double *psd );
+bool        RFC_spectral_damage         ( const void *ctx, const double *psd, size_t psd_count, double df, double T, rfc_spectral_method_e method, 
+                                                           double *damage, rfc_counts_t *rp, rfc_value_t *Sa );
 bool        RFC_wl_calc_sx              ( const void *ctx, double s0, double n0, double k, double *sx, double nx, double  k2, double  sd, double nd );
 bool        RFC_wl_calc_sd              ( const void *ctx, double s0, double n0, double k, double  sx, double nx, double  k2, double *sd, double nd );
 bool        RFC_wl_calc_k2              ( const void *ctx, double s0, double n0, double k, double  sx, double nx, double *k2, double  sd, double nd );
@@ -495,6 +642,14 @@ bool        RFC_wl_param_set            (       void *ctx, const rfc_wl_param_s
 bool        RFC_wl_param_get            ( const void *ctx, rfc_wl_param_s * );
 bool        RFC_class_param_set         (       void *ctx, const rfc_class_param_s * );
 bool        RFC_class_param_get         ( const void *ctx, rfc_class_param_s * );
+bool        RFC_class_bounds_set        (       void *ctx, const rfc_value_t *bounds, unsigned count );
+bool        RFC_class_bounds_get        ( const void *ctx, const rfc_value_t **bounds, unsigned *count );
+bool        RFC_cond_init               (       void *ctx, unsigned cond_count, rfc_cond_rule_e rule );
+bool        RFC_cond_rfm                ( const void *ctx, unsigned cond, const rfc_counts_t **rfm );
+bool        RFC_cond_damage             ( const void *ctx, unsigned cond, double *damage );
+bool        RFC_wl_bins_init            (       void *ctx, const rfc_wl_param_s *wl_params, unsigned count );
+bool        RFC_sl_param_set            (       void *ctx, const rfc_sl_param_s * );
+bool        RFC_sl_param_get            ( const void *ctx, rfc_sl_param_s * );
 bool        RFC_class_number            ( const void *ctx, rfc_value_t value, unsigned *class_number );
 bool        RFC_class_mean              ( const void *ctx, unsigned class_number, rfc_value_t *class_mean );
 bool        RFC_class_upper             ( const void *ctx, unsigned class_number, rfc_value_t *class_upper );
@@ -502,6 +657,7 @@ bool        RFC_class_count             ( const void *ctx, unsigned *class_count
 bool        RFC_class_offset            ( const void *ctx, rfc_value_t *class_offset );
 bool        RFC_class_width             ( const void *ctx, rfc_value_t *class_width );
 bool        RFC_hysteresis              ( const void *ctx, rfc_value_t *hysteresis );
+bool        RFC_hysteresis_from_damage  (       void *ctx, double fraction, double *damage_bound );
 bool        RFC_flags_set               (       void *ctx, int flags, int stack, bool overwrite );
 bool        RFC_flags_unset             (       void *ctx, int flags, int stack );
 bool        RFC_flags_get               ( const void *ctx, int *flags, int stack );
@@ -513,6 +669,11 @@ bool        RFC_tp_init_autoprune       (       void *ctx, bool autoprune, size_
 bool        RFC_tp_prune                (       void *ctx, size_t count, rfc_flags_e flags );
 bool        RFC_tp_refeed               (       void *ctx, rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param );
 bool        RFC_tp_clear                (       void *ctx );
+/* Turning point archives */
+bool        RFC_archive_write           ( const void *ctx, unsigned char *archive, size_t *size, unsigned chunk_size, double scale );
+bool        RFC_archive_info            ( const unsigned char *archive, size_t size, rfc_value_t *hysteresis, size_t *sample_count, size_t *tp_count );
+bool        RFC_archive_get             ( const unsigned char *archive, size_t size, size_t first, rfc_value_tuple_s *tp, size_t count );
+bool        RFC_archive_feed            (       void *ctx, const unsigned char *archive, size_t size );
 #endif /*RFC_TP_SUPPORT*/
 bool        RFC_res_get                 ( const void *ctx, const rfc_value_tuple_s **residue, unsigned *count );
 #if RFC_DH_SUPPORT
@@ -559,6 +720,9 @@ struct rfc_value_tuple
 {
     rfc_value_t                         value;                      /**< Value. Don't change order, value field must be first! */
     unsigned                            cls;                        /**< Class number, base 0 */
+#if !RFC_MINIMAL
+    unsigned                            cond;                       /**< Condition (state of an auxiliary channel), base 0 */
+#endif /*!RFC_MINIMAL*/
     size_t                              pos;                        /**< Absolute position in input data stream, base 1 */
 #if RFC_TP_SUPPORT
     size_t                              adj_pos;                    /**< Absolute position in input data stream of adjacent turning point, base 1. Valid only, if RFC_FLAGS_COUNT_DAMAGE is set! */
@@ -626,12 +790,138 @@ struct rfc_wl_param
     double                              D;                          /**< If D > 0, parameters define Woehler curve for impaired part */
 };
 
+/*
+ * Local strain approach:
+ *
+ *  Cyclic stress-strain curve (Ramberg-Osgood):  eps      = sigma/E  + (sigma/K)^(1/n)
+ *  Hysteresis branch (Masing):                   eps_r    = sigma_r/E + 2*(sigma_r/(2*K))^(1/n)
+ *  Notch (Neuber):                               sigma*eps = (Kt*S)^2/E
+ *  Strain-life curve (Coffin-Manson-Basquin):    eps_a    = sf/E*(2N)^b + ef*(2N)^c
+ *  SWT:                                          sigma_max*eps_a = sf^2/E*(2N)^(2b) + sf*ef*(2N)^(b+c)
+ *  Morrow:                                       eps_a    = (sf-sigma_m)/E*(2N)^b + ef*(2N)^c
+ */
+struct rfc_sl_param
+{
+    rfc_sl_model_e                      model;                      /**< Damage model, RFC_SL_MODEL_NONE for nominal stress approach */
+    double                              E;                          /**< Young's modulus */
+    double                              K;                          /**< Cyclic strength coefficient */
+    double                              n;                          /**< Cyclic strain hardening exponent */
+    double                              sf;                         /**< Fatigue strength coefficient */
+    double                              b;                          /**< Fatigue strength exponent, always negative */
+    double                              ef;                         /**< Fatigue ductility coefficient */
+    double                              c;                          /**< Fatigue ductility exponent, always negative */
+    double                              Kt;                         /**< Elastic notch factor, local elastic stress per input value */
+};
+
 struct rfc_rfm_item
 {
     unsigned                            from;                       /**< Start class, base 0 */
     unsigned                            to;                         /**< Ending class, base 0 */
     rfc_counts_t                        counts;                     /**< Counts */
 };
+
+
+/* Range-mean matrix element (direction folded) */
+struct rfc_rmm_item
+{
+    unsigned                            range;                      /**< Range class, base 0 (range = class_width * range) */
+    unsigned                            mean;                       /**< Sum of start and ending class, base 0 (mean = class_offset + class_width * (mean + 1) / 2) */
+    rfc_counts_t                        counts;                     /**< Counts */
+};
+
+
+/* Range-mean-duration histogram element (direction folded) */
+struct rfc_rmd_item
+{
+    unsigned                            range;                      /**< Range class, base 0 (as in rfc_rmm_item) */
+    unsigned                            mean;                       /**< Sum of start and ending class, base 0 (as in rfc_rmm_item) */
+    unsigned                            duration;                   /**< Duration class, base 0 (see RFC_rmd_duration()) */
+    rfc_counts_t                        counts;                     /**< Counts */
+};
+
+
+/* Cycle in value domain */
+struct rfc_cycle_item
+{
+    rfc_value_t                         from;                       /**< Start value */
+    rfc_value_t                         to;                         /**< Ending value */
+    rfc_counts_t                        counts;                     /**< Counts (full_inc for a full cycle) */
+};
+
+struct rfc_top_item
+{
+    rfc_value_t                         from;                       /**< Start value */
+    rfc_value_t                         to;                         /**< Ending value */
+    size_t                              from_pos;                   /**< Position of start value, base 1 */
+    size_t                              to_pos;                     /**< Position of ending value, base 1 */
+    double                              damage;                     /**< Damage, weighted by counts */
+    rfc_counts_t                        counts;                     /**< Counts (full_inc for a full cycle) */
+};
+
+struct rfc_res_result
+{
+    double                              damage;                     /**< Cumulated damage, residue included */
+    double                              damage_residue;             /**< Damage added by the residual method */
+    rfc_counts_t                       *rfm;                        /**< Counts added to rfm (class_count^2 elements, optional, may be NULL) */
+    rfc_counts_t                       *rp;                         /**< Counts added to rp (class_count elements, optional, may be NULL) */
+    rfc_counts_t                       *lc;                         /**< Counts added to lc (class_count elements, optional, may be NULL) */
+};
+
+struct rfc_snapshot
+{
+    size_t                              pos;                        /**< Number of samples fed */
+    double                              damage;                     /**< Cumulated damage */
+    rfc_state_e                         state;                      /**< Counting state */
+    size_t                              epoch;                      /**< Number of publications */
+};
+
+#define RFC_REGION_MAGIC    (0x52464352u)                           /**< "RFCR" */
+#define RFC_REGION_VERSION  (1u)                                    /**< Layout version of result regions */
+
+/**
+ * Header of a result region. Arrays follow at their offsets (counted from
+ * the begin of the header), an offset of 0 marks an array as not available.
+ * Readers guard their access by RFC_region_read_begin() and
+ * RFC_region_read_end().
+ */
+struct rfc_region_header
+{
+    unsigned                            magic;                      /**< RFC_REGION_MAGIC */
+    unsigned                            version;                    /**< RFC_REGION_VERSION */
+    unsigned                            header_size;                /**< sizeof(rfc_region_header_s) */
+    unsigned                            counts_size;                /**< sizeof(rfc_counts_t) */
+    size_t                              size;                       /**< Size of the region in bytes */
+    volatile size_t                     seq;                        /**< Sequence counter, odd while the region is written */
+    size_t                              epoch;                      /**< Number of publications */
+    size_t                              pos;                        /**< Number of samples fed */
+    double                              damage;                     /**< Cumulated damage */
+    int                                 state;                      /**< Counting state, see RFC_STATE... */
+    unsigned                            class_count;                /**< Class count */
+    double                              class_width;                /**< Class width */
+    double                              class_offset;               /**< Lower bound of first class */
+    size_t                              residue_cnt;                /**< Number of residual points */
+    double                              residue_min;                /**< Minimum value in residue */
+    double                              residue_max;                /**< Maximum value in residue */
+    size_t                              rfm_offset;                 /**< Rainflow matrix, class_count^2 counts */
+    size_t                              rp_offset;                  /**< Range pair counts, class_count counts */
+    size_t                              lc_offset;                  /**< Level crossings, class_count counts */
+};
+
+/**
+ * Multiplexer of many low-rate streams, one rainflow context per stream.
+ * Contexts and packet buffers are held in contiguous arenas, small packets
+ * are buffered and fed in batches.
+ */
+struct rfc_mux
+{
+    size_t                              version;                    /**< Version number as sizeof(struct rfc_mux), must be 1st field! */
+    rfc_mem_alloc_fcn_t                 mem_alloc;                  /**< Allocation function for arenas and contexts (NULL for default) */
+    unsigned                            stream_count;               /**< Number of streams */
+    unsigned                            batch_size;                 /**< Capacity of each packet buffer (number of values) */
+    rfc_ctx_s                          *ctx;                        /**< Contexts, stream_count elements */
+    rfc_value_t                        *buffer;                     /**< Packet buffers, batch_size values per stream */
+    unsigned                           *buffer_cnt;                 /**< Number of values buffered per stream */
+};
 #endif /*!RFC_MINIMAL*/
 
 
@@ -667,6 +957,13 @@ struct rfc_ctx
     unsigned                            class_count;                /**< Class count */
     rfc_value_t                         class_width;                /**< Class width */
     rfc_value_t                         class_offset;               /**< Lower bound of first class */
+#if !RFC_MINIMAL
+    rfc_value_t                        *class_bounds;               /**< Non-uniform class boundaries (class_count+1 values, strictly increasing), NULL for equidistant classes */
+    unsigned                           *class_bounds_lut;           /**< Approximate class index for equidistant cells over the class range */
+    unsigned                            class_bounds_lut_count;     /**< Number of cells in class_bounds_lut */
+    unsigned                            class_bounds_reserved;      /**< Unused, keeps the following members aligned to 8 bytes */
+    double                              class_bounds_lut_scale;     /**< Cells per value unit */
+#endif /*!RFC_MINIMAL*/
     rfc_value_t                         hysteresis;                 /**< Hysteresis filtering, slope must exceed hysteresis to be counted! */
 
     /* Woehler curve */
@@ -680,6 +977,9 @@ struct rfc_ctx
     double                              wl_omission;                /**< Omission level threshold, smaller amplitudes get discarded */
     double                              wl_q;                       /**< Parameter q based on k for "Miner consequent" approach, always positive */
     double                              wl_q2;                      /**< Parameter q based on k2 for "Miner consequent" approach, always positive */
+
+    /* Local strain approach */
+    rfc_sl_param_s                      sl;                         /**< Local strain approach parameters, replace the Woehler curve if sl.model is set */
 #endif /*!RFC_MINIMAL*/
 
 #if RFC_USE_DELEGATES
@@ -714,6 +1014,70 @@ struct rfc_ctx
 #if !RFC_MINIMAL
     rfc_counts_t                       *rp;                         /**< Range pair counts, always class_count elements */
     rfc_counts_t                       *lc;                         /**< Level crossing counts, always class_count elements. Every per .flags selected slope increments by .full_inc! */
+    rfc_counts_t                       *rmm;                        /**< Range-mean matrix, always class_count*(class_count+1)/2 elements (triangular, row=range, col=mean) */
+
+    /* Sparse storages (optional, may be NULL) */
+    rfc_rmd_item_s                     *rmd;                        /**< Range-mean-duration histogram, hash table (open addressing, slots with zero counts are unused) */
+    size_t                              rmd_cap;                    /**< Capacity of rmd (power of 2) */
+    size_t                              rmd_cnt;                    /**< Number of used slots in rmd */
+    double                              rmd_dur_min;                /**< Upper bound of duration class 0 [samples] */
+    double                              rmd_dur_ratio;              /**< Ratio between upper and lower bound of a duration class */
+    unsigned                            rmd_dur_count;              /**< Number of duration classes */
+
+    /* Rainflow matrix pyramid, coarser levels are materialized on demand (see RFC_rfm_level()) */
+    rfc_counts_t                       *rfm_pyr;                    /**< Levels 1..rfm_pyr_levels, level l has class width .class_width*2^l */
+    size_t                              rfm_pyr_cap;                /**< Capacity of rfm_pyr (number of elements) */
+    unsigned                            rfm_pyr_levels;             /**< Number of levels materialized in rfm_pyr */
+    size_t                              rfm_pyr_rev;                /**< Revision of rfm, rfm_pyr was built from */
+    size_t                              rfm_rev;                    /**< Revision of rfm, incremented on every change */
+
+    /* Cycles in value domain (optional, may be NULL) */
+    rfc_cycle_item_s                   *cycles;                     /**< Recorded cycles, pointer may be changed whilst memory reallocation! */
+    size_t                              cycles_cap;                 /**< Capacity of cycles */
+    size_t                              cycles_cnt;                 /**< Number of cycles recorded */
+
+    /* Conditional counting (optional, may be NULL), see RFC_feed_cond() */
+    unsigned                            cond_count;                 /**< Number of conditions (states of the auxiliary channel) */
+    rfc_cond_rule_e                     cond_rule;                  /**< Rule to attribute cycles to conditions */
+    rfc_counts_t                       *cond_rfm;                   /**< Rainflow matrices per condition, cond_count*class_count^2 values */
+    double                             *cond_damage;                /**< Damage per condition */
+    unsigned                            wl_bin_count;               /**< Number of Woehler curves per condition (0 or cond_count) */
+    double                             *wl_bin_lut;                 /**< Damage per closed cycle and condition, wl_bin_count*class_count^2 values */
+
+    /* Time at level (optional, may be NULL) */
+    size_t                             *tal;                        /**< Number of samples per class */
+
+    /* Most damaging cycles (optional, may be NULL), see RFC_top_init() */
+    rfc_top_item_s                     *top;                        /**< Min-heap of the most damaging cycles */
+    size_t                              top_cap;                    /**< Capacity of top */
+    size_t                              top_cnt;                    /**< Number of cycles in top */
+    rfc_top_key_e                       top_key;                    /**< Ranking of cycles */
+
+    /* Snapshots for concurrent readers (optional), see RFC_snapshot_init() */
+    struct snapshot_buf
+    {
+        volatile size_t                 seq;                        /**< Sequence counter, odd while the buffer is written */
+        rfc_snapshot_s                  scalars;                    /**< Scalar results */
+        rfc_counts_t                   *rfm;                        /**< Copy of rfm (may be NULL) */
+        rfc_counts_t                   *lc;                         /**< Copy of lc (may be NULL) */
+        unsigned char                  *dirty;                      /**< Tiles of rfm changed since last publication into this buffer */
+    }                                   snapshot[2];
+    volatile size_t                     snapshot_epoch;             /**< Number of publications, (epoch & 1) is the buffer to read from */
+    size_t                              snapshot_rfm_rev;           /**< Revision of rfm covered by dirty tiles */
+    unsigned                            snapshot_tiles;             /**< Number of tiles per rfm row (0, if snapshots are disabled) */
+
+    /* Result region for other processes (optional, may be NULL), see RFC_region_attach() */
+    rfc_region_header_s                *region;                     /**< Attached result region */
+    unsigned char                      *region_dirty;               /**< Tiles of rfm changed since last publication into the region */
+    size_t                              region_rfm_rev;             /**< Revision of rfm covered by dirty tiles */
+    unsigned                            region_tiles;               /**< Number of tiles per rfm row */
+#if RFC_SHM_SUPPORT
+    char                               *region_shm_name;            /**< Name of the shared memory segment owned by the context (may be NULL) */
+#endif /*RFC_SHM_SUPPORT*/
+
+    /* Followers counting turning points of this context (optional, may be NULL), see RFC_follower_add() */
+    void                              **followers;                  /**< Followers (rainflow contexts) */
+    unsigned                            follower_cnt;               /**< Number of followers */
 #endif /*!RFC_MINIMAL*/
 
 #if RFC_TP_SUPPORT
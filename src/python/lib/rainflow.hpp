@@ -43,6 +43,9 @@
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include "rainflow.h"
 
 #pragma pack(push, 1)
@@ -128,6 +131,23 @@ public:
         RFC_MEM_AIM_HCM                         =  RF::RFC_MEM_AIM_HCM,                         /**< Error on accessing memory for HCM algorithm */
         RFC_MEM_AIM_DH                          =  RF::RFC_MEM_AIM_DH,                          /**< Error on accessing memory for damage history */
         RFC_MEM_AIM_RFM_ELEMENTS                =  RF::RFC_MEM_AIM_RFM_ELEMENTS,                /**< Error on accessing memory for rf matrix elements */
+        RFC_MEM_AIM_CP                          =  RF::RFC_MEM_AIM_CP,                          /**< Error on accessing memory for critical plane counting states */
+        RFC_MEM_AIM_RMM                         =  RF::RFC_MEM_AIM_RMM,                         /**< Error on accessing memory for range-mean matrix */
+        RFC_MEM_AIM_RMM_ELEMENTS                =  RF::RFC_MEM_AIM_RMM_ELEMENTS,                /**< Error on accessing memory for range-mean matrix elements */
+        RFC_MEM_AIM_RMD                         =  RF::RFC_MEM_AIM_RMD,                         /**< Error on accessing memory for range-mean-duration histogram */
+        RFC_MEM_AIM_RMD_ELEMENTS                =  RF::RFC_MEM_AIM_RMD_ELEMENTS,                /**< Error on accessing memory for range-mean-duration histogram elements */
+        RFC_MEM_AIM_RFM_PYRAMID                 =  RF::RFC_MEM_AIM_RFM_PYRAMID,                 /**< Error on accessing memory for rainflow matrix pyramid */
+        RFC_MEM_AIM_CYCLES                      =  RF::RFC_MEM_AIM_CYCLES,                      /**< Error on accessing memory for cycles in value domain */
+        RFC_MEM_AIM_CLASS_BOUNDS                =  RF::RFC_MEM_AIM_CLASS_BOUNDS,                /**< Error on accessing memory for non-uniform class boundaries */
+        RFC_MEM_AIM_COND                        =  RF::RFC_MEM_AIM_COND,                        /**< Error on accessing memory for conditional counting */
+        RFC_MEM_AIM_TAL                         =  RF::RFC_MEM_AIM_TAL,                         /**< Error on accessing memory for time at level */
+        RFC_MEM_AIM_WL_BINS                     =  RF::RFC_MEM_AIM_WL_BINS,                     /**< Error on accessing memory for Woehler curves per condition */
+        RFC_MEM_AIM_TOP                         =  RF::RFC_MEM_AIM_TOP,                         /**< Error on accessing memory for most damaging cycles */
+        RFC_MEM_AIM_SNAPSHOT                    =  RF::RFC_MEM_AIM_SNAPSHOT,                    /**< Error on accessing memory for snapshots */
+        RFC_MEM_AIM_REGION                      =  RF::RFC_MEM_AIM_REGION,                      /**< Error on accessing memory for result regions */
+        RFC_MEM_AIM_MUX                         =  RF::RFC_MEM_AIM_MUX,                         /**< Error on accessing memory for stream multiplexers */
+        RFC_MEM_AIM_ARCHIVE                     =  RF::RFC_MEM_AIM_ARCHIVE,                     /**< Error on accessing memory for turning point archives */
+        RFC_MEM_AIM_FOLLOWERS                   =  RF::RFC_MEM_AIM_FOLLOWERS,                   /**< Error on accessing memory for followers */
     };
 
 
@@ -149,6 +169,10 @@ public:
         RFC_FLAGS_TPPRUNE_PRESERVE_RES          = RF::RFC_FLAGS_TPPRUNE_PRESERVE_RES,           /**< Preserve turning points that exist in resiude on pruning */
         RFC_FLAGS_TPAUTOPRUNE                   = RF::RFC_FLAGS_TPAUTOPRUNE,                    /**< Automatic prune on tp */
         RFC_FLAGS_AUTORESIZE                    = RF::RFC_FLAGS_AUTORESIZE,                     /**< Automatically resize buffers for rp, lc, and rfm */
+        RFC_FLAGS_COUNT_RMM                     = RF::RFC_FLAGS_COUNT_RMM,                      /**< Count into range-mean matrix */
+        RFC_FLAGS_COUNT_RMD                     = RF::RFC_FLAGS_COUNT_RMD,                      /**< Count into range-mean-duration histogram */
+        RFC_FLAGS_COUNT_VALUES                  = RF::RFC_FLAGS_COUNT_VALUES,                   /**< Close cycles on values (4PTM) and record them as value pairs */
+        RFC_FLAGS_COUNT_TAL                     = RF::RFC_FLAGS_COUNT_TAL,                      /**< Count samples per class (time at level) */
     };
 
 
@@ -195,6 +219,9 @@ public:
         RFC_ERROR_LUT                           = RF::RFC_ERROR_LUT,                            /**< Error while accessing look up tables */
         RFC_ERROR_DATA_OUT_OF_RANGE             = RF::RFC_ERROR_DATA_OUT_OF_RANGE,              /**< Input data leaves classrange */
         RFC_ERROR_DATA_INCONSISTENT             = RF::RFC_ERROR_DATA_INCONSISTENT,              /**< Processed data is inconsistent (internal error) */
+#if RFC_SHM_SUPPORT
+        RFC_ERROR_SHM                           = RF::RFC_ERROR_SHM,                            /**< Error on creating or mapping a shared memory segment */
+#endif /*RFC_SHM_SUPPORT*/
     };
 
 
@@ -241,6 +268,15 @@ public:
     };
 
 
+    enum rfc_spectral_method
+    {
+        RFC_SPECTRAL_NARROW_BAND                = RF::RFC_SPECTRAL_NARROW_BAND,                 /**< Narrow band approximation (Rayleigh distributed amplitudes) */
+        RFC_SPECTRAL_DIRLIK                     = RF::RFC_SPECTRAL_DIRLIK,                      /**< Dirlik's empirical rainflow range distribution */
+        RFC_SPECTRAL_TOVO_BENASCIUTTI           = RF::RFC_SPECTRAL_TOVO_BENASCIUTTI,            /**< Tovo-Benasciutti, weighted narrow band and range counting */
+        RFC_SPECTRAL_COUNT                      = RF::RFC_SPECTRAL_COUNT,                       /**< Number of options */
+    };
+
+
     enum rfc_lc_count_method
     {
         RFC_LC_COUNT_METHOD_SLOPES_UP           = RF::RFC_LC_COUNT_METHOD_SLOPES_UP,            /**< Count on rising slopes only (default) */
@@ -249,6 +285,29 @@ public:
     };
 
 
+    enum rfc_cond_rule
+    {
+        RFC_COND_RULE_FROM                      = RF::RFC_COND_RULE_FROM,                       /**< Cycle belongs to the condition at its starting turning point */
+        RFC_COND_RULE_TO                        = RF::RFC_COND_RULE_TO,                         /**< Cycle belongs to the condition at its ending turning point */
+        RFC_COND_RULE_MAX                       = RF::RFC_COND_RULE_MAX,                        /**< Cycle belongs to the condition at its maximum turning point */
+    };
+
+
+    enum rfc_sl_model
+    {
+        RFC_SL_MODEL_NONE                       = RF::RFC_SL_MODEL_NONE,                        /**< Nominal stress approach, Woehler curve */
+        RFC_SL_MODEL_SWT                        = RF::RFC_SL_MODEL_SWT,                         /**< Local strain approach, damage parameter of Smith, Watson and Topper */
+        RFC_SL_MODEL_MORROW                     = RF::RFC_SL_MODEL_MORROW,                      /**< Local strain approach, strain-life curve with Morrow mean stress correction */
+    };
+
+
+    enum rfc_top_key
+    {
+        RFC_TOP_KEY_DAMAGE                      = RF::RFC_TOP_KEY_DAMAGE,                       /**< Rank cycles by damage */
+        RFC_TOP_KEY_RANGE                       = RF::RFC_TOP_KEY_RANGE,                        /**< Rank cycles by range */
+    };
+
+
     /* Typedefs */
     typedef                 RF::rfc_value_t         rfc_value_t;                                /** Input data value type */
     typedef                 RF::rfc_counts_t        rfc_counts_t;                               /** Type of counting values */
@@ -256,7 +315,15 @@ public:
     typedef                 RF::rfc_ctx_s           rfc_ctx_s;                                  /** Forward declaration (rainflow context) */
     typedef                 RF::rfc_class_param     rfc_class_param_s;                          /** Class parameters (width, offset, count) */
     typedef                 RF::rfc_wl_param        rfc_wl_param_s;                             /** Woehler curve parameters (sd, nd, k, k2, omission) */
+    typedef                 RF::rfc_sl_param        rfc_sl_param_s;                             /** Local strain approach parameters (material, notch) */
     typedef                 RF::rfc_rfm_item        rfc_rfm_item_s;                             /** Rainflow matrix element */
+    typedef                 RF::rfc_rmm_item        rfc_rmm_item_s;                             /** Range-mean matrix element */
+    typedef                 RF::rfc_rmd_item        rfc_rmd_item_s;                             /** Range-mean-duration histogram element */
+    typedef                 RF::rfc_cycle_item      rfc_cycle_item_s;                           /** Cycle in value domain */
+    typedef                 RF::rfc_top_item        rfc_top_item_s;                             /** Cycle ranked among the most damaging */
+    typedef                 RF::rfc_snapshot        rfc_snapshot_s;                             /** Scalar results of a snapshot */
+    typedef                 RF::rfc_res_result      rfc_res_result_s;                           /** Results of a residual method */
+    typedef                 RF::rfc_region_header   rfc_region_header_s;                        /** Header of a result region */
     typedef     enum        rfc_mem_aim             rfc_mem_aim_e;                              /** Memory accessing mode */
     typedef     enum        rfc_flags               rfc_flags_e;                                /** Flags, see RFC_FLAGS... */
     typedef     enum        rfc_state               rfc_state_e;                                /** Counting state, see RFC_STATE... */
@@ -266,18 +333,27 @@ public:
     typedef     enum        rfc_rp_damage_method    rfc_rp_damage_method_e;                     /** Method when calculating damage from range pair counting, see RFC_RP_DAMAGE_CALC_METHOD... */
     typedef     enum        rfc_sd_method           rfc_sd_method_e;                            /** Spread damage method, see RFC_SD... */
     typedef     enum        rfc_lc_count_method     rfc_lc_count_method_e;                      /** Controls which slopes to take into account, when doing the level crossing counting */
+    typedef     enum        rfc_spectral_method     rfc_spectral_method_e;                      /** Spectral damage estimation method, see RFC_SPECTRAL... */
+    typedef     enum        rfc_cond_rule           rfc_cond_rule_e;                            /** Rule to attribute cycles to conditions, see RFC_COND_RULE... */
+    typedef     enum        rfc_sl_model            rfc_sl_model_e;                             /** Local strain damage model, see RFC_SL_MODEL... */
+    typedef     enum        rfc_top_key             rfc_top_key_e;                              /** Ranking of most damaging cycles, see RFC_TOP_KEY... */
 
     typedef     std::vector<double>                 rfc_double_v;                               /** Vector of double */
     typedef     std::vector<rfc_value_t>            rfc_value_v;                                /** Vector of values */
     typedef     std::vector<rfc_value_tuple_s>      rfc_value_tuple_v;                          /** Vector of value tuples */
     typedef     std::vector<rfc_counts_t>           rfc_counts_v;                               /** Vector of counts */
+    typedef     std::vector<size_t>                 rfc_size_v;                                 /** Vector of sizes (sample counts) */
+    typedef     std::vector<rfc_top_item_s>         rfc_top_item_v;                             /** Vector of most damaging cycles */
     typedef     std::vector<rfc_rfm_item_s>         rfc_rfm_item_v;                             /** Vector of rainflow matrix items */
+    typedef     std::vector<rfc_rmm_item_s>         rfc_rmm_item_v;                             /** Vector of range-mean matrix items */
+    typedef     std::vector<rfc_rmd_item_s>         rfc_rmd_item_v;                             /** Vector of range-mean-duration histogram items */
 
     typedef     T                                   rfc_tp_storage;                             /** Rainflow turning points storage */
 
 
     /* Memory allocation functions typedef */
     typedef     void *   ( *rfc_mem_alloc_fcn_t )   ( void *, size_t num, size_t size, rfc_mem_aim_e aim );     /** Memory allocation functor */
+    typedef     bool     ( *rfc_rfm_visit_fcn_t )   ( void *user, unsigned from, unsigned to, rfc_counts_t counts );  /** Rainflow matrix visitor */
 
     /* Core function wrapper */
     bool            init                    ( unsigned class_count, rfc_value_t class_width, rfc_value_t class_offset, 
@@ -294,11 +370,17 @@ public:
     bool            cycle_process_counts    ( rfc_value_t from_val, rfc_value_t to_val, rfc_flags_e flags );
     bool            feed_scaled             ( const rfc_value_t* data, size_t count, double factor );
     bool            feed_tuple              ( rfc_value_tuple_s *data, size_t count );
+    bool            feed_cond               ( const rfc_value_t* data, const unsigned *cond, size_t count );
+    bool            feed_rle                ( const rfc_value_t* values, const size_t *repeats, size_t count );
+    bool            feed_classes            ( const uint16_t *cls, size_t count );
+    bool            feed_tp                 ( const rfc_value_t *values, const size_t *positions, size_t count );
     bool            finalize                ( rfc_res_method_e residual_method = RFC_RES_IGNORE );
+    bool            finalize_multi          ( const rfc_res_method_e *methods, rfc_res_result_s *results, unsigned count );
     /* Functions on rainflow matrix */           
     bool            rfm_make_symmetric      ();
     bool            rfm_non_zeros           ( unsigned *count ) const;
     bool            rfm_get                 ( rfc_rfm_item_s **buffer, unsigned *count ) const;
+    bool            rfm_foreach             ( rfc_rfm_visit_fcn_t visit, void *user ) const;
     bool            rfm_set                 ( const rfc_rfm_item_s *buffer, unsigned count, bool add_only );
     bool            rfm_peek                ( rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t *count ) const;
     bool            rfm_poke                ( rfc_value_t from_val, rfc_value_t to_val, rfc_counts_t count, bool add_only );
@@ -306,16 +388,54 @@ public:
     bool            rfm_damage              ( unsigned from_first, unsigned from_last, unsigned to_first, unsigned to_last, double *damage ) const;
     bool            rfm_check               () const;
     bool            rfm_refeed              ( rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param );
+    bool            rfm_level               ( unsigned level, const rfc_counts_t **rfm, rfc_class_param_s *class_param ) const;
+    bool            rfm_get_level           ( unsigned level, rfc_rfm_item_s **buffer, unsigned *count ) const;
+    bool            rfm_resample            ( const rfc_class_param_s *class_param, rfc_counts_t *rfm ) const;
+    /* Functions on range-mean matrix */
+    bool            rmm_non_zeros           ( unsigned *count ) const;
+    bool            rmm_get                 ( rfc_rmm_item_s **buffer, unsigned *count ) const;
+    bool            rmm_peek                ( rfc_value_t range_val, rfc_value_t mean_val, rfc_counts_t *count ) const;
+    bool            rmm_damage              ( double *damage, const rfc_counts_t *rmm = NULL ) const;
+    bool            rmm_from_rfm            ( rfc_counts_t *rmm, const rfc_counts_t *rfm = NULL ) const;
+    /* Functions on range-mean-duration histogram */
+    bool            rmd_init                ( double dur_min, double dur_ratio, unsigned dur_count );
+    bool            rmd_non_zeros           ( unsigned *count ) const;
+    bool            rmd_get                 ( rfc_rmd_item_s **buffer, unsigned *count ) const;
+    bool            rmd_duration            ( unsigned duration, double *dur_lower, double *dur_upper ) const;
+    /* Functions on cycles in value domain */
+    bool            cycles_get              ( const rfc_cycle_item_s **cycles, size_t *count ) const;
+    bool            cycles_class_param      ( unsigned class_count, rfc_class_param_s *class_param ) const;
+    bool            cycles_rfm              ( const rfc_class_param_s *class_param, rfc_counts_t *rfm ) const;
+    bool            cycles_rp               ( const rfc_class_param_s *class_param, rfc_counts_t *rp ) const;
+    bool            cycles_damage           ( double *damage ) const;
+    /* Functions on most damaging cycles */
+    bool            top_init                ( size_t cap, rfc_top_key_e key );
+    bool            top_get                 ( rfc_top_item_s *items, size_t *count ) const;
+    /* Snapshots for concurrent readers */
+    bool            snapshot_init           ( bool enable );
+    bool            snapshot_get            ( rfc_snapshot_s *snapshot, rfc_counts_t *rfm, rfc_counts_t *lc ) const;
+    /* Result regions for other processes */
+    bool            region_size             ( size_t *size ) const;
+    bool            region_attach           ( void *region, size_t size );
+#if RFC_SHM_SUPPORT
+    bool            shm_create              ( const char *name );
+#endif /*RFC_SHM_SUPPORT*/
 /* Functions on histograms */           
     bool            lc_get                  ( rfc_counts_t *lc, rfc_value_t *level ) const;
     bool            lc_from_rfm             ( rfc_counts_t *lc, rfc_value_t *level, const rfc_counts_t *rfm, rfc_flags_e flags ) const;
     bool            lc_from_residue         ( rfc_counts_t *lc, rfc_value_t *level, const rfc_value_tuple_s* residue, unsigned residue_cnt, rfc_flags_e flags ) const;
     bool            lc_from_residue         ( rfc_counts_t *lc, rfc_value_t *level, const rfc_value_t* residue, unsigned residue_cnt, rfc_flags_e flags ) const;
     bool            rp_get                  ( rfc_counts_t *rp, rfc_value_t *Sa ) const;
+    bool            tal_get                 ( size_t *tal, rfc_value_t *level ) const;
     bool            rp_from_rfm             ( rfc_counts_t *rp, rfc_value_t *Sa, const rfc_counts_t *rfm ) const;
     bool            damage                  ( rfc_value_t *damage = NULL, rfc_value_t *damage_residue = NULL ) const;
     bool            damage_from_rp          ( double *damage, const rfc_counts_t *counts, const rfc_value_t *Sa, rfc_rp_damage_method_e rp_calc_type ) const;
     bool            damage_from_rfm         ( double *damage, const rfc_counts_t *rfm ) const;
+    bool            cp_damage               ( const rfc_value_t *data, size_t data_count, unsigned comp_count, const double *coeffs, unsigned plane_count, 
+                                              rfc_res_method_e residual_method, double *damage, unsigned *critical_plane ) const;
+    bool            spectral_psd            ( const rfc_value_t *data, size_t data_count, double fs, unsigned nfft, double *psd ) const;
+    bool            spectral_damage         ( const double *psd, size_t psd_count, double df, double duration, rfc_spectral_method_e method, 
+                                              double *damage, rfc_counts_t *rp = NULL, rfc_value_t *Sa = NULL ) const;
     /* Woehler curve */
     bool            wl_calc_sx              ( double s0, double n0, double k, double *sx, double nx, double  k2, double  sd, double nd ) const;
     bool            wl_calc_sd              ( double s0, double n0, double k, double  sx, double nx, double  k2, double *sd, double nd ) const;
@@ -327,6 +447,8 @@ public:
     bool            tp_prune                ( size_t count, rfc_flags_e flags );
     bool            tp_refeed               ( rfc_value_t new_hysteresis, const rfc_class_param_s *new_class_param );
     bool            tp_clear                ();
+    bool            archive_write           ( unsigned char *archive, size_t *size, unsigned chunk_size, double scale ) const;
+    bool            archive_feed            ( const unsigned char *archive, size_t size );
     /* Residuum */
     bool            res_get                 ( const rfc_value_tuple_s **residue, unsigned *count ) const;
     /* Damage history */
@@ -350,13 +472,24 @@ public:
     bool            class_count             ( unsigned *class_count ) const;
     bool            class_offset            ( rfc_value_t *class_offset ) const;
     bool            class_width             ( rfc_value_t *class_width ) const;
+    bool            class_bounds_set        ( const rfc_value_t *bounds, unsigned count );
+    bool            class_bounds_get        ( const rfc_value_t **bounds, unsigned *count ) const;
+    bool            cond_init               ( unsigned cond_count, rfc_cond_rule_e rule );
+    bool            cond_rfm                ( unsigned cond, const rfc_counts_t **rfm ) const;
+    bool            cond_damage             ( unsigned cond, double *damage ) const;
+    bool            wl_bins_init            ( const rfc_wl_param_s *wl_params, unsigned count );
     bool            hysteresis              ( rfc_value_t *hysteresis ) const;
+    bool            hysteresis_from_damage  ( double fraction, double *damage_bound );
+    bool            follower_add            ( RainflowT &follower );
 
     /* more C++ specific extensions */
     bool            feed                    ( const std::vector<rfc_value_t> data );
     bool            feed_scaled             ( const std::vector<rfc_value_t> data, double factor );
     bool            rfm_get                 ( rfc_rfm_item_v &buffer ) const;
+    bool            rfm_get_level           ( unsigned level, rfc_rfm_item_v &buffer ) const;
     bool            rfm_set                 ( const rfc_rfm_item_v &buffer, bool add_only );
+    bool            rmm_get                 ( rfc_rmm_item_v &buffer ) const;
+    bool            rmd_get                 ( rfc_rmd_item_v &buffer ) const;
     bool            lc_get                  ( rfc_counts_v &lc, rfc_value_v &level ) const;
     bool            lc_from_rfm             ( rfc_counts_v &lc, rfc_value_v &level, const rfc_counts_t *rfm, rfc_flags_e flags ) const;
     bool            lc_from_residue         ( rfc_counts_v &lc, rfc_value_v &level, const rfc_value_tuple_s *residue, unsigned residue_cnt, rfc_flags_e flags ) const;
@@ -364,6 +497,8 @@ public:
     bool            lc_from_residue         ( rfc_counts_v &lc, rfc_value_v &level, const rfc_value_t *residue, unsigned residue_cnt, rfc_flags_e flags ) const;
     bool            lc_from_residue         ( rfc_counts_v &lc, rfc_value_v &level, const rfc_value_v &residue, rfc_flags_e flags ) const;
     bool            rp_get                  ( rfc_counts_v &rp, rfc_value_v &Sa ) const;
+    bool            tal_get                 ( rfc_size_v &tal, rfc_value_v &level ) const;
+    bool            top_get                 ( rfc_top_item_v &items ) const;
     bool            rp_from_rfm             ( rfc_counts_v &rp, rfc_value_v &Sa, const rfc_counts_t *rfm ) const;
     bool            damage_from_rp          ( double &damage, const rfc_counts_v &counts, const rfc_value_v &Sa, rfc_rp_damage_method_e rp_calc_type ) const;
     bool            at_init                 ( const rfc_double_v &Sa, const rfc_double_v &Sm, 
@@ -371,6 +506,8 @@ public:
     bool            at_init                 ( double M, double Sm_rig, double R_rig, bool R_pinned );
     bool            at_transform            ( double Sa, double Sm, double &Sa_transformed ) const;
     bool            wl_param_get            ( rfc_wl_param_s &wl_param ) const;
+    bool            sl_param_set            ( const rfc_sl_param_s &sl_param );
+    bool            sl_param_get            ( rfc_sl_param_s &sl_param ) const;
 
     /* TP storage access */
     inline const
@@ -384,6 +521,55 @@ public:
     inline
     rfc_counts_t*   rfm_storage             ()       { return m_ctx.rfm; }
 
+    /* Iterator on non-zero matrix elements (no allocation, invalidated by counting) */
+    class rfm_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef rfc_rfm_item_s              value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const rfc_rfm_item_s*       pointer;
+        typedef const rfc_rfm_item_s&       reference;
+
+                        rfm_iterator        () : m_rfm( NULL ), m_class_count( 0 ), m_index( 0 ), m_end( 0 ) {}
+                        rfm_iterator        ( const rfc_counts_t *rfm, unsigned class_count, size_t index )
+                                            : m_rfm( rfm ), m_class_count( class_count ), m_index( index ), 
+                                              m_end( rfm ? (size_t)class_count * class_count : 0 ) { seek(); }
+
+        reference       operator*           () const { return m_item; }
+        pointer         operator->          () const { return &m_item; }
+        rfm_iterator&   operator++          ()       { m_index++; seek(); return *this; }
+        rfm_iterator    operator++          ( int )  { rfm_iterator it( *this ); m_index++; seek(); return it; }
+        bool            operator==          ( const rfm_iterator &other ) const { return m_index == other.m_index && m_rfm == other.m_rfm; }
+        bool            operator!=          ( const rfm_iterator &other ) const { return !( *this == other ); }
+
+    private:
+        void            seek                ()
+        {
+            while( m_index < m_end && !m_rfm[m_index] ) m_index++;
+
+            if( m_index < m_end )
+            {
+                m_item.from   = (unsigned)( m_index / m_class_count );
+                m_item.to     = (unsigned)( m_index % m_class_count );
+                m_item.counts = m_rfm[m_index];
+            }
+            else
+            {
+                m_index = m_end;
+            }
+        }
+
+        const rfc_counts_t *m_rfm;
+        unsigned            m_class_count;
+        size_t              m_index;
+        size_t              m_end;
+        rfc_rfm_item_s      m_item;
+    };
+
+    rfm_iterator    rfm_begin               () const { return rfm_iterator( m_ctx.rfm, m_ctx.class_count, 0 ); }
+    rfm_iterator    rfm_end                 () const { return rfm_iterator( m_ctx.rfm, m_ctx.class_count, (size_t)m_ctx.class_count * m_ctx.class_count ); }
+
     /* Delegates */
     bool            tp_set                  ( size_t tp_pos, rfc_value_tuple_s *tp );
     bool            tp_get                  ( size_t tp_pos, rfc_value_tuple_s **tp );
@@ -432,6 +618,14 @@ public:
     void*           mem_alloc               ( void *ptr, size_t num, size_t size, rfc_mem_aim_e aim );
 
 private:
+    struct rfm_push_s                                                   // State of rfm_get(), passed to rfm_item_push()
+    {
+        rfc_rfm_item_v *buffer;
+        bool            ok;
+    };
+
+    static
+    bool            rfm_item_push           ( void *user, unsigned from, unsigned to, rfc_counts_t counts );
     void            ctx_assign              ( const rfc_ctx_s& );   // Inhibit assign on const ctx
                     RainflowT               ( const rfc_ctx_s& );   // Inhibit copy ctor on const ctx
                     RainflowT               ( const RainflowT& );       // Inhibit copy ctor on (non-)const RainflowT
@@ -551,6 +745,34 @@ bool RainflowT<T>::feed_tuple( rfc_value_tuple_s *data, size_t count )
 }
 
 
+template< class T >
+bool RainflowT<T>::feed_cond( const rfc_value_t* data, const unsigned *cond, size_t count )
+{
+    return RF::RFC_feed_cond( &m_ctx, (const RF::rfc_value_t*)data, cond, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::feed_rle( const rfc_value_t* values, const size_t *repeats, size_t count )
+{
+    return RF::RFC_feed_rle( &m_ctx, (const RF::rfc_value_t*)values, repeats, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::feed_classes( const uint16_t *cls, size_t count )
+{
+    return RF::RFC_feed_classes( &m_ctx, cls, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::feed_tp( const rfc_value_t *values, const size_t *positions, size_t count )
+{
+    return RF::RFC_feed_tp( &m_ctx, values, positions, count );
+}
+
+
 template< class T >
 bool RainflowT<T>::finalize( rfc_res_method_e residual_method )
 {
@@ -558,6 +780,13 @@ bool RainflowT<T>::finalize( rfc_res_method_e residual_method )
 }
 
 
+template< class T >
+bool RainflowT<T>::finalize_multi( const rfc_res_method_e *methods, rfc_res_result_s *results, unsigned count )
+{
+    return RF::RFC_finalize_multi( &m_ctx, (const RF::rfc_res_method_e *)methods, results, count );
+}
+
+
 template< class T >
 bool RainflowT<T>::rfm_make_symmetric()
 {
@@ -579,6 +808,13 @@ bool RainflowT<T>::rfm_get( rfc_rfm_item_s **buffer, unsigned *count ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::rfm_foreach( rfc_rfm_visit_fcn_t visit, void *user ) const
+{
+    return RF::RFC_rfm_foreach( &m_ctx, (RF::rfc_rfm_visit_fcn_t)visit, user );
+}
+
+
 template< class T >
 bool RainflowT<T>::rfm_set( const rfc_rfm_item_s *buffer, unsigned count, bool add_only )
 {
@@ -621,6 +857,27 @@ bool RainflowT<T>::rfm_refeed( rfc_value_t new_hysteresis, const rfc_class_param
 }
 
 
+template< class T >
+bool RainflowT<T>::rfm_level( unsigned level, const rfc_counts_t **rfm, rfc_class_param_s *class_param ) const
+{
+    return RF::RFC_rfm_level( &m_ctx, level, (const RF::rfc_counts_t **)rfm, class_param );
+}
+
+
+template< class T >
+bool RainflowT<T>::rfm_get_level( unsigned level, rfc_rfm_item_s **buffer, unsigned *count ) const
+{
+    return RF::RFC_rfm_get_level( &m_ctx, level, (RF::rfc_rfm_item_s **)buffer, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rfm_resample( const rfc_class_param_s *class_param, rfc_counts_t *rfm ) const
+{
+    return RF::RFC_rfm_resample( &m_ctx, class_param, (RF::rfc_counts_t *)rfm );
+}
+
+
 template< class T >
 bool RainflowT<T>::rfm_check() const
 {
@@ -628,6 +885,155 @@ bool RainflowT<T>::rfm_check() const
 }
 
 
+template< class T >
+bool RainflowT<T>::rmm_non_zeros( unsigned *count ) const
+{
+    return RF::RFC_rmm_non_zeros( &m_ctx, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmm_get( rfc_rmm_item_s **buffer, unsigned *count ) const
+{
+    return RF::RFC_rmm_get( &m_ctx, (RF::rfc_rmm_item_s **)buffer, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmm_peek( rfc_value_t range_val, rfc_value_t mean_val, rfc_counts_t *counts ) const
+{
+    return RF::RFC_rmm_peek( &m_ctx, (RF::rfc_value_t)range_val, (RF::rfc_value_t)mean_val, (RF::rfc_counts_t *)counts );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmm_damage( double *damage, const rfc_counts_t *rmm ) const
+{
+    return RF::RFC_rmm_damage( &m_ctx, damage, (const RF::rfc_counts_t *)rmm );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmm_from_rfm( rfc_counts_t *rmm, const rfc_counts_t *rfm ) const
+{
+    return RF::RFC_rmm_from_rfm( &m_ctx, (RF::rfc_counts_t *)rmm, (const RF::rfc_counts_t *)rfm );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmd_init( double dur_min, double dur_ratio, unsigned dur_count )
+{
+    return RF::RFC_rmd_init( &m_ctx, dur_min, dur_ratio, dur_count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmd_non_zeros( unsigned *count ) const
+{
+    return RF::RFC_rmd_non_zeros( &m_ctx, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmd_get( rfc_rmd_item_s **buffer, unsigned *count ) const
+{
+    return RF::RFC_rmd_get( &m_ctx, (RF::rfc_rmd_item_s **)buffer, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::rmd_duration( unsigned duration, double *dur_lower, double *dur_upper ) const
+{
+    return RF::RFC_rmd_duration( &m_ctx, duration, dur_lower, dur_upper );
+}
+
+
+template< class T >
+bool RainflowT<T>::cycles_get( const rfc_cycle_item_s **cycles, size_t *count ) const
+{
+    return RF::RFC_cycles_get( &m_ctx, (const RF::rfc_cycle_item_s **)cycles, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::cycles_class_param( unsigned class_count, rfc_class_param_s *class_param ) const
+{
+    return RF::RFC_cycles_class_param( &m_ctx, class_count, class_param );
+}
+
+
+template< class T >
+bool RainflowT<T>::cycles_rfm( const rfc_class_param_s *class_param, rfc_counts_t *rfm ) const
+{
+    return RF::RFC_cycles_rfm( &m_ctx, class_param, (RF::rfc_counts_t *)rfm );
+}
+
+
+template< class T >
+bool RainflowT<T>::cycles_rp( const rfc_class_param_s *class_param, rfc_counts_t *rp ) const
+{
+    return RF::RFC_cycles_rp( &m_ctx, class_param, (RF::rfc_counts_t *)rp );
+}
+
+
+template< class T >
+bool RainflowT<T>::cycles_damage( double *damage ) const
+{
+    return RF::RFC_cycles_damage( &m_ctx, damage );
+}
+
+
+template< class T >
+bool RainflowT<T>::top_init( size_t cap, rfc_top_key_e key )
+{
+    return RF::RFC_top_init( &m_ctx, cap, (RF::rfc_top_key_e)key );
+}
+
+
+template< class T >
+bool RainflowT<T>::top_get( rfc_top_item_s *items, size_t *count ) const
+{
+    return RF::RFC_top_get( &m_ctx, (RF::rfc_top_item_s *)items, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::snapshot_init( bool enable )
+{
+    return RF::RFC_snapshot_init( &m_ctx, enable );
+}
+
+
+template< class T >
+bool RainflowT<T>::snapshot_get( rfc_snapshot_s *snapshot, rfc_counts_t *rfm, rfc_counts_t *lc ) const
+{
+    return RF::RFC_snapshot_get( &m_ctx, (RF::rfc_snapshot_s *)snapshot, (RF::rfc_counts_t *)rfm, (RF::rfc_counts_t *)lc );
+}
+
+
+template< class T >
+bool RainflowT<T>::region_size( size_t *size ) const
+{
+    return RF::RFC_region_size( &m_ctx, size );
+}
+
+
+template< class T >
+bool RainflowT<T>::region_attach( void *region, size_t size )
+{
+    return RF::RFC_region_attach( &m_ctx, region, size );
+}
+
+
+#if RFC_SHM_SUPPORT
+template< class T >
+bool RainflowT<T>::shm_create( const char *name )
+{
+    return RF::RFC_shm_create( &m_ctx, name );
+}
+#endif /*RFC_SHM_SUPPORT*/
+
+
 template< class T >
 bool RainflowT<T>::lc_get( rfc_counts_t *lc, rfc_value_t *level ) const
 {
@@ -663,6 +1069,13 @@ bool RainflowT<T>::rp_get( rfc_counts_t *rp, rfc_value_t *Sa ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::tal_get( size_t *tal, rfc_value_t *level ) const
+{
+    return RF::RFC_tal_get( &m_ctx, tal, (RF::rfc_value_t *)level );
+}
+
+
 template< class T >
 bool RainflowT<T>::rp_from_rfm( rfc_counts_t *rp, rfc_value_t *Sa, const rfc_counts_t *rfm ) const
 {
@@ -690,6 +1103,30 @@ bool RainflowT<T>::damage_from_rfm( double *damage, const rfc_counts_t *rfm ) co
 }
 
 
+template< class T >
+bool RainflowT<T>::cp_damage( const rfc_value_t *data, size_t data_count, unsigned comp_count, const double *coeffs, unsigned plane_count, 
+                              rfc_res_method_e residual_method, double *damage, unsigned *critical_plane ) const
+{
+    return RF::RFC_cp_damage( &m_ctx, (const RF::rfc_value_t *)data, data_count, comp_count, coeffs, plane_count, 
+                              (RF::rfc_res_method_e)residual_method, damage, critical_plane );
+}
+
+
+template< class T >
+bool RainflowT<T>::spectral_psd( const rfc_value_t *data, size_t data_count, double fs, unsigned nfft, double *psd ) const
+{
+    return RF::RFC_spectral_psd( &m_ctx, (const RF::rfc_value_t *)data, data_count, fs, nfft, psd );
+}
+
+
+template< class T >
+bool RainflowT<T>::spectral_damage( const double *psd, size_t psd_count, double df, double duration, rfc_spectral_method_e method, 
+                                    double *damage, rfc_counts_t *rp, rfc_value_t *Sa ) const
+{
+    return RF::RFC_spectral_damage( &m_ctx, psd, psd_count, df, duration, (RF::rfc_spectral_method_e)method, damage, (RF::rfc_counts_t *)rp, (RF::rfc_value_t *)Sa );
+}
+
+
 template< class T >
 bool RainflowT<T>::wl_calc_sx( double s0, double n0, double k, double *sx, double nx, double  k2, double  sd, double nd ) const
 {
@@ -765,6 +1202,20 @@ bool RainflowT<T>::tp_clear()
 }
 
 
+template< class T >
+bool RainflowT<T>::archive_write( unsigned char *archive, size_t *size, unsigned chunk_size, double scale ) const
+{
+    return RF::RFC_archive_write( &m_ctx, archive, size, chunk_size, scale );
+}
+
+
+template< class T >
+bool RainflowT<T>::archive_feed( const unsigned char *archive, size_t size )
+{
+    return RF::RFC_archive_feed( &m_ctx, archive, size );
+}
+
+
 template< class T >
 bool RainflowT<T>::res_get( const rfc_value_tuple_s **residue, unsigned *count ) const
 {
@@ -864,6 +1315,48 @@ bool RainflowT<T>::class_width( rfc_value_t *class_width ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::class_bounds_set( const rfc_value_t *bounds, unsigned count )
+{
+    return RF::RFC_class_bounds_set( &m_ctx, bounds, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::class_bounds_get( const rfc_value_t **bounds, unsigned *count ) const
+{
+    return RF::RFC_class_bounds_get( &m_ctx, bounds, count );
+}
+
+
+template< class T >
+bool RainflowT<T>::cond_init( unsigned cond_count, rfc_cond_rule_e rule )
+{
+    return RF::RFC_cond_init( &m_ctx, cond_count, (RF::rfc_cond_rule_e)rule );
+}
+
+
+template< class T >
+bool RainflowT<T>::cond_rfm( unsigned cond, const rfc_counts_t **rfm ) const
+{
+    return RF::RFC_cond_rfm( &m_ctx, cond, (const RF::rfc_counts_t **)rfm );
+}
+
+
+template< class T >
+bool RainflowT<T>::cond_damage( unsigned cond, double *damage ) const
+{
+    return RF::RFC_cond_damage( &m_ctx, cond, damage );
+}
+
+
+template< class T >
+bool RainflowT<T>::wl_bins_init( const rfc_wl_param_s *wl_params, unsigned count )
+{
+    return RF::RFC_wl_bins_init( &m_ctx, (const RF::rfc_wl_param_s*) wl_params, count );
+}
+
+
 template< class T >
 bool RainflowT<T>::hysteresis( rfc_value_t *hysteresis ) const
 {
@@ -871,6 +1364,20 @@ bool RainflowT<T>::hysteresis( rfc_value_t *hysteresis ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::hysteresis_from_damage( double fraction, double *damage_bound )
+{
+    return RF::RFC_hysteresis_from_damage( &m_ctx, fraction, damage_bound );
+}
+
+
+template< class T >
+bool RainflowT<T>::follower_add( RainflowT &follower )
+{
+    return RF::RFC_follower_add( &m_ctx, &follower.m_ctx );
+}
+
+
 /* CPP specific extensions */
 template< class T >
 bool RainflowT<T>::feed( const std::vector<rfc_value_t> data )
@@ -888,12 +1395,49 @@ bool RainflowT<T>::feed_scaled( const std::vector<rfc_value_t> data, double fact
 
 template< class T >
 bool RainflowT<T>::rfm_get( rfc_rfm_item_v &buffer ) const
+{
+    rfm_push_s push = { &buffer, true };
+
+    // Capacity of buffer is kept, no intermediate allocation
+    buffer.clear();
+
+    return rfm_foreach( rfm_item_push, &push ) && push.ok;
+}
+
+
+template< class T >
+bool RainflowT<T>::rfm_item_push( void *user, unsigned from, unsigned to, rfc_counts_t counts )
+{
+    rfm_push_s     *push = (rfm_push_s*)user;
+    rfc_rfm_item_s  item;
+
+    item.from   = from;
+    item.to     = to;
+    item.counts = counts;
+
+    // Exceptions must not pass through RFC_rfm_foreach(), stop visiting instead
+    try
+    {
+        push->buffer->push_back( item );
+    }
+    catch( const std::bad_alloc& )
+    {
+        push->ok = false;
+        return false;
+    }
+
+    return true;
+}
+
+
+template< class T >
+bool RainflowT<T>::rfm_get_level( unsigned level, rfc_rfm_item_v &buffer ) const
 {
     rfc_rfm_item_s *buffer_ = NULL;
     unsigned        count   = 0;
     bool            ok;
 
-    if( rfm_get( &buffer_, &count ) )
+    if( rfm_get_level( level, &buffer_, &count ) )
     {
         buffer = rfc_rfm_item_v( buffer_, buffer_ + count );
         ok     = true;
@@ -904,7 +1448,6 @@ bool RainflowT<T>::rfm_get( rfc_rfm_item_v &buffer ) const
     }
 
     (void)mem_alloc( buffer_, 0, 0, RFC_MEM_AIM_RFM_ELEMENTS );
-
     return ok;
 }
 
@@ -916,6 +1459,50 @@ bool RainflowT<T>::rfm_set( const rfc_rfm_item_v &buffer, bool add_only )
 }
 
 
+template< class T >
+bool RainflowT<T>::rmm_get( rfc_rmm_item_v &buffer ) const
+{
+    rfc_rmm_item_s *buffer_ = NULL;
+    unsigned        count   = 0;
+    bool            ok;
+
+    if( rmm_get( &buffer_, &count ) )
+    {
+        buffer = rfc_rmm_item_v( buffer_, buffer_ + count );
+        ok     = true;
+    }
+    else
+    { 
+        ok = false;
+    }
+
+    (void)mem_alloc( buffer_, 0, 0, RFC_MEM_AIM_RMM_ELEMENTS );
+    return ok;
+}
+
+
+template< class T >
+bool RainflowT<T>::rmd_get( rfc_rmd_item_v &buffer ) const
+{
+    rfc_rmd_item_s *buffer_ = NULL;
+    unsigned        count   = 0;
+    bool            ok;
+
+    if( rmd_get( &buffer_, &count ) )
+    {
+        buffer = rfc_rmd_item_v( buffer_, buffer_ + count );
+        ok     = true;
+    }
+    else
+    { 
+        ok = false;
+    }
+
+    (void)mem_alloc( buffer_, 0, 0, RFC_MEM_AIM_RMD_ELEMENTS );
+    return ok;
+}
+
+
 template< class T >
 bool RainflowT<T>::lc_get( rfc_counts_v &lc, rfc_value_v &level ) const
 {
@@ -977,6 +1564,35 @@ bool RainflowT<T>::rp_get( rfc_counts_v &rp, rfc_value_v &Sa ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::tal_get( rfc_size_v &tal, rfc_value_v &level ) const
+{
+    tal.resize( m_ctx.class_count );
+    level.resize( m_ctx.class_count );
+
+    return tal_get( &tal[0], &level[0] );
+}
+
+
+template< class T >
+bool RainflowT<T>::top_get( rfc_top_item_v &items ) const
+{
+    size_t count = m_ctx.top_cap;
+
+    items.resize( count );
+
+    if( !count || !top_get( &items[0], &count ) )
+    {
+        items.clear();
+        return false;
+    }
+
+    items.resize( count );
+
+    return true;
+}
+
+
 template< class T >
 bool RainflowT<T>::rp_from_rfm( rfc_counts_v &rp, rfc_value_v &Sa, const rfc_counts_t *rfm ) const
 {
@@ -1028,6 +1644,20 @@ bool RainflowT<T>::wl_param_get( rfc_wl_param_s &wl_param ) const
 }
 
 
+template< class T >
+bool RainflowT<T>::sl_param_set( const rfc_sl_param_s &sl_param )
+{
+    return RF::RFC_sl_param_set( &m_ctx, &sl_param );
+}
+
+
+template< class T >
+bool RainflowT<T>::sl_param_get( rfc_sl_param_s &sl_param ) const
+{
+    return RF::RFC_sl_param_get( &m_ctx, &sl_param );
+}
+
+
 /* Delegates */
 template< class T >
 bool RainflowT<T>::tp_set( size_t tp_pos, rfc_value_tuple_s *tp )
@@ -1,4 +1,4 @@
-from typing import Optional, Union
+from typing import Iterable, Optional, Union
 
 from . import ArrayLike, LCMethod, ResidualMethod, SDMethod
 
@@ -17,4 +17,5 @@ def rfc(
         use_ASTM: Optional[Union[int, bool]] = 0,
         enforce_margin: Optional[Union[int, bool]] = 0,
         auto_resize: Optional[Union[int, bool]] = 0,
-        wl: Optional[dict] = None) -> tuple: ...
+        wl: Optional[dict] = None,
+        outputs: Optional[Iterable[str]] = None) -> tuple: ...
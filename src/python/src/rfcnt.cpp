@@ -13,6 +13,40 @@
 typedef std::vector<Rainflow::rfc_value_tuple_s> rfc_residuum_vec;
 
 
+// Results selectable by argument `outputs`
+enum rfc_output
+{
+    RFC_OUTPUT_DAMAGE   = 1 << 0,
+    RFC_OUTPUT_RP       = 1 << 1,
+    RFC_OUTPUT_LC       = 1 << 2,
+    RFC_OUTPUT_TAL      = 1 << 3,
+    RFC_OUTPUT_TP       = 1 << 4,
+    RFC_OUTPUT_RES_RAW  = 1 << 5,
+    RFC_OUTPUT_RES      = 1 << 6,
+    RFC_OUTPUT_RFM      = 1 << 7,
+    RFC_OUTPUT_DH       = 1 << 8,
+    RFC_OUTPUT_ALL      = ( 1 << 9 ) - 1
+};
+
+
+static const struct
+{
+    const char *name;
+    int         output;
+} rfc_output_names[] =
+{
+    { "damage",  RFC_OUTPUT_DAMAGE },
+    { "rp",      RFC_OUTPUT_RP },
+    { "lc",      RFC_OUTPUT_LC },
+    { "tal",     RFC_OUTPUT_TAL },
+    { "tp",      RFC_OUTPUT_TP },
+    { "res_raw", RFC_OUTPUT_RES_RAW },
+    { "res",     RFC_OUTPUT_RES },
+    { "rfm",     RFC_OUTPUT_RFM },
+    { "dh",      RFC_OUTPUT_DH },
+};
+
+
 
 
 static
@@ -178,6 +212,62 @@ bool get_dict_wl( PyObject *Py_wl, const char *name, Rainflow::rfc_wl_param_s &w
 }
 
 
+static
+bool get_outputs( PyObject *Py_outputs, const char *name, int &outputs )
+{
+    if( PyUnicode_Check( Py_outputs ) )
+    {
+        PyErr_Format( PyExc_TypeError, "`%s` must be a collection of strings, not a string", name );
+        return false;
+    }
+
+    PyObject *iter = PyObject_GetIter( Py_outputs );
+    PyObject *item;
+
+    if( !iter )
+    {
+        PyErr_Format( PyExc_TypeError, "`%s` must be a collection of strings", name );
+        return false;
+    }
+
+    outputs = 0;
+
+    // Iterate over names
+    while( ( item = PyIter_Next( iter ) ) != nullptr )
+    {
+        size_t i;
+
+        if( !PyUnicode_Check( item ) )
+        {
+            PyErr_Format( PyExc_TypeError, "Only strings allowed in `%s`", name );
+            Py_DECREF( item );
+            Py_DECREF( iter );
+            return false;
+        }
+
+        for( i = 0; i < sizeof(rfc_output_names) / sizeof(*rfc_output_names); i++ )
+        {
+            if( PyUnicode_CompareWithASCIIString( item, rfc_output_names[i].name ) == 0 ) break;
+        }
+
+        if( i == sizeof(rfc_output_names) / sizeof(*rfc_output_names) )
+        {
+            PyErr_Format( PyExc_ValueError, "Unknown output in `%s`: `%S`", name, item );
+            Py_DECREF( item );
+            Py_DECREF( iter );
+            return false;
+        }
+
+        outputs |= rfc_output_names[i].output;
+        Py_DECREF( item );
+    }
+
+    Py_DECREF( iter );
+
+    return !PyErr_Occurred();
+}
+
+
 // Convert RFC error numbers to strings
 static
 const char* rfc_err_str( int nr )
@@ -201,7 +291,7 @@ const char* rfc_err_str( int nr )
 
 // Parse RFC counting parameters
 static
-int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::rfc_res_method *res_method )
+int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::rfc_res_method *res_method, int *outputs )
 {
     PyObject   *empty           =  PyTuple_New(0);
     int         class_count     =  100;
@@ -212,20 +302,25 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
     int         use_hcm         =  0;  // false
     int         use_astm        =  0;  // false
     int         lc_method       =  0;  // Count rising slopes only
-    int         flags           =  Rainflow::RFC_FLAGS_DEFAULT;
+    int         flags           =  Rainflow::RFC_FLAGS_COUNT_ALL            |  // Defaults plus time at level
+                                   Rainflow::RFC_FLAGS_TPPRUNE_PRESERVE_POS |
+                                   Rainflow::RFC_FLAGS_TPPRUNE_PRESERVE_RES |
+                                   Rainflow::RFC_FLAGS_COUNT_TAL;
     int         auto_resize     =  0;  // false
     int         spread_damage   =  Rainflow::RFC_SD_TRANSIENT_23c;
     PyObject   *wl              =  nullptr;
+    PyObject   *Py_outputs      =  nullptr;
     double      wl_sd           =  1e3, wl_nd = 1e7,
                 wl_k            =  5,   wl_k2 = 5;
 
     *res_method = Rainflow::RFC_RES_REPEATED;
+    *outputs    = RFC_OUTPUT_ALL;
 
     const char* kw[] = {"class_width", "class_count", "class_offset",
                         "hysteresis","residual_method", "enforce_margin", "auto_resize",
-                        "use_HCM", "use_ASTM", "spread_damage", "lc_method", "wl", nullptr};
+                        "use_HCM", "use_ASTM", "spread_damage", "lc_method", "wl", "outputs", nullptr};
 
-    if( !PyArg_ParseTupleAndKeywords( empty, kwargs, "d|iddi$ppppiiO", (char**)kw,
+    if( !PyArg_ParseTupleAndKeywords( empty, kwargs, "d|iddi$ppppiiOO", (char**)kw,
                                       &class_width,     // d
                                       &class_count,     // i
                                       &class_offset,    // d
@@ -237,7 +332,8 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
                                       &use_astm,        // p
                                       &spread_damage,   // i
                                       &lc_method,       // i
-                                      &wl ) )           // O
+                                      &wl,              // O
+                                      &Py_outputs ) )   // O
     {
         Py_DECREF( empty );
         return 0;
@@ -266,6 +362,22 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
         }
     }
 
+    // Results wanted, unused countings are neither allocated nor processed
+    if( Py_outputs && Py_outputs != Py_None )
+    {
+        if( !get_outputs( Py_outputs, "outputs", *outputs ) ) return 0;
+
+        flags &= ~( Rainflow::RFC_FLAGS_COUNT_ALL | Rainflow::RFC_FLAGS_COUNT_TAL );
+
+        // Damage is also assigned to turning points and spread over damage history
+        if( *outputs & ( RFC_OUTPUT_DAMAGE | RFC_OUTPUT_TP | RFC_OUTPUT_DH ) ) flags |= Rainflow::RFC_FLAGS_COUNT_DAMAGE | Rainflow::RFC_FLAGS_COUNT_MK;
+        if( *outputs & RFC_OUTPUT_RFM ) flags |= Rainflow::RFC_FLAGS_COUNT_RFM;
+        if( *outputs & RFC_OUTPUT_RP  ) flags |= Rainflow::RFC_FLAGS_COUNT_RP;
+        if( *outputs & RFC_OUTPUT_LC  ) flags |= Rainflow::RFC_FLAGS_COUNT_LC;
+        if( *outputs & RFC_OUTPUT_TAL ) flags |= Rainflow::RFC_FLAGS_COUNT_TAL;
+        if( *outputs & ( RFC_OUTPUT_TP | RFC_OUTPUT_DH ) ) flags |= Rainflow::RFC_FLAGS_COUNT_DH;
+    }
+
     if( hysteresis < 0 ) hysteresis = class_width;
 
     if( !rf->init( class_count, class_width, class_offset, hysteresis, (Rainflow::rfc_flags_e)flags ) )
@@ -299,6 +411,11 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
                 return 0;
         }
 
+        if( !( *outputs & RFC_OUTPUT_LC ) )
+        {
+            flags &= ~Rainflow::RFC_FLAGS_COUNT_LC;
+        }
+
         switch( auto_resize )
         {
             case 0:
@@ -344,7 +461,8 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
         return 0;
     }
 
-    if( spread_damage > (int)Rainflow::RFC_SD_NONE )
+    // Damage of turning points is spread via damage history
+    if( spread_damage > (int)Rainflow::RFC_SD_NONE && ( *outputs & ( RFC_OUTPUT_TP | RFC_OUTPUT_DH ) ) )
     {
         if( !rf->dh_init( (Rainflow::rfc_sd_method_e) spread_damage, nullptr, (size_t)len, /*is_static*/ false ) )
         {
@@ -369,6 +487,14 @@ int parse_rfc_kwargs( PyObject* kwargs, Py_ssize_t len, Rainflow *rf, Rainflow::
         rf->ctx_get().counting_method = RF::RFC_COUNTING_METHOD_HCM;
     }
 
+    if( !( *outputs & ( RFC_OUTPUT_TP | RFC_OUTPUT_DH ) ) )
+    {
+        // No turning points storage
+        rf->ctx_get().tp_set_fcn        = nullptr;
+        rf->ctx_get().tp_get_fcn        = nullptr;
+        rf->ctx_get().tp_inc_damage_fcn = nullptr;
+    }
+
     if( use_astm )
     {
         rf->ctx_get().counting_method = RF::RFC_COUNTING_METHOD_ASTM;
@@ -434,10 +560,11 @@ fail:
 
 // Prepare results
 static
-int prepare_results( Rainflow *rf, Py_ssize_t data_len, Rainflow::rfc_res_method res_method, rfc_residuum_vec &residuum_raw, PyObject **ret )
+int prepare_results( Rainflow *rf, Py_ssize_t data_len, Rainflow::rfc_res_method res_method, int outputs, rfc_residuum_vec &residuum_raw, PyObject **ret )
 {
     const Rainflow::rfc_value_tuple_s *p_residue;
     Rainflow::rfc_counts_v ct;
+    Rainflow::rfc_size_v tal;
     Rainflow::rfc_value_v sa;
     Rainflow::rfc_tp_storage tp;
     Rainflow::rfc_rfm_item_v rfm;
@@ -452,124 +579,162 @@ int prepare_results( Rainflow *rf, Py_ssize_t data_len, Rainflow::rfc_res_method
 
     *ret = nullptr;
 
-    // Retrieve range pair counts
     if( !rf->class_count( &u ) ) goto fail;
     class_count = u;
-    if( !rf->rp_get( ct, sa ) )
-    {
-        goto fail_rfc;
-    }
 
     // Create dict (return value)
     *ret = PyDict_New();
     if( *ret == nullptr ) goto fail_cont;
 
     // Insert damage value
-    if( !rf->damage( &damage ) ) goto fail_rfc;
-    PyDict_SetItemString( *ret, "damage", PyFloat_FromDouble( damage ) );
+    if( outputs & RFC_OUTPUT_DAMAGE )
+    {
+        if( !rf->damage( &damage ) ) goto fail_rfc;
+        PyDict_SetItemString( *ret, "damage", PyFloat_FromDouble( damage ) );
+    }
 
     // Insert range pair counts
-    len[0] = class_count;
-    len[1] = 2;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( unsigned i = 0; i < class_count; i++ )
-    {
-        *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)sa[i] * 2;  // range = 2 * amplitude
-        *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)ct[i];
+    if( outputs & RFC_OUTPUT_RP )
+    {
+        if( !rf->rp_get( ct, sa ) ) goto fail_rfc;
+        len[0] = class_count;
+        len[1] = 2;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( unsigned i = 0; i < class_count; i++ )
+        {
+            *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)sa[i] * 2;  // range = 2 * amplitude
+            *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)ct[i];
+        }
+        PyDict_SetItemString( *ret, "rp", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "rp", (PyObject*)arr );
-    Py_DECREF( arr );
 
     // Insert level crossings
-    if( !rf->lc_get( ct, sa ) ) goto fail_rfc;
-    len[0] = class_count;
-    len[1] = 2;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( unsigned i = 0; i < class_count; i++ )
+    if( outputs & RFC_OUTPUT_LC )
+    {
+        if( !rf->lc_get( ct, sa ) ) goto fail_rfc;
+        len[0] = class_count;
+        len[1] = 2;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( unsigned i = 0; i < class_count; i++ )
+        {
+            *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)sa[i];  // class upper limit
+            *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)ct[i];
+        }
+        PyDict_SetItemString( *ret, "lc", (PyObject*)arr );
+        Py_DECREF( arr );
+    }
+
+    // Insert time at level
+    if( outputs & RFC_OUTPUT_TAL )
     {
-        *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)sa[i];  // class upper limit
-        *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)ct[i];
+        if( !rf->tal_get( tal, sa ) ) goto fail_rfc;
+        len[0] = class_count;
+        len[1] = 2;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( unsigned i = 0; i < class_count; i++ )
+        {
+            *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)sa[i];  // class mean
+            *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)tal[i];  // number of samples
+        }
+        PyDict_SetItemString( *ret, "tal", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "lc", (PyObject*)arr );
-    Py_DECREF( arr );
 
     // Insert turning points
-    len[0] = rf->tp_storage().size();
-    len[1] = 3;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( size_t i = 0; i < rf->tp_storage().size(); i++ )
-    {
-        *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)rf->tp_storage()[i].pos;
-        *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)rf->tp_storage()[i].value;
-        *(double*)PyArray_GETPTR2( arr, i, 2 ) = (double)rf->tp_storage()[i].damage;
+    if( outputs & RFC_OUTPUT_TP )
+    {
+        len[0] = rf->tp_storage().size();
+        len[1] = 3;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( size_t i = 0; i < rf->tp_storage().size(); i++ )
+        {
+            *(double*)PyArray_GETPTR2( arr, i, 0 ) = (double)rf->tp_storage()[i].pos;
+            *(double*)PyArray_GETPTR2( arr, i, 1 ) = (double)rf->tp_storage()[i].value;
+            *(double*)PyArray_GETPTR2( arr, i, 2 ) = (double)rf->tp_storage()[i].damage;
+        }
+        PyDict_SetItemString( *ret, "tp", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "tp", (PyObject*)arr );
-    Py_DECREF( arr );
 
     // Insert residue_raw
-    u = (unsigned int)residuum_raw.size();
-    len[0] = u;
-    len[1] = 0;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( unsigned i = 0; i < u; i++ )
-    {
-        *(double*)PyArray_GETPTR1( arr, i ) = (double)residuum_raw[i].value;
+    if( outputs & RFC_OUTPUT_RES_RAW )
+    {
+        u = (unsigned int)residuum_raw.size();
+        len[0] = u;
+        len[1] = 0;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( unsigned i = 0; i < u; i++ )
+        {
+            *(double*)PyArray_GETPTR1( arr, i ) = (double)residuum_raw[i].value;
+        }
+        PyDict_SetItemString( *ret, "res_raw", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "res_raw", (PyObject*)arr );
-    Py_DECREF( arr );
 
     // Insert residue
-    if( !rf->res_get( &p_residue, &u ) ) goto fail;
-    len[0] = u;
-    len[1] = 0;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( unsigned i = 0; i < u; i++ )
-    {
-        *(double*)PyArray_GETPTR1( arr, i ) = (double)p_residue[i].value;
+    if( outputs & RFC_OUTPUT_RES )
+    {
+        if( !rf->res_get( &p_residue, &u ) ) goto fail;
+        len[0] = u;
+        len[1] = 0;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( unsigned i = 0; i < u; i++ )
+        {
+            *(double*)PyArray_GETPTR1( arr, i ) = (double)p_residue[i].value;
+        }
+        PyDict_SetItemString( *ret, "res", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "res", (PyObject*)arr );
-    Py_DECREF( arr );
 
     // Insert rainflow matrix
-    if( !rf->rfm_get( rfm ) ) goto fail_rfc;
-    len[0] = class_count;
-    len[1] = class_count;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( size_t k = 0; k < rfm.size(); k++ )
-    {
-        unsigned i, j;
-        i = rfm[k].from;
-        j = rfm[k].to;
-        *(double*)PyArray_GETPTR2( arr, i, j ) += (double)rfm[k].counts / RFC_FULL_CYCLE_INCREMENT;
-    }
-    PyDict_SetItemString( *ret, "rfm", (PyObject*)arr );
-    Py_DECREF( arr );
+    if( outputs & RFC_OUTPUT_RFM )
+    {
+        if( !rf->rfm_get( rfm ) ) goto fail_rfc;
+        len[0] = class_count;
+        len[1] = class_count;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 2, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( size_t k = 0; k < rfm.size(); k++ )
+        {
+            unsigned i, j;
+            i = rfm[k].from;
+            j = rfm[k].to;
+            *(double*)PyArray_GETPTR2( arr, i, j ) += (double)rfm[k].counts / RFC_FULL_CYCLE_INCREMENT;
+        }
+        PyDict_SetItemString( *ret, "rfm", (PyObject*)arr );
+        Py_DECREF( arr );
+    }
 
     // Insert damage history
-    if( !rf->dh_get( &dh, &dh_cnt ) ) goto fail_rfc;
-    len[0] = data_len;
-    len[1] = 0;
-    arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
-    if( !arr ) goto fail_cont;
-    PyArray_FILLWBYTE( arr, 0 );
-    for( size_t i = 0; i < dh_cnt; i++ )
-    {
-        *(double*)PyArray_GETPTR1( arr, i ) = dh[i];
+    if( outputs & RFC_OUTPUT_DH )
+    {
+        if( !rf->dh_get( &dh, &dh_cnt ) ) goto fail_rfc;
+        len[0] = data_len;
+        len[1] = 0;
+        arr = (PyArrayObject*)PyArray_SimpleNew( 1, len, NPY_DOUBLE );
+        if( !arr ) goto fail_cont;
+        PyArray_FILLWBYTE( arr, 0 );
+        for( size_t i = 0; i < dh_cnt; i++ )
+        {
+            *(double*)PyArray_GETPTR1( arr, i ) = dh[i];
+        }
+        PyDict_SetItemString( *ret, "dh", (PyObject*)arr );
+        Py_DECREF( arr );
     }
-    PyDict_SetItemString( *ret, "dh", (PyObject*)arr );
-    Py_DECREF( arr );
 
     return 1;
 
@@ -595,6 +760,7 @@ PyObject* rfc( PyObject *self, PyObject *args, PyObject *kwargs )
     Rainflow::rfc_res_method res_method;
     rfc_residuum_vec residuum_raw;
     Py_ssize_t len;
+    int outputs;
     bool ok = false;
 
     if( !PyArg_ParseTuple( args, "O", &arg1 ) )
@@ -609,7 +775,7 @@ PyObject* rfc( PyObject *self, PyObject *args, PyObject *kwargs )
             break;
         }
 
-        if( !parse_rfc_kwargs( kwargs, len, &rf, &res_method ) )
+        if( !parse_rfc_kwargs( kwargs, len, &rf, &res_method, &outputs ) )
         {
             break;
         }
@@ -619,7 +785,7 @@ PyObject* rfc( PyObject *self, PyObject *args, PyObject *kwargs )
             break;
         }
 
-        if( !prepare_results( &rf, len, res_method, residuum_raw, &ret ) )
+        if( !prepare_results( &rf, len, res_method, outputs, residuum_raw, &ret ) )
         {
             break;
         }
@@ -166,6 +166,8 @@ class TestRainflowCounting(unittest.TestCase):
         self.assertEqual(res["rfm"][3 - 1, 2 - 1], 1)
         # Assert that the residuals match the expected values
         self.assertTrue((res["res"].flatten() == [1, 4]).all())
+        # Assert that each sample is counted once in time at level
+        self.assertEqual(res["tal"][:, 1].sum(), len(x))
 
     def test_one_cycle_down(self):
         """
@@ -374,6 +376,61 @@ class TestRainflowCounting(unittest.TestCase):
         ])
         self.assertTrue(test.sum() < 1e-3)
 
+    def test_outputs(self):
+        """
+        Test the selection of results by argument `outputs`.
+
+        This test verifies that only the requested results are returned and that
+        they match the results of a full counting.
+
+        Parameters
+        ----------
+        None
+
+        Returns
+        -------
+        None
+
+        Raises
+        ------
+        AssertionError
+            If the returned keys or values differ from the expected ones.
+        ValueError
+            If an unknown output is requested.
+        """
+        class_count = 100  # Number of classes
+        x = 10 * np.sin(np.arange(5000) * 0.05) + 3 * np.sin(np.arange(5000) * 0.7)
+
+        # Calculate class parameters
+        class_width, class_offset = self.class_param(x, class_count)
+
+        kwargs = dict(
+            class_count=class_count,
+            class_width=class_width,
+            class_offset=class_offset,
+            hysteresis=class_width,
+            residual_method=ResidualMethod.REPEATED,
+            enforce_margin=True,
+            spread_damage=SDMethod.TRANSIENT_23c
+        )
+
+        # Perform rainflow counting with all and with selected outputs
+        res_all = rfc(x, **kwargs)
+        res = rfc(x, outputs={"damage", "rfm"}, **kwargs)
+
+        self.assertEqual(set(res.keys()), {"damage", "rfm"})
+        self.assertEqual(res["damage"], res_all["damage"])
+        self.assertTrue((res["rfm"] == res_all["rfm"]).all())
+
+        res = rfc(x, outputs=["lc", "tp"], **kwargs)
+
+        self.assertEqual(set(res.keys()), {"lc", "tp"})
+        self.assertTrue((res["lc"] == res_all["lc"]).all())
+        self.assertTrue((res["tp"] == res_all["tp"]).all())
+
+        with self.assertRaises(ValueError):
+            rfc(x, outputs=["foo"], **kwargs)
+
 
 def run():
     unittest.main()
@@ -0,0 +1,10 @@
+/* Using the single header amalgamation for declarations only (rfc_inline_test.c holds the implementation) */
+
+#include "rainflow_inline.h"
+
+
+/* Feed through the external API, resolved by the implementation unit */
+bool rfc_inline_decl_feed( void *ctx, const rfc_value_t *data, size_t data_count )
+{
+    return RFC_feed( ctx, data, data_count );
+}
@@ -0,0 +1,98 @@
+/* Using the single header amalgamation (rainflow_inline.h) with its inlinable feed entry points */
+
+#define RFC_IMPLEMENTATION
+#include "rainflow_inline.h"
+#include "greatest.h"
+
+#include <math.h>
+#include <string.h>
+
+
+bool rfc_inline_decl_feed( void *ctx, const rfc_value_t *data, size_t data_count );  /* rfc_inline_decl.c */
+
+
+TEST RFC_inline_feed_test( void )
+{
+    unsigned            class_count     = 50;
+    double              class_width     = 0.2;
+    double              class_offset    = -5.0;
+    static rfc_value_t  data[10000];
+    rfc_ctx_s           ref             = { sizeof(ref) };
+    rfc_ctx_s           ctx_block       = { sizeof(ctx_block) };
+    rfc_ctx_s           ctx_sample      = { sizeof(ctx_sample) };
+#if RFC_MINIMAL
+    rfc_res_method_e    residual_method = RFC_RES_IGNORE;
+#else /*!RFC_MINIMAL*/
+    rfc_res_method_e    residual_method = RFC_RES_REPEATED;
+#endif /*RFC_MINIMAL*/
+    size_t              i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 3.0 * sin( 0.011 * i ) + 1.2 * sin( 0.17 * i ) + 0.4 * sin( 1.9 * i );
+    }
+
+    ASSERT( RFC_init( &ref,        class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_init( &ctx_block,  class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_init( &ctx_sample, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_wl_init_elementary( &ref,        /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+    ASSERT( RFC_wl_init_elementary( &ctx_block,  /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+    ASSERT( RFC_wl_init_elementary( &ctx_sample, /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+
+    /* Reference through the external API, in a unit of its own */
+    ASSERT( rfc_inline_decl_feed( &ref, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ref, residual_method ) );
+
+    /* Inline entry points, consecutive calls */
+    ASSERT( RFC_feed_block_inline( &ctx_block, data, NUMEL(data) / 3, ctx_block.internal.flags ) );
+    ASSERT( RFC_feed_block_inline( &ctx_block, data + NUMEL(data) / 3, NUMEL(data) - NUMEL(data) / 3, ctx_block.internal.flags ) );
+    ASSERT( RFC_finalize( &ctx_block, residual_method ) );
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        ASSERT( RFC_feed_sample_inline( &ctx_sample, data[i], ctx_sample.internal.flags ) );
+    }
+    ASSERT( RFC_finalize( &ctx_sample, residual_method ) );
+
+    ASSERT( ref.damage > 0.0 );
+    ASSERT_EQ( ctx_block.damage,  ref.damage );
+    ASSERT_EQ( ctx_sample.damage, ref.damage );
+    ASSERT_MEM_EQ( ctx_block.rfm,  ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( ctx_sample.rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+#if !RFC_MINIMAL
+    ASSERT_MEM_EQ( ctx_block.lc,   ref.lc,  sizeof(rfc_counts_t) * class_count );
+    ASSERT_MEM_EQ( ctx_sample.lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+#endif /*!RFC_MINIMAL*/
+
+    /* Finalized */
+    ASSERT( !RFC_feed_sample_inline( &ctx_sample, 0.0, ctx_sample.internal.flags ) );
+
+    ASSERT( RFC_deinit( &ref ) );
+    ASSERT( RFC_deinit( &ctx_block ) );
+    ASSERT( RFC_deinit( &ctx_sample ) );
+
+    /* Flags must equal the context flags */
+    ASSERT( RFC_init( &ctx_sample, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( !RFC_feed_sample_inline( &ctx_sample, 0.0, ctx_sample.internal.flags ^ RFC_FLAGS_COUNT_RFM ) );
+    ASSERT_EQ( ctx_sample.error, RFC_ERROR_INVARG );
+    ASSERT( RFC_deinit( &ctx_sample ) );
+
+    PASS();
+}
+
+
+SUITE( RFC_INLINE_SUITE )
+{
+    RUN_TEST( RFC_inline_feed_test );
+}
+
+
+/* Add definitions that need to be in the test runner's main file. */
+GREATEST_MAIN_DEFS();
+
+int main( int argc, char *argv[] )
+{
+    GREATEST_MAIN_BEGIN();      /* init & parse command-line args */
+    RUN_SUITE( RFC_INLINE_SUITE );
+    GREATEST_MAIN_END();        /* display results */
+}
@@ -57,6 +57,14 @@
 #include <float.h>
 #include <stddef.h>  /* offsetof */
 #include "long_series.h"
+#if RFC_SHM_SUPPORT
+#include <sys/types.h>  /* pid_t */
+#include <sys/wait.h>   /* waitpid() */
+#include <unistd.h>     /* fork(), _exit(), getpid() */
+#endif /*RFC_SHM_SUPPORT*/
+#if RFC_TEST_PTHREADS
+#include <pthread.h>
+#endif /*RFC_TEST_PTHREADS*/
 
 
 #define ROUND(x)    ((x)>=0?(long)((x)+0.5):(long)((x)-0.5))
@@ -2320,6 +2328,2248 @@ TEST RFC_miner_consequent2( void )
 #endif /*!RFC_MINIMAL*/
 
 
+#if !RFC_MINIMAL
+TEST RFC_cp_test( void )
+{
+    /* Two channels, four candidate planes */
+    double          coeffs[4][2]    = { { 1.0, 0.0 }, { 0.0, 1.0 }, { 0.7, 0.7 }, { 0.7, -0.7 } };
+    double          damage[4];
+    double          D_ref, D_max    = -1.0;
+    unsigned        critical_plane  = (unsigned)-1;
+    unsigned        critical_ref    = (unsigned)-1;
+    unsigned        class_count     = 100;
+    double          class_width     = 0.1;
+    double          class_offset    = -5.0;
+    double          hysteresis      = class_width;
+    rfc_value_t     data[1000][2];
+    rfc_value_t     proj[1000];
+    rfc_ctx_s       ref             = { sizeof(ref) };
+    size_t          i;
+    unsigned        p;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i][0] = 3.0 * sin( 0.3 * i ) + sin( 1.7 * i );
+        data[i][1] = 2.0 * cos( 0.45 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_wl_init_elementary( &ctx, /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+    ASSERT( RFC_cp_damage( &ctx, &data[0][0], NUMEL(data), /*comp_count*/ 2, &coeffs[0][0], /*plane_count*/ 4, 
+                           RFC_RES_HALFCYCLES, damage, &critical_plane ) );
+    ASSERT_EQ( ctx.state, RFC_STATE_INIT );
+
+    /* Compare to counting each projection separately */
+    for( p = 0; p < NUMEL(coeffs); p++ )
+    {
+        for( i = 0; i < NUMEL(data); i++ )
+        {
+            proj[i] = coeffs[p][0] * data[i][0] + coeffs[p][1] * data[i][1];
+        }
+
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_COUNT_DAMAGE ) );
+        ASSERT( RFC_wl_init_elementary( &ref, /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+        ASSERT( RFC_feed( &ref, proj, NUMEL(proj) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_HALFCYCLES ) );
+        ASSERT( RFC_damage( &ref, &D_ref, NULL ) );
+        ASSERT( RFC_deinit( &ref ) );
+
+        ASSERT( D_ref > 0.0 );
+        ASSERT_IN_RANGE( D_ref, damage[p], D_ref * 1e-10 );
+
+        if( D_ref > D_max )
+        {
+            D_max        = D_ref;
+            critical_ref = p;
+        }
+    }
+
+    ASSERT_EQ( critical_plane, critical_ref );
+
+    /* Data out of class range */
+    coeffs[0][0] = 10.0;
+    ASSERT( !RFC_cp_damage( &ctx, &data[0][0], NUMEL(data), 2, &coeffs[0][0], 4, RFC_RES_HALFCYCLES, damage, NULL ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_DATA_OUT_OF_RANGE );
+
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_spectral_test( void )
+{
+    /* Gaussian-like process as sum of harmonics with pseudo random phases */
+    const double    two_pi          = 6.28318530717958647692;
+    const double    fs              = 100.0;
+    const unsigned  nfft            = 1024;
+    const size_t    data_len        = 200000;
+    double          psd[1024/2+1];
+    rfc_counts_t    rp[100];
+    rfc_value_t     Sa[100];
+    rfc_value_t    *data;
+    double          D_rfc, D_nb, D_dk, D_tb;
+    double          var             = 0.0;
+    double          m0              = 0.0;
+    double          rp_sum          = 0.0;
+    unsigned long   seed            = 1;
+    unsigned        class_count     = 100;
+    double          class_width;
+    double          class_offset;
+    size_t          i, j;
+
+    data = (rfc_value_t*)calloc( data_len, sizeof(rfc_value_t) );
+    ASSERT( data );
+
+    for( j = 0; j < 40; j++ )
+    {
+        double f     = 1.0 + 0.25 * j;
+        double phase;
+
+        seed  = seed * 1103515245UL + 12345UL;
+        phase = two_pi * ( ( seed >> 16 ) & 0x7fff ) / 32768.0;
+
+        for( i = 0; i < data_len; i++ )
+        {
+            data[i] += sin( two_pi * f * i / fs + phase );
+        }
+    }
+
+    for( i = 0; i < data_len; i++ )
+    {
+        var += data[i] * data[i];
+    }
+    var /= data_len;
+
+    class_width  = 12.0 * sqrt( var ) / class_count;
+    class_offset = -6.0 * sqrt( var );
+
+    /* Time domain reference */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_wl_init_elementary( &ctx, /*sx*/ sqrt( var ), /*nx*/ 1e3, /*k*/ -5 ) );
+    ASSERT( RFC_feed( &ctx, data, data_len ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_HALFCYCLES ) );
+    ASSERT( RFC_damage( &ctx, &D_rfc, NULL ) );
+
+    /* PSD preserves the variance */
+    ASSERT( RFC_spectral_psd( &ctx, data, data_len, fs, nfft, psd ) );
+    for( i = 0; i < NUMEL(psd); i++ )
+    {
+        m0 += psd[i] * fs / nfft;
+    }
+    ASSERT_IN_RANGE( var, m0, var * 0.02 );
+
+    /* Spectral estimators */
+    ASSERT( RFC_spectral_damage( &ctx, psd, NUMEL(psd), fs / nfft, data_len / fs, RFC_SPECTRAL_NARROW_BAND, &D_nb, NULL, NULL ) );
+    ASSERT( RFC_spectral_damage( &ctx, psd, NUMEL(psd), fs / nfft, data_len / fs, RFC_SPECTRAL_DIRLIK, &D_dk, rp, Sa ) );
+    ASSERT( RFC_spectral_damage( &ctx, psd, NUMEL(psd), fs / nfft, data_len / fs, RFC_SPECTRAL_TOVO_BENASCIUTTI, &D_tb, NULL, NULL ) );
+
+    fprintf( stdout, "\nDamage rfc: %g, narrow band: %g, Dirlik: %g, Tovo-Benasciutti: %g", D_rfc, D_nb, D_dk, D_tb );
+
+    /* Narrow band approximation is conservative */
+    ASSERT( D_nb > D_rfc );
+    ASSERT_IN_RANGE( D_rfc, D_dk, D_rfc * 0.2 );
+    ASSERT_IN_RANGE( D_rfc, D_tb, D_rfc * 0.2 );
+
+    /* Damage from estimated range pair histogram matches */
+    for( i = 0; i < class_count; i++ )
+    {
+        ASSERT_IN_RANGE( class_width * i / 2, Sa[i], 1e-10 );
+        rp_sum += (double)rp[i] / ctx.full_inc;
+    }
+    ASSERT( rp_sum > 0.0 );
+    ASSERT( RFC_damage_from_rp( &ctx, &D_rfc, rp, Sa, RFC_RP_DAMAGE_CALC_METHOD_DEFAULT ) );
+    ASSERT_IN_RANGE( D_dk, D_rfc, D_dk * 0.2 );
+
+    ASSERT( RFC_deinit( &ctx ) );
+    free( data );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_rmm_test( int autoresize )
+{
+    unsigned        class_count     = autoresize ? 20 : 100;
+    double          class_width     = 0.13;
+    double          class_offset    = autoresize ? -1.3 : -6.5;
+    int             flags           = RFC_FLAGS_COUNT_RFM | RFC_FLAGS_COUNT_DAMAGE | RFC_FLAGS_COUNT_RMM;
+    rfc_value_t     data[2000];
+    rfc_counts_t   *rmm;
+    rfc_rmm_item_s *items           = NULL;
+    unsigned        items_count     = 0;
+    unsigned        non_zeros;
+    rfc_counts_t    counts, sum_rfm = 0, sum_rmm = 0;
+    double          D_rfm, D_rmm;
+    size_t          i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 3.0 * sin( 0.3 * i ) + sin( 1.7 * i ) + 2.0 * cos( 0.45 * i );
+    }
+
+#if RFC_AR_SUPPORT
+    if( autoresize )
+    {
+        flags |= RFC_FLAGS_AUTORESIZE;
+    }
+#endif /*RFC_AR_SUPPORT*/
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, (rfc_flags_e)flags ) );
+    ASSERT( ctx.rmm );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_HALFCYCLES ) );
+    class_count = ctx.class_count;
+    ASSERT( !autoresize || class_count > 20 );
+
+    /* Direct accumulation equals conversion from rainflow matrix */
+    rmm = (rfc_counts_t*)calloc( class_count * ( class_count + 1 ) / 2, sizeof(rfc_counts_t) );
+    ASSERT( rmm );
+    ASSERT( RFC_rmm_from_rfm( &ctx, rmm, NULL ) );
+    ASSERT_MEM_EQ( rmm, ctx.rmm, sizeof(rfc_counts_t) * class_count * ( class_count + 1 ) / 2 );
+    free( rmm );
+
+    ASSERT( RFC_damage_from_rfm( &ctx, &D_rfm, NULL ) );
+    ASSERT( RFC_rmm_damage( &ctx, &D_rmm, NULL ) );
+    ASSERT( D_rfm > 0.0 );
+    ASSERT_IN_RANGE( D_rfm, D_rmm, D_rfm * 1e-10 );
+
+    /* Sparse access */
+    ASSERT( RFC_rmm_non_zeros( &ctx, &non_zeros ) );
+    ASSERT( RFC_rmm_get( &ctx, &items, &items_count ) );
+    ASSERT_EQ( non_zeros, items_count );
+
+    for( i = 0; i < class_count * class_count; i++ )
+    {
+        sum_rfm += ctx.rfm[i];
+    }
+    for( i = 0; i < items_count; i++ )
+    {
+        rfc_value_t range = class_width * items[i].range;
+        rfc_value_t mean  = ctx.class_offset + class_width * ( items[i].mean + 1 ) / 2;
+
+        ASSERT( RFC_rmm_peek( &ctx, range, mean, &counts ) );
+        ASSERT_EQ( counts, items[i].counts );
+        sum_rmm += counts;
+    }
+    ASSERT_EQ( sum_rfm, sum_rmm );
+    free( items );
+
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_rmd_test( int autoresize )
+{
+    const double    two_pi          = 6.28318530717958647692;
+    unsigned        class_count     = autoresize ? 20 : 100;
+    double          class_width     = 0.2;
+    double          class_offset    = autoresize ? -2.0 : -10.0;
+    int             flags           = RFC_FLAGS_COUNT_RMM | RFC_FLAGS_COUNT_RMD;
+    rfc_value_t     data[4000];
+    rfc_counts_t   *rmm;
+    rfc_rmd_item_s *items           = NULL;
+    unsigned        items_count     = 0;
+    double          dur_lower, dur_upper;
+    size_t          i;
+
+    /* Slow cycles (period 200 samples) superimposed by small fast cycles (period 10 samples) */
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 4.0 * sin( two_pi * i / 200 ) + 0.8 * sin( two_pi * i / 10 );
+    }
+
+#if RFC_AR_SUPPORT
+    if( autoresize )
+    {
+        flags |= RFC_FLAGS_AUTORESIZE;
+    }
+#endif /*RFC_AR_SUPPORT*/
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, (rfc_flags_e)flags ) );
+    ASSERT( ctx.rmd );
+    ASSERT( RFC_rmd_init( &ctx, 2.0, 2.0, 16 ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    class_count = ctx.class_count;
+    ASSERT( !autoresize || class_count > 20 );
+
+    ASSERT( RFC_rmd_get( &ctx, &items, &items_count ) );
+    ASSERT( items_count > 0 );
+
+    /* Summing up over duration yields the range-mean matrix */
+    rmm = (rfc_counts_t*)calloc( class_count * ( class_count + 1 ) / 2, sizeof(rfc_counts_t) );
+    ASSERT( rmm );
+    for( i = 0; i < items_count; i++ )
+    {
+        unsigned range = items[i].range;
+        unsigned mean  = items[i].mean;
+
+        ASSERT( i == 0 || items[i-1].range < range || ( items[i-1].range == range && items[i-1].mean <= mean ) );
+        ASSERT( items[i].duration < 16 );
+        rmm[ range * class_count - range * ( range - 1 ) / 2 + ( mean - range ) / 2 ] += items[i].counts;
+
+        /* Durations match the generating periods */
+        ASSERT( RFC_rmd_duration( &ctx, items[i].duration, &dur_lower, &dur_upper ) );
+        if( range * class_width > 6.0 )
+        {
+            ASSERT( dur_lower <= 200.0 && dur_upper > 200.0 );
+        }
+        else
+        {
+            ASSERT( dur_upper <= 32.0 );
+        }
+    }
+    ASSERT_MEM_EQ( rmm, ctx.rmm, sizeof(rfc_counts_t) * class_count * ( class_count + 1 ) / 2 );
+    free( rmm );
+    free( items );
+
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_rfm_pyramid_test( void )
+{
+    unsigned            class_count     = 64;
+    double              class_width     = 0.1;
+    double              class_offset    = -3.2;
+    double              hysteresis      = class_width;
+    rfc_value_t         data[3000];
+    rfc_ctx_s           ctx2            = { sizeof(ctx2) };
+    rfc_class_param_s   class_param;
+    const rfc_counts_t *rfm_level, *rfm_cached;
+    rfc_counts_t       *rfm;
+    rfc_rfm_item_s     *items           = NULL;
+    unsigned            items_count     = 0;
+    unsigned            level, from, to, n;
+    rfc_counts_t        sum_level, sum_items;
+    size_t              i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 1.5 * sin( 0.21 * i ) + sin( 1.3 * i ) + 0.4 * cos( 2.9 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_COUNT_RFM ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) / 2 ) );
+
+    rfm = (rfc_counts_t*)calloc( class_count * class_count, sizeof(rfc_counts_t) );
+    ASSERT( rfm );
+
+    for( level = 1; level <= 3; level++ )
+    {
+        ASSERT( RFC_rfm_level( &ctx, level, &rfm_level, &class_param ) );
+        n = class_count >> level;
+        ASSERT_EQ( class_param.count, n );
+        ASSERT_IN_RANGE( class_param.width, class_width * ( 1 << level ), 1e-12 );
+
+        /* Direct aggregation of the finest grid */
+        memset( rfm, 0, sizeof(rfc_counts_t) * class_count * class_count );
+        for( from = 0; from < class_count; from++ )
+        {
+            for( to = 0; to < class_count; to++ )
+            {
+                if( from >> level != to >> level )
+                {
+                    rfm[ ( from >> level ) * n + ( to >> level ) ] += ctx.rfm[ from * class_count + to ];
+                }
+            }
+        }
+        ASSERT_MEM_EQ( rfm, rfm_level, sizeof(rfc_counts_t) * n * n );
+    }
+
+    /* Levels are cached until counts change */
+    ASSERT( RFC_rfm_level( &ctx, 2, &rfm_cached, NULL ) );
+    ASSERT( RFC_rfm_level( &ctx, 2, &rfm_level, NULL ) );
+    ASSERT( rfm_cached == rfm_level );
+    ASSERT_EQ( ctx.rfm_pyr_levels, 3 );
+    ASSERT( RFC_feed( &ctx, data + NUMEL(data) / 2, NUMEL(data) - NUMEL(data) / 2 ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    ASSERT( RFC_rfm_level( &ctx, 2, &rfm_level, &class_param ) );
+    ASSERT_EQ( ctx.rfm_pyr_levels, 2 );
+
+    /* Sparse access */
+    ASSERT( RFC_rfm_get_level( &ctx, 2, &items, &items_count ) );
+    sum_level = sum_items = 0;
+    for( i = 0; i < class_param.count * class_param.count; i++ )
+    {
+        sum_level += rfm_level[i];
+    }
+    for( i = 0; i < items_count; i++ )
+    {
+        ASSERT( items[i].from != items[i].to );
+        ASSERT_EQ( items[i].counts, rfm_level[ items[i].from * class_param.count + items[i].to ] );
+        sum_items += items[i].counts;
+    }
+    ASSERT_EQ( sum_level, sum_items );
+    free( items );
+
+    /* Aligned grid is resampled from pyramid */
+    ASSERT( RFC_rfm_resample( &ctx, &class_param, rfm ) );
+    ASSERT_MEM_EQ( rfm, rfm_level, sizeof(rfc_counts_t) * class_param.count * class_param.count );
+
+    /* Non-aligned grid falls back to redistribution, as refeed does */
+    class_param.count  = class_count;
+    class_param.width  = class_width * 3;
+    class_param.offset = class_offset - class_width;
+    ASSERT( RFC_rfm_resample( &ctx, &class_param, rfm ) );
+
+    ASSERT( RFC_init( &ctx2, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_COUNT_RFM ) );
+    ASSERT( RFC_feed( &ctx2, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx2, RFC_RES_IGNORE ) );
+    ASSERT( RFC_rfm_refeed( &ctx2, hysteresis, &class_param ) );
+    ASSERT_MEM_EQ( rfm, ctx2.rfm, sizeof(rfc_counts_t) * class_param.count * class_param.count );
+    ASSERT( RFC_deinit( &ctx2 ) );
+
+    /* Aligned grid has to cover the level */
+    class_param.count  = ( class_count >> 2 ) - 1;
+    class_param.width  = class_width * 4;
+    class_param.offset = class_offset;
+    ASSERT( !RFC_rfm_resample( &ctx, &class_param, rfm ) );
+
+    free( rfm );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_cycles_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    double                  hysteresis      = class_width;
+    rfc_value_t             data[5000];
+    rfc_ctx_s               ctx2            = { sizeof(ctx2) };
+    rfc_class_param_s       class_param, class_param_64;
+    const rfc_cycle_item_s *cycles;
+    size_t                  cycles_count, cycles_count_fed, residue_cnt, cycles_cap;
+    rfc_counts_t           *rfm, *rp, sum, rfm_sum;
+    double                  D_values;
+    rfc_error_e             error;
+    size_t                  i;
+    bool                    ok;
+
+    /* Values on class means, class and value comparison are equivalent then */
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        unsigned cls = (unsigned)( 50.0 + 20.0 * sin( 0.3 * i ) + 15.0 * sin( 1.1 * i ) + 10.0 * cos( 0.07 * i ) );
+
+        data[i] = class_offset + class_width * ( cls + 0.5 );
+    }
+
+    ASSERT( RFC_init( &ctx2, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_COUNT_RFM | RFC_FLAGS_COUNT_DAMAGE | RFC_FLAGS_COUNT_RP ) );
+    ASSERT( RFC_feed( &ctx2, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx2, RFC_RES_IGNORE ) );
+
+    /* No class grid needed in advance, binning at readout */
+    class_param.count  = class_count;
+    class_param.width  = class_width;
+    class_param.offset = class_offset;
+    rfm = (rfc_counts_t*)calloc( class_count * class_count, sizeof(rfc_counts_t) );
+    rp  = (rfc_counts_t*)calloc( class_count, sizeof(rfc_counts_t) );
+    cycles_count = 0;
+
+    ok = rfm && rp &&
+         RFC_init( &ctx, /*class_count*/ 0, 0.0, 0.0, hysteresis, RFC_FLAGS_COUNT_VALUES ) &&
+         RFC_feed( &ctx, data, NUMEL(data) ) &&
+         RFC_finalize( &ctx, RFC_RES_IGNORE ) &&
+         RFC_cycles_get( &ctx, &cycles, &cycles_count ) &&
+         RFC_cycles_rfm( &ctx, &class_param, rfm ) &&
+         RFC_cycles_rp( &ctx, &class_param, rp ) &&
+         RFC_cycles_damage( &ctx, &D_values ) &&
+         RFC_cycles_class_param( &ctx, 64, &class_param_64 );
+
+    /* Release the shared context before asserting, following tests rely on it */
+    (void)RFC_deinit( &ctx );
+
+    ASSERT( ok );
+    ASSERT( cycles_count > 100 );
+
+    /* Binning at readout equals counting on the class grid */
+    ASSERT_MEM_EQ( rfm, ctx2.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( rp, ctx2.rp, sizeof(rfc_counts_t) * class_count );
+    free( rfm );
+    free( rp );
+
+    ASSERT( D_values > 0.0 );
+    ASSERT_IN_RANGE( ctx2.damage, D_values, ctx2.damage * 1e-9 );
+
+    ASSERT_EQ( class_param_64.count, 64 );
+    ASSERT( class_param_64.offset < class_offset + class_width * 5 );
+    ASSERT( class_param_64.offset + class_param_64.width * 64 > class_offset + class_width * 95 );
+
+    ASSERT( RFC_deinit( &ctx2 ) );
+
+    /* Diverging series, residue grows beyond static capacity */
+    for( i = 0; i < 500; i++ )
+    {
+        data[i] = ( ( i & 1 ) ? 1.0 : -1.0 ) * ( 1.0 + 0.01 * i );
+    }
+
+    cycles_count_fed = 0;
+    residue_cnt      = 0;
+    ok = RFC_init( &ctx, /*class_count*/ 0, 0.0, 0.0, hysteresis, RFC_FLAGS_COUNT_VALUES ) &&
+         RFC_feed( &ctx, data, 500 ) &&
+         RFC_cycles_get( &ctx, &cycles, &cycles_count_fed );
+    residue_cnt = ctx.residue_cnt;
+    ok = ok &&
+         RFC_finalize( &ctx, RFC_RES_HALFCYCLES ) &&
+         RFC_cycles_get( &ctx, &cycles, &cycles_count );
+    (void)RFC_deinit( &ctx );
+
+    ASSERT( ok );
+    ASSERT_EQ( cycles_count_fed, 0 );
+    ASSERT( residue_cnt >= 498 );
+    ASSERT_EQ( cycles_count, 499 );
+
+    /* Repeating value pairs are merged, the storage doesn't grow with the count of cycles */
+    for( i = 0; i < 5000; i++ )
+    {
+        data[i] = ( i & 1 ) ? ( 1.0 + 0.5 * ( ( i / 2 ) % 3 ) ) : -1.0;
+    }
+
+    ok = RFC_init( &ctx2, /*class_count*/ 10, /*class_width*/ 1.0, /*class_offset*/ -5.0, hysteresis, RFC_FLAGS_COUNT_RFM ) &&
+         RFC_feed( &ctx2, data, 5000 ) &&
+         RFC_finalize( &ctx2, RFC_RES_IGNORE ) &&
+         RFC_init( &ctx, /*class_count*/ 0, 0.0, 0.0, hysteresis, RFC_FLAGS_COUNT_VALUES ) &&
+         RFC_feed( &ctx, data, 5000 ) &&
+         RFC_finalize( &ctx, RFC_RES_IGNORE ) &&
+         RFC_cycles_get( &ctx, &cycles, &cycles_count );
+    cycles_cap = ctx.cycles_cap;
+    sum        = 0;
+    for( i = 0; ok && i < cycles_count; i++ )
+    {
+        sum += cycles[i].counts;
+    }
+    rfm_sum = 0;
+    for( i = 0; ok && i < 10 * 10; i++ )
+    {
+        rfm_sum += ctx2.rfm[i];
+    }
+    (void)RFC_deinit( &ctx );
+    (void)RFC_deinit( &ctx2 );
+
+    ASSERT( ok );
+    ASSERT_EQ( cycles_cap, 256 );
+    ASSERT( cycles_count <= 256 );
+    ASSERT( rfm_sum > 256 * ctx2.full_inc );
+    ASSERT_EQ( sum, rfm_sum );
+
+#if RFC_HCM_SUPPORT || RFC_ASTM_SUPPORT
+    /* Only the 4-point method compares values, on feeding and on finalizing */
+    for( i = 0; i < 2; i++ )
+    {
+        ok = RFC_init( &ctx, /*class_count*/ 0, 0.0, 0.0, hysteresis, RFC_FLAGS_COUNT_VALUES );
+#if RFC_HCM_SUPPORT
+        ctx.counting_method = RFC_COUNTING_METHOD_HCM;
+#else /*!RFC_HCM_SUPPORT*/
+        ctx.counting_method = RFC_COUNTING_METHOD_ASTM;
+#endif /*RFC_HCM_SUPPORT*/
+        if( !i )
+        {
+            ok = ok && !RFC_feed( &ctx, data, 500 );
+        }
+        else
+        {
+            ok = ok && RFC_feed( &ctx, data, 1 ) && !RFC_finalize( &ctx, RFC_RES_IGNORE );
+        }
+        error = ctx.error;
+        (void)RFC_deinit( &ctx );
+
+        ASSERT( ok );
+        ASSERT_EQ( error, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_HCM_SUPPORT || RFC_ASTM_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_class_bounds_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             bounds[81];
+    rfc_value_t             data[5000];
+    rfc_value_t             Sa[80];
+    rfc_ctx_s               ctx2            = { sizeof(ctx2) };
+    rfc_counts_t           *rp;
+    rfc_counts_t            sum, rp_sum;
+    const rfc_value_t      *bounds_ptr;
+    unsigned                count;
+    double                  D;
+    size_t                  i, from, to;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+    }
+
+    /* Equidistant bounds give the same results as class parameters */
+    for( i = 0; i <= class_count; i++ )
+    {
+        bounds[i] = class_offset + class_width * i;
+    }
+
+    ASSERT( RFC_init( &ctx,  class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_init( &ctx2, class_count, 1.0, 0.0, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_class_bounds_set( &ctx2, bounds, class_count ) );
+    ASSERT( RFC_class_bounds_get( &ctx2, &bounds_ptr, &count ) );
+    ASSERT( bounds_ptr && count == class_count );
+    ASSERT_EQ( ctx2.class_offset, class_offset );
+    ASSERT_EQ( ctx2.class_width,  class_width );
+    ASSERT( RFC_feed( &ctx,  data, NUMEL(data) ) && RFC_finalize( &ctx,  RFC_RES_IGNORE ) );
+    ASSERT( RFC_feed( &ctx2, data, NUMEL(data) ) && RFC_finalize( &ctx2, RFC_RES_IGNORE ) );
+    ASSERT_MEM_EQ( ctx.rfm, ctx2.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( ctx.rp,  ctx2.rp,  sizeof(rfc_counts_t) * class_count );
+    ASSERT_MEM_EQ( ctx.lc,  ctx2.lc,  sizeof(rfc_counts_t) * class_count );
+    ASSERT( ctx.damage > 0.0 );
+    ASSERT_IN_RANGE( ctx.damage, ctx2.damage, ctx.damage * 1e-12 );
+    ASSERT( RFC_deinit( &ctx2 ) );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Logarithmic classes, fine around zero */
+    for( i = 0; i <= class_count; i++ )
+    {
+        double x = ( (double)i - class_count / 2 ) / ( class_count / 2 );
+
+        bounds[i] = ( x < 0.0 ? -1.0 : 1.0 ) * 0.01 * ( exp( 6.5 * fabs( x ) ) - 1.0 );
+    }
+    bounds[0] -= 1e-3;
+
+    ASSERT( RFC_init( &ctx, class_count, 1.0, 0.0, 0.02, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_class_bounds_set( &ctx, bounds, class_count ) );
+
+    /* Quantization equals a binary search on the bounds */
+    for( i = 0; i < 20000; i++ )
+    {
+        double   value = bounds[0] + ( bounds[class_count] - bounds[0] ) * i / 20000;
+        unsigned lo = 0, hi = class_count, cls;
+
+        while( hi - lo > 1 )
+        {
+            unsigned mid = ( lo + hi ) / 2;
+            if( value >= bounds[mid] ) lo = mid; else hi = mid;
+        }
+        ASSERT( RFC_class_number( &ctx, value, &cls ) );
+        ASSERT_EQ( cls, lo );
+    }
+    for( i = 0; i <= class_count; i++ )
+    {
+        unsigned cls;
+        ASSERT( RFC_class_number( &ctx, bounds[i], &cls ) );
+        ASSERT_EQ( cls, i );
+    }
+
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) && RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+
+    /* Damage from cycle amplitudes on the class bounds */
+    D = 0.0;
+    sum = 0;
+    for( from = 0; from < class_count; from++ )
+    {
+        for( to = 0; to < class_count; to++ )
+        {
+            rfc_counts_t counts = ctx.rfm[ from * class_count + to ];
+
+            if( counts )
+            {
+                double N;
+
+                ASSERT( RFC_wl_calc_n( &ctx, ctx.wl_sx, ctx.wl_nx, ctx.wl_k, fabs( bounds[from] - bounds[to] ) / 2, &N ) );
+                D   += (double)counts / ctx.full_inc / N;
+                sum += counts;
+            }
+        }
+    }
+    ASSERT( sum > 0 );
+    ASSERT_IN_RANGE( D, ctx.damage, D * 1e-9 );
+
+    /* Range pairs refer to ranges bounds[i] - bounds[0] */
+    rp = (rfc_counts_t*)calloc( class_count, sizeof(rfc_counts_t) );
+    ASSERT( rp );
+    ASSERT( RFC_rp_from_rfm( &ctx, rp, NULL, NULL ) );
+    ASSERT_MEM_EQ( rp, ctx.rp, sizeof(rfc_counts_t) * class_count );
+    ASSERT( RFC_rp_get( &ctx, rp, Sa ) );
+    for( i = 0, rp_sum = 0; i < class_count; i++ )
+    {
+        ASSERT_EQ( Sa[i], ( bounds[i] - bounds[0] ) / 2 );
+        rp_sum += rp[i];
+    }
+    ASSERT_EQ( rp_sum, sum );
+    free( rp );
+
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_cond_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[5000];
+    unsigned                cond[5000];
+    unsigned                zero_class      = 40;  /* Class holding values from 0.0 */
+    const rfc_counts_t     *rfm[3];
+    int                     rule;
+    size_t                  i, from, to;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+        /* Condition 0 below, 1 above zero, 2 never occurs */
+        cond[i] = data[i] >= 0.0;
+    }
+
+    for( rule = RFC_COND_RULE_FROM; rule <= RFC_COND_RULE_MAX; rule++ )
+    {
+        double D;
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 3, (rfc_cond_rule_e)rule ) );
+        /* Split feeding, shared residue */
+        ASSERT( RFC_feed_cond( &ctx, data, cond, 1234 ) );
+        ASSERT( RFC_feed_cond( &ctx, data + 1234, cond + 1234, NUMEL(data) - 1234 ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+
+        for( i = 0, D = 0.0; i < 3; i++ )
+        {
+            double D_i;
+
+            ASSERT( RFC_cond_rfm( &ctx, (unsigned)i, &rfm[i] ) );
+            ASSERT( RFC_cond_damage( &ctx, (unsigned)i, &D_i ) );
+            D += D_i;
+        }
+        ASSERT( ctx.damage > 0.0 );
+        ASSERT_IN_RANGE( ctx.damage, D, ctx.damage * 1e-12 );
+
+        for( from = 0; from < class_count; from++ )
+        {
+            for( to = 0; to < class_count; to++ )
+            {
+                size_t   idx = from * class_count + to;
+                unsigned cls;
+
+                ASSERT_EQ( rfm[0][idx] + rfm[1][idx], ctx.rfm[idx] );
+                ASSERT_EQ( rfm[2][idx], 0 );
+
+                if( !ctx.rfm[idx] ) continue;
+
+                switch( rule )
+                {
+                    case RFC_COND_RULE_FROM: cls = (unsigned)from; break;
+                    case RFC_COND_RULE_TO:   cls = (unsigned)to;   break;
+                    default:                 cls = (unsigned)( from > to ? from : to ); break;
+                }
+
+                ASSERT_EQ( rfm[ cls >= zero_class ][idx], ctx.rfm[idx] );
+            }
+        }
+
+        ASSERT( RFC_deinit( &ctx ) );
+    }
+
+#if RFC_DH_SUPPORT
+    /* Damage history spread over the input stream */
+    {
+        double D = 0.0;
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 3, RFC_COND_RULE_FROM ) );
+        ASSERT( RFC_dh_init( &ctx, RFC_SD_TRANSIENT_23, /*dh*/ NULL, /*dh_cap*/ 1, /*is_static*/ false ) );
+        ASSERT( RFC_wl_init_elementary( &ctx, /*sx*/ 1.0, /*nx*/ 1e3, /*k*/ -5 ) );
+#if RFC_TP_SUPPORT
+        ASSERT( RFC_tp_init( &ctx, /*tp*/ NULL, /*tp_cap*/ 128, /*is_static*/ false ) );
+#endif /*RFC_TP_SUPPORT*/
+        ASSERT( RFC_feed_cond( &ctx, data, cond, 1234 ) );
+        ASSERT( RFC_feed_cond( &ctx, data + 1234, cond + 1234, NUMEL(data) - 1234 ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+        ASSERT( ctx.dh_istream == data );
+        for( i = 0; i < ctx.dh_cnt; i++ )
+        {
+            D += ctx.dh[i];
+        }
+#if RFC_TP_SUPPORT
+        ASSERT( ctx.damage > 0.0 );
+        ASSERT_IN_RANGE( ctx.damage, D, ctx.damage * 1e-12 );
+#endif /*RFC_TP_SUPPORT*/
+        ASSERT( RFC_deinit( &ctx ) );
+
+        /* Stream has to be contiguous */
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 3, RFC_COND_RULE_FROM ) );
+        ASSERT( RFC_dh_init( &ctx, RFC_SD_TRANSIENT_23, /*dh*/ NULL, /*dh_cap*/ 1, /*is_static*/ false ) );
+        ASSERT( RFC_feed_cond( &ctx, data, cond, 1234 ) );
+        ASSERT( !RFC_feed_cond( &ctx, data + 2000, cond + 2000, 100 ) );
+        ASSERT_EQ( ctx.error, RFC_ERROR_DH_BAD_STREAM );
+        ASSERT( RFC_deinit( &ctx ) );
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_tal_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[5000];
+    rfc_value_t             level[80];
+    size_t                  tal[80], tal_ref[80];
+    size_t                  i;
+
+    memset( tal_ref, 0, sizeof(tal_ref) );
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        unsigned cls;
+
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+        cls     = (unsigned)( ( data[i] - class_offset ) / class_width );
+        tal_ref[cls]++;
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, 
+                      RFC_FLAGS_COUNT_RFM | RFC_FLAGS_COUNT_DAMAGE | RFC_FLAGS_COUNT_TAL ) );
+    ASSERT( RFC_feed( &ctx, data, 1234 ) );
+    ASSERT( RFC_feed_scaled( &ctx, data + 1234, NUMEL(data) - 1234, 1.0 ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+    ASSERT( RFC_tal_get( &ctx, tal, level ) );
+    ASSERT_MEM_EQ( tal, tal_ref, sizeof(tal) );
+    ASSERT_EQ( level[0], class_offset + class_width / 2 );
+    ASSERT( ctx.damage > 0.0 );
+    ASSERT( RFC_clear_counts( &ctx ) );
+    ASSERT( RFC_tal_get( &ctx, tal, NULL ) );
+    ASSERT_EQ( tal[40], 0 );
+    ASSERT( RFC_deinit( &ctx ) );
+
+#if RFC_AR_SUPPORT
+    /* Grid grows in both directions */
+    ASSERT( RFC_init( &ctx, 10, class_width, -0.625, class_width, 
+                      RFC_FLAGS_COUNT_RFM | RFC_FLAGS_COUNT_TAL | RFC_FLAGS_AUTORESIZE ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    ASSERT( ctx.class_count > 10 && ctx.class_count <= class_count );
+    ASSERT( RFC_tal_get( &ctx, tal, level ) );
+    for( i = 0; i < ctx.class_count; i++ )
+    {
+        ASSERT_EQ( tal[i], tal_ref[ (unsigned)( ( level[i] - class_offset ) / class_width ) ] );
+    }
+    ASSERT( RFC_deinit( &ctx ) );
+#endif /*RFC_AR_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_wl_bins_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[5000];
+    unsigned                cond[5000];
+    rfc_wl_param_s          wl[2];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    double                  D_cond[2], D_base;
+    size_t                  i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+        /* Condition 0 for the first, 1 for the second half */
+        cond[i] = i >= NUMEL(data) / 2;
+    }
+
+    /* Reference: common Woehler curve */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    D_base = ctx.damage;
+    ASSERT( D_base > 0.0 );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+    /* Condition 0 keeps the common curve, condition 1 has a weaker one */
+    ASSERT( RFC_wl_param_get( &ctx, &wl[0] ) );
+    wl[1]    = wl[0];
+    wl[1].sx = wl[0].sx * 0.8;
+    wl[1].sd = wl[0].sd * 0.8;
+    wl[1].k  = wl[1].k2 = -3.0;
+    wl[1].q  = wl[1].q2 =  2.0;
+    ASSERT( RFC_wl_bins_init( &ctx, wl, 2 ) );
+    ASSERT_EQ( ctx.wl_bin_count, 2 );
+    ASSERT( RFC_feed_cond( &ctx, data, cond, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+
+    ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    for( i = 0; i < 2; i++ )
+    {
+        const rfc_counts_t *rfm;
+        double              D_ref;
+
+        ASSERT( RFC_cond_rfm( &ctx, (unsigned)i, &rfm ) );
+        ASSERT( RFC_cond_damage( &ctx, (unsigned)i, &D_cond[i] ) );
+        ASSERT( RFC_wl_init_any( &ref, &wl[i] ) );
+        ASSERT( RFC_damage_from_rfm( &ref, &D_ref, rfm ) );
+        ASSERT( D_cond[i] > 0.0 );
+        ASSERT_IN_RANGE( D_ref, D_cond[i], D_ref * 1e-10 );
+    }
+    ASSERT( RFC_deinit( &ref ) );
+
+    /* Total damage follows the curves per condition, common curve is untouched */
+    ASSERT_IN_RANGE( ctx.damage, D_cond[0] + D_cond[1], ctx.damage * 1e-12 );
+    ASSERT( ctx.damage > D_base );
+    ASSERT_EQ( ctx.wl_k, wl[0].k );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Critical planes share the curves, planes are fed without conditions (condition 0) */
+    {
+        rfc_wl_param_s  wl_swap[2];
+        double          coeff = 1.0;
+        double          D_plane;
+
+        wl_swap[0] = wl[1];
+        wl_swap[1] = wl[0];
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_any( &ref, &wl[1] ) );
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_IGNORE ) );
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+        ASSERT( RFC_wl_bins_init( &ctx, wl_swap, 2 ) );
+        ASSERT( RFC_cp_damage( &ctx, data, NUMEL(data), /*comp_count*/ 1, &coeff, /*plane_count*/ 1, 
+                               RFC_RES_IGNORE, &D_plane, NULL ) );
+        ASSERT( ref.damage > D_base );
+        ASSERT_IN_RANGE( ref.damage, D_plane, ref.damage * 1e-12 );
+        ASSERT( ctx.wl_bin_lut && ctx.wl_bin_count == 2 );
+        ASSERT( RFC_deinit( &ctx ) );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    /* Changing the number of conditions drops the curves */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+    ASSERT( RFC_wl_bins_init( &ctx, wl, 2 ) );
+    ASSERT( RFC_cond_init( &ctx, 3, RFC_COND_RULE_FROM ) );
+    ASSERT( !ctx.wl_bin_lut && !ctx.wl_bin_count );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Damage is tabulated on the class grid */
+    ASSERT( RFC_init( &ctx, /*class_count*/ 0, 0.0, 0.0, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+    ASSERT( !RFC_wl_bins_init( &ctx, wl, 2 ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_INVARG );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Local strain approach doesn't regard Woehler curves */
+    {
+        rfc_sl_param_s sl = { RFC_SL_MODEL_SWT };
+
+        sl.E  = 206000.0;
+        sl.K  = 1200.0;
+        sl.n  = 0.15;
+        sl.sf = 1100.0;
+        sl.b  = -0.09;
+        sl.ef = 0.6;
+        sl.c  = -0.6;
+        sl.Kt = 150.0;
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+        ASSERT( RFC_wl_bins_init( &ctx, wl, 2 ) );
+        ASSERT( !RFC_sl_param_set( &ctx, &sl ) );
+        ASSERT_EQ( ctx.error, RFC_ERROR_UNSUPPORTED );
+        ASSERT( RFC_deinit( &ctx ) );
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_cond_init( &ctx, 2, RFC_COND_RULE_FROM ) );
+        ASSERT( RFC_sl_param_set( &ctx, &sl ) );
+        ASSERT( !RFC_wl_bins_init( &ctx, wl, 2 ) );
+        ASSERT_EQ( ctx.error, RFC_ERROR_UNSUPPORTED );
+        ASSERT( RFC_deinit( &ctx ) );
+    }
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+static
+double sl_test_damage( unsigned from, unsigned to )
+{
+    static rfc_counts_t     rfm[20 * 20];
+    double                  D = -1.0;
+
+    memset( rfm, 0, sizeof(rfm) );
+    rfm[ from * 20 + to ] = ctx.full_inc;
+    if( !RFC_damage_from_rfm( &ctx, &D, rfm ) ) return -1.0;
+
+    return D;
+}
+
+
+TEST RFC_sl_test( void )
+{
+    unsigned                class_count     = 20;
+    double                  class_width     = 0.5;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[]          = { 0.25, 2.25, -1.75, 2.25, -1.75, 0.25 };
+    rfc_sl_param_s          sl;
+    double                  D_sym, D_pos, D_neg, D_base, N, P;
+    int                     model;
+
+    /* Steel like material, input values scaled to local stresses by Kt */
+    sl.E  = 206000.0;
+    sl.K  = 1200.0;
+    sl.n  = 0.15;
+    sl.sf = 1100.0;
+    sl.b  = -0.09;
+    sl.ef = 0.6;
+    sl.c  = -0.6;
+    sl.Kt = 150.0;
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    D_base = sl_test_damage( 6, 14 );
+    ASSERT( D_base > 0.0 );
+
+    for( model = RFC_SL_MODEL_SWT; model <= RFC_SL_MODEL_MORROW; model++ )
+    {
+        sl.model = (rfc_sl_model_e)model;
+        ASSERT( RFC_sl_param_set( &ctx, &sl ) );
+
+        /* Classes 6 and 14 have symmetric lower bounds: Sa = 2, Sm = 0 */
+        D_sym = sl_test_damage(  6, 14 );
+        D_pos = sl_test_damage( 10, 18 );
+        D_neg = sl_test_damage(  2, 10 );
+        ASSERT( D_sym > 0.0 && D_pos > D_sym && D_neg < D_sym );
+
+        if( model == RFC_SL_MODEL_SWT )
+        {
+            /* Symmetric cycle: sigma_max*eps_a equals Neubers' (Kt*Sa)^2/E */
+            N = 1.0 / D_sym;
+            P = sl.sf * sl.sf / sl.E * pow( 2 * N, 2 * sl.b ) + sl.sf * sl.ef * pow( 2 * N, sl.b + sl.c );
+            ASSERT_IN_RANGE( sl.Kt * 2.0 * sl.Kt * 2.0 / sl.E, P, P * 1e-9 );
+            /* No tension, no damage */
+            ASSERT_EQ( D_neg, 0.0 );
+        }
+    }
+
+    /* Counting uses the tabulated damage */
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    ASSERT_IN_RANGE( D_sym, ctx.damage, D_sym * 1e-12 );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Back to nominal stress approach */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_sl_param_set( &ctx, &sl ) );
+    sl.model = RFC_SL_MODEL_NONE;
+    ASSERT( RFC_sl_param_set( &ctx, &sl ) );
+    ASSERT_EQ( sl_test_damage( 6, 14 ), D_base );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_top_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[5000];
+    static rfc_top_item_s   all[5000];
+    rfc_top_item_s          top[10];
+    size_t                  all_cnt, top_cnt, i;
+    double                  D;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+    }
+
+    /* Reference: keep all cycles */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_top_init( &ctx, NUMEL(all), RFC_TOP_KEY_DAMAGE ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    all_cnt = NUMEL(all);
+    ASSERT( RFC_top_get( &ctx, all, &all_cnt ) );
+    ASSERT( all_cnt > NUMEL(top) && all_cnt < NUMEL(all) );
+    for( i = 0, D = 0.0; i < all_cnt; i++ )
+    {
+        D += all[i].damage;
+        ASSERT( i == 0 || all[i].damage <= all[i-1].damage );
+        ASSERT_EQ( all[i].from, data[ all[i].from_pos - 1 ] );
+        ASSERT_EQ( all[i].to,   data[ all[i].to_pos   - 1 ] );
+    }
+    ASSERT_IN_RANGE( ctx.damage, D, ctx.damage * 1e-12 );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Bounded: the worst cycles only */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_top_init( &ctx, NUMEL(top), RFC_TOP_KEY_DAMAGE ) );
+    ASSERT( RFC_feed( &ctx, data, 1234 ) );
+    ASSERT( RFC_feed( &ctx, data + 1234, NUMEL(data) - 1234 ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    top_cnt = NUMEL(top);
+    ASSERT( RFC_top_get( &ctx, top, &top_cnt ) );
+    ASSERT_EQ( top_cnt, NUMEL(top) );
+    for( i = 0; i < top_cnt; i++ )
+    {
+        ASSERT_EQ( top[i].damage, all[i].damage );
+    }
+    /* Buffer too small */
+    top_cnt = 5;
+    ASSERT( !RFC_top_get( &ctx, top, &top_cnt ) );
+    ASSERT_EQ( top_cnt, NUMEL(top) );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Ranked by range */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_top_init( &ctx, 1, RFC_TOP_KEY_RANGE ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+    top_cnt = 1;
+    ASSERT( RFC_top_get( &ctx, top, &top_cnt ) );
+    for( i = 0; i < all_cnt; i++ )
+    {
+        ASSERT( fabs( all[i].to - all[i].from ) <= fabs( top[0].to - top[0].from ) );
+    }
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_snapshot_test( void )
+{
+    unsigned                class_count     = 80;
+    double                  class_width     = 0.125;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[5000];
+    static rfc_counts_t     rfm[80 * 80];
+    rfc_counts_t            lc[80];
+    rfc_snapshot_s          snap;
+    size_t                  i, chunk = 777;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT | RFC_FLAGS_COUNT_LC ) );
+    ASSERT( !RFC_snapshot_get( &ctx, &snap, NULL, NULL ) );
+    ASSERT( RFC_snapshot_init( &ctx, true ) );
+    ASSERT( RFC_snapshot_get( &ctx, &snap, rfm, lc ) );
+    ASSERT_EQ( snap.pos, 0 );
+    ASSERT_EQ( snap.epoch, 1 );
+
+    /* Snapshot follows each feed */
+    for( i = 0; i < NUMEL(data); i += chunk )
+    {
+        size_t n = ( i + chunk < NUMEL(data) ) ? chunk : NUMEL(data) - i;
+
+        ASSERT( RFC_feed( &ctx, data + i, n ) );
+        ASSERT( RFC_snapshot_get( &ctx, &snap, rfm, lc ) );
+        ASSERT_EQ( snap.pos, i + n );
+        ASSERT_EQ( snap.damage, ctx.damage );
+        ASSERT_MEM_EQ( rfm, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( lc,  ctx.lc,  sizeof(rfc_counts_t) * class_count );
+    }
+
+    /* Changes beyond counting are covered as well */
+    ASSERT( RFC_rfm_poke( &ctx, -4.9, 4.9, 3, /*add_only*/ true ) );
+    ASSERT( RFC_feed( &ctx, data, 0 ) );
+    ASSERT( RFC_snapshot_get( &ctx, NULL, rfm, NULL ) );
+    ASSERT_MEM_EQ( rfm, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+    ASSERT( RFC_snapshot_get( &ctx, &snap, rfm, lc ) );
+    ASSERT_EQ( snap.state, RFC_STATE_FINISHED );
+    ASSERT_EQ( snap.damage, ctx.damage );
+    ASSERT_MEM_EQ( rfm, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( lc,  ctx.lc,  sizeof(rfc_counts_t) * class_count );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL && RFC_TEST_PTHREADS
+typedef struct snapshot_reader
+{
+    const rfc_ctx_s    *ctx;
+    const size_t       *pos;                /* Reference positions after each feed */
+    const double       *damage;             /* Reference damage after each feed */
+    const rfc_counts_t *rfm_sum;            /* Reference sum of rfm counts after each feed */
+    size_t              ref_count;
+    double              damage_final;       /* Reference damage after finalizing */
+    rfc_counts_t        rfm[40 * 40];
+    size_t              reads;
+    volatile bool       done;               /* Feeding thread gave up */
+    bool                ok;
+} snapshot_reader_s;
+
+
+static
+void *snapshot_reader_run( void *arg )
+{
+    snapshot_reader_s *reader = (snapshot_reader_s*)arg;
+    rfc_snapshot_s     snap;
+    size_t             pos_last = 0, epoch_last = 0;
+
+    reader->ok = true;
+
+    do
+    {
+        rfc_counts_t sum = 0;
+        size_t       i;
+
+        if( !RFC_snapshot_get( reader->ctx, &snap, reader->rfm, NULL ) )
+        {
+            reader->ok = false;
+            break;
+        }
+        reader->reads++;
+
+        for( i = 0; i < NUMEL(reader->rfm); i++ )
+        {
+            sum += reader->rfm[i];
+        }
+
+        /* Publications appear in order and each one is consistent in itself */
+        if( snap.pos < pos_last || snap.epoch < epoch_last )
+        {
+            reader->ok = false;
+        }
+        pos_last   = snap.pos;
+        epoch_last = snap.epoch;
+
+        if( snap.state == RFC_STATE_FINISHED )
+        {
+            if( snap.damage != reader->damage_final || sum != reader->rfm_sum[reader->ref_count - 1] )
+            {
+                reader->ok = false;
+            }
+        }
+        else
+        {
+            for( i = 0; i < reader->ref_count && reader->pos[i] != snap.pos; i++ );
+
+            if( i == reader->ref_count || snap.damage != reader->damage[i] || sum != reader->rfm_sum[i] )
+            {
+                reader->ok = false;
+            }
+        }
+    } while( reader->ok && snap.state != RFC_STATE_FINISHED && !reader->done );
+
+    return NULL;
+}
+
+
+TEST RFC_snapshot_thread_test( void )
+{
+    unsigned                    class_count     = 40;
+    double                      class_width     = 0.25;
+    double                      class_offset    = -5.0;
+    static rfc_value_t          data[20000];
+    static size_t               pos[20000 / 10 + 1];
+    static double               damage[20000 / 10 + 1];
+    static rfc_counts_t         rfm_sum[20000 / 10 + 1];
+    static snapshot_reader_s    reader;
+    rfc_ctx_s                   ref             = { sizeof(ref) };
+    pthread_t                   thread;
+    size_t                      i, j, n, chunk = 10;
+    bool                        ok, started;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+    }
+
+    /* Reference results after each feed */
+    ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    pos[0] = 0; damage[0] = 0.0; rfm_sum[0] = 0;
+    for( i = 0, n = 1; i < NUMEL(data); i += chunk, n++ )
+    {
+        ASSERT( RFC_feed( &ref, data + i, chunk ) );
+        pos[n]     = i + chunk;
+        damage[n]  = ref.damage;
+        rfm_sum[n] = 0;
+        for( j = 0; j < (size_t)class_count * class_count; j++ )
+        {
+            rfm_sum[n] += ref.rfm[j];
+        }
+    }
+    ASSERT( RFC_finalize( &ref, RFC_RES_IGNORE ) );
+    reader.damage_final = ref.damage;
+    ASSERT( RFC_deinit( &ref ) );
+
+    /* Feeding thread publishes, while the reader thread checks each snapshot it gets */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ok = RFC_snapshot_init( &ctx, true );
+    reader.ctx       = &ctx;
+    reader.pos       = pos;
+    reader.damage    = damage;
+    reader.rfm_sum   = rfm_sum;
+    reader.ref_count = n;
+    reader.reads     = 0;
+    reader.done      = false;
+    started = ok && pthread_create( &thread, NULL, snapshot_reader_run, &reader ) == 0;
+
+    for( i = 0, ok = started; ok && i < NUMEL(data); i += chunk )
+    {
+        ok = RFC_feed( &ctx, data + i, chunk );
+    }
+    ok = ok && RFC_finalize( &ctx, RFC_RES_IGNORE );
+    if( started )
+    {
+        reader.done = true;
+        ok = pthread_join( thread, NULL ) == 0 && ok;
+    }
+    (void)RFC_deinit( &ctx );
+
+    ASSERT( ok );
+    ASSERT( reader.ok );
+    ASSERT( reader.reads > 0 );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL && RFC_TEST_PTHREADS*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_region_test( void )
+{
+    unsigned                    class_count     = 80;
+    double                      class_width     = 0.125;
+    double                      class_offset    = -5.0;
+    rfc_value_t                 data[5000];
+    const rfc_region_header_s  *header;
+    const unsigned char        *region;
+    double                     *buffer;
+    size_t                      i, chunk = 777, size, seq;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.3 * i ) + 1.5 * sin( 1.1 * i ) + 0.75 * cos( 0.07 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_region_size( &ctx, &size ) );
+    ASSERT( size >= sizeof(rfc_region_header_s) + sizeof(rfc_counts_t) * class_count * ( class_count + 2 ) );
+    buffer = (double*)calloc( size, 1 );
+    ASSERT( buffer );
+    ASSERT( !RFC_region_read_begin( buffer, &seq ) );
+    ASSERT( RFC_region_attach( &ctx, buffer, size ) );
+
+    region = (const unsigned char*)buffer;
+    header = (const rfc_region_header_s*)buffer;
+    ASSERT( RFC_region_read_begin( region, &seq ) );
+    ASSERT_EQ( header->epoch, 1 );
+    ASSERT_EQ( header->pos, 0 );
+    ASSERT_EQ( header->class_count, class_count );
+    ASSERT( header->rfm_offset && header->rp_offset && header->lc_offset );
+    ASSERT( RFC_region_read_end( region, seq ) );
+
+    /* Region follows each feed, arrays are read in place */
+    for( i = 0; i < NUMEL(data); i += chunk )
+    {
+        size_t n = ( i + chunk < NUMEL(data) ) ? chunk : NUMEL(data) - i;
+
+        ASSERT( RFC_feed( &ctx, data + i, n ) );
+        ASSERT( RFC_region_read_begin( region, &seq ) );
+        ASSERT_EQ( header->pos, i + n );
+        ASSERT_EQ( header->damage, ctx.damage );
+        ASSERT_EQ( header->residue_cnt, ctx.residue_cnt );
+        ASSERT_MEM_EQ( region + header->rfm_offset, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( region + header->rp_offset,  ctx.rp,  sizeof(rfc_counts_t) * class_count );
+        ASSERT_MEM_EQ( region + header->lc_offset,  ctx.lc,  sizeof(rfc_counts_t) * class_count );
+        ASSERT( RFC_region_read_end( region, seq ) );
+    }
+
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+    ASSERT( RFC_region_read_begin( region, &seq ) );
+    ASSERT_EQ( header->state, RFC_STATE_FINISHED );
+    ASSERT_EQ( header->residue_cnt, 0 );
+    ASSERT_MEM_EQ( region + header->rfm_offset, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT( RFC_region_read_end( region, seq ) );
+    ASSERT( RFC_deinit( &ctx ) );
+    free( buffer );
+
+#if RFC_SHM_SUPPORT
+    /* Consumer in another process */
+    {
+        char        name[64];
+        rfc_ctx_s   dup = { sizeof(dup) };
+        pid_t       pid;
+        int         status;
+
+        /* Unique per test process */
+        sprintf( name, "/rfc_test_region_%ld", (long)getpid() );
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_shm_create( &ctx, name ) );
+
+        /* Existing segments are not taken over */
+        ASSERT( RFC_init( &dup, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( !RFC_shm_create( &dup, name ) );
+        ASSERT_EQ( dup.error, RFC_ERROR_SHM );
+        ASSERT( RFC_deinit( &dup ) );
+
+        ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+
+        fflush( stdout );
+        pid = fork();
+        ASSERT( pid >= 0 );
+
+        if( !pid )
+        {
+            const void *shm;
+            bool        ok;
+
+            ok = RFC_shm_open( name, &shm, &size ) && RFC_region_read_begin( shm, &seq );
+            if( ok )
+            {
+                header = (const rfc_region_header_s*)shm;
+                region = (const unsigned char*)shm;
+                ok     = header->pos == NUMEL(data) && header->damage == ctx.damage &&
+                         !memcmp( region + header->rfm_offset, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count ) &&
+                         RFC_region_read_end( shm, seq ) && RFC_shm_close( shm, size );
+            }
+            _exit( ok ? 0 : 1 );
+        }
+
+        ASSERT( waitpid( pid, &status, 0 ) == pid );
+        ASSERT( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+        ASSERT( RFC_deinit( &ctx ) );
+
+        /* Segment is unlinked */
+        {
+            const void *shm;
+            ASSERT( !RFC_shm_open( name, &shm, &size ) );
+        }
+    }
+#endif /*RFC_SHM_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_mux_test( void )
+{
+    unsigned                class_count     = 50;
+    double                  class_width     = 0.2;
+    double                  class_offset    = -5.0;
+    rfc_mux_s               mux             = { sizeof(mux) };
+    rfc_value_t             data[16][600];
+    size_t                  pos[16]         = { 0 };
+    unsigned                s, i, k;
+
+    for( s = 0; s < NUMEL(data); s++ )
+    {
+        for( i = 0; i < NUMEL(data[s]); i++ )
+        {
+            data[s][i] = 2.5 * sin( 0.3 * i + s ) + 1.5 * sin( ( 1.1 + 0.01 * s ) * i );
+        }
+    }
+
+    ASSERT( !RFC_mux_push( &mux, 0, data[0], 1 ) );
+    ASSERT( RFC_mux_init( &mux, NUMEL(data), 32 ) );
+    ASSERT( !RFC_mux_ctx( &mux, NUMEL(data) ) );
+
+    for( s = 0; s < NUMEL(data); s++ )
+    {
+        ASSERT( RFC_init( RFC_mux_ctx( &mux, s ), class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    }
+
+    /* Interleaved packets of various sizes, some exceed the buffer */
+    for( k = 0; ; k++ )
+    {
+        bool pending = false;
+
+        for( s = 0; s < NUMEL(data); s++ )
+        {
+            size_t n = ( k * 7 + s * 3 ) % 11 + 1;
+
+            if( ( k + s ) % 29 == 0 ) n = 45;
+            if( pos[s] + n > NUMEL(data[s]) ) n = NUMEL(data[s]) - pos[s];
+
+            ASSERT( RFC_mux_push( &mux, s, data[s] + pos[s], n ) );
+            pos[s] += n;
+            pending = pending || pos[s] < NUMEL(data[s]);
+        }
+
+        if( !pending ) break;
+    }
+
+    /* Flush halves, as two workers would */
+    ASSERT( !RFC_mux_flush( &mux, 8, 9 ) );
+    ASSERT( RFC_mux_flush( &mux, 0, 8 ) );
+    ASSERT( RFC_mux_flush( &mux, 8, 8 ) );
+
+    for( s = 0; s < NUMEL(data); s++ )
+    {
+        rfc_ctx_s *stream = (rfc_ctx_s*)RFC_mux_ctx( &mux, s );
+
+        ASSERT( RFC_finalize( stream, RFC_RES_IGNORE ) );
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_feed( &ctx, data[s], NUMEL(data[s]) ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_IGNORE ) );
+        ASSERT_EQ( stream->internal.pos, NUMEL(data[s]) );
+        ASSERT_EQ( stream->damage, ctx.damage );
+        ASSERT_MEM_EQ( stream->rfm, ctx.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT( RFC_deinit( &ctx ) );
+    }
+
+#if RFC_DH_SUPPORT
+    /* Damage history needs the input stream */
+    {
+        rfc_ctx_s *stream = (rfc_ctx_s*)RFC_mux_ctx( &mux, 0 );
+
+        ASSERT( RFC_deinit( stream ) );
+        ASSERT( RFC_init( stream, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_dh_init( stream, RFC_SD_FULL_P2, /*dh*/ NULL, /*dh_cap*/ 1, /*is_static*/ false ) );
+        ASSERT( !RFC_mux_push( &mux, 0, data[0], NUMEL(data[0]) ) );
+        ASSERT_EQ( stream->error, RFC_ERROR_UNSUPPORTED );
+    }
+#endif /*RFC_DH_SUPPORT*/
+
+    ASSERT( RFC_mux_deinit( &mux ) );
+    ASSERT( !mux.ctx );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_hysteresis_damage_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    rfc_value_t             data[10000];
+    rfc_value_t             hysteresis;
+    double                  bound;
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    size_t                  i;
+    int                     pass;
+
+    /* Noisy channel */
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 3.0 * sin( 0.013 * i ) + 0.8 * sin( 0.21 * i ) + 0.3 * sin( 2.3 * i ) + 0.2 * sin( 3.7 * i );
+    }
+
+    for( pass = 0; pass < 2; pass++ )
+    {
+        /* Miner original discards cycles below sd, Miner modified weights them by k2 */
+        double      fraction = pass ? 0.05 : 0.0;
+        rfc_ctx_s  *ctxs[2];
+        int         c;
+
+        ctxs[0] = &ref;
+        ctxs[1] = &ctx;
+
+        for( c = 0; c < 2; c++ )
+        {
+            ASSERT( RFC_init( ctxs[c], class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+            if( !pass )
+            {
+                ASSERT( RFC_wl_init_original( ctxs[c], /*sd*/ 1.0, /*nd*/ 1e6, /*k*/ -5 ) );
+            }
+            else
+            {
+                ASSERT( RFC_wl_init_modified( ctxs[c], /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+            }
+#if RFC_TP_SUPPORT
+            ASSERT( RFC_tp_init( ctxs[c], NULL, 128, /* is_static */ false ) );
+#endif /*RFC_TP_SUPPORT*/
+        }
+
+        ASSERT( RFC_hysteresis_from_damage( &ctx, fraction, &bound ) );
+        ASSERT( RFC_hysteresis( &ctx, &hysteresis ) );
+        ASSERT( hysteresis > class_width );
+        ASSERT( bound <= fraction / 1e6 );
+
+        for( c = 0; c < 2; c++ )
+        {
+            ASSERT( RFC_feed( ctxs[c], data, NUMEL(data) ) );
+            ASSERT( RFC_finalize( ctxs[c], RFC_RES_IGNORE ) );
+        }
+
+#if RFC_TP_SUPPORT
+        ASSERT( ctx.tp_cnt < ref.tp_cnt / 5 );
+#endif /*RFC_TP_SUPPORT*/
+
+        if( !pass )
+        {
+            /* Cycles below fatigue strength only are discarded */
+            ASSERT_EQ( bound, 0.0 );
+            ASSERT_IN_RANGE( ref.damage, ctx.damage, ref.damage * 1e-12 );
+        }
+        else
+        {
+            ASSERT( bound > 0.0 );
+            ASSERT( ctx.damage <= ref.damage );
+            ASSERT_IN_RANGE( ref.damage, ctx.damage, ref.damage * 1e-3 );
+        }
+
+        ASSERT( RFC_deinit( &ctx ) );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if RFC_TP_SUPPORT
+TEST RFC_archive_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    static rfc_value_t      data[20000];
+    static unsigned char    archive[20000 * sizeof(rfc_value_t)];
+    rfc_value_tuple_s       tp[10];
+    rfc_value_t             hysteresis;
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    size_t                  i, size, sample_count, tp_count;
+    int                     pass;
+
+    /* Signal sampled from an ADC, quantized values */
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        double value = 3.0 * sin( 0.013 * i ) + 0.8 * sin( 0.21 * i ) + 0.3 * sin( 2.3 * i ) + 0.2 * sin( 3.7 * i );
+
+        data[i] = floor( value * 1000.0 + 0.5 ) / 1000.0;
+    }
+
+    /* Extraction only, no counting */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, /*flags*/ 0 ) );
+    ASSERT( RFC_tp_init( &ctx, NULL, 1024, /* is_static */ false ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_NONE ) );
+
+    size = 0;
+    ASSERT( !RFC_archive_write( &ctx, NULL, &size, 100, 1000.0 ) );
+    ASSERT( size > 0 && size < sizeof(data) / 4 );
+    size = sizeof(archive);
+    ASSERT( RFC_archive_write( &ctx, archive, &size, 100, 1000.0 ) );
+    ASSERT( RFC_archive_info( archive, size, &hysteresis, &sample_count, &tp_count ) );
+    ASSERT_EQ( hysteresis, class_width );
+    ASSERT_EQ( sample_count, NUMEL(data) );
+    ASSERT_EQ( tp_count, ctx.tp_cnt );
+
+    /* Random access across a chunk border */
+    ASSERT( RFC_archive_get( archive, size, 195, tp, NUMEL(tp) ) );
+    for( i = 0; i < NUMEL(tp); i++ )
+    {
+        ASSERT_EQ( tp[i].value, ctx.tp[195 + i].value );
+        ASSERT_EQ( tp[i].pos,   ctx.tp[195 + i].pos );
+    }
+    ASSERT( !RFC_archive_get( archive, size, tp_count - 5, tp, NUMEL(tp) ) );
+
+    /* Unquantized values are XOR coded */
+    size = sizeof(archive);
+    ASSERT( RFC_archive_write( &ctx, archive, &size, 0, 0.0 ) );
+    ASSERT( RFC_archive_get( archive, size, 1000, tp, NUMEL(tp) ) );
+    for( i = 0; i < NUMEL(tp); i++ )
+    {
+        ASSERT_EQ( tp[i].value, ctx.tp[1000 + i].value );
+        ASSERT_EQ( tp[i].pos,   ctx.tp[1000 + i].pos );
+    }
+    size = sizeof(archive);
+    ASSERT( RFC_archive_write( &ctx, archive, &size, 100, 1000.0 ) );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    /* Recounts are identical for any hysteresis not less than the archive's */
+    for( pass = 0; pass < 2; pass++ )
+    {
+        rfc_value_t h = pass ? 3 * class_width : class_width;
+
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, h, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_modified( &ref, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, h, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_modified( &ctx, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+        ASSERT( RFC_archive_feed( &ctx, archive, size ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+        ASSERT_EQ( ctx.internal.pos, ref.internal.pos );
+        ASSERT_EQ( ctx.damage, ref.damage );
+        ASSERT_MEM_EQ( ctx.rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( ctx.lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+        ASSERT( RFC_deinit( &ctx ) );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    /* Hysteresis below the archive's */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width / 2, RFC_FLAGS_DEFAULT ) );
+    ASSERT( !RFC_archive_feed( &ctx, archive, size ) );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*RFC_TP_SUPPORT*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_follower_test( void )
+{
+    unsigned                class_count     = 50;
+    double                  class_width     = 0.2;
+    double                  class_offset    = -5.0;
+    static rfc_value_t      data[5000];
+    rfc_counting_method_e   methods[]       = { RFC_COUNTING_METHOD_4PTM,
+#if RFC_HCM_SUPPORT
+                                                RFC_COUNTING_METHOD_HCM,
+#endif /*RFC_HCM_SUPPORT*/
+#if RFC_ASTM_SUPPORT
+                                                RFC_COUNTING_METHOD_ASTM,
+#endif /*RFC_ASTM_SUPPORT*/
+                                              };
+    rfc_ctx_s               follower[NUMEL(methods)];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    size_t                  i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 3.0 * sin( 0.011 * i ) + 1.2 * sin( 0.17 * i ) + 0.4 * sin( 1.9 * i );
+    }
+
+    /* Class parameters must match */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_init( &ref, class_count, class_width * 2, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( !RFC_follower_add( &ctx, &ref ) );
+    ASSERT( RFC_deinit( &ctx ) );
+    ASSERT( RFC_deinit( &ref ) );
+
+    /* Leader filters only */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ctx.counting_method = RFC_COUNTING_METHOD_NONE;
+
+    for( i = 0; i < NUMEL(methods); i++ )
+    {
+        memset( &follower[i], 0, sizeof(rfc_ctx_s) );
+        follower[i].version = sizeof(rfc_ctx_s);
+        ASSERT( RFC_init( &follower[i], class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_modified( &follower[i], /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+        follower[i].counting_method = methods[i];
+        ASSERT( RFC_follower_add( &ctx, &follower[i] ) );
+    }
+
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) / 2 ) );
+    ASSERT( RFC_feed( &ctx, data + NUMEL(data) / 2, NUMEL(data) - NUMEL(data) / 2 ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+    /* Each follower counts as a context of its own */
+    for( i = 0; i < NUMEL(methods); i++ )
+    {
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_modified( &ref, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+        ref.counting_method = methods[i];
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+
+        ASSERT_EQ( follower[i].state, RFC_STATE_FINISHED );
+        ASSERT( ref.damage > 0.0 );
+        ASSERT_EQ( follower[i].damage, ref.damage );
+        ASSERT_EQ( follower[i].residue_cnt, ref.residue_cnt );
+        ASSERT_MEM_EQ( follower[i].rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( follower[i].lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+        ASSERT_MEM_EQ( follower[i].rp,  ref.rp,  sizeof(rfc_counts_t) * class_count );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    ASSERT( RFC_deinit( &ctx ) );
+
+    for( i = 0; i < NUMEL(methods); i++ )
+    {
+        ASSERT( RFC_deinit( &follower[i] ) );
+    }
+
+#if RFC_TP_SUPPORT
+    /* Leader enforces margins, first turning point is the left margin */
+    data[0] = -4.9;
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_COUNT_ALL | RFC_FLAGS_ENFORCE_MARGIN ) );
+    ASSERT( RFC_init( &follower[0], class_count, class_width, class_offset, class_width, RFC_FLAGS_COUNT_ALL | RFC_FLAGS_ENFORCE_MARGIN ) );
+    ASSERT( !RFC_follower_add( &ctx, &follower[0] ) );
+    ASSERT( RFC_deinit( &ctx ) );
+    ASSERT( RFC_deinit( &follower[0] ) );
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_COUNT_ALL | RFC_FLAGS_ENFORCE_MARGIN ) );
+    ASSERT( RFC_init( &follower[0], class_count, class_width, class_offset, class_width, RFC_FLAGS_COUNT_ALL ) );
+    ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_COUNT_ALL ) );
+    ASSERT( RFC_wl_init_modified( &follower[0], /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+    ASSERT( RFC_wl_init_modified( &ref, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+    ctx.counting_method = RFC_COUNTING_METHOD_NONE;
+    ASSERT( RFC_follower_add( &ctx, &follower[0] ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+    ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+    ASSERT_EQ( follower[0].damage, ref.damage );
+    ASSERT_MEM_EQ( follower[0].rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( follower[0].lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+    ASSERT( RFC_deinit( &ctx ) );
+    ASSERT( RFC_deinit( &follower[0] ) );
+    ASSERT( RFC_deinit( &ref ) );
+#endif /*RFC_TP_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_finalize_multi_test( void )
+{
+    unsigned                class_count     = 50;
+    double                  class_width     = 0.2;
+    double                  class_offset    = -5.0;
+    static rfc_value_t      data[3000];
+    static rfc_counts_t     rfm[5][50 * 50];
+    static rfc_counts_t     rp[5][50];
+    static rfc_counts_t     lc[5][50];
+    rfc_res_method_e        methods[]       = { RFC_RES_HALFCYCLES, RFC_RES_FULLCYCLES, RFC_RES_CLORMANN_SEEGER, 
+                                                RFC_RES_REPEATED, RFC_RES_RP_DIN45667 };
+    rfc_res_result_s        results[NUMEL(methods)];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    size_t                  i, j;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 3.0 * sin( 0.007 * i ) + 1.2 * sin( 0.13 * i ) + 0.4 * sin( 1.7 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+    ASSERT( RFC_wl_init_modified( &ctx, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+
+    for( i = 0; i < NUMEL(methods); i++ )
+    {
+        results[i].rfm = rfm[i];
+        results[i].rp  = rp[i];
+        results[i].lc  = lc[i];
+    }
+
+    ASSERT( RFC_finalize_multi( &ctx, methods, results, NUMEL(methods) ) );
+    ASSERT( ctx.state < RFC_STATE_FINALIZE );
+
+    for( i = 0; i < NUMEL(methods); i++ )
+    {
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, RFC_FLAGS_DEFAULT ) );
+        ASSERT( RFC_wl_init_modified( &ref, /*sx*/ 1.0, /*nx*/ 1e6, /*k*/ -5, /*k2*/ -9 ) );
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, methods[i] ) );
+
+        ASSERT_EQ( results[i].damage, ref.damage );
+        ASSERT_IN_RANGE( ref.damage_residue, results[i].damage_residue, ref.damage * 1e-12 );
+
+        /* Base counts plus deltas */
+        for( j = 0; j < (size_t)class_count * class_count; j++ )
+        {
+            ASSERT_EQ( ctx.rfm[j] + rfm[i][j], ref.rfm[j] );
+        }
+
+        for( j = 0; j < class_count; j++ )
+        {
+            ASSERT_EQ( ctx.rp[j] + rp[i][j], ref.rp[j] );
+            ASSERT_EQ( ctx.lc[j] + lc[i][j], ref.lc[j] );
+        }
+
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    /* Context may be finalized as usual */
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+    ASSERT_EQ( ctx.damage, results[3].damage );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_feed_rle_test( void )
+{
+    unsigned                class_count     = 50;
+    double                  class_width     = 0.2;
+    double                  class_offset    = -5.0;
+    static rfc_value_t      data[20000];
+    static rfc_value_t      values[4000];
+    static size_t           repeats[4000];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    rfc_flags_e             flags           = RFC_FLAGS_COUNT_ALL | RFC_FLAGS_COUNT_TAL;
+    size_t                  i, n, run_count = 0;
+
+#if RFC_TP_SUPPORT
+    flags |= RFC_FLAGS_ENFORCE_MARGIN;
+#endif /*RFC_TP_SUPPORT*/
+
+    /* Plateau signal, runs of 1 to 19 samples */
+    for( i = 0, n = 0; n < NUMEL(data); i++ )
+    {
+        size_t j, r = 1 + ( i * 7 ) % 19;
+
+        values[run_count]  = floor( 10.0 * ( 2.0 * sin( 0.05 * i ) + sin( 0.7 * i ) ) + 0.5 ) / 10.0;
+        repeats[run_count] = ( i % 11 == 5 ) ? 0 : r;
+
+        for( j = 0; j < repeats[run_count] && n < NUMEL(data); j++ )
+        {
+            data[n++] = values[run_count];
+        }
+
+        repeats[run_count++] = j;
+    }
+
+    ASSERT( RFC_init( &ref, class_count, class_width, class_offset, class_width, flags ) );
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, flags ) );
+#if RFC_TP_SUPPORT
+    ASSERT( RFC_tp_init( &ref, NULL, 1024, /* is_static */ false ) );
+    ASSERT( RFC_tp_init( &ctx, NULL, 1024, /* is_static */ false ) );
+#endif /*RFC_TP_SUPPORT*/
+
+    ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+
+    ASSERT( RFC_feed_rle( &ctx, values, repeats, run_count / 3 ) );
+    ASSERT( RFC_feed_rle( &ctx, values + run_count / 3, repeats + run_count / 3, run_count - run_count / 3 ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+    ASSERT_EQ( ctx.internal.pos, NUMEL(data) );
+    ASSERT( ref.damage > 0.0 );
+    ASSERT_EQ( ctx.damage, ref.damage );
+    ASSERT_MEM_EQ( ctx.rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+    ASSERT_MEM_EQ( ctx.lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+    ASSERT_MEM_EQ( ctx.tal, ref.tal, sizeof(size_t) * class_count );
+#if RFC_TP_SUPPORT
+    ASSERT_EQ( ctx.tp_cnt, ref.tp_cnt );
+    for( i = 0; i < ref.tp_cnt; i++ )
+    {
+        ASSERT_EQ( ctx.tp[i].value, ref.tp[i].value );
+        ASSERT_EQ( ctx.tp[i].pos,   ref.tp[i].pos );
+    }
+#endif /*RFC_TP_SUPPORT*/
+
+    ASSERT( RFC_deinit( &ctx ) );
+    ASSERT( RFC_deinit( &ref ) );
+
+#if RFC_DH_SUPPORT && RFC_TP_SUPPORT
+    /* Runs don't provide the input stream for transient spreading */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, flags ) );
+    ASSERT( RFC_tp_init( &ctx, NULL, 1024, /* is_static */ false ) );
+    ASSERT( RFC_dh_init( &ctx, RFC_SD_TRANSIENT_23c, /*dh*/ NULL, /*dh_cap*/ 1, /*is_static*/ false ) );
+    ASSERT( !RFC_feed_rle( &ctx, values, repeats, run_count ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_UNSUPPORTED );
+    ASSERT( RFC_deinit( &ctx ) );
+#endif /*RFC_DH_SUPPORT && RFC_TP_SUPPORT*/
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_feed_classes_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    static uint16_t         cls[20000];
+    static rfc_value_t      data[20000];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    rfc_flags_e             flags           = RFC_FLAGS_COUNT_ALL | RFC_FLAGS_COUNT_TAL;
+    size_t                  i;
+    int                     pass;
+
+#if RFC_TP_SUPPORT
+    flags |= RFC_FLAGS_ENFORCE_MARGIN;
+#endif /*RFC_TP_SUPPORT*/
+
+    /* Pre-binned signal with plateaus and noise */
+    for( i = 0; i < NUMEL(cls); i++ )
+    {
+        double value = 2.5 * sin( 0.003 * i ) + ( ( i / 40 ) % 3 ? 0.0 : 0.8 * sin( 0.9 * i ) );
+
+        cls[i]  = (uint16_t)( ( value - class_offset ) / class_width );
+        data[i] = class_width * ( 0.5 + cls[i] ) + class_offset;
+    }
+
+    for( pass = 0; pass < 2; pass++ )
+    {
+        double hysteresis = pass ? 4.5 * class_width : class_width;
+
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, hysteresis, flags ) );
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, hysteresis, flags ) );
+#if RFC_TP_SUPPORT
+        ASSERT( RFC_tp_init( &ref, NULL, 1024, /* is_static */ false ) );
+        ASSERT( RFC_tp_init( &ctx, NULL, 1024, /* is_static */ false ) );
+#endif /*RFC_TP_SUPPORT*/
+
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+
+        ASSERT( RFC_feed_classes( &ctx, cls, 777 ) );
+        ASSERT( RFC_feed_classes( &ctx, cls + 777, NUMEL(cls) - 777 ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+        ASSERT_EQ( ctx.internal.pos, NUMEL(data) );
+        ASSERT( ref.damage > 0.0 );
+        ASSERT_EQ( ctx.damage, ref.damage );
+        ASSERT_MEM_EQ( ctx.rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( ctx.lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+        ASSERT_MEM_EQ( ctx.tal, ref.tal, sizeof(size_t) * class_count );
+#if RFC_TP_SUPPORT
+        ASSERT_EQ( ctx.tp_cnt, ref.tp_cnt );
+        for( i = 0; i < ref.tp_cnt; i++ )
+        {
+            ASSERT_EQ( ctx.tp[i].value, ref.tp[i].value );
+            ASSERT_EQ( ctx.tp[i].pos,   ref.tp[i].pos );
+        }
+#endif /*RFC_TP_SUPPORT*/
+
+        ASSERT( RFC_deinit( &ctx ) );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    /* Class index out of range */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, flags ) );
+    cls[0] = (uint16_t)class_count;
+    ASSERT( !RFC_feed_classes( &ctx, cls, 1 ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_DATA_OUT_OF_RANGE );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+TEST RFC_feed_tp_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    static rfc_value_t      data[20000];
+    static rfc_value_t      values[20000];
+    static size_t           positions[20000];
+    rfc_ctx_s               ref             = { sizeof(ref) };
+    rfc_flags_e             flags           = RFC_FLAGS_COUNT_ALL;
+    size_t                  i, n;
+    int                     pass;
+
+#if RFC_TP_SUPPORT
+    flags |= RFC_FLAGS_ENFORCE_MARGIN;
+#endif /*RFC_TP_SUPPORT*/
+
+    /* Binned signal with noise, margins are turning points */
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        double   value = 2.5 * sin( 0.003 * i ) + ( ( i / 40 ) % 3 ? 0.0 : 0.8 * sin( 0.9 * i ) );
+        unsigned cls   = (unsigned)( ( value - class_offset ) / class_width );
+
+        data[i] = class_width * ( 0.5 + cls ) + class_offset;
+    }
+
+    data[0] = data[NUMEL(data)-2] = class_width * 97.5 + class_offset;
+    data[1] = data[NUMEL(data)-1] = class_width *  2.5 + class_offset;
+
+    for( pass = 0; pass < 2; pass++ )
+    {
+        double hysteresis = pass ? 4.5 * class_width : 1.5 * class_width;
+        int    slope      = -1;
+
+        /* Peak-valley and hysteresis filtering */
+        values[0] = data[0]; positions[0] = 1;
+        values[1] = data[1]; positions[1] = 2;
+        for( i = 2, n = 2; i < NUMEL(data); i++ )
+        {
+            double delta = data[i] - values[n-1];
+
+            if( delta * slope > 0.0 )
+            {
+                values[n-1]    = data[i];
+                positions[n-1] = i + 1;
+            }
+            else if( fabs( delta ) > hysteresis )
+            {
+                values[n]      = data[i];
+                positions[n++] = i + 1;
+                slope          = -slope;
+            }
+        }
+
+        ASSERT( RFC_init( &ref, class_count, class_width, class_offset, hysteresis, flags ) );
+        ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, hysteresis, flags ) );
+#if RFC_TP_SUPPORT
+        ASSERT( RFC_tp_init( &ref, NULL, 1024, /* is_static */ false ) );
+        ASSERT( RFC_tp_init( &ctx, NULL, 1024, /* is_static */ false ) );
+#endif /*RFC_TP_SUPPORT*/
+
+        ASSERT( RFC_feed( &ref, data, NUMEL(data) ) );
+        ASSERT( RFC_finalize( &ref, RFC_RES_REPEATED ) );
+
+        ASSERT( RFC_feed_tp( &ctx, values, positions, 33 ) );
+        ASSERT( RFC_feed_tp( &ctx, values + 33, positions + 33, n - 33 ) );
+        ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+        ASSERT_EQ( ctx.internal.pos, NUMEL(data) );
+        ASSERT( ref.damage > 0.0 );
+        ASSERT_EQ( ctx.damage, ref.damage );
+        ASSERT_MEM_EQ( ctx.rfm, ref.rfm, sizeof(rfc_counts_t) * class_count * class_count );
+        ASSERT_MEM_EQ( ctx.lc,  ref.lc,  sizeof(rfc_counts_t) * class_count );
+#if RFC_TP_SUPPORT
+        ASSERT_EQ( ctx.tp_cnt, ref.tp_cnt );
+        for( i = 0; i < ref.tp_cnt; i++ )
+        {
+            ASSERT_EQ( ctx.tp[i].value, ref.tp[i].value );
+            ASSERT_EQ( ctx.tp[i].pos,   ref.tp[i].pos );
+        }
+#endif /*RFC_TP_SUPPORT*/
+
+        ASSERT( RFC_deinit( &ctx ) );
+        ASSERT( RFC_deinit( &ref ) );
+    }
+
+    /* Slopes not alternating, positions not increasing */
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, flags ) );
+    values[0] = 1.0; values[1] = 2.0; values[2] = 3.0;
+    ASSERT( !RFC_feed_tp( &ctx, values, NULL, 3 ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_INVARG );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, class_width, flags ) );
+    values[0] = 1.0; values[1] = -1.0;
+    positions[0] = 5; positions[1] = 5;
+    ASSERT( !RFC_feed_tp( &ctx, values, positions, 2 ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_INVARG );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
+#if !RFC_MINIMAL
+typedef struct
+{
+    rfc_rfm_item_s         *items;
+    unsigned                count;
+    unsigned                limit;
+} rfm_visit_s;
+
+
+static
+bool rfm_visit( void *user, unsigned from, unsigned to, rfc_counts_t counts )
+{
+    rfm_visit_s *visit = (rfm_visit_s*)user;
+
+    if( visit->count >= visit->limit ) return false;
+
+    visit->items[visit->count].from   = from;
+    visit->items[visit->count].to     = to;
+    visit->items[visit->count].counts = counts;
+    visit->count++;
+
+    return true;
+}
+
+
+TEST RFC_rfm_foreach_test( void )
+{
+    unsigned                class_count     = 100;
+    double                  class_width     = 0.1;
+    double                  class_offset    = -5.0;
+    double                  hysteresis      = class_width;
+    static rfc_value_t      data[10000];
+    static rfc_rfm_item_s   items[10000];
+    rfc_rfm_item_s         *buffer          = NULL;
+    unsigned                count           = 0;
+    rfm_visit_s             visit           = { items, 0, NUMEL(items) };
+    size_t                  i;
+
+    for( i = 0; i < NUMEL(data); i++ )
+    {
+        data[i] = 2.5 * sin( 0.01 * i ) + 1.5 * sin( 0.7 * i );
+    }
+
+    ASSERT( RFC_init( &ctx, class_count, class_width, class_offset, hysteresis, RFC_FLAGS_COUNT_RFM ) );
+
+    ASSERT( RFC_feed( &ctx, data, NUMEL(data) ) );
+    ASSERT( RFC_finalize( &ctx, RFC_RES_REPEATED ) );
+
+    /* Same elements in same order as RFC_rfm_get() */
+    ASSERT( RFC_rfm_get( &ctx, &buffer, &count ) );
+    ASSERT( RFC_rfm_foreach( &ctx, rfm_visit, &visit ) );
+    ASSERT( count > 2 );
+    ASSERT_EQ( visit.count, count );
+    ASSERT_MEM_EQ( items, buffer, sizeof(rfc_rfm_item_s) * count );
+
+    /* Visitor stops iteration */
+    visit.count = 0;
+    visit.limit = 2;
+    ASSERT( RFC_rfm_foreach( &ctx, rfm_visit, &visit ) );
+    ASSERT_EQ( visit.count, 2 );
+    ASSERT_MEM_EQ( items, buffer, sizeof(rfc_rfm_item_s) * 2 );
+
+    ASSERT( !RFC_rfm_foreach( &ctx, NULL, NULL ) );
+    ASSERT_EQ( ctx.error, RFC_ERROR_INVARG );
+
+    free( buffer );
+    ASSERT( RFC_deinit( &ctx ) );
+
+    PASS();
+}
+#endif /*!RFC_MINIMAL*/
+
+
 TEST RFC_ctx_inspect( void )
 {
     fprintf( stdout, "\n %20s\t%lu", "version",             (unsigned long)offsetof( rfc_ctx_s, version ) );
@@ -2421,6 +4671,63 @@ SUITE( RFC_TEST_SUITE )
     /* "Miner consequent" approach */
     RUN_TEST( RFC_miner_consequent );
     RUN_TEST( RFC_miner_consequent2 );
+    /* Critical plane counting */
+    RUN_TEST( RFC_cp_test );
+    /* Spectral damage estimation */
+    RUN_TEST( RFC_spectral_test );
+    /* Range-mean matrix */
+    RUN_TEST1( RFC_rmm_test, 0 );
+#if RFC_AR_SUPPORT
+    RUN_TEST1( RFC_rmm_test, 1 );
+#endif /*RFC_AR_SUPPORT*/
+    /* Range-mean-duration histogram */
+    RUN_TEST1( RFC_rmd_test, 0 );
+#if RFC_AR_SUPPORT
+    RUN_TEST1( RFC_rmd_test, 1 );
+#endif /*RFC_AR_SUPPORT*/
+    /* Rainflow matrix pyramid */
+    RUN_TEST( RFC_rfm_pyramid_test );
+    /* Counting in value domain */
+    RUN_TEST( RFC_cycles_test );
+    /* Non-uniform class boundaries */
+    RUN_TEST( RFC_class_bounds_test );
+    /* Conditional counting */
+    RUN_TEST( RFC_cond_test );
+    /* Time at level */
+    RUN_TEST( RFC_tal_test );
+    /* Woehler curves per condition */
+    RUN_TEST( RFC_wl_bins_test );
+    /* Local strain approach */
+    RUN_TEST( RFC_sl_test );
+    /* Most damaging cycles */
+    RUN_TEST( RFC_top_test );
+    /* Snapshots for concurrent readers */
+    RUN_TEST( RFC_snapshot_test );
+#if RFC_TEST_PTHREADS
+    RUN_TEST( RFC_snapshot_thread_test );
+#endif /*RFC_TEST_PTHREADS*/
+    /* Result regions for other processes */
+    RUN_TEST( RFC_region_test );
+    /* Multiplexer of many low-rate streams */
+    RUN_TEST( RFC_mux_test );
+    /* Damage based hysteresis filtering */
+    RUN_TEST( RFC_hysteresis_damage_test );
+#if RFC_TP_SUPPORT
+    /* Turning point archives */
+    RUN_TEST( RFC_archive_test );
+#endif /*RFC_TP_SUPPORT*/
+    /* Several counting methods over one filter pass */
+    RUN_TEST( RFC_follower_test );
+    /* Several residual methods at once */
+    RUN_TEST( RFC_finalize_multi_test );
+    /* Run-length encoded data */
+    RUN_TEST( RFC_feed_rle_test );
+    /* Pre-quantized class indices */
+    RUN_TEST( RFC_feed_classes_test );
+    /* Feed turning points */
+    RUN_TEST( RFC_feed_tp_test );
+    /* Visit rainflow matrix elements */
+    RUN_TEST( RFC_rfm_foreach_test );
 #endif /*!RFC_MINIMAL*/
 #if RFC_TP_SUPPORT
     /* Test turning points */